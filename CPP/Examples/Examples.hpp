@@ -14,9 +14,11 @@
 
 #include "cfl/AssetModel.hpp"
 #include "cfl/Data.hpp"
+#include "cfl/Exercise.hpp"
 #include "cfl/Fit.hpp"
 #include "cfl/InterestRateModel.hpp"
 #include "cfl/Interp.hpp"
+#include "cfl/MonteCarlo.hpp"
 #include "cfl/Root.hpp"
 #include "cfl/RootD.hpp"
 
@@ -477,6 +479,28 @@ cfl::MultiFunction americanPut (double dStrike,
                                 const std::vector<double> &rExerciseTimes,
                                 cfl::AssetModel &rModel);
 
+/**
+ * Computes the value of the <strong>American put option</strong> and
+ * records or replays its exercise region. In the recording mode of \p
+ * rExercise the option is exercised optimally and the exercise region
+ * is kept in \p rExercise. In the replay mode the recorded exercise
+ * region is used, for example, to compute the sensitivities by the
+ * reprices of the option in the perturbed model.
+ *
+ * @param dStrike The strike of the option.
+ * @param rExerciseTimes The vector of exercise times. The first exercise
+ * time is  greater than the initial time.
+ * @param rModel The reference to an implementation of cfl::AssetModel.
+ * @param rExercise The exercise region of the option.
+ *
+ * @return The price of the option as the function of the initial
+ * values of the state processes in the model.
+ */
+cfl::MultiFunction americanPut (double dStrike,
+                                const std::vector<double> &rExerciseTimes,
+                                cfl::AssetModel &rModel,
+                                cfl::Exercise &rExercise);
+
 /**
  * Computes the value of the <strong>up-or-down-and-out barrier
  * option</strong>. The payoff of the option at maturity (last
@@ -775,6 +799,89 @@ cfl::MultiFunction autoCap (const cfl::Data::CashFlow &rCap,
                             unsigned iNumberOfCaplets,
                             cfl::InterestRateModel &rModel);
 /** @} */
+
+/**
+ * @defgroup prbMonteCarlo Options with early exercise by Monte Carlo.
+ *
+ * This module deals with valuation of options with early exercise by
+ * the least-squares Monte Carlo method. The exercise boundary is
+ * computed on one set of paths and the option is priced on new
+ * paths, see cfl::MonteCarlo::boundary().
+ *
+ * @{
+ */
+
+/**
+ * Computes the value of the <strong>American put option</strong> by
+ * the least-squares Monte Carlo method. In this contract, at any
+ * exercise time (from \p rExerciseTimes) a holder of the option can
+ * sell the stock at strike \p dStrike.
+ *
+ * @param dStrike The strike of the option.
+ * @param rExerciseTimes The vector of exercise times. The first exercise
+ * time is  greater than the initial time.
+ * @param rData The parameters of Black model.
+ * @param iPaths The number of paths for the exercise boundary and for
+ * the price.
+ * @param iSeed The seed of the random numbers.
+ *
+ * @return The price of the option at the initial time and its
+ * standard error.
+ */
+std::valarray<double> americanPut (double dStrike,
+                                   const std::vector<double> &rExerciseTimes,
+                                   const cfl::Black::Data &rData,
+                                   unsigned long iPaths,
+                                   unsigned long iSeed = 0);
+
+/**
+ * Computes the value of the <strong>swing option</strong> by the
+ * least-squares Monte Carlo method.  The holder can exercise the
+ * option \p iNumberOfExercises times.  At each exercise time the
+ * holder can buy only one stock for strike \p dStrike.
+ *
+ * @param dStrike The strike of the option.
+ * @param rExerciseTimes The vector of exercise times.
+ * @param iNumberOfExercises The maximal number of exercises.
+ * @param rData The parameters of Black model.
+ * @param iPaths The number of paths for the exercise boundary and for
+ * the price.
+ * @param iSeed The seed of the random numbers.
+ *
+ * @return The price of the option at the initial time and its
+ * standard error.
+ */
+std::valarray<double> swing (double dStrike,
+                             const std::vector<double> &rExerciseTimes,
+                             unsigned iNumberOfExercises,
+                             const cfl::Black::Data &rData,
+                             unsigned long iPaths, unsigned long iSeed = 0);
+
+/**
+ * Computes the price of <strong>American swaption</strong> by the
+ * least-squares Monte Carlo method. A holder of the option can enter
+ * into the underlying swap agreement at any exercise time. This time
+ * then becomes the issue time of the swap.
+ *
+ * @param rSwap The parameters of the underlying interest rate
+ * swap.
+ * @param rExerciseTimes The set of exercise times. The first
+ * exercise time is strictly greater than the initial time in the
+ * model.
+ * @param rData The parameters of Hull and White model.
+ * @param iPaths The number of paths for the exercise boundary and for
+ * the price.
+ * @param iSeed The seed of the random numbers.
+ *
+ * @return The price of the option at the initial time and its
+ * standard error.
+ */
+std::valarray<double>
+americanSwaption (const cfl::Data::Swap &rSwap,
+                  const std::vector<double> &rExerciseTimes,
+                  const cfl::HullWhite::Data &rData, unsigned long iPaths,
+                  unsigned long iSeed = 0);
+/** @} */
 }
 
 #endif // of __Examples_hpp__
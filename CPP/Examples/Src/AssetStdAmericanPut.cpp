@@ -6,6 +6,14 @@ using namespace std;
 cfl::MultiFunction
 prb::americanPut (double dStrike, const std::vector<double> &rExerciseTimes,
                   AssetModel &rModel)
+{
+  Exercise uExercise;
+  return americanPut (dStrike, rExerciseTimes, rModel, uExercise);
+}
+
+cfl::MultiFunction
+prb::americanPut (double dStrike, const std::vector<double> &rExerciseTimes,
+                  AssetModel &rModel, Exercise &rExercise)
 {
   PRECONDITION (rModel.initialTime () < rExerciseTimes.front ());
   PRECONDITION (std::is_sorted (rExerciseTimes.begin (), rExerciseTimes.end (),
@@ -22,7 +30,7 @@ prb::americanPut (double dStrike, const std::vector<double> &rExerciseTimes,
   while (iTime > 0)
     {
       // uOption is the value to continue
-      uOption = max (uOption, dStrike - rModel.spot (iTime));
+      uOption = rExercise.max (uOption, dStrike - rModel.spot (iTime));
       iTime--;
       uOption.rollback (iTime);
     }
@@ -9,14 +9,14 @@ cfl::Slice
 swapRate (unsigned iTime, double dPeriod, unsigned iPeriods,
           const InterestRateModel &rModel)
 {
-  cfl::Slice uFixed = rModel.cash (iTime, 0.);
+  std::vector<double> uPaymentTimes (iPeriods);
   double dTime = rModel.eventTimes ()[iTime];
-  for (unsigned iI = 0; iI < iPeriods; iI++)
+  for (double &rT : uPaymentTimes)
     {
       dTime += dPeriod;
-      uFixed += rModel.discount (iTime, dTime);
+      rT = dTime;
     }
-  uFixed *= dPeriod;
+  cfl::Slice uFixed = rModel.annuity (iTime, uPaymentTimes);
   cfl::Slice uFloat = 1. - rModel.discount (iTime, dTime);
   cfl::Slice uRate = (uFloat / uFixed);
 
@@ -10,14 +10,14 @@ cfl::Slice
 couponBond (unsigned iTime, const Data::CashFlow &rBond,
             const InterestRateModel &rModel)
 {
-  Slice uCashFlow = rModel.cash (iTime, 0.);
+  std::vector<double> uPaymentTimes (rBond.numberOfPayments);
   double dTime = rModel.eventTimes ()[iTime];
-  for (unsigned iI = 0; iI < rBond.numberOfPayments; iI++)
+  for (double &rT : uPaymentTimes)
     {
       dTime += rBond.period;
-      uCashFlow += rModel.discount (iTime, dTime);
+      rT = dTime;
     }
-  uCashFlow *= (rBond.rate * rBond.period);
+  Slice uCashFlow = rModel.annuity (iTime, uPaymentTimes) * rBond.rate;
   uCashFlow += rModel.discount (iTime, dTime);
   uCashFlow *= rBond.notional;
 
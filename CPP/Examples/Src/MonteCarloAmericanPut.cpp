@@ -0,0 +1,42 @@
+#include "Examples/Examples.hpp"
+
+using namespace cfl;
+using namespace std;
+
+std::valarray<double>
+prb::americanPut (double dStrike, const std::vector<double> &rExerciseTimes,
+                  const cfl::Black::Data &rData, unsigned long iPaths,
+                  unsigned long iSeed)
+{
+  PRECONDITION (rData.initialTime < rExerciseTimes.front ());
+  PRECONDITION (std::is_sorted (rExerciseTimes.begin (), rExerciseTimes.end (),
+                                std::less_equal<double> ()));
+
+  std::vector<double> uEventTimes (rExerciseTimes.size () + 1);
+  uEventTimes.front () = rData.initialTime;
+  copy (rExerciseTimes.begin (), rExerciseTimes.end (),
+        uEventTimes.begin () + 1);
+  MonteCarlo::PathModel uModel = MonteCarlo::black (rData, uEventTimes);
+
+  // the payoff of exercise divided by the numeraire
+  MonteCarlo::TPathFunction uExercise
+      = [dStrike] (const MonteCarlo::Paths &rPaths,
+                   unsigned iTime) -> std::valarray<double> {
+    return (dStrike - rPaths.spot (iTime)) / rPaths.numeraire (iTime);
+  };
+  // the regressor is the spot price in units of the strike
+  MonteCarlo::TPathFunction uState
+      = [dStrike] (const MonteCarlo::Paths &rPaths,
+                   unsigned iTime) -> std::valarray<double> {
+    return rPaths.spot (iTime) / dStrike;
+  };
+  std::vector<Function> uBasis
+      = { Function (1.), Function ([] (double dX) { return dX; }),
+          Function ([] (double dX) { return dX * dX; }) };
+
+  MonteCarlo::Boundary uBoundary = MonteCarlo::boundary (
+      uModel, uExercise, uState, uBasis, iPaths, 1, iSeed);
+  // the price is computed with the new paths
+  MonteCarlo::TPayoff uPayoff = MonteCarlo::american (uExercise, uBoundary);
+  return MonteCarlo::price (uModel, uPayoff, iPaths, iSeed + 1);
+}
@@ -0,0 +1,58 @@
+#include "Examples/Examples.hpp"
+
+using namespace cfl;
+using namespace std;
+
+std::valarray<double>
+prb::americanSwaption (const cfl::Data::Swap &rSwap,
+                       const std::vector<double> &rExerciseTimes,
+                       const cfl::HullWhite::Data &rData,
+                       unsigned long iPaths, unsigned long iSeed)
+{
+  PRECONDITION (rData.initialTime < rExerciseTimes.front ());
+  PRECONDITION (std::is_sorted (rExerciseTimes.begin (), rExerciseTimes.end (),
+                                std::less_equal<double> ()));
+
+  std::vector<double> uEventTimes (rExerciseTimes.size () + 1);
+  uEventTimes.front () = rData.initialTime;
+  copy (rExerciseTimes.begin (), rExerciseTimes.end (),
+        uEventTimes.begin () + 1);
+  MonteCarlo::PathModel uModel = MonteCarlo::hullWhite (rData, uEventTimes);
+
+  // the value of the swap issued at exercise divided by the numeraire
+  MonteCarlo::TPathFunction uExercise
+      = [rSwap] (const MonteCarlo::Paths &rPaths,
+                 unsigned iTime) -> std::valarray<double> {
+    double dTime = rPaths.eventTimes ()[iTime];
+    std::valarray<double> uFixed (0., rPaths.size ());
+    for (unsigned iI = 1; iI <= rSwap.numberOfPayments; iI++)
+      {
+        uFixed += rPaths.discount (iTime, dTime + iI * rSwap.period);
+      }
+    uFixed *= rSwap.rate * rSwap.period;
+    double dMaturity = dTime + rSwap.numberOfPayments * rSwap.period;
+    std::valarray<double> uSwap
+        = rSwap.notional
+          * (uFixed - 1. + rPaths.discount (iTime, dMaturity));
+    if (!rSwap.payFloat)
+      {
+        uSwap *= -1.;
+      }
+    return uSwap / rPaths.numeraire (iTime);
+  };
+  // the regressor is the state process
+  MonteCarlo::TPathFunction uState
+      = [] (const MonteCarlo::Paths &rPaths,
+            unsigned iTime) -> std::valarray<double> {
+    return rPaths.state (iTime);
+  };
+  std::vector<Function> uBasis
+      = { Function (1.), Function ([] (double dX) { return dX; }),
+          Function ([] (double dX) { return dX * dX; }) };
+
+  MonteCarlo::Boundary uBoundary = MonteCarlo::boundary (
+      uModel, uExercise, uState, uBasis, iPaths, 1, iSeed);
+  // the price is computed with the new paths
+  MonteCarlo::TPayoff uPayoff = MonteCarlo::american (uExercise, uBoundary);
+  return MonteCarlo::price (uModel, uPayoff, iPaths, iSeed + 1);
+}
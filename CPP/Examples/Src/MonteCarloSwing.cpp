@@ -0,0 +1,44 @@
+#include "Examples/Examples.hpp"
+
+using namespace cfl;
+using namespace std;
+
+std::valarray<double>
+prb::swing (double dStrike, const std::vector<double> &rExerciseTimes,
+            unsigned iNumberOfExercises, const cfl::Black::Data &rData,
+            unsigned long iPaths, unsigned long iSeed)
+{
+  PRECONDITION (rData.initialTime < rExerciseTimes.front ());
+  PRECONDITION (std::is_sorted (rExerciseTimes.begin (), rExerciseTimes.end (),
+                                std::less_equal<double> ()));
+
+  std::vector<double> uEventTimes (rExerciseTimes.size () + 1);
+  uEventTimes.front () = rData.initialTime;
+  copy (rExerciseTimes.begin (), rExerciseTimes.end (),
+        uEventTimes.begin () + 1);
+  MonteCarlo::PathModel uModel = MonteCarlo::black (rData, uEventTimes);
+
+  // the payoff of one exercise divided by the numeraire
+  MonteCarlo::TPathFunction uExercise
+      = [dStrike] (const MonteCarlo::Paths &rPaths,
+                   unsigned iTime) -> std::valarray<double> {
+    return (rPaths.spot (iTime) - dStrike) / rPaths.numeraire (iTime);
+  };
+  // the regressor is the spot price in units of the strike
+  MonteCarlo::TPathFunction uState
+      = [dStrike] (const MonteCarlo::Paths &rPaths,
+                   unsigned iTime) -> std::valarray<double> {
+    return rPaths.spot (iTime) / dStrike;
+  };
+  std::vector<Function> uBasis
+      = { Function (1.), Function ([] (double dX) { return dX; }),
+          Function ([] (double dX) { return dX * dX; }) };
+
+  // the regressions for all numbers of the remaining exercises
+  MonteCarlo::Boundary uBoundary
+      = MonteCarlo::boundary (uModel, uExercise, uState, uBasis, iPaths,
+                              iNumberOfExercises, iSeed);
+  // the price is computed with the new paths
+  MonteCarlo::TPayoff uPayoff = MonteCarlo::american (uExercise, uBoundary);
+  return MonteCarlo::price (uModel, uPayoff, iPaths, iSeed + 1);
+}
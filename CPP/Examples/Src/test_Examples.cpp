@@ -1,6 +1,13 @@
 #include "Examples/Examples.hpp"
 #include "Examples/Output.hpp"
+#include "cfl/Adjoint.hpp"
+#include "cfl/Analytic.hpp"
+#include "cfl/Bootstrap.hpp"
+#include "cfl/Calibration.hpp"
 #include "cfl/Data.hpp"
+#include "cfl/Dual.hpp"
+#include "cfl/LocalVolModel.hpp"
+#include "cfl/RootSolver.hpp"
 #include "test/Black.hpp"
 #include "test/Data.hpp"
 #include "test/HullWhite.hpp"
@@ -315,6 +322,70 @@ callsImplVol ()
          true);
 }
 
+void
+smileImplVol ()
+{
+  test::print ("IMPLIED VOLATILITIES OF A SMILE WITH REUSABLE ROOT SOLVERS");
+
+  double dDF = 0.9;
+  double dF = 100;
+  double dT = 0.75;
+  double dErr = 1E-12;
+  unsigned iStrikes = 9;
+
+  print (dDF, "discount factor");
+  print (dF, "forward price");
+  print (dT, "maturity");
+  print (dErr, "error for volatility", true);
+
+  // the volatility is quadratic in the moneyness
+  std::valarray<double> uStrike (iStrikes), uSigma (iStrikes),
+      uPrice (iStrikes);
+  for (unsigned i = 0; i < iStrikes; i++)
+    {
+      uStrike[i] = dF * (0.8 + 0.05 * i);
+      double dM = uStrike[i] / dF - 1.;
+      uSigma[i] = 0.2 + 0.5 * dM * dM;
+      uPrice[i] = prb::callBlack (uStrike[i], dT, dDF, dF, uSigma[i]);
+    }
+  test::print (begin (uStrike), end (uStrike), "strikes");
+  test::print (begin (uSigma), end (uSigma), "volatilities");
+
+  // every search starts from the previous solution
+  cfl::Brent uBrent (dErr, dErr);
+  cfl::Newton uNewton (dErr, dErr);
+  std::valarray<double> uBrentSigma (iStrikes), uNewtonSigma (iStrikes);
+  double dBrentSigma = 0.2;
+  double dNewtonSigma = 0.2;
+  for (unsigned i = 0; i < iStrikes; i++)
+    {
+      double dK = uStrike[i];
+      double dC = uPrice[i];
+      auto uF = [dK, dT, dDF, dF, dC] (double dSigma) {
+        return prb::callBlack (dK, dT, dDF, dF, dSigma) - dC;
+      };
+      auto uFD = [dK, dT, dDF, dF, dC] (double dSigma) {
+        return std::make_pair (prb::callBlack (dK, dT, dDF, dF, dSigma) - dC,
+                               prb::callVegaBlack (dK, dT, dDF, dF, dSigma));
+      };
+      dBrentSigma = uBrent.findNear (uF, dBrentSigma, 0.05);
+      dNewtonSigma = uNewton.find (uFD, dNewtonSigma, 0.01, 1.);
+      uBrentSigma[i] = dBrentSigma;
+      uNewtonSigma[i] = dNewtonSigma;
+    }
+  std::valarray<double> uBatchSigma = cfl::NAnalytic::impliedVol (
+      uStrike, std::valarray<double> (dT, iStrikes),
+      std::valarray<double> (dDF, iStrikes),
+      std::valarray<double> (dF, iStrikes), uPrice);
+
+  test::compare (uSigma, uBrentSigma,
+                 "Exact volatilities versus Brent method with warm starts:");
+  test::compare (uSigma, uNewtonSigma,
+                 "Exact volatilities versus safeguarded Newton method:");
+  test::compare (uSigma, uBatchSigma,
+                 "Exact volatilities versus batch implied volatilities:");
+}
+
 // INTERPOLATION OF DATA CURVES
 
 void
@@ -455,6 +526,231 @@ discountVasicekFit ()
   test::Data::print (c_sDF, uDiscount, uErr, dInitialTime, dInterval);
 }
 
+// the yields of the discount factors rDF with maturities rTimes
+std::vector<double>
+yields (const std::vector<double> &rTimes, const std::vector<double> &rDF,
+        double dInitialTime)
+{
+  std::vector<double> uYields (rTimes.size ());
+  std::transform (rTimes.begin (), rTimes.end (), rDF.begin (),
+                  uYields.begin (), [dInitialTime] (double dT, double dDF) {
+                    return -std::log (dDF) / (dT - dInitialTime);
+                  });
+  return uYields;
+}
+
+// the linear fit with the factors of Nelson-Siegel family
+cfl::Fit
+nelsonSiegelLinearFit (double dLambda, double dInitialTime)
+{
+  std::vector<Function> uF = { Function (1., dInitialTime),
+                               prb::yieldShape1 (dLambda, dInitialTime),
+                               prb::yieldShape2 (dLambda, dInitialTime) };
+  return cfl::NFit::linear (uF);
+}
+
+void
+nelsonSiegelYieldFit ()
+{
+  test::print ("NELSON-SIEGEL FIT OF YIELD CURVE WITH FITTED DECAY RATE");
+
+  double dInitialTime = 1.;
+  auto uDF = test::Data::getDiscount (dInitialTime);
+  std::vector<double> uYields
+      = yields (uDF.first, uDF.second, dInitialTime);
+
+  cfl::Fit uFit = cfl::NFit::nelsonSiegel (dInitialTime);
+  uFit.assign (uDF.first.begin (), uDF.first.end (), uYields.begin ());
+  FitParam uParam = uFit.param ();
+  double dLambda = uParam.fit[3];
+  test::Data::printFit (uParam);
+
+  // the yields are given by Nelson-Siegel family with the decay
+  // rate 0.22
+  std::valarray<double> uExact = { 0., 0.07, 0., 0.22 };
+  test::compare (uExact, uParam.fit,
+                 "Exact versus fitted coefficients and decay rate:");
+
+  cfl::Fit uLinear = nelsonSiegelLinearFit (dLambda, dInitialTime);
+  uLinear.assign (uDF.first.begin (), uDF.first.end (), uYields.begin ());
+  test::compare (uLinear.param ().fit,
+                 std::valarray<double> (uParam.fit[std::slice (0, 3, 1)]),
+                 "Linear fit with the fitted decay rate versus Nelson-Siegel "
+                 "fit:");
+}
+
+void
+incrementalYieldFit ()
+{
+  test::print ("INCREMENTAL LEAST-SQUARES FIT OF YIELD CURVE");
+
+  double dLambda = 0.05;
+  double dInitialTime = 1.;
+
+  print (dLambda, "lambda");
+  auto uDF = test::Data::getDiscount (dInitialTime);
+  std::vector<double> uYields
+      = yields (uDF.first, uDF.second, dInitialTime);
+  unsigned iHalf = uYields.size () / 2;
+
+  // the second half of the nodes is added one by one
+  cfl::Fit uFit = nelsonSiegelLinearFit (dLambda, dInitialTime);
+  uFit.assign (uDF.first.begin (), uDF.first.begin () + iHalf,
+               uYields.begin ());
+  for (unsigned i = iHalf; i < uYields.size (); i++)
+    {
+      uFit.update (uDF.first[i], uYields[i]);
+    }
+  cfl::Fit uAll = nelsonSiegelLinearFit (dLambda, dInitialTime);
+  uAll.assign (uDF.first.begin (), uDF.first.end (), uYields.begin ());
+  test::compare (uAll.param ().fit, uFit.param ().fit,
+                 "Fit of all nodes versus updates of the fit of the first "
+                 "half:");
+
+  // the last node is removed
+  uFit.remove (uDF.first.back (), uYields.back ());
+  uAll.assign (uDF.first.begin (), uDF.first.end () - 1, uYields.begin ());
+  test::compare (uAll.param ().fit, uFit.param ().fit,
+                 "Fit without the last node versus its removal:");
+}
+
+void
+batchYieldFit ()
+{
+  test::print ("BATCH LEAST-SQUARES FIT OF YIELD CURVES");
+
+  double dLambda = 0.05;
+  double dInitialTime = 1.;
+  unsigned iDates = 3;
+  double dShift = 0.01;
+
+  print (dLambda, "lambda");
+  print (iDates, "number of dates");
+  print (dShift, "shift of yields between dates", true);
+  auto uDF = test::Data::getDiscount (dInitialTime);
+  std::vector<double> uYields
+      = yields (uDF.first, uDF.second, dInitialTime);
+
+  // the yield curve is shifted in parallel from date to date
+  std::vector<double> uDate, uArg, uVal;
+  for (unsigned iD = 0; iD < iDates; iD++)
+    {
+      for (unsigned i = 0; i < uYields.size (); i++)
+        {
+          uDate.push_back (iD);
+          uArg.push_back (uDF.first[i]);
+          uVal.push_back (uYields[i] + iD * dShift);
+        }
+    }
+  std::vector<double> uWt (uVal.size (), 1.);
+
+  cfl::Fit uFit = nelsonSiegelLinearFit (dLambda, dInitialTime);
+  FitBatch uBatch = uFit.batch (uDate, uArg, uVal, uWt);
+
+  std::valarray<double> uFits (uBatch.fit.size ());
+  for (unsigned iD = 0; iD < iDates; iD++)
+    {
+      std::vector<double>::const_iterator itVal
+          = uVal.begin () + iD * uYields.size ();
+      uFit.assign (uDF.first.begin (), uDF.first.end (), itVal);
+      uFits[std::slice (iD * uBatch.size, uBatch.size, 1)]
+          = uFit.param ().fit;
+    }
+  test::compare (uFits, uBatch.fit,
+                 "Separate fits versus batch fit of the coefficients:");
+}
+
+void
+bsplineFit ()
+{
+  test::print ("LEAST-SQUARES FIT OF CUBIC POLYNOMIAL WITH BASIS SPLINES");
+
+  unsigned iOrder = 4;
+  unsigned iBreakpoints = 5;
+  unsigned iNodes = 25;
+  double dL = 0.;
+  double dR = 1.;
+
+  print (iOrder, "order of splines");
+  print (iBreakpoints, "number of breakpoints");
+  print (iNodes, "number of nodes", true);
+
+  Function uPolynomial (
+      [] (double dX) { return 1. + dX * (1. - dX * (2. - 0.5 * dX)); });
+  std::valarray<double> uNodes = test::getArg (dL, dR, iNodes);
+  std::valarray<double> uValues = test::getValues (uPolynomial, uNodes);
+
+  cfl::Fit uFit = cfl::NFit::bspline (iOrder, dL, dR, iBreakpoints);
+  uFit.assign (begin (uNodes), end (uNodes), begin (uValues));
+
+  // the cubic polynomial is fitted exactly
+  std::valarray<double> uArg = test::getArg (dL, dR, test::c_iPoints);
+  std::vector<double> uGrid (begin (uArg), end (uArg));
+  test::compare (test::getValues (uPolynomial, uArg), uFit.fit (uGrid),
+                 "Cubic polynomial versus its fit with basis splines:");
+}
+
+// BOOTSTRAP OF DISCOUNT CURVES
+
+void
+bootstrapDiscount ()
+{
+  test::print ("BOOTSTRAP OF DISCOUNT CURVE FROM DEPOSIT AND SWAP RATES");
+
+  double dInitialTime = 1.;
+  double dPeriod = 0.5;
+  unsigned iSwaps = 10;
+
+  print (dInitialTime, "initial time");
+  print (dPeriod, "period between payments");
+  print (iSwaps, "number of instruments", true);
+
+  // the deposit and the swaps are priced at par by the discount
+  // curve; their maturities are the payment times
+  Function uDiscount = test::Data::getDiscountCurve (dInitialTime);
+  std::vector<double> uTimes (iSwaps), uDF (iSwaps), uRates (iSwaps);
+  cfl::Bootstrap uLogLin (dInitialTime, false);
+  cfl::Bootstrap uConvex (dInitialTime, true);
+  double dAnnuity = 0.;
+  for (unsigned i = 0; i < iSwaps; i++)
+    {
+      uTimes[i] = dInitialTime + (i + 1) * dPeriod;
+      uDF[i] = uDiscount (uTimes[i]);
+      dAnnuity += dPeriod * uDF[i];
+      uRates[i] = (1. - uDF[i]) / dAnnuity;
+      if (i == 0)
+        {
+          uLogLin.addDeposit (uTimes[i]);
+          uConvex.addDeposit (uTimes[i]);
+        }
+      else
+        {
+          uLogLin.addSwap (dPeriod, i + 1);
+          uConvex.addSwap (dPeriod, i + 1);
+        }
+    }
+  test::print (uRates.begin (), uRates.end (), "deposit and swap rates");
+
+  Function uConvexDiscount = uConvex.discount (uRates);
+  std::valarray<double> uPillars (uTimes.data (), uTimes.size ());
+  test::compare (std::valarray<double> (uDF.data (), uDF.size ()),
+                 test::getValues (uConvexDiscount, uPillars),
+                 "Discount factors versus monotone convex bootstrap at the "
+                 "maturities:");
+
+  std::valarray<double> uArg
+      = test::getArg (dInitialTime, uTimes.back (), test::c_iPoints);
+  Function uLogLinInterp
+      = prb::discountLogLinInterp (uTimes, uDF, dInitialTime);
+  test::compare (test::getValues (uLogLinInterp, uArg),
+                 test::getValues (uLogLin.discount (uRates), uArg),
+                 "Log-linear interpolation of discount factors versus "
+                 "log-linear bootstrap:");
+  test::compare (test::getValues (uDiscount, uArg),
+                 test::getValues (uConvexDiscount, uArg),
+                 "Discount curve versus monotone convex bootstrap:");
+}
+
 // OPTIONS ON A SINGLE STOCK IN BLACK MODEL
 
 MultiFunction
@@ -577,6 +873,305 @@ fxCrossCurrencyCap (AssetModel &rModel)
   return prb::fxCrossCurrencyCap (uCap, rModel);
 }
 
+// OPTIONS ON A SINGLE STOCK IN LOCAL VOLATILITY MODEL
+
+void
+localVolAmericanPut ()
+{
+  test::print ("AMERICAN PUT OPTION IN LOCAL VOLATILITY AND BLACK MODELS");
+
+  double dTimeQuality = 100;
+  cfl::Black::Data uData = test::Black::data (
+      "PARAMETERS OF BLACK MODEL:", test::c_dYield, test::c_dSpot,
+      test::c_dDividendYield, test::Black::c_dSigma, 0.);
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality");
+  print (dTimeQuality, "time quality", true);
+  AssetModel uBlack = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+  // the local volatility is constant
+  cfl::LocalVol::Data uLocalData = cfl::LocalVol::makeData (
+      uData.discount, uData.forward, Function (test::Black::c_dSigma),
+      uData.initialTime);
+  AssetModel uLocalVol = cfl::LocalVol::model (
+      uLocalData, test::c_dInterval, test::Black::c_dStepQuality,
+      test::Black::c_dWidthQuality, dTimeQuality);
+
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  print (dStrike, "strike", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  Function uExact = toFunction (
+      prb::americanPut (dStrike, uExerciseTimes, uBlack));
+  Function uLocal = toFunction (
+      prb::americanPut (dStrike, uExerciseTimes, uLocalVol));
+  test::compare (uExact, uLocal, test::c_dInterval, test::c_iPoints,
+                 "Black model versus local volatility model:");
+}
+
+// TWO-DIMENSIONAL BROWNIAN MODEL
+
+void
+brownian2Sum ()
+{
+  test::print ("CALL ON THE SUM OF TWO CORRELATED BROWNIAN MOTIONS");
+
+  double dSigma1 = 0.2;
+  double dSigma2 = 0.3;
+  double dCorrelation = -0.5;
+  double dMaturity = 1.;
+  double dStrike = 0.1;
+  double dInterval = 0.2;
+  print (dSigma1, "volatility of the first motion");
+  print (dSigma2, "volatility of the second motion");
+  print (dCorrelation, "correlation");
+  print (dMaturity, "maturity");
+  print (dStrike, "strike");
+  print (dInterval, "interval of initial values");
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+
+  std::vector<double> uEventTimes = { c_dInitialTime,
+                                      c_dInitialTime + dMaturity };
+  cfl::Model uTwo = cfl::brownian2 (test::Black::c_dStepQuality,
+                                    test::Black::c_dWidthQuality) (
+      std::vector<double> (2, dSigma1 * dSigma1),
+      std::vector<double> (2, dSigma2 * dSigma2), dCorrelation, uEventTimes,
+      std::valarray<double> (dInterval, 2));
+  Slice uTwoCall = max (uTwo.state (1, 0) + uTwo.state (1, 1) - dStrike, 0.);
+  uTwoCall.rollback (0);
+  MultiFunction uTwoF = interpolate (uTwoCall);
+
+  // the sum is the Brownian motion with the variance
+  double dVar = dSigma1 * dSigma1 + dSigma2 * dSigma2
+                + 2. * dCorrelation * dSigma1 * dSigma2;
+  cfl::Model uOne = cfl::brownian (test::Black::c_dStepQuality,
+                                   test::Black::c_dWidthQuality) (
+      std::vector<double> (2, dVar), uEventTimes, 2. * dInterval);
+  Slice uOneCall = max (uOne.state (1, 0) - dStrike, 0.);
+  uOneCall.rollback (0);
+
+  // the initial values of the motions are equal
+  Function uExact = toFunction (interpolate (uOneCall));
+  Function uApprox ([uTwoF] (double dX) {
+    return uTwoF (std::valarray<double> (0.5 * dX, 2))[0];
+  });
+  test::compare (uExact, uApprox, dInterval, test::c_iPoints,
+                 "One-dimensional model for the sum versus two-dimensional "
+                 "model:");
+}
+
+// EXERCISE REGIONS OF OPTIONS ON A SINGLE STOCK
+
+void
+exerciseAmericanPut ()
+{
+  test::print ("RECORD AND REPLAY OF EXERCISE REGION OF AMERICAN PUT");
+
+  AssetModel uModel = test::Black::model ();
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  print (dStrike, "strike", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  cfl::Exercise uExercise;
+  Function uRecord = toFunction (
+      prb::americanPut (dStrike, uExerciseTimes, uModel, uExercise));
+  uExercise.replay ();
+  Function uReplay = toFunction (
+      prb::americanPut (dStrike, uExerciseTimes, uModel, uExercise));
+  test::compare (uRecord, uReplay, test::c_dInterval, test::c_iPoints,
+                 "Recorded versus replayed exercise region:");
+}
+
+// the american put in Black model rModel with the data rData
+// recorded on rTape; the spot prices depend on the forward curve and
+// on the total variance of the state
+cfl::TapeSlice
+tapeAmericanPut (double dStrike, const std::vector<double> &rExerciseTimes,
+                 const cfl::Black::Data &rData, AssetModel &rModel,
+                 cfl::Tape &rTape)
+{
+  std::vector<double> uEventTimes (1, rModel.initialTime ());
+  uEventTimes.insert (uEventTimes.end (), rExerciseTimes.begin (),
+                      rExerciseTimes.end ());
+  rModel.assignEventTimes (uEventTimes);
+
+  int iTime = uEventTimes.size () - 1;
+  cfl::TapeSlice uOption = rTape.input (rModel.cash (iTime, 0.));
+  while (iTime > 0)
+    {
+      double dTime = uEventTimes[iTime];
+      cfl::TapeSlice uSpot = rTape.forward (rModel.spot (iTime), dTime,
+                                            rData.shape (dTime));
+      uOption = max (uOption, dStrike - uSpot);
+      iTime--;
+      uOption.rollback (iTime);
+    }
+  return uOption;
+}
+
+// the price of the american put at the origin
+double
+americanPutPrice (double dStrike, const std::vector<double> &rExerciseTimes,
+                  double dYield, double dSpot, double dSigma)
+{
+  cfl::Function uDiscount = cfl::Data::discount (dYield, c_dInitialTime);
+  cfl::Function uForward = cfl::Data::forward (
+      dSpot, c_dDividendYield, uDiscount, c_dInitialTime);
+  cfl::Black::Data uData = cfl::Black::makeData (
+      uDiscount, uForward, dSigma, test::Black::c_dLambda, c_dInitialTime);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+  cfl::Tape uTape;
+  cfl::TapeSlice uPut
+      = tapeAmericanPut (dStrike, rExerciseTimes, uData, uModel, uTape);
+  return atOrigin (uPut.value ())[0];
+}
+
+void
+adjointAmericanPut ()
+{
+  test::print ("SENSITIVITIES OF AMERICAN PUT BY ADJOINT METHOD");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  print (dStrike, "strike", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+  // the rollback of Black model discounts and is gaussian
+  cfl::Tape uTape (true, true);
+  cfl::TapeSlice uPut
+      = tapeAmericanPut (dStrike, uExerciseTimes, uData, uModel, uTape);
+  uTape.backward (uPut);
+
+  double dT0 = c_dInitialTime;
+  double dSigma = test::Black::c_dSigma;
+  cfl::Function uTime ([dT0] (double dT) { return dT - dT0; });
+  // Sigma(t) is proportional to the square of sigma
+  cfl::Function uVar ([dT0, dSigma, &uData] (double dT) {
+    return 2. * std::pow (uData.volatility (dT), 2) * (dT - dT0) / dSigma;
+  });
+  std::valarray<double> uAdjoint{
+    uTape.forwardSensitivity (cfl::Function (1.)) / test::c_dSpot,
+    uTape.forwardSensitivity (uTime) - uTape.discountSensitivity (uTime),
+    uTape.varianceSensitivity (uVar)
+  };
+
+  // the central differences of the prices
+  const double c_dBump = 1e-4;
+  std::valarray<double> uBump (3);
+  double dSpot = test::c_dSpot * c_dBump;
+  uBump[0] = (americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                test::c_dSpot + dSpot, dSigma)
+              - americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                  test::c_dSpot - dSpot, dSigma))
+             / (2. * dSpot);
+  uBump[1] = (americanPutPrice (dStrike, uExerciseTimes,
+                                test::c_dYield + c_dBump, test::c_dSpot,
+                                dSigma)
+              - americanPutPrice (dStrike, uExerciseTimes,
+                                  test::c_dYield - c_dBump, test::c_dSpot,
+                                  dSigma))
+             / (2. * c_dBump);
+  uBump[2] = (americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                test::c_dSpot, dSigma + c_dBump)
+              - americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                  test::c_dSpot, dSigma - c_dBump))
+             / (2. * c_dBump);
+
+  print (atOrigin (uPut.value ())[0], "price", true);
+  test::print ("Delta, rho and vega: bumped prices versus adjoint method:");
+  test::compare (uBump, uAdjoint, "sensitivities");
+}
+
+// SENSITIVITIES BY DUAL NUMBERS
+
+// the american put with the derivatives with respect to the strike
+// and to the common factor of the spot prices; the spot prices in
+// Black model are proportional to the initial spot price
+cfl::DualSlice
+dualSliceAmericanPut (double dStrike,
+                      const std::vector<double> &rExerciseTimes,
+                      AssetModel &rModel)
+{
+  std::vector<double> uEventTimes (1, rModel.initialTime ());
+  uEventTimes.insert (uEventTimes.end (), rExerciseTimes.begin (),
+                      rExerciseTimes.end ());
+  rModel.assignEventTimes (uEventTimes);
+
+  cfl::Dual uStrike (dStrike, 2, 0);
+  cfl::Dual uFactor (1., 2, 1);
+  int iTime = uEventTimes.size () - 1;
+  cfl::DualSlice uOption (rModel.cash (iTime, 0.));
+  while (iTime > 0)
+    {
+      cfl::DualSlice uSpot (rModel.spot (iTime));
+      uOption = max (uOption, uStrike - uFactor * uSpot);
+      iTime--;
+      uOption.rollback (iTime);
+    }
+  return uOption;
+}
+
+void
+dualAmericanPut ()
+{
+  test::print ("SENSITIVITIES OF AMERICAN PUT BY DUAL NUMBERS");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  print (dStrike, "strike", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+  std::valarray<double> uPut = atOrigin (
+      dualSliceAmericanPut (dStrike, uExerciseTimes, uModel));
+  std::valarray<double> uDual = { uPut[1], uPut[2] / test::c_dSpot };
+
+  // the central differences of the prices
+  const double c_dBump = 1e-4;
+  double dSigma = test::Black::c_dSigma;
+  double dStrikeBump = dStrike * c_dBump;
+  double dSpotBump = test::c_dSpot * c_dBump;
+  std::valarray<double> uBump (2);
+  uBump[0] = (americanPutPrice (dStrike + dStrikeBump, uExerciseTimes,
+                                test::c_dYield, test::c_dSpot, dSigma)
+              - americanPutPrice (dStrike - dStrikeBump, uExerciseTimes,
+                                  test::c_dYield, test::c_dSpot, dSigma))
+             / (2. * dStrikeBump);
+  uBump[1] = (americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                test::c_dSpot + dSpotBump, dSigma)
+              - americanPutPrice (dStrike, uExerciseTimes, test::c_dYield,
+                                  test::c_dSpot - dSpotBump, dSigma))
+             / (2. * dSpotBump);
+
+  print (uPut[0], "price", true);
+  test::print ("Derivatives in strike and delta: bumped prices versus dual "
+               "numbers:");
+  test::compare (uBump, uDual, "sensitivities");
+}
+
 // INTEREST RATE OPTIONS IN HULL-WHITE MODEL
 
 cfl::MultiFunction
@@ -698,6 +1293,385 @@ autoCap (InterestRateModel &rModel)
   return prb::autoCap (uCap, iNumberOfCaplets, rModel);
 }
 
+// CALIBRATION OF MODELS TO PRICES OF OPTIONS
+
+// the step quality of the lattice of Hull-White model for the
+// comparison with the closed-form and Monte Carlo prices; the
+// lattice with the standard step quality is not accurate for the
+// options at the money
+const double c_dHullWhiteStepQuality = 4000;
+
+void
+calibrationBlack ()
+{
+  test::print ("CALIBRATION OF BLACK MODEL TO PRICES OF PUT OPTIONS");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+
+  std::vector<double> uStrikes
+      = { 0.9 * test::c_dSpot, test::c_dSpot, 1.1 * test::c_dSpot };
+  std::vector<double> uMaturities = test::getTimes (c_dInitialTime, c_dInitialTime + 2., 4);
+  test::print (uStrikes.begin (), uStrikes.end (), "strikes");
+  test::print (uMaturities.begin (), uMaturities.end (), "maturities");
+
+  // the market prices are computed on the lattice
+  cfl::Black::Basket uBasket (uData.discount, uData.forward,
+                              uData.initialTime);
+  std::vector<double> uQuotes;
+  for (double dMaturity : uMaturities)
+    {
+      for (double dStrike : uStrikes)
+        {
+          uQuotes.push_back (
+              toFunction (prb::put (dStrike, dMaturity, uModel)) (0.));
+          uBasket.addOption (dStrike, dMaturity, false, uQuotes.back ());
+        }
+    }
+  test::compare (std::valarray<double> (uQuotes.data (), uQuotes.size ()),
+                 uBasket.price (uData),
+                 "Lattice versus Black formula for the prices of puts:");
+
+  double dKappa = 2. * test::Black::c_dSigma;
+  double dLambda = 2. * test::Black::c_dLambda;
+  print (dKappa, "initial guess for volatility");
+  print (dLambda, "initial guess for mean-reversion rate", true);
+  uBasket.calibrate (dKappa, dLambda);
+  test::compare (
+      std::valarray<double>{ test::Black::c_dSigma, test::Black::c_dLambda },
+      std::valarray<double>{ dKappa, dLambda },
+      "Exact versus calibrated volatility and mean-reversion rate:");
+}
+
+void
+calibrationHullWhite ()
+{
+  test::print ("CALIBRATION OF HULL-WHITE MODEL TO CAPS AND SWAPTIONS");
+
+  cfl::HullWhite::Data uData = test::HullWhite::data ();
+  print (c_dHullWhiteStepQuality, "step quality");
+  print (test::HullWhite::c_dWidthQuality, "width quality", true);
+  InterestRateModel uModel = cfl::HullWhite::model (
+      uData, test::c_dInterval, c_dHullWhiteStepQuality,
+      test::HullWhite::c_dWidthQuality);
+
+  cfl::Data::CashFlow uCap = test::swapParameters ();
+  cfl::Data::Swap uSwap = test::swapParameters ();
+  std::vector<double> uCapRates
+      = { 0.9 * test::c_dYield, test::c_dYield, 1.1 * test::c_dYield };
+  std::vector<double> uMaturities = test::getTimes (c_dInitialTime, c_dInitialTime + 2., 4);
+  test::printSwap (uSwap, "swap parameters");
+  test::print (uCapRates.begin (), uCapRates.end (), "cap rates");
+  test::print (uMaturities.begin (), uMaturities.end (),
+               "maturities of swaptions");
+
+  // the market prices are computed on the lattice
+  cfl::HullWhite::Basket uBasket (uData.discount, uData.initialTime);
+  std::vector<double> uQuotes;
+  for (double dRate : uCapRates)
+    {
+      uCap.rate = dRate;
+      uQuotes.push_back (toFunction (prb::cap (uCap, uModel)) (0.));
+      uBasket.addCap (uCap, uQuotes.back ());
+    }
+  for (double dMaturity : uMaturities)
+    {
+      uQuotes.push_back (
+          toFunction (prb::swaption (uSwap, dMaturity, uModel)) (0.));
+      uBasket.addSwaption (uSwap, dMaturity, uQuotes.back ());
+    }
+  test::compare (std::valarray<double> (uQuotes.data (), uQuotes.size ()),
+                 uBasket.price (uData),
+                 "Lattice versus closed-form prices of caps and swaptions:");
+
+  double dSigma = 2. * test::HullWhite::c_dSigma;
+  double dLambda = 2. * test::HullWhite::c_dLambda;
+  print (dSigma, "initial guess for volatility");
+  print (dLambda, "initial guess for mean-reversion rate", true);
+  uBasket.calibrate (dSigma, dLambda);
+  test::compare (
+      std::valarray<double>{ test::HullWhite::c_dSigma,
+                             test::HullWhite::c_dLambda },
+      std::valarray<double>{ dSigma, dLambda },
+      "Exact versus calibrated volatility and mean-reversion rate:");
+}
+
+// OPTIONS WITH EARLY EXERCISE BY LEAST-SQUARES MONTE CARLO
+
+const unsigned c_iMonteCarloPaths = 1u << 16;
+
+// prints the prices of the option on the lattice and by Monte Carlo
+void
+compareMonteCarlo (double dLattice, const std::valarray<double> &rMonteCarlo)
+{
+  test::compare (std::valarray<double> (dLattice, 1),
+                 std::valarray<double> (rMonteCarlo[0], 1),
+                 "Lattice versus Monte Carlo price at the initial time:");
+  print (rMonteCarlo[1], "standard error of Monte Carlo price", true);
+}
+
+void
+monteCarloAmericanPut ()
+{
+  test::print ("AMERICAN PUT OPTION BY LEAST-SQUARES MONTE CARLO");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  print (dStrike, "strike");
+  print (c_iMonteCarloPaths, "number of paths", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  double dLattice = toFunction (
+      prb::americanPut (dStrike, uExerciseTimes, uModel)) (0.);
+  compareMonteCarlo (dLattice,
+                     prb::americanPut (dStrike, uExerciseTimes, uData,
+                                       c_iMonteCarloPaths));
+}
+
+void
+monteCarloSwing ()
+{
+  test::print ("SWING OPTION BY LEAST-SQUARES MONTE CARLO");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+
+  double dStrike = test::c_dSpot;
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  unsigned iNumberOfExercises = uExerciseTimes.size () / 3;
+  print (dStrike, "strike");
+  print (iNumberOfExercises, "maximal number of exercises");
+  print (c_iMonteCarloPaths, "number of paths", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  double dLattice = toFunction (prb::swing (dStrike, uExerciseTimes,
+                                            iNumberOfExercises, uModel)) (0.);
+  compareMonteCarlo (dLattice,
+                     prb::swing (dStrike, uExerciseTimes, iNumberOfExercises,
+                                 uData, c_iMonteCarloPaths));
+}
+
+// the price of the american swaption at the origin of the lattice
+double
+latticeAmericanSwaption (const cfl::Data::Swap &rSwap,
+                         const std::vector<double> &rExerciseTimes,
+                         InterestRateModel &rModel)
+{
+  std::vector<double> uEventTimes (1, rModel.initialTime ());
+  uEventTimes.insert (uEventTimes.end (), rExerciseTimes.begin (),
+                      rExerciseTimes.end ());
+  rModel.assignEventTimes (uEventTimes);
+
+  int iTime = uEventTimes.size () - 1;
+  Slice uOption = rModel.cash (iTime, 0.);
+  while (iTime > 0)
+    {
+      double dTime = uEventTimes[iTime];
+      Slice uFixed = rModel.cash (iTime, 0.);
+      for (unsigned iI = 1; iI <= rSwap.numberOfPayments; iI++)
+        {
+          uFixed += rModel.discount (iTime, dTime + iI * rSwap.period);
+        }
+      double dMaturity = dTime + rSwap.numberOfPayments * rSwap.period;
+      Slice uSwap = rSwap.notional
+                    * (rSwap.rate * rSwap.period * uFixed - 1.
+                       + rModel.discount (iTime, dMaturity));
+      if (!rSwap.payFloat)
+        {
+          uSwap *= -1.;
+        }
+      uOption = max (uOption, uSwap);
+      iTime--;
+      uOption.rollback (iTime);
+    }
+  return atOrigin (uOption)[0];
+}
+
+void
+monteCarloAmericanSwaption ()
+{
+  test::print ("AMERICAN SWAPTION BY LEAST-SQUARES MONTE CARLO");
+
+  cfl::HullWhite::Data uData = test::HullWhite::data ();
+  print (test::HullWhite::c_dStepQuality, "step quality");
+  print (test::HullWhite::c_dWidthQuality, "width quality", true);
+  InterestRateModel uModel = cfl::HullWhite::model (
+      uData, test::c_dInterval, test::HullWhite::c_dStepQuality,
+      test::HullWhite::c_dWidthQuality);
+
+  cfl::Data::Swap uSwap = test::swapParameters ();
+  const std::vector<double> uExerciseTimes = test::exerciseTimes ();
+  test::printSwap (uSwap, "swap parameters");
+  print (c_iMonteCarloPaths, "number of paths", true);
+  test::print (uExerciseTimes.begin (), uExerciseTimes.end (),
+               "exercise times");
+
+  double dLattice = latticeAmericanSwaption (uSwap, uExerciseTimes, uModel);
+  compareMonteCarlo (dLattice,
+                     prb::americanSwaption (uSwap, uExerciseTimes, uData,
+                                            c_iMonteCarloPaths));
+}
+
+// PRICES BY MONTE CARLO AND QUASI MONTE CARLO
+
+const unsigned c_iReplications = 16;
+
+// prints the prices of the derivative on the lattice, by Monte Carlo
+// and by quasi Monte Carlo with the same total number of paths
+void
+compareQuasiMonteCarlo (double dLattice,
+                        const MonteCarlo::PathModel &rModel,
+                        const MonteCarlo::TPayoff &rPayoff)
+{
+  std::valarray<double> uMC
+      = MonteCarlo::price (rModel, rPayoff, c_iMonteCarloPaths);
+  std::valarray<double> uQMC = MonteCarlo::quasiPrice (
+      rModel, rPayoff, c_iMonteCarloPaths / c_iReplications,
+      c_iReplications);
+  test::compare (std::valarray<double> (dLattice, 2),
+                 std::valarray<double>{ uMC[0], uQMC[0] },
+                 "Lattice versus Monte Carlo and quasi Monte Carlo prices:");
+  print (uMC[1], "standard error of Monte Carlo price");
+  print (uQMC[1], "standard error of quasi Monte Carlo price", true);
+}
+
+void
+quasiMonteCarloPut ()
+{
+  test::print ("PUT OPTION BY MONTE CARLO AND QUASI MONTE CARLO");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+
+  double dStrike = test::c_dSpot;
+  double dMaturity = test::c_dMaturity;
+  print (dStrike, "strike");
+  print (dMaturity, "maturity");
+  print (c_iMonteCarloPaths, "number of paths");
+  print (c_iReplications, "number of replications of Sobol sequence", true);
+
+  MonteCarlo::PathModel uPathModel
+      = MonteCarlo::black (uData, { uData.initialTime, dMaturity });
+  MonteCarlo::TPayoff uPut
+      = [dStrike] (const MonteCarlo::Paths &rPaths) -> std::valarray<double> {
+    std::valarray<double> uPayoff = dStrike - rPaths.spot (1);
+    uPayoff = uPayoff.apply ([] (double dX) { return std::max (dX, 0.); });
+    return uPayoff / rPaths.numeraire (1);
+  };
+
+  double dLattice = toFunction (prb::put (dStrike, dMaturity, uModel)) (0.);
+  compareQuasiMonteCarlo (dLattice, uPathModel, uPut);
+}
+
+void
+quasiMonteCarloForwardOnAverageSpot ()
+{
+  test::print ("FORWARD ON AVERAGE SPOT BY MONTE CARLO AND QUASI MONTE CARLO");
+
+  cfl::Black::Data uData = test::Black::data ();
+  print (test::Black::c_dStepQuality, "step quality");
+  print (test::Black::c_dWidthQuality, "width quality", true);
+  AssetModel uModel = cfl::Black::model (uData, test::c_dInterval,
+                                         test::Black::c_dStepQuality,
+                                         test::Black::c_dWidthQuality);
+
+  const std::vector<double> uAverTimes = test::barrierTimes ();
+  print (c_iMonteCarloPaths, "number of paths");
+  print (c_iReplications, "number of replications of Sobol sequence", true);
+  test::print (uAverTimes.begin (), uAverTimes.end (), "averaging times");
+
+  std::vector<double> uEventTimes (1, uData.initialTime);
+  uEventTimes.insert (uEventTimes.end (), uAverTimes.begin (),
+                      uAverTimes.end ());
+  MonteCarlo::PathModel uPathModel = MonteCarlo::black (uData, uEventTimes);
+  // the average spot price is paid at the last averaging time; its
+  // price is divided by the discount factor for this time
+  double dMaturity = uAverTimes.back ();
+  double dScale = 1. / (uAverTimes.size () * uData.discount (dMaturity));
+  MonteCarlo::TPayoff uAverage
+      = [dScale] (const MonteCarlo::Paths &rPaths) -> std::valarray<double> {
+    unsigned iLast = rPaths.eventTimes ().size () - 1;
+    std::valarray<double> uSum (0., rPaths.size ());
+    for (unsigned iTime = 1; iTime <= iLast; iTime++)
+      {
+        uSum += rPaths.spot (iTime);
+      }
+    return (dScale * uSum) / rPaths.numeraire (iLast);
+  };
+
+  double dLattice
+      = toFunction (prb::forwardOnAverageSpot (uAverTimes, uModel)) (0.);
+  compareQuasiMonteCarlo (dLattice, uPathModel, uAverage);
+}
+
+void
+quasiMonteCarloSwaption ()
+{
+  test::print ("SWAPTION BY MONTE CARLO AND QUASI MONTE CARLO");
+
+  cfl::HullWhite::Data uData = test::HullWhite::data ();
+  print (c_dHullWhiteStepQuality, "step quality");
+  print (test::HullWhite::c_dWidthQuality, "width quality", true);
+  InterestRateModel uModel = cfl::HullWhite::model (
+      uData, test::c_dInterval, c_dHullWhiteStepQuality,
+      test::HullWhite::c_dWidthQuality);
+
+  cfl::Data::Swap uSwap = test::swapParameters ();
+  double dMaturity = test::c_dMaturity;
+  test::printSwap (uSwap, "swap parameters");
+  print (dMaturity, "maturity");
+  print (c_iMonteCarloPaths, "number of paths");
+  print (c_iReplications, "number of replications of Sobol sequence", true);
+
+  MonteCarlo::PathModel uPathModel
+      = MonteCarlo::hullWhite (uData, { uData.initialTime, dMaturity });
+  MonteCarlo::TPayoff uSwaption
+      = [uSwap, dMaturity] (
+            const MonteCarlo::Paths &rPaths) -> std::valarray<double> {
+    std::valarray<double> uFixed (0., rPaths.size ());
+    for (unsigned iI = 1; iI <= uSwap.numberOfPayments; iI++)
+      {
+        uFixed += rPaths.discount (1, dMaturity + iI * uSwap.period);
+      }
+    double dEnd = dMaturity + uSwap.numberOfPayments * uSwap.period;
+    std::valarray<double> uValue
+        = uSwap.notional
+          * (uSwap.rate * uSwap.period * uFixed - 1.
+             + rPaths.discount (1, dEnd));
+    if (!uSwap.payFloat)
+      {
+        uValue *= -1.;
+      }
+    uValue = uValue.apply ([] (double dX) { return std::max (dX, 0.); });
+    return uValue / rPaths.numeraire (1);
+  };
+
+  double dLattice
+      = toFunction (prb::swaption (uSwap, dMaturity, uModel)) (0.);
+  compareQuasiMonteCarlo (dLattice, uPathModel, uSwaption);
+}
+
 std::function<void ()>
 test_Examples ()
 {
@@ -717,6 +1691,7 @@ test_Examples ()
     callImplVolBlack ();
     callImplVolBlack_rootD ();
     callsImplVol ();
+    smileImplVol ();
 
     print ("INTERPOLATION OF DATA CURVES");
 
@@ -730,6 +1705,14 @@ test_Examples ()
     discountConstYieldFit ();
     discountNelsonSiegelFit ();
     discountVasicekFit ();
+    nelsonSiegelYieldFit ();
+    incrementalYieldFit ();
+    batchYieldFit ();
+    bsplineFit ();
+
+    print ("BOOTSTRAP OF DISCOUNT CURVES");
+
+    bootstrapDiscount ();
 
     print ("OPTIONS ON A SINGLE STOCK IN BLACK MODEL");
 
@@ -743,6 +1726,26 @@ test_Examples ()
     test::report (swing, uBlack);
     test::report (fxCrossCurrencyCap, uBlack);
 
+    print ("OPTIONS ON A SINGLE STOCK IN LOCAL VOLATILITY MODEL");
+
+    localVolAmericanPut ();
+
+    print ("TWO-DIMENSIONAL BROWNIAN MODEL");
+
+    brownian2Sum ();
+
+    print ("EXERCISE REGIONS OF OPTIONS ON A SINGLE STOCK");
+
+    exerciseAmericanPut ();
+
+    print ("SENSITIVITIES BY ADJOINT METHOD");
+
+    adjointAmericanPut ();
+
+    print ("SENSITIVITIES BY DUAL NUMBERS");
+
+    dualAmericanPut ();
+
     print ("INTEREST RATE OPTIONS IN HULL-WHITE MODEL");
 
     InterestRateModel uHullWhite = test::HullWhite::model ();
@@ -754,6 +1757,23 @@ test_Examples ()
     test::report (futuresOnRate, uHullWhite);
     test::report (dropLockSwap, uHullWhite);
     test::report (autoCap, uHullWhite);
+
+    print ("CALIBRATION OF MODELS TO PRICES OF OPTIONS");
+
+    calibrationBlack ();
+    calibrationHullWhite ();
+
+    print ("OPTIONS WITH EARLY EXERCISE BY LEAST-SQUARES MONTE CARLO");
+
+    monteCarloAmericanPut ();
+    monteCarloSwing ();
+    monteCarloAmericanSwaption ();
+
+    print ("PRICES BY MONTE CARLO AND QUASI MONTE CARLO");
+
+    quasiMonteCarloPut ();
+    quasiMonteCarloForwardOnAverageSpot ();
+    quasiMonteCarloSwaption ();
   };
 }
 
@@ -14,6 +14,7 @@
 
 #include "cfl/AssetModel.hpp"
 #include "cfl/Data.hpp"
+#include "cfl/Exercise.hpp"
 
 /**
  * @mainpage Homework 4: standard and barrier options on a stock.
@@ -111,6 +112,32 @@ cfl::MultiFunction upInAmericanPut (double dBarrier,
                                     const std::vector<double> &rExerciseTimes,
                                     cfl::AssetModel &rModel);
 
+/**
+ * Computes the value of the <strong>up-and-in American
+ * put</strong> and records or replays the exercise region of the
+ * American put. In the recording mode of \p rExercise the put is
+ * exercised optimally and the exercise region is kept in \p
+ * rExercise. In the replay mode the recorded exercise region is used.
+ *
+ * @param dBarrier The upper barrier.
+ * @param rBarrierTimes The vector of barrier times. The first
+ * time is greater than the initial time.
+ * @param dStrike The strike of the option.
+ * @param rExerciseTimes The vector of exercise times. The first exercise
+ * time is  greater than the initial time.
+ * @param rModel The reference to an implementation of cfl::AssetModel.
+ * @param rExercise The exercise region of the American put.
+ *
+ * @return The price of the option as the function of the initial
+ * values of the state processes in the model.
+ */
+cfl::MultiFunction upInAmericanPut (double dBarrier,
+                                    const std::vector<double> &rBarrierTimes,
+                                    double dStrike,
+                                    const std::vector<double> &rExerciseTimes,
+                                    cfl::AssetModel &rModel,
+                                    cfl::Exercise &rExercise);
+
 /** @} */
 }
 
@@ -7,6 +7,13 @@
 
 cfl::MultiFunction prb::upInAmericanPut(double dBarrier, const std::vector<double> &rBarrierTimes, double dStrike,
                                         const std::vector<double> &rExerciseTimes, cfl::AssetModel &rModel) {
+    cfl::Exercise uExercise;
+    return upInAmericanPut(dBarrier, rBarrierTimes, dStrike, rExerciseTimes, rModel, uExercise);
+}
+
+cfl::MultiFunction prb::upInAmericanPut(double dBarrier, const std::vector<double> &rBarrierTimes, double dStrike,
+                                        const std::vector<double> &rExerciseTimes, cfl::AssetModel &rModel,
+                                        cfl::Exercise &rExercise) {
 
     // check preconditions
             PRECONDITION(dBarrier > 0);
@@ -34,7 +41,7 @@ cfl::MultiFunction prb::upInAmericanPut(double dBarrier, const std::vector<doubl
 
         // if actual time is in exercise times, compute put value
         if (std::find(rExerciseTimes.begin(), rExerciseTimes.end(), dTime) != rExerciseTimes.end()) {
-            uPut = max(uPut, max(dStrike - uSpot, 0.0));
+            uPut = rExercise.max(uPut, max(dStrike - uSpot, 0.0));
         }
 
         // if actual time is in barrier times, compute option value
@@ -13,6 +13,7 @@
  */
 
 #include "cfl/Data.hpp"
+#include "cfl/Exercise.hpp"
 #include "cfl/InterestRateModel.hpp"
 
 /**
@@ -64,6 +65,29 @@ cfl::MultiFunction americanSwaption (const cfl::Data::Swap &rSwap,
                                      const std::vector<double> &rExerciseTimes,
                                      cfl::InterestRateModel &rModel);
 
+/**
+ * Computes the price of <strong>American swaption</strong> and
+ * records or replays its exercise region. In the recording mode of \p
+ * rExercise the option is exercised optimally and the exercise region
+ * is kept in \p rExercise. In the replay mode the recorded exercise
+ * region is used.
+ *
+ * @param rSwap The parameters of the underlying interest rate
+ * swap.
+ * @param rExerciseTimes The set of exercise times. The first
+ * exercise time is strictly greater than the initial time in the
+ * model.
+ * @param rModel The reference to the implementation of cfl::InterestRateModel.
+ * @param rExercise The exercise region of the option.
+ *
+ * @return The price of the option as the function of the initial
+ * values of the state processes in the model.
+ */
+cfl::MultiFunction americanSwaption (const cfl::Data::Swap &rSwap,
+                                     const std::vector<double> &rExerciseTimes,
+                                     cfl::InterestRateModel &rModel,
+                                     cfl::Exercise &rExercise);
+
 /**
  * Computes the price of <strong>puttable and callable coupon
  * bond</strong>.
@@ -8,14 +8,14 @@
 // function to price the swap at given time (iTime)
 cfl::Slice swap(unsigned int iTime, const cfl::Data::Swap &rSwap, cfl::InterestRateModel &rModel) {
 
-    cfl::Slice uFixed = rModel.cash(iTime, 0.0);
+    std::vector<double> uPaymentTimes(rSwap.numberOfPayments);
     double dTime = rModel.eventTimes()[iTime];
 
-    for (int k = 0; k < rSwap.numberOfPayments; k++) {
+    for (double &rT : uPaymentTimes) {
         dTime += rSwap.period;
-        uFixed += rSwap.rate * rSwap.period * rModel.discount(iTime, dTime);
+        rT = dTime;
     }
-    uFixed *= rSwap.notional;
+    cfl::Slice uFixed = rSwap.rate * rSwap.notional * rModel.annuity(iTime, uPaymentTimes);
     cfl::Slice uFloat = (1 - rModel.discount(iTime, dTime)) * rSwap.notional;
 
     // assume first we receive fixed and pay float
@@ -28,6 +28,12 @@ cfl::Slice swap(unsigned int iTime, const cfl::Data::Swap &rSwap, cfl::InterestR
 
 cfl::MultiFunction prb::americanSwaption(const cfl::Data::Swap &rSwap, const std::vector<double> &rExerciseTimes,
                                          cfl::InterestRateModel &rModel) {
+    cfl::Exercise uExercise;
+    return americanSwaption(rSwap, rExerciseTimes, rModel, uExercise);
+}
+
+cfl::MultiFunction prb::americanSwaption(const cfl::Data::Swap &rSwap, const std::vector<double> &rExerciseTimes,
+                                         cfl::InterestRateModel &rModel, cfl::Exercise &rExercise) {
 
     // construct time vector
     std::vector<double> eventTimes(rExerciseTimes.size() + 1);
@@ -42,7 +48,7 @@ cfl::MultiFunction prb::americanSwaption(const cfl::Data::Swap &rSwap, const std
     // price backwards in time
     while (iTime > 0) {
 
-        uOption = max(swap(iTime, rSwap, rModel), uOption);
+        uOption = rExercise.max(uOption, swap(iTime, rSwap, rModel));
         iTime--;
         uOption.rollback(iTime);
     }
@@ -14,6 +14,7 @@
 
 #include "cfl/AssetModel.hpp"
 #include "cfl/Data.hpp"
+#include "cfl/Exercise.hpp"
 
 /**
  * @mainpage Session 4: standard and barrier options on a stock.
@@ -99,6 +100,28 @@ americanButterfly (double dStrike, double dStrikeStep,
                    const std::vector<double> &rExerciseTimes,
                    cfl::AssetModel &rModel);
 
+/**
+ * Computes the value of the <strong>American butterfly
+ * option</strong> and records or replays its exercise region. In the
+ * recording mode of \p rExercise the option is exercised optimally
+ * and the exercise region is kept in \p rExercise. In the replay mode
+ * the recorded exercise region is used.
+ *
+ * @param dStrike The strike in the middle.
+ * @param dStrikeStep The length of the wing.
+ * @param rExerciseTimes The vector of exercise times. The first exercise
+ * time is  greater than the initial time.
+ * @param rModel The reference to an implementation of cfl::AssetModel.
+ * @param rExercise The exercise region of the option.
+ *
+ * @return The price of the option as the function of the initial
+ * values of the state processes in the model.
+ */
+cfl::MultiFunction
+americanButterfly (double dStrike, double dStrikeStep,
+                   const std::vector<double> &rExerciseTimes,
+                   cfl::AssetModel &rModel, cfl::Exercise &rExercise);
+
 /**
  * Computes the value of the <strong>"corridor" option</strong>.
  * The last barrier time is the maturity of the option.  The payoff of
@@ -6,6 +6,12 @@
 
 cfl::MultiFunction prb::americanButterfly(double dStrike, double dStrikeStep, const std::vector<double> &rExerciseTimes,
                                           cfl::AssetModel &rModel) {
+    cfl::Exercise uExercise;
+    return americanButterfly(dStrike, dStrikeStep, rExerciseTimes, rModel, uExercise);
+}
+
+cfl::MultiFunction prb::americanButterfly(double dStrike, double dStrikeStep, const std::vector<double> &rExerciseTimes,
+                                          cfl::AssetModel &rModel, cfl::Exercise &rExercise) {
 
     // CHECK PRECONDITIONS
             PRECONDITION(std::is_sorted(rExerciseTimes.begin(), rExerciseTimes.end()));
@@ -32,7 +38,7 @@ cfl::MultiFunction prb::americanButterfly(double dStrike, double dStrikeStep, co
                      - 2 * max(uSpot - dStrike, 0.0)
                      + max(uSpot - (dStrike - dStrikeStep), 0.0);
 
-        uOption = max(uOption, uButterFly); // update option value
+        uOption = rExercise.max(uOption, uButterFly); // update option value
         iTime--;
         uOption.rollback(iTime); // roll back to previous time
     }
@@ -61,14 +61,14 @@ prb::putOnFRA(double dFixedRate, double dPeriod, double dNotional, double dMatur
 cfl::Slice swapRate(unsigned int iTime, double dPeriod,
                     unsigned int iSwapPayments, cfl::InterestRateModel &rModel) {
 
+    std::vector<double> uPaymentTimes(iSwapPayments);
     double dTime = rModel.eventTimes()[iTime];
-    cfl::Slice uFloat = 1. - rModel.discount(iTime, dTime + dPeriod * iSwapPayments);
-    cfl::Slice uFixed = rModel.cash(iTime, 0.0);
-
-    for (int l = 0; l < iSwapPayments; l++) {
+    for (double &rT : uPaymentTimes) {
         dTime += dPeriod;
-        uFixed += dPeriod * rModel.discount(iTime, dTime);
+        rT = dTime;
     }
+    cfl::Slice uFloat = 1. - rModel.discount(iTime, dTime);
+    cfl::Slice uFixed = rModel.annuity(iTime, uPaymentTimes);
 
     cfl::Slice uRate = uFloat / uFixed;
 
@@ -0,0 +1,657 @@
+#ifndef __cflAdjoint_hpp__
+#define __cflAdjoint_hpp__
+
+/**
+ * @file Adjoint.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Reverse-mode (adjoint) sensitivities of payoffs.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Dual.hpp"
+#include <functional>
+#include <map>
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflAdjoint Reverse-mode sensitivities.
+ *
+ * This module contains the tape for the reverse (adjoint) computation
+ * of sensitivities in backward induction. The operations on payoffs
+ * are recorded on the tape in the forward (pricing) pass. The reverse
+ * sweep then propagates the derivative of the price from the result
+ * to all recorded payoffs and curve inputs. The cost of all
+ * sensitivities is a small multiple of the cost of one price,
+ * regardless of their number.
+ * @{
+ */
+
+class Tape;
+
+/**
+ * @brief A payoff recorded on a tape.
+ *
+ * The object is a light handle: it keeps the value of the payoff and
+ * the position of the operation on the tape. Operations on objects
+ * from different tapes are not allowed.
+ *
+ * @see Tape, Slice
+ */
+class TapeSlice
+{
+public:
+  /**
+   * Default constructor. The object is not attached to a tape.
+   */
+  TapeSlice ();
+
+  /**
+   * Returns the payoff.
+   *
+   * @return The value of \p *this.
+   */
+  const Slice &value () const;
+
+  /**
+   * Returns the index of the event time.
+   *
+   * @return The index of the event time.
+   */
+  unsigned timeIndex () const;
+
+  /**
+   * Returns the tape on which \p *this is recorded.
+   *
+   * @return Reference to the tape.
+   */
+  Tape &tape () const;
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rSlice.
+   *
+   * @param rSlice A recorded payoff.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator+= (const TapeSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rSlice.
+   *
+   * @param rSlice A recorded payoff.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator-= (const TapeSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rSlice.
+   *
+   * @param rSlice A recorded payoff.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator*= (const TapeSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rSlice.
+   *
+   * @param rSlice A recorded payoff.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator/= (const TapeSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff that does not depend on the inputs.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator+= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff that does not depend on the inputs.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator-= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff that does not depend on the inputs.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator*= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff that does not depend on the inputs.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator/= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p dValue.
+   *
+   * @param dValue A number.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator+= (double dValue);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p dValue.
+   *
+   * @param dValue A number.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator-= (double dValue);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p dValue.
+   *
+   * @param dValue A number.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator*= (double dValue);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p dValue.
+   *
+   * @param dValue A number.
+   * @return Reference to \p *this.
+   */
+  TapeSlice &operator/= (double dValue);
+
+  /**
+   * Replaces \p *this with its value at the event time with index \p
+   * iEventTime. The reverse sweep applies the transpose of the
+   * rollback operator given by IModel::adjointRollback.
+   *
+   * @param iEventTime The index of the target event time.
+   */
+  void rollback (unsigned iEventTime);
+
+private:
+  friend class Tape;
+  TapeSlice (Tape *pTape, unsigned iNode, const Slice &rValue);
+
+  Tape *m_pTape;
+  unsigned m_iNode;
+  Slice m_uValue;
+};
+
+/**
+ * @brief The record of operations on payoffs.
+ *
+ * The inputs of the computation are created by the tape. The
+ * operations on them are recorded in the forward pass. The function
+ * Tape::backward runs the reverse sweep and computes the derivatives
+ * of the price of the result with respect to
+ * - all inputs created by Tape::input (node by node);
+ * - the parameters of the inputs created by Tape::input with
+ *   derivatives;
+ * - the logarithms of discount factors and forward prices at all
+ *   relevant times;
+ * - the total variances \f$\Sigma(t)\f$ of the state process at the
+ *   event times.
+ *
+ * The sensitivities with respect to the discount curve are collected
+ * from the payoffs created by Tape::discount and, if it is requested
+ * in the constructor, from rollback. The latter is valid only for the
+ * models whose rollback operator between the event times \f$t_i <
+ * t_j\f$ contains the factor \f$D(t_j)/D(t_i)\f$ of the discount
+ * curve, as in Black::model and HullWhite::model, and not for the
+ * models without discounting, as cfl::brownian.
+ *
+ * The sensitivities with respect to the volatility curve are
+ * collected from the payoffs created by Tape::forward with the shape
+ * of volatility and, if it is requested in the constructor, from
+ * rollback. The rollback between the event times \f$t_i < t_j\f$
+ * is the conditional expectation with respect to the gaussian
+ * distribution with variance \f$\Sigma(t_j) - \Sigma(t_i)\f$, hence,
+ * its derivative with respect to this variance is one half of the
+ * second derivative of the result with respect to the state. It is
+ * valid for the models with one state process and a numeraire that
+ * does not depend on the state, as cfl::brownian and Black::model,
+ * and not for HullWhite::model. The memory of the tape is bounded
+ * with Tape::checkpoint.
+ *
+ * @see TapeSlice, DualSlice
+ */
+class Tape
+{
+public:
+  /**
+   * The adjoint rule of an operation. It receives the adjoint of the
+   * result and adds the adjoints of the arguments with
+   * Tape::accumulate.
+   */
+  typedef std::function<void (const Slice &rAdjoint)> TBackward;
+
+  /**
+   * Constructs an empty tape.
+   *
+   * @param bDiscountRollback If \p true, then rollback contributes to
+   * the sensitivities with respect to the discount curve. It should
+   * be set only for the models whose rollback discounts with the
+   * discount curve.
+   * @param bVarianceRollback If \p true, then rollback contributes to
+   * the sensitivities with respect to the total variances of the
+   * state process. It should be set only for the models with one
+   * state process and a numeraire that does not depend on the state.
+   */
+  explicit Tape (bool bDiscountRollback = false,
+                 bool bVarianceRollback = false);
+
+  Tape (const Tape &) = delete;
+  Tape &operator= (const Tape &) = delete;
+
+  /**
+   * Records an independent input.
+   *
+   * @param rValue The value of the input.
+   * @return The recorded payoff.
+   */
+  TapeSlice input (const Slice &rValue);
+
+  /**
+   * Records an input with the given derivatives with respect to
+   * the parameters.
+   *
+   * @param rValue The value of the input.
+   * @param rDerivative The derivatives of \p rValue with respect to
+   * the parameters.
+   * @return The recorded payoff.
+   */
+  TapeSlice input (const Slice &rValue, const std::vector<Slice> &rDerivative);
+
+  /**
+   * Records an input given by a payoff with derivatives with
+   * respect to the parameters.
+   *
+   * @param rValue The payoff with derivatives.
+   * @return The recorded payoff.
+   */
+  TapeSlice input (const DualSlice &rValue);
+
+  /**
+   * Records the discount factor \p rDiscount for the maturity \p
+   * dMaturity obtained from a model at the event time with index
+   * \f$i\f$. Its logarithm depends on the discount curve through
+   * \f$\log D(T) - \log D(t_i)\f$.
+   *
+   * @param rDiscount The discount factor returned by the model.
+   * @param dMaturity The maturity \f$T\f$.
+   * @return The recorded payoff.
+   */
+  TapeSlice discount (const Slice &rDiscount, double dMaturity);
+
+  /**
+   * Records the forward price \p rForward for the maturity \p
+   * dMaturity obtained from a model. Its logarithm depends on the
+   * forward curve through \f$\log F(T)\f$.
+   *
+   * @param rForward The forward price returned by the model.
+   * @param dMaturity The maturity \f$T\f$.
+   * @return The recorded payoff.
+   */
+  TapeSlice forward (const Slice &rForward, double dMaturity);
+
+  /**
+   * Records the forward price \p rForward for the maturity \p
+   * dMaturity obtained from Black::model at the event time with index
+   * \f$i\f$. Its logarithm equals \f$\log F(T) + b x -
+   * \frac12 b^2 \Sigma(t_i)\f$, where \f$x\f$ is the state process and
+   * \f$b\f$ is the shape of volatility at \f$T\f$, hence, it also
+   * depends on the total variance of the state process.
+   *
+   * @param rForward The forward price returned by the model.
+   * @param dMaturity The maturity \f$T\f$.
+   * @param dShape The shape of volatility \f$b\f$ at \f$T\f$.
+   * @return The recorded payoff.
+   */
+  TapeSlice forward (const Slice &rForward, double dMaturity, double dShape);
+
+  /**
+   * Records an operation.
+   *
+   * @param rValue The value of the result.
+   * @param rBackward The adjoint rule of the operation.
+   * @return The recorded payoff.
+   */
+  TapeSlice record (const Slice &rValue, const TBackward &rBackward);
+
+  /**
+   * Adds \p rAdjoint to the adjoint of \p rSlice. It is used by the
+   * adjoint rules in the reverse sweep.
+   *
+   * @param rSlice A recorded payoff.
+   * @param rAdjoint The contribution to the adjoint of \p rSlice.
+   */
+  void accumulate (const TapeSlice &rSlice, const Slice &rAdjoint);
+
+  /**
+   * Runs the segment \p rSegment without keeping its operations.
+   * The reverse sweep recomputes the segment on a temporary tape.
+   * Hence, the memory is bounded by the length of the longest
+   * segment.
+   *
+   * @param rInput The input of the segment.
+   * @param rSegment The computation. It receives the input recorded on
+   * a temporary tape and returns the result on the same tape.
+   * @return The result of the segment recorded on \p *this.
+   */
+  TapeSlice
+  checkpoint (const TapeSlice &rInput,
+              const std::function<TapeSlice (const TapeSlice &)> &rSegment);
+
+  /**
+   * Runs the reverse sweep for the price of \p rOutput at the
+   * origin: <code>atOrigin(rOutput.value())[0]</code>.
+   *
+   * @param rOutput The result of the computation.
+   */
+  void backward (const TapeSlice &rOutput);
+
+  /**
+   * Runs the reverse sweep for the linear functional \p rSeed of
+   * \p rOutput.
+   *
+   * @param rOutput The result of the computation.
+   * @param rSeed The adjoint of \p rOutput.
+   */
+  void backward (const TapeSlice &rOutput, const Slice &rSeed);
+
+  /**
+   * Returns the adjoint of an input after the reverse sweep.
+   *
+   * @param rInput An input created by Tape::input.
+   * @return The derivatives with respect to the values of \p rInput.
+   */
+  Slice adjoint (const TapeSlice &rInput) const;
+
+  /**
+   * Returns the sensitivities with respect to the parameters of the
+   * inputs.
+   *
+   * @return The derivatives with respect to the parameters.
+   */
+  const std::valarray<double> &sensitivity () const;
+
+  /**
+   * Returns the sensitivities with respect to the logarithms of
+   * discount factors.
+   *
+   * @return The map: \f$t \mapsto \partial / \partial \log D(t)\f$.
+   */
+  const std::map<double, double> &discountSensitivity () const;
+
+  /**
+   * Returns the sensitivity with respect to a parameter of the
+   * discount curve.
+   *
+   * @param rDerivative The derivative of \f$\log D(t)\f$ with respect
+   * to the parameter.
+   * @return The derivative with respect to the parameter.
+   */
+  double discountSensitivity (const Function &rDerivative) const;
+
+  /**
+   * Returns the sensitivities with respect to the logarithms of
+   * forward prices.
+   *
+   * @return The map: \f$t \mapsto \partial / \partial \log F(t)\f$.
+   */
+  const std::map<double, double> &forwardSensitivity () const;
+
+  /**
+   * Returns the sensitivity with respect to a parameter of the
+   * forward curve.
+   *
+   * @param rDerivative The derivative of \f$\log F(t)\f$ with respect
+   * to the parameter.
+   * @return The derivative with respect to the parameter.
+   */
+  double forwardSensitivity (const Function &rDerivative) const;
+
+  /**
+   * Returns the sensitivities with respect to the total variances of
+   * the state process.
+   *
+   * @return The map: \f$t \mapsto \partial / \partial \Sigma(t)\f$.
+   */
+  const std::map<double, double> &varianceSensitivity () const;
+
+  /**
+   * Returns the sensitivity with respect to a parameter of the
+   * volatility curve. For Black::model, \f$\Sigma(t) =
+   * \sigma^2(t)(t-t_0)\f$, where \f$\sigma(t)\f$ is the volatility
+   * curve and \f$t_0\f$ is the initial time.
+   *
+   * @param rDerivative The derivative of \f$\Sigma(t)\f$ with respect
+   * to the parameter.
+   * @return The derivative with respect to the parameter.
+   */
+  double varianceSensitivity (const Function &rDerivative) const;
+
+  /**
+   * Returns the number of recorded operations.
+   *
+   * @return The size of the tape.
+   */
+  unsigned size () const;
+
+private:
+  struct Node
+  {
+    const IModel *pModel;
+    unsigned iTime;
+    std::vector<unsigned> uDependence;
+    TBackward uBackward;
+  };
+
+  void accumulate (unsigned iNode, const Slice &rAdjoint);
+  void merge (const Tape &rTape);
+  friend class TapeSlice;
+
+  bool m_bDiscountRollback, m_bVarianceRollback;
+  std::vector<Node> m_uNodes;
+  std::vector<Slice> m_uAdjoint;
+  std::vector<bool> m_uHasAdjoint;
+  std::valarray<double> m_uSensitivity;
+  std::map<double, double> m_uDiscount, m_uForward, m_uVariance;
+};
+
+/**
+ * Returns the payoff with the opposite sign.
+ *
+ * @param rSlice A recorded payoff.
+ * @return The payoff <code>-rSlice</code>.
+ */
+TapeSlice operator- (const TapeSlice &rSlice);
+
+/**
+ * Returns the sum of \p rX and \p rY. One of the arguments can be
+ * Slice or double.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The sum of \p rX and \p rY.
+ */
+TapeSlice operator+ (const TapeSlice &rX, const TapeSlice &rY);
+
+/**
+ * Returns the difference of \p rX and \p rY. One of the arguments can
+ * be Slice or double.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The difference of \p rX and \p rY.
+ */
+TapeSlice operator- (const TapeSlice &rX, const TapeSlice &rY);
+
+/**
+ * Returns the product of \p rX and \p rY. One of the arguments can be
+ * Slice or double.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The product of \p rX and \p rY.
+ */
+TapeSlice operator* (const TapeSlice &rX, const TapeSlice &rY);
+
+/**
+ * Returns the ratio of \p rX and \p rY. One of the arguments can be
+ * Slice or double.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The ratio of \p rX and \p rY.
+ */
+TapeSlice operator/ (const TapeSlice &rX, const TapeSlice &rY);
+
+/** @cond */
+TapeSlice operator+ (const TapeSlice &rX, const Slice &rY);
+TapeSlice operator+ (const Slice &rX, const TapeSlice &rY);
+TapeSlice operator+ (const TapeSlice &rX, double dY);
+TapeSlice operator+ (double dX, const TapeSlice &rY);
+TapeSlice operator- (const TapeSlice &rX, const Slice &rY);
+TapeSlice operator- (const Slice &rX, const TapeSlice &rY);
+TapeSlice operator- (const TapeSlice &rX, double dY);
+TapeSlice operator- (double dX, const TapeSlice &rY);
+TapeSlice operator* (const TapeSlice &rX, const Slice &rY);
+TapeSlice operator* (const Slice &rX, const TapeSlice &rY);
+TapeSlice operator* (const TapeSlice &rX, double dY);
+TapeSlice operator* (double dX, const TapeSlice &rY);
+TapeSlice operator/ (const TapeSlice &rX, const Slice &rY);
+TapeSlice operator/ (const Slice &rX, const TapeSlice &rY);
+TapeSlice operator/ (const TapeSlice &rX, double dY);
+TapeSlice operator/ (double dX, const TapeSlice &rY);
+/** @endcond */
+
+/**
+ * Returns the maximum of \p rSlice and \p dValue. The adjoint is
+ * propagated to \p rSlice on the event <code>rSlice > dValue</code>.
+ *
+ * @param rSlice A recorded payoff.
+ * @param dValue A number.
+ * @return The payoff <code>max(rSlice, dValue)</code>.
+ */
+TapeSlice max (const TapeSlice &rSlice, double dValue);
+
+/**
+ * Returns the minimum of \p rSlice and \p dValue.
+ *
+ * @param rSlice A recorded payoff.
+ * @param dValue A number.
+ * @return The payoff <code>min(rSlice, dValue)</code>.
+ */
+TapeSlice min (const TapeSlice &rSlice, double dValue);
+
+/**
+ * Returns the maximum of \p rX and \p rY.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The payoff <code>max(rX, rY)</code>.
+ */
+TapeSlice max (const TapeSlice &rX, const TapeSlice &rY);
+
+/**
+ * Returns the minimum of \p rX and \p rY.
+ *
+ * @param rX A recorded payoff.
+ * @param rY A recorded payoff.
+ * @return The payoff <code>min(rX, rY)</code>.
+ */
+TapeSlice min (const TapeSlice &rX, const TapeSlice &rY);
+
+/**
+ * Returns the exponent of \p rSlice.
+ *
+ * @param rSlice A recorded payoff.
+ * @return The exponent of \p rSlice.
+ */
+TapeSlice exp (const TapeSlice &rSlice);
+
+/**
+ * Returns the logarithm of \p rSlice.
+ *
+ * @param rSlice A recorded payoff.
+ * @return The logarithm of \p rSlice.
+ */
+TapeSlice log (const TapeSlice &rSlice);
+
+/**
+ * Returns \p rSlice in the power \p dPower.
+ *
+ * @param rSlice A recorded payoff.
+ * @param dPower The power.
+ * @return The payoff given by <code> rSlice^dPower </code>.
+ */
+TapeSlice pow (const TapeSlice &rSlice, double dPower);
+
+/**
+ * Returns the square root of \p rSlice.
+ *
+ * @param rSlice A recorded payoff.
+ * @return The square root of \p rSlice.
+ */
+TapeSlice sqrt (const TapeSlice &rSlice);
+
+/**
+ * Returns the indicator of the event: \p rSlice is greater than \p
+ * dBarrier. The value is the smoothed indicator of the model. The
+ * adjoint applies the transpose of its Jacobian. The indicators of
+ * NInd couple only the neighbouring nodes, hence, the Jacobian is
+ * tridiagonal and is obtained with three pairs of evaluations. The
+ * model should have at most one state process.
+ *
+ * @param rSlice A recorded payoff.
+ * @param dBarrier The lower barrier.
+ * @return The indicator <code> I(rSlice > dBarrier) </code>.
+ */
+TapeSlice indicator (const TapeSlice &rSlice, double dBarrier);
+
+/**
+ * Returns the indicator of the event: \p dBarrier is greater than \p
+ * rSlice.
+ *
+ * @param dBarrier The upper barrier.
+ * @param rSlice A recorded payoff.
+ * @return The indicator <code> I(dBarrier > rSlice) </code>.
+ */
+TapeSlice indicator (double dBarrier, const TapeSlice &rSlice);
+
+/**
+ * Returns the indicator of the event: \p rSlice is greater than \p
+ * rBarrier.
+ *
+ * @param rSlice A recorded payoff.
+ * @param rBarrier The lower barrier.
+ * @return The indicator <code> I(rSlice > rBarrier) </code>.
+ */
+TapeSlice indicator (const TapeSlice &rSlice, const TapeSlice &rBarrier);
+
+/**
+ * Returns the equivalent value of \p rSlice at the event time with
+ * index \p iEventTime.
+ *
+ * @param rSlice A recorded payoff.
+ * @param iEventTime The index of the target event time.
+ * @return The price of \p rSlice at the event time with index \p
+ * iEventTime.
+ */
+TapeSlice rollback (const TapeSlice &rSlice, unsigned iEventTime);
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iAdjoint.hpp"
+#endif // of __cflAdjoint_hpp__
@@ -0,0 +1,190 @@
+#ifndef __cflAnalytic_hpp__
+#define __cflAnalytic_hpp__
+
+/**
+ * @file Analytic.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Closed-form prices of European options in Black and
+ * Hull-White models.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/BlackModel.hpp"
+#include "cfl/Data.hpp"
+#include "cfl/HullWhiteModel.hpp"
+
+namespace cfl
+{
+/**
+ * @ingroup cflModel
+ *
+ * @defgroup cflAnalytic Closed-form prices of European options.
+ *
+ * This module contains closed-form prices of standard European
+ * options in Black and Hull-White models. The results are functions
+ * of the initial value of the state process with four components:
+ * the value, delta and gamma with respect to the state process, as
+ * for the interpolation of a price computed in the model with
+ * cfl::brownian, and vega, the derivative with respect to the
+ * standard deviation of the state process between the initial time
+ * and the last event time that the numerical scheme would use.
+ * The functions do not build event times, slices or grids.
+ * @{
+ */
+
+/**
+ * @brief Closed-form prices of European options.
+ */
+namespace NAnalytic
+{
+/**
+ * Computes the price of the European option on the forward price
+ * \f$F(T,T_F)\f$ in Black model. The payoff at maturity \f$T\f$ is
+ * \f$\max(F(T,T_F)-K,0)\f$ for a call and \f$\max(K-F(T,T_F),0)\f$ for
+ * a put. The last event time is \f$T\f$.
+ *
+ * @param rData The parameters of Black model.
+ * @param dStrike The strike \f$K\f$.
+ * @param dMaturity The maturity \f$T\f$ of the option.
+ * @param dForwardMaturity The maturity \f$T_F \geq T\f$ of the
+ * forward contract.
+ * @param bCall The type of the option: \p true for a call and \p
+ * false for a put.
+ * @return The price of the option as a function of the initial
+ * state.
+ */
+MultiFunction forwardOption (const Black::Data &rData, double dStrike,
+                             double dMaturity, double dForwardMaturity,
+                             bool bCall);
+
+/**
+ * Computes the price of the standard European option on the stock in
+ * Black model. The same as forwardOption() with \f$T_F = T\f$.
+ *
+ * @param rData The parameters of Black model.
+ * @param dStrike The strike.
+ * @param dMaturity The maturity of the option.
+ * @param bCall The type of the option: \p true for a call and \p
+ * false for a put.
+ * @return The price of the option as a function of the initial
+ * state.
+ */
+MultiFunction option (const Black::Data &rData, double dStrike,
+                      double dMaturity, bool bCall);
+
+/**
+ * Computes the price of the European option on the coupon bond in
+ * Hull-White model. The bond pays \p rPayments[k] at \p
+ * rPaymentTimes[k]. The payoff at maturity \f$T\f$ is \f$\max(P-K,0)\f$
+ * for a call and \f$\max(K-P,0)\f$ for a put, where \f$P\f$ is the
+ * price of the bond. For several payments the price is given by the
+ * decomposition of Jamshidian into options on discount bonds. The
+ * last event time is \f$T\f$.
+ *
+ * @param rData The parameters of Hull-White model.
+ * @param rPaymentTimes The increasing vector of payment times. The
+ * first payment time is greater than the maturity of the option.
+ * @param rPayments The positive payments of the bond.
+ * @param dStrike The strike \f$K\f$.
+ * @param dMaturity The maturity \f$T\f$ of the option.
+ * @param bCall The type of the option: \p true for a call and \p
+ * false for a put.
+ * @return The price of the option as a function of the initial
+ * state.
+ */
+MultiFunction bondOption (const HullWhite::Data &rData,
+                          const std::vector<double> &rPaymentTimes,
+                          const std::vector<double> &rPayments,
+                          double dStrike, double dMaturity, bool bCall);
+
+/**
+ * Computes the price of the interest rate cap in Hull-White model.
+ * The first period starts at the initial time. The last event time
+ * is the beginning of the last period.
+ *
+ * @param rData The parameters of Hull-White model.
+ * @param rCap The parameters of the cap.
+ * @return The price of the cap as a function of the initial state.
+ */
+MultiFunction cap (const HullWhite::Data &rData,
+                   const Data::CashFlow &rCap);
+
+/**
+ * Computes the price of the European swaption in Hull-White model.
+ * The underlying swap starts at the maturity of the option. The last
+ * event time is the maturity.
+ *
+ * @param rData The parameters of Hull-White model.
+ * @param rSwap The parameters of the underlying swap.
+ * @param dMaturity The maturity of the option.
+ * @return The price of the swaption as a function of the initial
+ * state.
+ */
+MultiFunction swaption (const HullWhite::Data &rData,
+                        const Data::Swap &rSwap, double dMaturity);
+
+/**
+ * Computes Black formula for the forward price of the call option:
+ * \f[
+ * F N(d_1) - K N(d_2), \quad d_{1,2} = \frac{\ln(F/K)}{s} \pm
+ * \frac12 s,
+ * \f]
+ * where \f$s\f$ is the total standard deviation of the logarithm of
+ * the forward price. The formula is evaluated by the normalized price
+ * of impliedVol(). The function does not build a MultiFunction and is
+ * used for the batch pricing in calibrations.
+ *
+ * @param dForward The forward price \f$F>0\f$.
+ * @param dStrike The strike \f$K>0\f$.
+ * @param dStd The total standard deviation \f$s\geq 0\f$.
+ * @param rVega On exit, the derivative of the price with respect to
+ * \f$s\f$.
+ * @return The forward price of the call option.
+ */
+double black (double dForward, double dStrike, double dStd, double &rVega);
+
+/**
+ * Computes the implied volatilities of a batch of European options
+ * in Black model. The price of the call is
+ * \f[
+ * C = D (F N(d_1) - K N(d_2)), \quad d_{1,2} = \frac{\ln(F/K)}{\sigma
+ * \sqrt{T}} \pm \frac12 \sigma\sqrt{T},
+ * \f]
+ * and the price of the put follows from the put-call parity. The
+ * options are reduced to out-of-the-money calls with normalized
+ * prices. The initial guess is given by the inflection point of the
+ * normalized price and by the rational approximation of the inverse
+ * of the normal distribution. Then every quote is refined by the
+ * Householder iterations of the third order on the price (above the
+ * inflection point) or on its logarithm (below the inflection
+ * point). The iterations are safeguarded by bisection and stop
+ * independently for every quote. Large batches are distributed among
+ * the threads.
+ *
+ * @param rStrike The strikes \f$K\f$.
+ * @param rMaturity The times to maturity \f$T\f$.
+ * @param rDiscount The discount factors \f$D\f$.
+ * @param rForward The forward prices \f$F\f$.
+ * @param rPrice The prices of the options.
+ * @param bCall The type of the options: \p true for calls and \p
+ * false for puts.
+ * @param dErr The relative error of the volatility.
+ * @return The implied volatilities \f$\sigma\f$. The volatility is
+ * zero if the price equals the intrinsic value and is NaN if the
+ * price violates the bounds of no-arbitrage.
+ */
+std::valarray<double> impliedVol (const std::valarray<double> &rStrike,
+                                  const std::valarray<double> &rMaturity,
+                                  const std::valarray<double> &rDiscount,
+                                  const std::valarray<double> &rForward,
+                                  const std::valarray<double> &rPrice,
+                                  bool bCall = true, double dErr = 1E-12);
+} // namespace NAnalytic
+/** @} */
+} // namespace cfl
+
+#endif // of __cflAnalytic_hpp__
@@ -110,6 +110,15 @@ public:
    */
   const IModel &model () const;
 
+  /**
+   * Returns the implementation of the model. It is used by the
+   * functions that create new models from the existing ones, for
+   * example, after a change of the initial curves.
+   *
+   * @return The implementation of IAssetModel.
+   */
+  const IAssetModel &implementation () const;
+
   /**
    * @copydoc InterestRateModel::eventTimes
    */
@@ -244,6 +244,25 @@ AssetModel model (const Data &rData, double dInterval, double dStepQuality,
  */
 AssetModel model (const Data &rData, double dInterval,
                   const TBrownian &rBrownian);
+
+/**
+ * Replaces the parameters of Black model \p rModel by \p rData. The
+ * result has the same event times as \p rModel. The lattice of
+ * Brownian motion depends only on the volatility curve. Therefore, if
+ * \p rData and the parameters of \p rModel have the same initial
+ * time and the same volatilities at the event times, then the grids
+ * and the rollback operators of \p rModel are reused and only the
+ * deterministic numeraire and the forward prices change. Otherwise,
+ * the model is constructed from scratch. This function is designed
+ * for the computation of risks with respect to the discount and
+ * forward curves.
+ *
+ * @param rModel A model constructed by Black::model.
+ * @param rData The new parameters of Black model.
+ * @return Black model with the parameters \p rData and the event
+ * times of \p rModel.
+ */
+AssetModel rebind (const AssetModel &rModel, const Data &rData);
 } // namespace Black
 /** @} */
 } // namespace cfl
@@ -0,0 +1,136 @@
+#ifndef __cflBootstrap_hpp__
+#define __cflBootstrap_hpp__
+
+/**
+ * @file Bootstrap.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Global bootstrap of discount curves from deposit and swap
+ * rates.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Function.hpp"
+#include <vector>
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflBootstrap Bootstrap of discount curves.
+ *
+ * This module contains the construction of discount curves that
+ * reprice exactly a set of deposits and interest rate swaps.
+ * @{
+ */
+
+/**
+ * @brief Global bootstrap of the discount curve.
+ *
+ * The unknowns are the logarithms \f$x_i = \ln D(T_i)\f$ of the
+ * discount factors at the pillars \f$T_1<\dots<T_n\f$, the maturities
+ * of the instruments. The swap with period \f$\delta\f$, \f$m\f$
+ * payments and the rate \f$R\f$ starts at the initial time \f$t_0\f$
+ * and is priced at par:
+ * \f[
+ *  R \delta \sum_{k=1}^m D(t_0 + k\delta) + D(t_0 + m\delta) = 1.
+ * \f]
+ * A deposit is the swap with one payment. The discount curve between
+ * the pillars is either piecewise log-linear (the forward rate is
+ * constant between the pillars) or the monotone convex interpolation
+ * of Hagan and West (the forward rate is continuous and preserves the
+ * monotonicity and convexity of the discrete forward rates). In both
+ * cases \f$\ln D(t)\f$ at a payment time depends only on the nearest
+ * pillars, and the Jacobian of the system has at most one nonzero
+ * diagonal above the main diagonal. The Jacobian is kept as a band
+ * matrix; its lower bandwidth is the largest number of pillars
+ * spanned by the payments of a swap. All equations are solved
+ * together by Newton method with the analytic derivatives of the
+ * annuities.
+ * The solution is kept and is used as the initial guess for the next
+ * quotes.
+ */
+class Bootstrap
+{
+public:
+  /**
+   * Constructs the bootstrap without instruments.
+   *
+   * @param dInitialTime The initial time \f$t_0\f$.
+   * @param bMonotoneConvex If \p true, then the monotone convex
+   * interpolation is used; otherwise the interpolation is piecewise
+   * log-linear.
+   */
+  explicit Bootstrap (double dInitialTime, bool bMonotoneConvex = true);
+
+  /**
+   * Adds the deposit with the maturity \p dMaturity. The deposit
+   * pays \f$1 + R (T - t_0)\f$ at the maturity \f$T\f$ for the
+   * investment of 1 at \f$t_0\f$, where \f$R\f$ is the deposit rate.
+   *
+   * @param dMaturity The maturity \f$T\f$ of the deposit.
+   */
+  void addDeposit (double dMaturity);
+
+  /**
+   * Adds the interest rate swap that starts at the initial time.
+   *
+   * @param dPeriod The interval \f$\delta\f$ between two payments.
+   * @param iNumberOfPayments The number of payments \f$m\f$.
+   */
+  void addSwap (double dPeriod, unsigned iNumberOfPayments);
+
+  /**
+   * Computes the discount curve that reprices all instruments. The
+   * maturities of the instruments are different. At the evaluation
+   * of the curve, the interval of the pillars is found by a table of
+   * uniform buckets followed by a linear search over the pillars in
+   * the bucket.
+   *
+   * @param rRates The rates of the instruments in the order of their
+   * addition.
+   * @return The discount curve on \f$[t_0,\infty)\f$.
+   */
+  Function discount (const std::vector<double> &rRates);
+
+  /**
+   * Returns the number of Newton iterations in the last bootstrap.
+   *
+   * @return The number of iterations.
+   */
+  unsigned iterations () const;
+
+private:
+  // computes the tables of the instruments
+  void setup ();
+
+  double m_dInitialTime;
+  bool m_bMonotoneConvex;
+  // the instruments: period and number of payments
+  std::vector<double> m_uPeriod;
+  std::vector<unsigned> m_uPayments;
+  // the pillars: the instruments sorted by maturity and the times
+  // from the initial time
+  std::vector<unsigned> m_uOrder;
+  std::vector<double> m_uTau;
+  // the coefficients of the deviations of the forward rate at the
+  // ends of the intervals from the discrete forward rates
+  std::vector<double> m_uC0, m_uC1;
+  // the payments: pillar, interval and relative position there
+  std::vector<unsigned> m_uPayRow, m_uPayInterval;
+  std::vector<double> m_uPayXi;
+  // the lower bandwidth of the Jacobian
+  unsigned m_iLower;
+  // the last solution for the logarithms of the discount factors
+  std::vector<double> m_uX;
+  unsigned m_iIter;
+};
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iBootstrap.hpp"
+#endif // of __cflBootstrap_hpp__
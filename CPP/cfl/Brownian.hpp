@@ -28,6 +28,15 @@ namespace cfl
  * This module contains implementation of the basic financial model
  * where the state process is a one-dimensional Brownian motion.
  *
+ * The interpolation of a payoff covers the interval of initial
+ * values and has three components: the value, delta and gamma with
+ * respect to the state process. Delta and gamma are computed with
+ * GaussRollback::rollback on the first request of the corresponding
+ * components. A slice does not determine the
+ * derivative with respect to the volatility of the state process for
+ * early-exercise and path-dependent payoffs, so the model does not
+ * report vega.
+ *
  * @{
  */
 
@@ -103,6 +112,117 @@ TBrownian brownian (const std::function<double (double)> &rH,
                     const std::function<unsigned (double)> &rSize,
                     const GaussRollback &rRollback, const Ind &rInd,
                     const Interp &rInterp);
+
+/**
+ * Changes the numeraire of the model of Brownian motion. At event
+ * time \f$t_i\f$ the numeraire is a log-affine function of the state
+ * \f$x\f$:
+ * \f[
+ * N_i(x) = \exp(a_i + b_i x),
+ * \f]
+ * and the rollback from \f$t_j\f$ to \f$t_i\f$ computes
+ * \f$ V_i = N_i E(V_j/N_j | x_i) \f$.  If \a rBrownian is constructed
+ * by cfl::brownian, then the result is a single model where the
+ * rescaling by the numeraire is fused with the Gaussian rollback. For
+ * other models the result is given by cfl::similar. If \a rBrownian
+ * is itself a fused result of this function, then the numeraires are
+ * multiplied and the grids are reused; in particular, a change of
+ * \a rShift alone does not recompute the numeraire on the grids.
+ *
+ * @param rBrownian The model of Brownian motion.
+ * @param rShift The vector of \f$a_i\f$. It has the same size as the
+ * vector of event times.
+ * @param rSlope The vector of \f$b_i\f$. It has the same size as the
+ * vector of event times.
+ * @return The model of Brownian motion under the new numeraire.
+ */
+Model numeraire (const Model &rBrownian, const std::vector<double> &rShift,
+                 const std::vector<double> &rSlope);
+
+/**
+ * Returns cfl::Model representing two correlated Brownian motions
+ * given
+ * - \a rVar1 and \a rVar2 The vectors of average variances of the
+ *   first and the second Brownian motions. They are defined as
+ *   \a rVar in cfl::TBrownian.
+ * - \a dCorrelation The correlation coefficient of the Brownian
+ *   motions. The volatilities are assumed to be constant between
+ *   event times.
+ * - \a rEventTimes The vector of event times in the model.
+ * - \a rInterval The widths of the intervals of initial values for
+ *   the first and the second Brownian motions.
+ */
+typedef std::function<Model (const std::vector<double> &rVar1,
+                             const std::vector<double> &rVar2,
+                             double dCorrelation,
+                             const std::vector<double> &rEventTimes,
+                             const std::valarray<double> &rInterval)>
+    TBrownian2;
+
+/**
+ * Implements the generator of the model with two correlated Brownian
+ * motions for given step, width and size of the grids. The
+ * implementation is described below for the other constructor.
+ *
+ * @param rH Returns the step on the grids as a function of
+ * the \em minimal total variance between two event times.
+ * @param rWidth The width of a grid as a function of the total
+ * variance. The width does not include the interval of initial values.
+ * @param rSize The size of a grid as a function of the total
+ * variance. It has to return powers of 2.
+ * @param rRollback An implementation of the operator of conditional
+ * expectation for payoffs that depend on one Brownian motion.
+ * @param rInd A numerically efficient implementation of
+ * discontinuous functions.
+ * @param rInterp An implementation of numerical interpolation.
+ * @return The constructor of the model with two Brownian motions.
+ */
+TBrownian2 brownian2 (const std::function<double (double)> &rH,
+                      const std::function<double (double)> &rWidth,
+                      const std::function<unsigned (double)> &rSize,
+                      const GaussRollback &rRollback, const Ind &rInd,
+                      const Interp &rInterp);
+
+/**
+ * Implements the generator of the model with two correlated Brownian
+ * motions. The storage is a tensor product of the grids of
+ * cfl::brownian. A payoff that depends on one of the Brownian motions
+ * is kept on the grid of this motion and is rolled back by \a
+ * rRollback. It is extended to the two-dimensional grid only after
+ * an operation with a payoff that depends on the other motion. The
+ * two-dimensional rollback applies the Gaussian kernel with the
+ * correlation by the tensor Fast Fourier Transform; the rows and the
+ * columns of the grid are transformed in parallel.
+ *
+ * The indicator of a two-dimensional payoff is the average of the
+ * indicators along the rows and along the columns of the grid. The
+ * interpolation of a payoff returns its value only. For a payoff on
+ * the two-dimensional grid it is the bicubic Hermite interpolation;
+ * the derivatives at the nodes are given by \a rInterp along the rows
+ * and the columns and are computed once for the payoff.
+ *
+ * @param dStepQuality The parameter of the step on the grids, see
+ * cfl::brownian.
+ * @param dWidthQuality The parameter of the width of the grids, see
+ * cfl::brownian.
+ * @param iUniformSteps The minimal number of uniform steps in the explicit
+ * scheme between two event times.
+ * @param rSize The size of a grid as a function of the total
+ * variance. It has to return powers of 2.
+ * @param rRollback An implementation of the operator of conditional
+ * expectation for payoffs that depend on one Brownian motion.
+ * @param rInd A numerically efficient implementation of
+ * discontinuous functions.
+ * @param rInterp An implementation of numerical interpolation.
+ * @return The constructor of the model with two Brownian motions.
+ */
+TBrownian2
+brownian2 (double dStepQuality, double dWidthQuality,
+           unsigned iUniformSteps = 3,
+           const std::function<unsigned (double)> &rSize = Grid::size2 (),
+           const GaussRollback &rRollback = cfl::NGaussRollback::chain (),
+           const Ind &rInd = cfl::NInd::linear (),
+           const Interp &rInterp = cfl::NInterp::cspline ());
 /** @} */
 } // namespace cfl
 
@@ -0,0 +1,296 @@
+#ifndef __cflCalibration_hpp__
+#define __cflCalibration_hpp__
+
+/**
+ * @file Calibration.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Calibration of models to the prices of liquid options.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/BlackModel.hpp"
+#include "cfl/Data.hpp"
+#include "cfl/HullWhiteModel.hpp"
+#include <valarray>
+#include <vector>
+
+namespace cfl
+{
+/**
+ * @ingroup cflModel
+ *
+ * @defgroup cflCalibration Calibration of models.
+ *
+ * This module contains the calibration of the parameters of models
+ * to the market prices of liquid options. The options are priced in
+ * closed form and the Jacobians of the prices with respect to the
+ * parameters are computed analytically. Neither event times nor
+ * slices are built during the calibration.
+ *
+ * @see cflAnalytic, cflLeastSquares
+ * @{
+ */
+
+namespace HullWhite
+{
+/**
+ * @brief The basket of caps and swaptions for the calibration of
+ * Hull-White model.
+ *
+ * Every cap and swaption is an option on a coupon bond or a
+ * portfolio of such options. By the decomposition of Jamshidian, the
+ * price of the option with maturity \f$T\f$ in Hull-White model with
+ * the constant mean-reversion rate \f$\lambda\f$ depends only on
+ * \f$\lambda\f$ and on the variance of the state process at \f$T\f$:
+ * \f[
+ *  Q(T) = \int_{t_0}^T \sigma^2(t) e^{2\lambda (t-t_0)} dt,
+ * \f]
+ * where \f$\sigma(t)\f$ is the short-term volatility. The basket keeps
+ * the discount factors and the payments of all options in contiguous
+ * arrays, and the whole basket is priced in one sweep. The derivatives
+ * of the prices with respect to the volatilities of the discount bonds
+ * are given by Black's vegas with the strikes of Jamshidian held
+ * fixed; this is exact for one-factor models.
+ *
+ * @see cfl::NAnalytic::cap, cfl::NAnalytic::swaption
+ */
+class Basket
+{
+public:
+  /**
+   * Constructs the empty basket.
+   *
+   * @param rDiscount The initial discount curve.
+   * @param dInitialTime The initial time as year fraction.
+   */
+  Basket (const Function &rDiscount, double dInitialTime);
+
+  /**
+   * Adds the quote of the interest rate cap. The first period starts
+   * at the initial time.
+   *
+   * @param rCap The parameters of the cap.
+   * @param dPrice The market price of the cap.
+   * @param dWeight The weight of the quote in the least-squares fit.
+   */
+  void addCap (const cfl::Data::CashFlow &rCap, double dPrice,
+               double dWeight = 1.);
+
+  /**
+   * Adds the quote of the European swaption. The underlying swap
+   * starts at the maturity of the option.
+   *
+   * @param rSwap The parameters of the underlying swap.
+   * @param dMaturity The maturity of the option.
+   * @param dPrice The market price of the swaption.
+   * @param dWeight The weight of the quote in the least-squares fit.
+   */
+  void addSwaption (const cfl::Data::Swap &rSwap, double dMaturity,
+                    double dPrice, double dWeight = 1.);
+
+  /**
+   * Returns the number of quotes in the basket.
+   *
+   * @return The number of quotes.
+   */
+  unsigned size () const;
+
+  /**
+   * Computes the prices of all instruments of the basket in
+   * Hull-White model. The data should have the discount curve of the
+   * basket.
+   *
+   * @param rData The parameters of Hull-White model.
+   * @return The prices of the instruments in the order of quotes.
+   */
+  std::valarray<double> price (const HullWhite::Data &rData) const;
+
+  /**
+   * Calibrates the short-term volatility \f$\sigma\f$ and the
+   * mean-reversion rate \f$\lambda\f$ to the quotes by
+   * Levenberg-Marquardt algorithm. The objective is the weighted sum
+   * of squared pricing errors. The volatility is fitted in the
+   * logarithmic scale and all instruments are repriced in parallel at
+   * every step.
+   *
+   * @param rSigma On entry, the initial guess for \f$\sigma>0\f$; on
+   * exit, the calibrated value.
+   * @param rLambda On entry, the initial guess for \f$\lambda\f$; on
+   * exit, the calibrated value.
+   * @param dErr The relative error of the objective.
+   * @return The calibrated parameters of Hull-White model.
+   */
+  HullWhite::Data calibrate (double &rSigma, double &rLambda,
+                             double dErr = 1E-12) const;
+
+  /**
+   * Calibrates the piecewise constant short-term volatility for the
+   * given mean-reversion rate \f$\lambda\f$. The basket contains only
+   * swaptions. The volatility is constant between consecutive
+   * maturities of the swaptions and after the last maturity. For every
+   * maturity the variance \f$Q(T)\f$ of the state process is the root
+   * of the weighted sum of pricing errors of the swaptions with this
+   * maturity. These equations are independent and are solved in
+   * parallel by Newton method safeguarded by bisection. The
+   * volatilities are then recovered from the increments of \f$Q\f$.
+   *
+   * @param dLambda The mean-reversion rate \f$\lambda\f$.
+   * @param dErr The relative error of the standard deviation of the
+   * state process.
+   * @return The calibrated parameters of Hull-White model.
+   */
+  HullWhite::Data bootstrap (double dLambda, double dErr = 1E-12) const;
+
+private:
+  // prices the options [iBegin, iEnd) for the volatilities rV of the
+  // payments; rY holds the exercise boundaries of Jamshidian and is
+  // used as the warm start, rVega gets the vegas of the payments
+  void options (const std::vector<double> &rV, std::vector<double> &rY,
+                std::vector<double> &rPrice, std::vector<double> &rVega,
+                unsigned iBegin, unsigned iEnd) const;
+
+  // the prices of the quotes from the prices of the options
+  std::valarray<double> quotes (const std::vector<double> &rPrice) const;
+
+  Function m_uDiscount;
+  double m_dInitialTime;
+  // the options: maturity, discount factor for the maturity, strike,
+  // type and the range of payments
+  std::vector<double> m_uMaturity, m_uDiscountT, m_uStrike;
+  std::vector<bool> m_uCall;
+  std::vector<unsigned> m_uFirstPay;
+  // the payments: time and forward value at the maturity of the
+  // option
+  std::vector<double> m_uPayTime, m_uForward;
+  // the quotes: price, weight and the range of options
+  std::vector<double> m_uQuote, m_uWeight;
+  std::vector<unsigned> m_uFirstOption;
+};
+} // namespace HullWhite
+
+namespace Black
+{
+/**
+ * @brief The basket of European options on a single asset for the
+ * calibration of Black model.
+ *
+ * The price of the option with maturity \f$T\f$ in Black model is
+ * given by Black formula with the total variance
+ * \f[
+ *  V(T) = A^2(T) \Sigma^2(T) (T-t_0),
+ * \f]
+ * where \f$A\f$ is the shape and \f$\Sigma\f$ is the average
+ * normalized volatility. The basket keeps the discount factors and
+ * the forward prices for all maturities, and the derivatives of the
+ * prices with respect to the parameters are computed from the vegas
+ * of Black formula. The calibrated parameters can be validated by the
+ * prices of the options in the lattice of cfl::Black::model.
+ */
+class Basket
+{
+public:
+  /**
+   * Constructs the empty basket.
+   *
+   * @param rDiscount The initial discount curve.
+   * @param rForward The initial forward curve.
+   * @param dInitialTime The initial time as year fraction.
+   */
+  Basket (const Function &rDiscount, const Function &rForward,
+          double dInitialTime);
+
+  /**
+   * Adds the quote of the European option.
+   *
+   * @param dStrike The strike of the option.
+   * @param dMaturity The maturity of the option.
+   * @param bCall If \p true, then the option is a call; otherwise
+   * it is a put.
+   * @param dPrice The market price of the option.
+   * @param dWeight The weight of the quote in the least-squares fit.
+   */
+  void addOption (double dStrike, double dMaturity, bool bCall,
+                  double dPrice, double dWeight = 1.);
+
+  /**
+   * Returns the number of quotes in the basket.
+   *
+   * @return The number of quotes.
+   */
+  unsigned size () const;
+
+  /**
+   * Computes the prices of all options of the basket in Black model
+   * by Black formula. The data should have the discount and forward
+   * curves of the basket.
+   *
+   * @param rData The parameters of Black model.
+   * @return The prices of the options in the order of quotes.
+   */
+  std::valarray<double> price (const Black::Data &rData) const;
+
+  /**
+   * Calibrates the spot volatility \f$\kappa\f$ and the
+   * mean-reversion rate \f$\lambda\f$ of the stationary Black model
+   * to the quotes by Levenberg-Marquardt algorithm. The implied
+   * volatility for the maturity \f$T\f$ is
+   * \f[
+   *  \kappa \sqrt{\frac{1 - e^{-2\lambda(T-t_0)}}{2\lambda(T-t_0)}}.
+   * \f]
+   * The objective is the weighted sum of squared pricing errors. The
+   * spot volatility is fitted in the logarithmic scale and all options
+   * are repriced in parallel at every step.
+   *
+   * @param rKappa On entry, the initial guess for \f$\kappa>0\f$; on
+   * exit, the calibrated value.
+   * @param rLambda On entry, the initial guess for \f$\lambda\f$; on
+   * exit, the calibrated value. If \f$\lambda=0\f$, then the
+   * volatility is constant.
+   * @param dErr The relative error of the objective.
+   * @return The calibrated parameters of Black model.
+   *
+   * @see cfl::Black::makeData
+   */
+  Black::Data calibrate (double &rKappa, double &rLambda,
+                         double dErr = 1E-12) const;
+
+  /**
+   * Calibrates the piecewise linear total variance \f$\Sigma^2(T)
+   * (T-t_0)\f$ of the classical Black model. The volatility is
+   * constant between consecutive maturities of the options and after
+   * the last maturity. For every maturity the total variance is the
+   * root of the weighted sum of pricing errors of the options with
+   * this maturity. These equations are independent and are solved in
+   * parallel by Newton method safeguarded by bisection.
+   *
+   * @param dErr The relative error of the implied volatilities.
+   * @return The calibrated parameters of Black model.
+   */
+  Black::Data bootstrap (double dErr = 1E-12) const;
+
+private:
+  // prices the options [iBegin, iEnd) for the total variances rV and
+  // writes the derivatives in the total variances to rVega
+  void options (const std::vector<double> &rV, std::vector<double> &rPrice,
+                std::vector<double> &rVega, unsigned iBegin,
+                unsigned iEnd) const;
+
+  Function m_uDiscount, m_uForward;
+  double m_dInitialTime;
+  // the options: maturity, discount factor, forward price, strike and
+  // type
+  std::vector<double> m_uMaturity, m_uDiscountT, m_uForwardT, m_uStrike;
+  std::vector<bool> m_uCall;
+  // the quotes: price and weight
+  std::vector<double> m_uQuote, m_uWeight;
+};
+} // namespace Black
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iCalibration.hpp"
+#endif // of __cflCalibration_hpp__
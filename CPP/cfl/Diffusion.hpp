@@ -0,0 +1,108 @@
+#ifndef __cflDiffusion_hpp__
+#define __cflDiffusion_hpp__
+
+/**
+ * @file Diffusion.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Financial model driven by one-dimensional diffusion.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "Ind.hpp"
+#include "Interp.hpp"
+#include "Slice.hpp"
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflDiffusion Basic model with one-dimensional diffusion.
+ *
+ * This module contains implementation of the basic financial model
+ * where the state process is a one-dimensional diffusion
+ * \f[
+ * dX_t = \mu(t,X_t) dt + \sigma(t,X_t) dW_t
+ * \f]
+ * and the values are discounted at the rate \f$r(t,X_t)\f$. The
+ * rollback solves the backward equation
+ * \f[
+ * \frac{\partial V}{\partial t} + \mu \frac{\partial V}{\partial x} +
+ * \frac12 \sigma^2 \frac{\partial^2 V}{\partial x^2} - r V = 0
+ * \f]
+ * by the theta scheme on a uniform grid. The interval between two
+ * event times is divided into time steps and the coefficients are
+ * evaluated at the middle of every step; the tridiagonal operators
+ * and their factorizations are computed on the first rollback over
+ * the interval and reused afterwards. The first
+ * time steps of every rollback are replaced by implicit half-steps
+ * (Rannacher smoothing) to damp the oscillations caused by the
+ * discontinuities of payoffs.
+ *
+ * The rollbacks of different slices are independent and can run in
+ * parallel. The interpolation of a payoff covers the grid of the
+ * state process and has three components: the value, delta and gamma
+ * with respect to the state process. The volatility of the diffusion
+ * depends on the state, so the model does not report vega.
+ *
+ * @{
+ */
+
+/**
+ * The coefficient of the diffusion as the function of time and of the
+ * vector of states.
+ */
+typedef std::function<std::valarray<double> (
+    double dTime, const std::valarray<double> &rState)>
+    TCoefficient;
+
+/**
+ * Returns cfl::Model representing a one-dimensional diffusion given
+ * - \a rDrift The drift \f$\mu\f$.
+ * - \a rVolatility The volatility \f$\sigma\f$.
+ * - \a rRate The discount rate \f$r\f$.
+ * - \a rVar The vector of the average variances of the state
+ *   process. It defines the width of the grid in the same way as for
+ *   cfl::TBrownian and has the same size as the vector of event
+ *   times.
+ * - \a rEventTimes The vector of event times in the model.
+ * - \a dInterval The width of the interval of initial values for
+ *   the state process.
+ */
+typedef std::function<Model (
+    const TCoefficient &rDrift, const TCoefficient &rVolatility,
+    const TCoefficient &rRate, const std::vector<double> &rVar,
+    const std::vector<double> &rEventTimes, double dInterval)>
+    TDiffusion;
+
+/**
+ * Implements the generator of the model of one-dimensional
+ * diffusion. The grid is symmetric around zero, has an odd number of
+ * nodes, and its step is \f$h = 1/q\f$, where \f$q\f$ is the step
+ * quality.
+ *
+ * @param dStepQuality The step on the grid equals 1/dStepQuality.
+ * @param dWidthQuality The width of the grid as in cfl::brownian.
+ * @param dTimeQuality The maximal time step equals 1/dTimeQuality.
+ * @param dTheta The parameter of the theta scheme: 0.5 for
+ * Crank-Nicolson, 1 for the implicit scheme.
+ * @param iImplicitSteps The number of steps at the beginning of every
+ * rollback that are replaced by two implicit half-steps.
+ * @param rInd A numerically efficient implementation of
+ * discontinuous functions.
+ * @param rInterp An implementation of numerical interpolation.
+ * @return The constructor of the model of diffusion.
+ */
+TDiffusion diffusion (double dStepQuality, double dWidthQuality,
+                      double dTimeQuality, double dTheta = 0.5,
+                      unsigned iImplicitSteps = 2,
+                      const Ind &rInd = cfl::NInd::linear (),
+                      const Interp &rInterp = cfl::NInterp::cspline ());
+/** @} */
+} // namespace cfl
+
+#endif // of __cflDiffusion_hpp__
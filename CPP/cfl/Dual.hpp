@@ -0,0 +1,720 @@
+#ifndef __cflDual_hpp__
+#define __cflDual_hpp__
+
+/**
+ * @file Dual.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Forward-mode sensitivities of numbers, functions, and payoffs.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Slice.hpp"
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflDual Forward-mode sensitivities.
+ *
+ * This module contains dual numbers, functions, and payoffs. Along
+ * with the value, they carry the derivatives (tangents) with respect
+ * to a fixed set of parameters. All first order sensitivities of a
+ * price are computed in one backward induction.
+ *
+ * An object without tangents is treated as a constant with respect to
+ * all parameters.
+ * @{
+ */
+
+/**
+ * @brief A number with derivatives with respect to parameters.
+ *
+ * @see DualFunction, DualSlice
+ */
+class Dual
+{
+public:
+  /**
+   * Constructs a constant number.
+   *
+   * @param dValue The value.
+   * @param iParameters The number of parameters.
+   */
+  explicit Dual (double dValue = 0., unsigned iParameters = 0);
+
+  /**
+   * Constructs the number with the given derivatives.
+   *
+   * @param dValue The value.
+   * @param rTangent The derivatives with respect to the parameters.
+   */
+  Dual (double dValue, const std::valarray<double> &rTangent);
+
+  /**
+   * Constructs the parameter with index \p iParameter. Its derivative
+   * with respect to itself is one, other derivatives are zero.
+   *
+   * @param dValue The value of the parameter.
+   * @param iParameters The number of parameters.
+   * @param iParameter The index of the parameter.
+   */
+  Dual (double dValue, unsigned iParameters, unsigned iParameter);
+
+  /**
+   * Returns the value.
+   *
+   * @return The value of the number.
+   */
+  double value () const;
+
+  /**
+   * Returns the derivatives with respect to the parameters.
+   *
+   * @return The derivatives of the number.
+   */
+  const std::valarray<double> &tangent () const;
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rDual.
+   *
+   * @param rDual A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  Dual &operator+= (const Dual &rDual);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rDual.
+   *
+   * @param rDual A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  Dual &operator-= (const Dual &rDual);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rDual.
+   *
+   * @param rDual A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  Dual &operator*= (const Dual &rDual);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rDual.
+   *
+   * @param rDual A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  Dual &operator/= (const Dual &rDual);
+
+private:
+  double m_dValue;
+  std::valarray<double> m_uTangent;
+};
+
+/**
+ * Returns the sum of \p rX and \p rY.
+ *
+ * @param rX A number with derivatives.
+ * @param rY A number with derivatives.
+ * @return The sum of \p rX and \p rY.
+ */
+Dual operator+ (const Dual &rX, const Dual &rY);
+
+/**
+ * Returns the difference of \p rX and \p rY.
+ *
+ * @param rX A number with derivatives.
+ * @param rY A number with derivatives.
+ * @return The difference of \p rX and \p rY.
+ */
+Dual operator- (const Dual &rX, const Dual &rY);
+
+/**
+ * Returns the product of \p rX and \p rY.
+ *
+ * @param rX A number with derivatives.
+ * @param rY A number with derivatives.
+ * @return The product of \p rX and \p rY.
+ */
+Dual operator* (const Dual &rX, const Dual &rY);
+
+/**
+ * Returns the ratio of \p rX and \p rY.
+ *
+ * @param rX A number with derivatives.
+ * @param rY A number with derivatives.
+ * @return The ratio of \p rX and \p rY.
+ */
+Dual operator/ (const Dual &rX, const Dual &rY);
+
+/**
+ * Returns the exponent of \p rX.
+ *
+ * @param rX A number with derivatives.
+ * @return The exponent of \p rX.
+ */
+Dual exp (const Dual &rX);
+
+/**
+ * Returns the logarithm of \p rX.
+ *
+ * @param rX A number with derivatives.
+ * @return The logarithm of \p rX.
+ */
+Dual log (const Dual &rX);
+
+/**
+ * Returns \p rX in the power \p dPower.
+ *
+ * @param rX A number with derivatives.
+ * @param dPower The power.
+ * @return The number given by <code> rX^dPower </code>.
+ */
+Dual pow (const Dual &rX, double dPower);
+
+/**
+ * Returns the square root of \p rX.
+ *
+ * @param rX A number with derivatives.
+ * @return The square root of \p rX.
+ */
+Dual sqrt (const Dual &rX);
+
+/**
+ * @brief A one-dimensional function with derivatives with respect to
+ * parameters.
+ *
+ * A typical example is a discount curve whose derivatives with
+ * respect to the input yields are known in closed form.
+ *
+ * @see Dual, DualSlice
+ */
+class DualFunction
+{
+public:
+  /**
+   * Constructs a function which does not depend on the parameters.
+   *
+   * @param rValue The function.
+   */
+  explicit DualFunction (const Function &rValue = Function ());
+
+  /**
+   * Constructs the function with the given derivatives.
+   *
+   * @param rValue The function.
+   * @param rTangent The derivatives of the function with respect to
+   * the parameters.
+   */
+  DualFunction (const Function &rValue, const std::vector<Function> &rTangent);
+
+  /**
+   * Returns the value and the derivatives at \p dX.
+   *
+   * @param dX The argument.
+   * @return The value of the function and its derivatives with
+   * respect to the parameters at \p dX.
+   */
+  Dual operator() (double dX) const;
+
+  /**
+   * Returns the function.
+   *
+   * @return The value component of \p *this.
+   */
+  const Function &value () const;
+
+  /**
+   * Returns the derivatives with respect to the parameters.
+   *
+   * @return The derivatives of the function.
+   */
+  const std::vector<Function> &tangent () const;
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rF.
+   *
+   * @param rF A function with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualFunction &operator+= (const DualFunction &rF);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rF.
+   *
+   * @param rF A function with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualFunction &operator-= (const DualFunction &rF);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rF.
+   *
+   * @param rF A function with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualFunction &operator*= (const DualFunction &rF);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rF.
+   *
+   * @param rF A function with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualFunction &operator/= (const DualFunction &rF);
+
+private:
+  Function m_uValue;
+  std::vector<Function> m_uTangent;
+};
+
+/**
+ * Returns the sum of \p rF and \p rG.
+ *
+ * @param rF A function with derivatives.
+ * @param rG A function with derivatives.
+ * @return The sum of \p rF and \p rG.
+ */
+DualFunction operator+ (const DualFunction &rF, const DualFunction &rG);
+
+/**
+ * Returns the difference of \p rF and \p rG.
+ *
+ * @param rF A function with derivatives.
+ * @param rG A function with derivatives.
+ * @return The difference of \p rF and \p rG.
+ */
+DualFunction operator- (const DualFunction &rF, const DualFunction &rG);
+
+/**
+ * Returns the product of \p rF and \p rG.
+ *
+ * @param rF A function with derivatives.
+ * @param rG A function with derivatives.
+ * @return The product of \p rF and \p rG.
+ */
+DualFunction operator* (const DualFunction &rF, const DualFunction &rG);
+
+/**
+ * Returns the ratio of \p rF and \p rG.
+ *
+ * @param rF A function with derivatives.
+ * @param rG A function with derivatives.
+ * @return The ratio of \p rF and \p rG.
+ */
+DualFunction operator/ (const DualFunction &rF, const DualFunction &rG);
+
+/**
+ * Returns the exponent of \p rF.
+ *
+ * @param rF A function with derivatives.
+ * @return The exponent of \p rF.
+ */
+DualFunction exp (const DualFunction &rF);
+
+/**
+ * Returns the logarithm of \p rF.
+ *
+ * @param rF A function with derivatives.
+ * @return The logarithm of \p rF.
+ */
+DualFunction log (const DualFunction &rF);
+
+/**
+ * Returns \p rF in the power \p dPower.
+ *
+ * @param rF A function with derivatives.
+ * @param dPower The power.
+ * @return The function given by <code> rF^dPower </code>.
+ */
+DualFunction pow (const DualFunction &rF, double dPower);
+
+/**
+ * @brief A payoff with derivatives with respect to parameters.
+ *
+ * The value and the derivatives are represented by Slice objects
+ * defined on the same model and at the same event time. Because
+ * rollback is linear, the derivatives are rolled back together with
+ * the value. The sensitivities with respect to parameters of the
+ * model itself (such as volatility) are not covered.
+ *
+ * @see Dual, Slice
+ */
+class DualSlice
+{
+public:
+  /**
+   * Constructs a payoff which does not depend on the parameters.
+   *
+   * @param rValue The payoff.
+   */
+  explicit DualSlice (const Slice &rValue = Slice ());
+
+  /**
+   * Constructs the payoff with the given derivatives.
+   *
+   * @param rValue The payoff.
+   * @param rTangent The derivatives of the payoff with respect to
+   * the parameters. They have the same model and event time as \p
+   * rValue.
+   */
+  DualSlice (const Slice &rValue, const std::vector<Slice> &rTangent);
+
+  /**
+   * Constructs the constant payoff at the given event time.
+   *
+   * @param rModel The reference to an implementation of IModel.
+   * @param iEventTime The index of the event time.
+   * @param rValue The constant value and its derivatives.
+   */
+  DualSlice (const IModel &rModel, unsigned iEventTime, const Dual &rValue);
+
+  /**
+   * Returns the payoff.
+   *
+   * @return The value component of \p *this.
+   */
+  const Slice &value () const;
+
+  /**
+   * Returns the derivatives with respect to the parameters.
+   *
+   * @return The derivatives of the payoff.
+   */
+  const std::vector<Slice> &tangent () const;
+
+  /**
+   * Returns the index of the event time.
+   *
+   * @return The index of the event time.
+   */
+  unsigned timeIndex () const;
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator+= (const DualSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator-= (const DualSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator*= (const DualSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator/= (const DualSlice &rSlice);
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff which does not depend on the parameters.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator+= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff which does not depend on the parameters.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator-= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff which does not depend on the parameters.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator*= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rSlice.
+   *
+   * @param rSlice A payoff which does not depend on the parameters.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator/= (const Slice &rSlice);
+
+  /**
+   * Replaces \p *this with the sum of \p *this and \p rValue.
+   *
+   * @param rValue A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator+= (const Dual &rValue);
+
+  /**
+   * Replaces \p *this with the difference of \p *this and \p rValue.
+   *
+   * @param rValue A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator-= (const Dual &rValue);
+
+  /**
+   * Replaces \p *this with the product of \p *this and \p rValue.
+   *
+   * @param rValue A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator*= (const Dual &rValue);
+
+  /**
+   * Replaces \p *this with the ratio of \p *this and \p rValue.
+   *
+   * @param rValue A number with derivatives.
+   * @return Reference to \p *this.
+   */
+  DualSlice &operator/= (const Dual &rValue);
+
+  /**
+   * Replaces \p *this with its equivalent value at the event time
+   * with index \p iEventTime. The value and the derivatives are
+   * rolled back together.
+   *
+   * @param iEventTime The index of the target event time.
+   */
+  void rollback (unsigned iEventTime);
+
+private:
+  Slice m_uValue;
+  std::vector<Slice> m_uTangent;
+};
+
+/**
+ * Returns minus \p rSlice.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return Minus \p rSlice.
+ */
+DualSlice operator- (const DualSlice &rSlice);
+
+/**
+ * Returns the sum of \p rX and \p rY. One of the arguments can be
+ * Slice, Dual, or double.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The sum of \p rX and \p rY.
+ */
+DualSlice operator+ (const DualSlice &rX, const DualSlice &rY);
+
+/**
+ * Returns the difference of \p rX and \p rY. One of the arguments
+ * can be Slice, Dual, or double.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The difference of \p rX and \p rY.
+ */
+DualSlice operator- (const DualSlice &rX, const DualSlice &rY);
+
+/**
+ * Returns the product of \p rX and \p rY. One of the arguments can
+ * be Slice, Dual, or double.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The product of \p rX and \p rY.
+ */
+DualSlice operator* (const DualSlice &rX, const DualSlice &rY);
+
+/**
+ * Returns the ratio of \p rX and \p rY. One of the arguments can be
+ * Slice, Dual, or double.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The ratio of \p rX and \p rY.
+ */
+DualSlice operator/ (const DualSlice &rX, const DualSlice &rY);
+
+/** @cond */
+DualSlice operator+ (const DualSlice &rX, const Slice &rY);
+DualSlice operator+ (const Slice &rX, const DualSlice &rY);
+DualSlice operator+ (const DualSlice &rX, const Dual &rY);
+DualSlice operator+ (const Dual &rX, const DualSlice &rY);
+DualSlice operator+ (const DualSlice &rX, double dY);
+DualSlice operator+ (double dX, const DualSlice &rY);
+DualSlice operator- (const DualSlice &rX, const Slice &rY);
+DualSlice operator- (const Slice &rX, const DualSlice &rY);
+DualSlice operator- (const DualSlice &rX, const Dual &rY);
+DualSlice operator- (const Dual &rX, const DualSlice &rY);
+DualSlice operator- (const DualSlice &rX, double dY);
+DualSlice operator- (double dX, const DualSlice &rY);
+DualSlice operator* (const DualSlice &rX, const Slice &rY);
+DualSlice operator* (const Slice &rX, const DualSlice &rY);
+DualSlice operator* (const DualSlice &rX, const Dual &rY);
+DualSlice operator* (const Dual &rX, const DualSlice &rY);
+DualSlice operator* (const DualSlice &rX, double dY);
+DualSlice operator* (double dX, const DualSlice &rY);
+DualSlice operator/ (const DualSlice &rX, const Slice &rY);
+DualSlice operator/ (const Slice &rX, const DualSlice &rY);
+DualSlice operator/ (const DualSlice &rX, const Dual &rY);
+DualSlice operator/ (const Dual &rX, const DualSlice &rY);
+DualSlice operator/ (const DualSlice &rX, double dY);
+DualSlice operator/ (double dX, const DualSlice &rY);
+/** @endcond */
+
+/**
+ * Returns the maximum of \p rSlice and \p dValue. The derivatives
+ * are taken from \p rSlice on the event where it exceeds \p dValue.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param dValue A number.
+ * @return The maximum of \p rSlice and \p dValue.
+ */
+DualSlice max (const DualSlice &rSlice, double dValue);
+
+/**
+ * Returns the minimum of \p rSlice and \p dValue.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param dValue A number.
+ * @return The minimum of \p rSlice and \p dValue.
+ */
+DualSlice min (const DualSlice &rSlice, double dValue);
+
+/**
+ * Returns the maximum of \p rX and \p rY.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The maximum of \p rX and \p rY.
+ */
+DualSlice max (const DualSlice &rX, const DualSlice &rY);
+
+/**
+ * Returns the minimum of \p rX and \p rY.
+ *
+ * @param rX A payoff with derivatives.
+ * @param rY A payoff with derivatives.
+ * @return The minimum of \p rX and \p rY.
+ */
+DualSlice min (const DualSlice &rX, const DualSlice &rY);
+
+/**
+ * Returns the exponent of \p rSlice.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return The exponent of \p rSlice.
+ */
+DualSlice exp (const DualSlice &rSlice);
+
+/**
+ * Returns the logarithm of \p rSlice.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return The logarithm of \p rSlice.
+ */
+DualSlice log (const DualSlice &rSlice);
+
+/**
+ * Returns \p rSlice in the power \p dPower.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param dPower The power.
+ * @return The payoff given by <code> rSlice^dPower </code>.
+ */
+DualSlice pow (const DualSlice &rSlice, double dPower);
+
+/**
+ * Returns the square root of \p rSlice.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return The square root of \p rSlice.
+ */
+DualSlice sqrt (const DualSlice &rSlice);
+
+/**
+ * Returns the indicator of the event: \p rSlice is greater than \p
+ * rBarrier. The value is computed by the model. The derivatives are
+ * the directional derivatives of the smoothed indicator of the model
+ * in the direction of the tangents of \p rSlice and \p rBarrier.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param rBarrier The lower barrier.
+ * @return The indicator <code> I(rSlice > rBarrier) </code>.
+ */
+DualSlice indicator (const DualSlice &rSlice, const DualSlice &rBarrier);
+
+/**
+ * Returns the indicator of the event: \p rSlice is greater than \p
+ * dBarrier.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param dBarrier The lower barrier.
+ * @return The indicator <code> I(rSlice > dBarrier) </code>.
+ */
+DualSlice indicator (const DualSlice &rSlice, double dBarrier);
+
+/**
+ * Returns the indicator of the event: \p dBarrier is greater than \p
+ * rSlice.
+ *
+ * @param dBarrier The upper barrier.
+ * @param rSlice A payoff with derivatives.
+ * @return The indicator <code> I(dBarrier > rSlice) </code>.
+ */
+DualSlice indicator (double dBarrier, const DualSlice &rSlice);
+
+/**
+ * Returns the equivalent value of \p rSlice at the event time with
+ * index \p iEventTime.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @param iEventTime The index of the target event time.
+ * @return The price of \p rSlice and its derivatives at the event
+ * time with index \p iEventTime.
+ */
+DualSlice rollback (const DualSlice &rSlice, unsigned iEventTime);
+
+/**
+ * Returns the explicit dependence of \p rSlice on the state
+ * processes. The first coordinate is the value, the others are the
+ * derivatives with respect to the parameters.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return The interpolation of the value of \p rSlice and its
+ * derivatives.
+ */
+MultiFunction interpolate (const DualSlice &rSlice);
+
+/**
+ * Returns the value and the derivatives of \p rSlice at the initial
+ * values of state processes.
+ *
+ * @param rSlice A payoff with derivatives.
+ * @return The value of \p rSlice at the origin followed by its
+ * derivatives with respect to the parameters.
+ */
+std::valarray<double> atOrigin (const DualSlice &rSlice);
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iDual.hpp"
+#endif // of __cflDual_hpp__
@@ -0,0 +1,141 @@
+#ifndef __cflExercise_hpp__
+#define __cflExercise_hpp__
+
+/**
+ * @file Exercise.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Exercise regions of options with early exercise.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Slice.hpp"
+#include <utility>
+#include <vector>
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflExercise Exercise regions.
+ *
+ * This module contains the record of the exercise decisions made in
+ * the backward induction for options with early exercise.
+ * @{
+ */
+
+/**
+ * @brief The exercise region of an option with early exercise.
+ *
+ * The object replaces <code>max(rHold, rExercise)</code> in the
+ * backward induction. In the recording mode it computes the maximum
+ * and keeps, for every event time, the intervals of the nodes where
+ * the exercise is strictly better than the continuation. For payoffs
+ * depending on one state process the corresponding intervals of the
+ * state are kept as well.
+ *
+ * In the replay mode the recorded decisions are applied to new
+ * continuation and exercise values: the result equals \p rExercise
+ * inside of the exercise region and \p rHold outside. By the
+ * envelope theorem, the changes of the price under small
+ * perturbations of the model are the same to the first order as for
+ * the optimal exercise, but the price is a smooth function of the
+ * perturbation. The replay is used for bumped reprices and the
+ * recorded region gives an exercise policy for Monte Carlo
+ * simulation.
+ *
+ * @see MonteCarlo::american
+ */
+class Exercise
+{
+public:
+  /**
+   * Constructs the empty exercise region in the recording mode.
+   */
+  Exercise ();
+
+  /**
+   * Returns the maximum of \p rHold and \p rExercise in the recording
+   * mode and applies the recorded exercise decisions in the replay
+   * mode. In the recording mode, the exercise region at the event
+   * time of the arguments is replaced. In the replay mode, the event
+   * times of the model should be the same as in the recording.
+   *
+   * @param rHold The value of continuation.
+   * @param rExercise The value of exercise.
+   * @return The value of the option at the event time.
+   */
+  Slice max (const Slice &rHold, const Slice &rExercise);
+
+  /**
+   * Sets the mode of the object.
+   *
+   * @param bReplay If \p true, then the recorded exercise region is
+   * replayed; otherwise, it is recorded.
+   */
+  void replay (bool bReplay = true);
+
+  /**
+   * Returns the mode of the object.
+   *
+   * @return \p true in the replay mode, \p false in the recording
+   * mode.
+   */
+  bool isReplay () const;
+
+  /**
+   * Returns the event times of the model in which the region has been
+   * recorded.
+   *
+   * @return The vector of event times.
+   */
+  const std::vector<double> &eventTimes () const;
+
+  /**
+   * Returns the intervals \f$[i_k, j_k)\f$ of the indexes of the nodes
+   * where the option is exercised at the event time with index \p
+   * iEventTime. The vector is empty if the option is not exercised or
+   * if the region has not been recorded.
+   *
+   * @param iEventTime The index of an event time.
+   * @return The increasing vector of disjoint intervals of nodes.
+   */
+  const std::vector<std::pair<unsigned, unsigned> > &
+  nodes (unsigned iEventTime) const;
+
+  /**
+   * Returns the indicator of the exercise region at the event time
+   * with index \p iEventTime as the function of the state process. The
+   * region should be recorded for a payoff that depends on at most one
+   * state process. The boundaries of the region are the midpoints
+   * between the nodes.
+   *
+   * @param iEventTime The index of an event time.
+   * @param rState The values of the state process.
+   * @return The indicators of the exercise for \p rState.
+   */
+  std::valarray<bool> exercise (unsigned iEventTime,
+                                const std::valarray<double> &rState) const;
+
+private:
+  struct Region
+  {
+    unsigned iSize = 0;
+    bool bState = false;
+    std::vector<std::pair<unsigned, unsigned> > uNodes;
+    std::vector<std::pair<double, double> > uStates;
+  };
+
+  bool m_bReplay;
+  std::vector<double> m_uEventTimes;
+  std::vector<Region> m_uRegion;
+};
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iExercise.hpp"
+#endif // of __cflExercise_hpp__
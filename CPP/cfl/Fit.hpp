@@ -57,6 +57,45 @@ struct FitParam
   double chi2;
 };
 
+/**
+ * @brief The results of a batch of least-squares fits.
+ *
+ * The coefficients of all fits are kept in one array, without
+ * constructing the fitted functions.
+ *
+ * @see Fit::batch()
+ */
+struct FitBatch
+{
+  /**
+   * The dates (keys) of the fits in increasing order of their
+   * appearance in the data.
+   *
+   */
+  std::valarray<double> date;
+
+  /**
+   * The fitted coefficients. The storage is row based: the
+   * coefficient \p j of the fit \p k has index
+   * <code>k*size + j</code>. The coefficients of the fits that have
+   * failed are NaN.
+   *
+   */
+  std::valarray<double> fit;
+
+  /**
+   * The total errors of the fits. The error of a failed fit is NaN.
+   *
+   */
+  std::valarray<double> chi2;
+
+  /**
+   * The number of fitted coefficients in every fit.
+   *
+   */
+  unsigned size;
+};
+
 /**
  * @brief The interface class for one-dimensional fitting.
  *
@@ -91,6 +130,54 @@ public:
                            const std::vector<double> &rW,
                            bool bChi2) const = 0;
 
+  /**
+   * Fits the vectors of arguments, values, and weights in place and
+   * returns the parameters of the fit. The buffers of the object are
+   * reused, which saves the allocations when many data sets of the
+   * same size are fitted in turn. After an exception the object can
+   * only be fitted again. The default implementation creates a new
+   * object by newObject().
+   *
+   * @param rArg The strictly increasing vector of arguments of
+   * the fitted function.
+   * @param rVal The vector of values of the fitted function.
+   * @param rW The vector of fitting weights.
+   * @param bChi2 If \p true, then the normalizing standard
+   * deviation \f$\kappa\f$ is obtained by the \f$\chi^2\f$ estimate.
+   * Otherwise, \f$\kappa=1\f$.
+   * @return The fitted coefficients, their covariance matrix, and
+   * the total \f$\chi^2\f$ error.
+   */
+  virtual FitParam refit (const std::vector<double> &rArg,
+                          const std::vector<double> &rVal,
+                          const std::vector<double> &rW, bool bChi2);
+
+  /**
+   * Returns a pointer to a new implementation of IFit where the node
+   * \p dArg with the value \p dVal and the weight \p dWt is added to
+   * the fitted data. The default implementation throws the exception
+   * NError::range.
+   *
+   * @param dArg The argument of the new node.
+   * @param dVal The value of the fitted function at \p dArg.
+   * @param dWt The fitting weight of the node.
+   * @return The pointer to a new implementation of IFit.
+   */
+  virtual IFit *update (double dArg, double dVal, double dWt) const;
+
+  /**
+   * Returns a pointer to a new implementation of IFit where the node
+   * \p dArg with the value \p dVal and the weight \p dWt is removed
+   * from the fitted data. The node has been fitted before. The default
+   * implementation throws the exception NError::range.
+   *
+   * @param dArg The argument of the removed node.
+   * @param dVal The value of the fitted function at \p dArg.
+   * @param dWt The fitting weight of the node.
+   * @return The pointer to a new implementation of IFit.
+   */
+  virtual IFit *remove (double dArg, double dVal, double dWt) const;
+
   /**
    * Returns the result of the fit.
    *
@@ -105,6 +192,28 @@ public:
    */
   virtual Function err () const = 0;
 
+  /**
+   * Returns the values of the fitted function at the arguments \p
+   * rArg. The default implementation evaluates the function from
+   * fit().
+   *
+   * @param rArg The vector of arguments.
+   * @return The values of the fitted function at \p rArg.
+   */
+  virtual std::valarray<double>
+  fitValues (const std::vector<double> &rArg) const;
+
+  /**
+   * Returns the values of the error of the fit at the arguments \p
+   * rArg. The default implementation evaluates the function from
+   * err().
+   *
+   * @param rArg The vector of arguments.
+   * @return The values of the error of the fit at \p rArg.
+   */
+  virtual std::valarray<double>
+  errValues (const std::vector<double> &rArg) const;
+
   /**
    * Returns the fitted coefficients, their covariance matrix,
    * and the total \f$\chi^2\f$ error.
@@ -168,6 +277,59 @@ public:
   void assign (InIt1 itArgBegin, InIt1 itArgEnd, InIt2 itValBegin,
                InIt3 itWtBegin, bool bChi2 = true);
 
+  /**
+   * Adds the node \p dArg with the value \p dVal and the weight \p
+   * dWt to the fitted data. The fit is not computed from scratch:
+   * the linear fits from NFit::linear() and NFit::linear_regression()
+   * apply a rank-one update to the QR factor of the problem in
+   * \f$O(M^2)\f$ operations, where \f$M\f$ is the number of fitted
+   * coefficients. The normalizing standard deviation is obtained as
+   * in the last call of assign(). The functions returned by fit() and
+   * err() before the update do not change.
+   *
+   * @param dArg The argument of the new node.
+   * @param dVal The value of the fitted function at \p dArg.
+   * @param dWt The fitting weight of the node.
+   */
+  void update (double dArg, double dVal, double dWt = 1.);
+
+  /**
+   * Removes the node \p dArg with the value \p dVal and the weight
+   * \p dWt from the fitted data. The node has been fitted before,
+   * either in assign() or in update(). The linear fits apply a
+   * rank-one downdate to the QR factor of the problem.
+   *
+   * @param dArg The argument of the removed node.
+   * @param dVal The value of the fitted function at \p dArg.
+   * @param dWt The fitting weight of the node.
+   */
+  void remove (double dArg, double dVal, double dWt = 1.);
+
+  /**
+   * Fits in parallel all data sets of the columnar block of
+   * observations with the scheme of this object. The observations of
+   * one data set have the same date, are contiguous, and have strictly
+   * increasing arguments. Every thread reuses its buffers for the
+   * arguments, values and weights and its fit, which is fitted again
+   * by IFit::refit(); only the coefficients and the errors are
+   * returned. A fit that throws an exception gets NaN
+   * coefficients. The state of this object does not change.
+   *
+   * @param rDate The dates (keys) of the observations.
+   * @param rArg The arguments of the observations, for example,
+   * tenors.
+   * @param rVal The values of the observations, for example, quotes.
+   * @param rWt The fitting weights of the observations.
+   * @param bChi2 If \p true, then the normalizing standard
+   * deviation \f$\kappa\f$ is obtained by the \f$\chi^2\f$ estimate.
+   * Otherwise, \f$\kappa=1\f$.
+   * @return The coefficients and the errors of the fits.
+   */
+  FitBatch batch (const std::vector<double> &rDate,
+                  const std::vector<double> &rArg,
+                  const std::vector<double> &rVal,
+                  const std::vector<double> &rWt, bool bChi2 = true) const;
+
   /**
    * @copydoc IFit::fit()
    */
@@ -178,6 +340,30 @@ public:
    */
   Function err () const;
 
+  /**
+   * Returns the values of the fitted function on the grid \p rArg.
+   * The linear fits from NFit::linear() keep the values of the basis
+   * functions on the last grids. These values are shared by all fits
+   * with the same basis, and a repeated evaluation on the same grid
+   * costs one matrix-vector product. The fits with basis splines
+   * evaluate only the non-zero basis splines.
+   *
+   * @param rArg The vector of arguments.
+   * @return The values of the fitted function at \p rArg.
+   */
+  std::valarray<double> fit (const std::vector<double> &rArg) const;
+
+  /**
+   * Returns the values of the error of the fit on the grid \p rArg.
+   * For the linear fits, the quadratic forms of the covariance matrix
+   * are computed for all arguments with the cached values of the
+   * basis functions.
+   *
+   * @param rArg The vector of arguments.
+   * @return The values of the error of the fit at \p rArg.
+   */
+  std::valarray<double> err (const std::vector<double> &rArg) const;
+
   /**
    * @copydoc IFit::param()
    */
@@ -202,7 +388,8 @@ namespace NFit
  *   f(x, \mathbf{c}) = \sum_{j=0}^{M-1} c_j g_j(x) + h(x),
  * \f]
  * where \f$\mathbf{c} = (c_0,\dots,c_{M-1})\f$ is the vector of
- * the fitting coefficients.
+ * the fitting coefficients. The arguments of the fitted function
+ * need not be ordered and may repeat, as in regressions.
  *
  * @param rBasisF The vector of basis functions
  * \f$(g_j)_{j=0,\dots,M-1}\f$.
@@ -246,7 +433,14 @@ cfl::Fit linear_regression (const cfl::Function &rBasisF,
                             const cfl::Function &rFreeF = cfl::Function (0.));
 
 /**
- * Least-squares fitting with basis splines.
+ * Least-squares fitting with basis splines. The normal equations are
+ * banded with \p iOrder diagonals and are solved by Cholesky method
+ * in linear time with respect to the number of breakpoints. Every
+ * basis spline should be supported by the arguments of the fitted
+ * function; otherwise the exception NError::size is thrown. The knots
+ * are shared by all fits obtained from this engine. The covariance
+ * matrix of the coefficients is computed only when requested by
+ * cfl::Fit::err() (its band) or cfl::Fit::param() (all of it).
  *
  * @param iOrder The order of the fitting spline.
  * @param rBreakpoints The vector of breakpoints.
@@ -265,6 +459,48 @@ cfl::Fit bspline (unsigned iOrder, const std::vector<double> &rBreakpoints);
  */
 cfl::Fit bspline (unsigned iOrder, double dL, double dR,
                   unsigned iBreakpoints);
+
+/**
+ * The nonlinear least-squares fit with Nelson-Siegel family:
+ * \f[
+ *   f(t, \mathbf{c}, \lambda) = c_0 + c_1 \frac{1 - e^{-\lambda
+ *   (t-t_0)}}{\lambda (t-t_0)} + c_2 \left(\frac{1 - e^{-\lambda
+ *   (t-t_0)}}{\lambda (t-t_0)} - e^{-\lambda (t-t_0)}\right), \quad
+ *   t\geq t_0,
+ * \f]
+ * where \f$\mathbf{c} = (c_0,c_1,c_2)\f$ and \f$\lambda>0\f$ are the
+ * fitting coefficients. For a given \f$\lambda\f$ the coefficients
+ * \f$\mathbf{c}\f$ are obtained by the linear least-squares (variable
+ * projection). The error is then minimized over \f$\lambda\f$ by
+ * Levenberg-Marquardt method with analytic derivatives, starting
+ * from a grid of initial values in parallel. The vector
+ * cfl::FitParam::fit equals \f$(c_0,c_1,c_2,\lambda)\f$; the
+ * covariance matrix and the error function are computed for the
+ * linearized problem.
+ *
+ * @param dInitialTime (\f$t_0\f$) The initial time.
+ * @return Least-squares fitting engine with Nelson-Siegel family.
+ */
+cfl::Fit nelsonSiegel (double dInitialTime);
+
+/**
+ * The nonlinear least-squares fit with Svensson family:
+ * \f[
+ *   f(t, \mathbf{c}, \lambda_1, \lambda_2) = c_0 + c_1
+ *   \Gamma_1(\lambda_1(t-t_0)) + c_2 \Gamma_2(\lambda_1(t-t_0)) + c_3
+ *   \Gamma_2(\lambda_2(t-t_0)), \quad t\geq t_0,
+ * \f]
+ * where \f$\Gamma_1(x) = (1-e^{-x})/x\f$, \f$\Gamma_2(x) =
+ * \Gamma_1(x) - e^{-x}\f$, and \f$\mathbf{c} = (c_0,\dots,c_3)\f$,
+ * \f$\lambda_1>0\f$, and \f$\lambda_2>0\f$ are the fitting
+ * coefficients. The method is the same as in nelsonSiegel(). The
+ * vector cfl::FitParam::fit equals
+ * \f$(c_0,\dots,c_3,\lambda_1,\lambda_2)\f$.
+ *
+ * @param dInitialTime (\f$t_0\f$) The initial time.
+ * @return Least-squares fitting engine with Svensson family.
+ */
+cfl::Fit svensson (double dInitialTime);
 } // namespace NFit
 /** @} */
 } // namespace cfl
@@ -79,6 +79,44 @@ std::function<unsigned (double)> size ();
  * as \f$2^n\f$.
  */
 std::function<unsigned (double)> size2 ();
+
+/**
+ * Computes the total variances of a Brownian motion at the event times
+ * from its average variances.
+ * @param rVar The vector of average variances: \p rVar[i] is the
+ * average variance between \p rEventTimes[0] and \p rEventTimes[i].
+ * @param rEventTimes The strictly increasing vector of event times.
+ * @return The strictly increasing vector of total variances.
+ */
+std::vector<double> totalVar (const std::vector<double> &rVar,
+                              const std::vector<double> &rEventTimes);
+
+/**
+ * Returns the minimal variance of a Brownian motion between two
+ * consecutive event times.
+ * @param rTotalVar The strictly increasing vector of total variances
+ * at the event times.
+ * @return The minimal increment of \p rTotalVar.
+ */
+double minVar (const std::vector<double> &rTotalVar);
+
+/**
+ * Computes the sizes of the grids of a Brownian motion at the event
+ * times. The grid with step \p dH at an event time covers the interval
+ * of initial values \p dInterval and the width given by \p rWidth for
+ * the total variance at this time.
+ * @param rTotalVar The vector of total variances at the event times.
+ * @param dH The step of the grids.
+ * @param dInterval The width of the interval of initial values.
+ * @param rWidth The width of the grid as a function of the total
+ * variance.
+ * @param rSize The round-off of the approximate size of the grid.
+ * @return The vector of the sizes of the grids.
+ */
+std::vector<unsigned> sizes (const std::vector<double> &rTotalVar, double dH,
+                             double dInterval,
+                             const std::function<double (double)> &rWidth,
+                             const std::function<unsigned (double)> &rSize);
 }
 /** @} */
 } // namespace cfl
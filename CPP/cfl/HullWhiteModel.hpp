@@ -219,6 +219,25 @@ InterestRateModel model (const Data &rData, double dInterval,
  */
 InterestRateModel model (const Data &rData, double dInterval,
                          const TBrownian &rBrownian);
+
+/**
+ * Replaces the parameters of Hull and White model \p rModel by \p
+ * rData. The result has the same event times as \p rModel. If \p
+ * rData differs from the parameters of \p rModel only by the discount
+ * curve, that is, the initial times, the volatilities and the shapes
+ * at the event times are the same, then the grids, the rollback
+ * operators and the state dependent part of the numeraire of \p
+ * rModel are reused. Otherwise, the model is constructed from
+ * scratch. This function is designed for the computation of risks
+ * with respect to the discount curve.
+ *
+ * @param rModel A model constructed by HullWhite::model.
+ * @param rData The new parameters of Hull and White model.
+ * @return Hull and White model with the parameters \p rData and the
+ * event times of \p rModel.
+ */
+InterestRateModel rebind (const InterestRateModel &rModel,
+                          const Data &rData);
 } // namespace HullWhite
 /** @} */
 } // namespace cfl
@@ -0,0 +1,233 @@
+// do not include this file
+
+// class TapeSlice
+
+inline const cfl::Slice &
+cfl::TapeSlice::value () const
+{
+  return m_uValue;
+}
+
+inline unsigned
+cfl::TapeSlice::timeIndex () const
+{
+  return m_uValue.timeIndex ();
+}
+
+inline cfl::Tape &
+cfl::TapeSlice::tape () const
+{
+  PRECONDITION (m_pTape);
+
+  return *m_pTape;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator+= (const TapeSlice &rSlice)
+{
+  *this = *this + rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator-= (const TapeSlice &rSlice)
+{
+  *this = *this - rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator*= (const TapeSlice &rSlice)
+{
+  *this = *this * rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator/= (const TapeSlice &rSlice)
+{
+  *this = *this / rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator+= (const Slice &rSlice)
+{
+  *this = *this + rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator-= (const Slice &rSlice)
+{
+  *this = *this - rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator*= (const Slice &rSlice)
+{
+  *this = *this * rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator/= (const Slice &rSlice)
+{
+  *this = *this / rSlice;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator+= (double dValue)
+{
+  *this = *this + dValue;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator-= (double dValue)
+{
+  *this = *this - dValue;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator*= (double dValue)
+{
+  *this = *this * dValue;
+  return *this;
+}
+
+inline cfl::TapeSlice &
+cfl::TapeSlice::operator/= (double dValue)
+{
+  *this = *this / dValue;
+  return *this;
+}
+
+// class Tape
+
+inline cfl::TapeSlice
+cfl::Tape::input (const DualSlice &rValue)
+{
+  return input (rValue.value (), rValue.tangent ());
+}
+
+inline const std::valarray<double> &
+cfl::Tape::sensitivity () const
+{
+  return m_uSensitivity;
+}
+
+inline const std::map<double, double> &
+cfl::Tape::discountSensitivity () const
+{
+  return m_uDiscount;
+}
+
+inline const std::map<double, double> &
+cfl::Tape::forwardSensitivity () const
+{
+  return m_uForward;
+}
+
+inline const std::map<double, double> &
+cfl::Tape::varianceSensitivity () const
+{
+  return m_uVariance;
+}
+
+inline unsigned
+cfl::Tape::size () const
+{
+  return m_uNodes.size ();
+}
+
+// functions
+
+inline cfl::TapeSlice
+cfl::operator+ (const TapeSlice &rX, double dY)
+{
+  return rX + Slice (&rX.value ().model (), rX.timeIndex (), dY);
+}
+
+inline cfl::TapeSlice
+cfl::operator+ (double dX, const TapeSlice &rY)
+{
+  return rY + dX;
+}
+
+inline cfl::TapeSlice
+cfl::operator- (const TapeSlice &rX, double dY)
+{
+  return rX + (-dY);
+}
+
+inline cfl::TapeSlice
+cfl::operator- (double dX, const TapeSlice &rY)
+{
+  return Slice (&rY.value ().model (), rY.timeIndex (), dX) - rY;
+}
+
+inline cfl::TapeSlice
+cfl::operator* (const TapeSlice &rX, double dY)
+{
+  return rX * Slice (&rX.value ().model (), rX.timeIndex (), dY);
+}
+
+inline cfl::TapeSlice
+cfl::operator* (double dX, const TapeSlice &rY)
+{
+  return rY * dX;
+}
+
+inline cfl::TapeSlice
+cfl::operator/ (const TapeSlice &rX, double dY)
+{
+  return rX * (1. / dY);
+}
+
+inline cfl::TapeSlice
+cfl::operator/ (double dX, const TapeSlice &rY)
+{
+  return Slice (&rY.value ().model (), rY.timeIndex (), dX) / rY;
+}
+
+inline cfl::TapeSlice
+cfl::min (const TapeSlice &rSlice, double dValue)
+{
+  return -max (-rSlice, -dValue);
+}
+
+inline cfl::TapeSlice
+cfl::min (const TapeSlice &rX, const TapeSlice &rY)
+{
+  return -max (-rX, -rY);
+}
+
+inline cfl::TapeSlice
+cfl::sqrt (const TapeSlice &rSlice)
+{
+  return pow (rSlice, 0.5);
+}
+
+inline cfl::TapeSlice
+cfl::indicator (double dBarrier, const TapeSlice &rSlice)
+{
+  return 1. - indicator (rSlice, dBarrier);
+}
+
+inline cfl::TapeSlice
+cfl::indicator (const TapeSlice &rSlice, const TapeSlice &rBarrier)
+{
+  return indicator (rSlice - rBarrier, 0.);
+}
+
+inline cfl::TapeSlice
+cfl::rollback (const TapeSlice &rSlice, unsigned iEventTime)
+{
+  TapeSlice uSlice (rSlice);
+  uSlice.rollback (iEventTime);
+  return uSlice;
+}
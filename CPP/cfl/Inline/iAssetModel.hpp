@@ -15,6 +15,12 @@ cfl::AssetModel::model () const
   return m_pModel->model ();
 }
 
+inline const cfl::IAssetModel &
+cfl::AssetModel::implementation () const
+{
+  return *m_pModel;
+}
+
 inline const std::vector<double> &
 cfl::AssetModel::eventTimes () const
 {
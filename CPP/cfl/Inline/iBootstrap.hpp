@@ -0,0 +1,9 @@
+// do not include this file
+
+// class Bootstrap
+
+inline unsigned
+cfl::Bootstrap::iterations () const
+{
+  return m_iIter;
+}
@@ -0,0 +1,17 @@
+// do not include this file
+
+// class HullWhite::Basket
+
+inline unsigned
+cfl::HullWhite::Basket::size () const
+{
+  return m_uQuote.size ();
+}
+
+// class Black::Basket
+
+inline unsigned
+cfl::Black::Basket::size () const
+{
+  return m_uQuote.size ();
+}
@@ -0,0 +1,437 @@
+// do not include this file
+
+// class Dual
+
+inline double
+cfl::Dual::value () const
+{
+  return m_dValue;
+}
+
+inline const std::valarray<double> &
+cfl::Dual::tangent () const
+{
+  return m_uTangent;
+}
+
+inline cfl::Dual
+cfl::operator+ (const Dual &rX, const Dual &rY)
+{
+  Dual uZ (rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::Dual
+cfl::operator- (const Dual &rX, const Dual &rY)
+{
+  Dual uZ (rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::Dual
+cfl::operator* (const Dual &rX, const Dual &rY)
+{
+  Dual uZ (rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::Dual
+cfl::operator/ (const Dual &rX, const Dual &rY)
+{
+  Dual uZ (rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::Dual
+cfl::sqrt (const Dual &rX)
+{
+  return pow (rX, 0.5);
+}
+
+// class DualFunction
+
+inline const cfl::Function &
+cfl::DualFunction::value () const
+{
+  return m_uValue;
+}
+
+inline const std::vector<cfl::Function> &
+cfl::DualFunction::tangent () const
+{
+  return m_uTangent;
+}
+
+inline cfl::DualFunction
+cfl::operator+ (const DualFunction &rF, const DualFunction &rG)
+{
+  DualFunction uH (rF);
+  uH += rG;
+  return uH;
+}
+
+inline cfl::DualFunction
+cfl::operator- (const DualFunction &rF, const DualFunction &rG)
+{
+  DualFunction uH (rF);
+  uH -= rG;
+  return uH;
+}
+
+inline cfl::DualFunction
+cfl::operator* (const DualFunction &rF, const DualFunction &rG)
+{
+  DualFunction uH (rF);
+  uH *= rG;
+  return uH;
+}
+
+inline cfl::DualFunction
+cfl::operator/ (const DualFunction &rF, const DualFunction &rG)
+{
+  DualFunction uH (rF);
+  uH /= rG;
+  return uH;
+}
+
+// class DualSlice
+
+inline const cfl::Slice &
+cfl::DualSlice::value () const
+{
+  return m_uValue;
+}
+
+inline const std::vector<cfl::Slice> &
+cfl::DualSlice::tangent () const
+{
+  return m_uTangent;
+}
+
+inline unsigned
+cfl::DualSlice::timeIndex () const
+{
+  return m_uValue.timeIndex ();
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator+= (const Slice &rSlice)
+{
+  m_uValue += rSlice;
+  return *this;
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator-= (const Slice &rSlice)
+{
+  m_uValue -= rSlice;
+  return *this;
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator*= (const Slice &rSlice)
+{
+  return operator*= (DualSlice (rSlice));
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator/= (const Slice &rSlice)
+{
+  return operator/= (DualSlice (rSlice));
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator+= (const Dual &rValue)
+{
+  return operator+= (DualSlice (m_uValue.model (), timeIndex (), rValue));
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator-= (const Dual &rValue)
+{
+  return operator-= (DualSlice (m_uValue.model (), timeIndex (), rValue));
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator*= (const Dual &rValue)
+{
+  return operator*= (DualSlice (m_uValue.model (), timeIndex (), rValue));
+}
+
+inline cfl::DualSlice &
+cfl::DualSlice::operator/= (const Dual &rValue)
+{
+  return operator/= (DualSlice (m_uValue.model (), timeIndex (), rValue));
+}
+
+inline cfl::DualSlice
+cfl::operator- (const DualSlice &rSlice)
+{
+  return -1. * rSlice;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const DualSlice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const DualSlice &rX, const Slice &rY)
+{
+  DualSlice uZ (rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const Slice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const DualSlice &rX, const Dual &rY)
+{
+  DualSlice uZ (rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const Dual &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), rX);
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (const DualSlice &rX, double dY)
+{
+  DualSlice uZ (rX);
+  uZ += Dual (dY);
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator+ (double dX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), Dual (dX));
+  uZ += rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const DualSlice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const DualSlice &rX, const Slice &rY)
+{
+  DualSlice uZ (rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const Slice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const DualSlice &rX, const Dual &rY)
+{
+  DualSlice uZ (rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const Dual &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), rX);
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (const DualSlice &rX, double dY)
+{
+  DualSlice uZ (rX);
+  uZ -= Dual (dY);
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator- (double dX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), Dual (dX));
+  uZ -= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const DualSlice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const DualSlice &rX, const Slice &rY)
+{
+  DualSlice uZ (rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const Slice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const DualSlice &rX, const Dual &rY)
+{
+  DualSlice uZ (rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const Dual &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), rX);
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (const DualSlice &rX, double dY)
+{
+  DualSlice uZ (rX);
+  uZ *= Dual (dY);
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator* (double dX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), Dual (dX));
+  uZ *= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const DualSlice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const DualSlice &rX, const Slice &rY)
+{
+  DualSlice uZ (rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const Slice &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const DualSlice &rX, const Dual &rY)
+{
+  DualSlice uZ (rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const Dual &rX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), rX);
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (const DualSlice &rX, double dY)
+{
+  DualSlice uZ (rX);
+  uZ /= Dual (dY);
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::operator/ (double dX, const DualSlice &rY)
+{
+  DualSlice uZ (rY.value ().model (), rY.timeIndex (), Dual (dX));
+  uZ /= rY;
+  return uZ;
+}
+
+inline cfl::DualSlice
+cfl::min (const DualSlice &rSlice, double dValue)
+{
+  return -max (-rSlice, -dValue);
+}
+
+inline cfl::DualSlice
+cfl::min (const DualSlice &rX, const DualSlice &rY)
+{
+  return -max (-rX, -rY);
+}
+
+inline cfl::DualSlice
+cfl::sqrt (const DualSlice &rSlice)
+{
+  return pow (rSlice, 0.5);
+}
+
+inline cfl::DualSlice
+cfl::indicator (double dBarrier, const DualSlice &rSlice)
+{
+  return 1. - indicator (rSlice, dBarrier);
+}
+
+inline cfl::DualSlice
+cfl::indicator (const DualSlice &rSlice, const DualSlice &rBarrier)
+{
+  return indicator (rSlice - rBarrier, 0.);
+}
+
+inline cfl::DualSlice
+cfl::rollback (const DualSlice &rSlice, unsigned iEventTime)
+{
+  DualSlice uSlice (rSlice);
+  uSlice.rollback (iEventTime);
+  return uSlice;
+}
@@ -0,0 +1,19 @@
+// do not include this file
+
+inline void
+cfl::Exercise::replay (bool bReplay)
+{
+  m_bReplay = bReplay;
+}
+
+inline bool
+cfl::Exercise::isReplay () const
+{
+  return m_bReplay;
+}
+
+inline const std::vector<double> &
+cfl::Exercise::eventTimes () const
+{
+  return m_uEventTimes;
+}
@@ -19,6 +19,18 @@ cfl::Fit::assign (InIt1 itArgBegin, InIt1 itArgEnd, InIt2 itValBegin,
   m_uP.reset (m_uP->newObject (uArg, uVal, uWt, bChi2));
 }
 
+inline void
+cfl::Fit::update (double dArg, double dVal, double dWt)
+{
+  m_uP.reset (m_uP->update (dArg, dVal, dWt));
+}
+
+inline void
+cfl::Fit::remove (double dArg, double dVal, double dWt)
+{
+  m_uP.reset (m_uP->remove (dArg, dVal, dWt));
+}
+
 inline cfl::Function
 cfl::Fit::fit () const
 {
@@ -31,6 +43,18 @@ cfl::Fit::err () const
   return m_uP->err ();
 }
 
+inline std::valarray<double>
+cfl::Fit::fit (const std::vector<double> &rArg) const
+{
+  return m_uP->fitValues (rArg);
+}
+
+inline std::valarray<double>
+cfl::Fit::err (const std::vector<double> &rArg) const
+{
+  return m_uP->errValues (rArg);
+}
+
 inline cfl::FitParam
 cfl::Fit::param () const
 {
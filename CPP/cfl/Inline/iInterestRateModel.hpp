@@ -16,6 +16,12 @@ cfl::InterestRateModel::model () const
   return m_pModel->model ();
 }
 
+inline const cfl::IInterestRateModel &
+cfl::InterestRateModel::implementation () const
+{
+  return *m_pModel;
+}
+
 inline const std::vector<double> &
 cfl::InterestRateModel::eventTimes () const
 {
@@ -45,6 +51,18 @@ cfl::InterestRateModel::discount (unsigned iTime, double dBondMaturity) const
   return m_pModel->discount (iTime, dBondMaturity);
 }
 
+inline std::vector<cfl::Slice>
+cfl::InterestRateModel::discount (
+    unsigned iTime, const std::vector<double> &rBondMaturities) const
+{
+  PRECONDITION (iTime < eventTimes ().size ());
+  PRECONDITION (std::all_of (
+      rBondMaturities.begin (), rBondMaturities.end (),
+      [dTime = eventTimes ()[iTime]] (double dT) { return dTime <= dT; }));
+
+  return m_pModel->discount (iTime, rBondMaturities);
+}
+
 inline cfl::Slice
 cfl::InterestRateModel::state (unsigned iTime, unsigned iState) const
 {
@@ -26,3 +26,9 @@ cfl::Interp::deriv2 () const
 {
   return m_uP->deriv2 ();
 }
+
+inline std::valarray<double>
+cfl::Interp::values (const std::valarray<double> &rArg, unsigned iDeriv) const
+{
+  return m_uP->values (rArg, iDeriv);
+}
@@ -0,0 +1,11 @@
+// do not include this file
+
+inline cfl::AssetModel
+cfl::LocalVol::model (const Data &rData, double dInterval,
+                      double dStepQuality, double dWidthQuality,
+                      double dTimeQuality)
+{
+  return cfl::LocalVol::model (
+      rData, dInterval,
+      diffusion (dStepQuality, dWidthQuality, dTimeQuality));
+}
@@ -0,0 +1,92 @@
+// do not include this file
+
+// class PathModel
+
+inline const cfl::MonteCarlo::IPathModel &
+cfl::MonteCarlo::PathModel::model () const
+{
+  return *m_pModel;
+}
+
+// class Sobol
+
+inline unsigned
+cfl::MonteCarlo::Sobol::dimension () const
+{
+  return m_iDimension;
+}
+
+// class Paths
+
+inline unsigned
+cfl::MonteCarlo::Paths::size () const
+{
+  return m_uState.front ().size ();
+}
+
+inline const std::vector<double> &
+cfl::MonteCarlo::Paths::eventTimes () const
+{
+  return m_uModel.model ().eventTimes ();
+}
+
+inline const std::valarray<double> &
+cfl::MonteCarlo::Paths::state (unsigned iTime) const
+{
+  PRECONDITION (iTime < m_uState.size ());
+
+  return m_uState[iTime];
+}
+
+inline std::valarray<double>
+cfl::MonteCarlo::Paths::numeraire (unsigned iTime) const
+{
+  return m_uModel.model ().numeraire (iTime, state (iTime));
+}
+
+inline std::valarray<double>
+cfl::MonteCarlo::Paths::discount (unsigned iTime, double dBondMaturity) const
+{
+  return m_uModel.model ().discount (iTime, dBondMaturity, state (iTime));
+}
+
+inline std::valarray<double>
+cfl::MonteCarlo::Paths::forward (unsigned iTime,
+                                 double dForwardMaturity) const
+{
+  return m_uModel.model ().forward (iTime, dForwardMaturity, state (iTime));
+}
+
+inline std::valarray<double>
+cfl::MonteCarlo::Paths::spot (unsigned iTime) const
+{
+  return forward (iTime, eventTimes ()[iTime]);
+}
+
+// class Boundary
+
+inline const std::vector<double> &
+cfl::MonteCarlo::Boundary::eventTimes () const
+{
+  return m_uEventTimes;
+}
+
+inline unsigned
+cfl::MonteCarlo::Boundary::rights () const
+{
+  return m_iRights;
+}
+
+inline unsigned
+cfl::MonteCarlo::Boundary::size () const
+{
+  return m_uBasis.size ();
+}
+
+inline const std::valarray<double> &
+cfl::MonteCarlo::Boundary::coefficients (unsigned iTime, unsigned iRights) const
+{
+  PRECONDITION ((iTime < m_uEventTimes.size ()) && (iRights <= m_iRights));
+
+  return m_uCoeff[iTime * (m_iRights + 1) + iRights];
+}
@@ -0,0 +1,279 @@
+// do not include this file
+
+namespace cflRootSolver
+{
+// the factor of the expansion of the interval in the search of the
+// bracket
+const double c_dGrow = 1.6;
+} // namespace cflRootSolver
+
+// class Brent
+
+inline cfl::Brent::Brent (double dAbsErr, double dRelErr, unsigned iMaxSteps)
+    : m_dAbsErr (dAbsErr), m_dRelErr (dRelErr), m_iMaxSteps (iMaxSteps),
+      m_iEval (0)
+{
+  PRECONDITION ((dAbsErr > 0) || (dRelErr > 0));
+}
+
+template <class F>
+double
+cfl::Brent::find (const F &rF, double dL, double dR)
+{
+  PRECONDITION (dL < dR);
+
+  double dX = zeroin (rF, dL, rF (dL), dR, rF (dR));
+  m_iEval += 2;
+  return dX;
+}
+
+template <class F>
+double
+cfl::Brent::findNear (const F &rF, double dX0, double dStep)
+{
+  PRECONDITION (dStep > 0);
+
+  double dL = dX0 - dStep;
+  double dR = dX0 + dStep;
+  double dFL = rF (dL);
+  double dFR = rF (dR);
+  m_iEval = 2;
+  unsigned iSteps = 0;
+  while (!(dFL * dFR <= 0))
+    {
+      if (iSteps == m_iMaxSteps)
+        {
+          throw (NError::range ("bracket of the root"));
+        }
+      iSteps++;
+      // we move the end with the smaller absolute value
+      if (std::abs (dFL) < std::abs (dFR))
+        {
+          dL -= cflRootSolver::c_dGrow * (dR - dL);
+          dFL = rF (dL);
+        }
+      else
+        {
+          dR += cflRootSolver::c_dGrow * (dR - dL);
+          dFR = rF (dR);
+        }
+      m_iEval++;
+    }
+  unsigned iEval = m_iEval;
+  double dX = zeroin (rF, dL, dFL, dR, dFR);
+  m_iEval += iEval;
+  return dX;
+}
+
+inline unsigned
+cfl::Brent::evaluations () const
+{
+  return m_iEval;
+}
+
+template <class F>
+double
+cfl::Brent::zeroin (const F &rF, double dA, double dFA, double dB,
+                    double dFB)
+{
+  PRECONDITION (dFA * dFB <= 0);
+
+  m_iEval = 0;
+  if (dFA == 0)
+    {
+      return dA;
+    }
+  // b is the best approximation, [b,c] is the bracket of the root and
+  // a is the previous value of b
+  double dC = dA, dFC = dFA;
+  double dD = dB - dA, dE = dD;
+  for (unsigned iI = 0; iI < m_iMaxSteps; iI++)
+    {
+      if (dFB * dFC > 0)
+        {
+          dC = dA;
+          dFC = dFA;
+          dD = dB - dA;
+          dE = dD;
+        }
+      if (std::abs (dFC) < std::abs (dFB))
+        {
+          dA = dB;
+          dB = dC;
+          dC = dA;
+          dFA = dFB;
+          dFB = dFC;
+          dFC = dFA;
+        }
+      double dTol = 0.5
+                    * (m_dAbsErr
+                       + m_dRelErr * std::min (std::abs (dB), std::abs (dC)));
+      double dM = 0.5 * (dC - dB);
+      if ((std::abs (dM) <= dTol) || (dFB == 0))
+        {
+          return dB;
+        }
+      if ((std::abs (dE) >= dTol) && (std::abs (dFA) > std::abs (dFB)))
+        {
+          // interpolation
+          double dS = dFB / dFA, dP, dQ;
+          if (dA == dC)
+            {
+              // linear
+              dP = 2. * dM * dS;
+              dQ = 1. - dS;
+            }
+          else
+            {
+              // inverse quadratic
+              double dQA = dFA / dFC;
+              double dR = dFB / dFC;
+              dP = dS * (2. * dM * dQA * (dQA - dR) - (dB - dA) * (dR - 1.));
+              dQ = (dQA - 1.) * (dR - 1.) * (dS - 1.);
+            }
+          if (dP > 0)
+            {
+              dQ = -dQ;
+            }
+          else
+            {
+              dP = -dP;
+            }
+          if (2. * dP
+              < std::min (3. * dM * dQ - std::abs (dTol * dQ),
+                          std::abs (dE * dQ)))
+            {
+              dE = dD;
+              dD = dP / dQ;
+            }
+          else
+            {
+              // bisection
+              dD = dM;
+              dE = dM;
+            }
+        }
+      else
+        {
+          // bisection
+          dD = dM;
+          dE = dM;
+        }
+      dA = dB;
+      dFA = dFB;
+      if (std::abs (dD) > dTol)
+        {
+          dB += dD;
+        }
+      else
+        {
+          dB += (dM > 0) ? dTol : -dTol;
+        }
+      dFB = rF (dB);
+      m_iEval++;
+    }
+  return dB;
+}
+
+// class Newton
+
+inline cfl::Newton::Newton (double dAbsErr, double dRelErr,
+                            unsigned iMaxSteps)
+    : m_dAbsErr (dAbsErr), m_dRelErr (dRelErr), m_iMaxSteps (iMaxSteps),
+      m_iEval (0)
+{
+  PRECONDITION ((dAbsErr > 0) || (dRelErr > 0));
+}
+
+template <class F>
+double
+cfl::Newton::find (const F &rF, double dX0)
+{
+  double dX = dX0;
+  m_iEval = 0;
+  for (unsigned iI = 0; iI < m_iMaxSteps; iI++)
+    {
+      std::pair<double, double> uF = rF (dX);
+      m_iEval++;
+      if (uF.first == 0)
+        {
+          return dX;
+        }
+      if (uF.second == 0)
+        {
+          throw (NError::range ("zero derivative in Newton method"));
+        }
+      double dY = dX - uF.first / uF.second;
+      if (std::abs (dY - dX) < m_dAbsErr + m_dRelErr * std::abs (dY))
+        {
+          return dY;
+        }
+      dX = dY;
+    }
+  return dX;
+}
+
+template <class F>
+double
+cfl::Newton::find (const F &rF, double dX0, double dL, double dR)
+{
+  PRECONDITION ((dL < dR) && (dL <= dX0) && (dX0 <= dR));
+
+  // the sign of the function at the right end is opposite
+  double dFL = rF (dL).first;
+  m_iEval = 1;
+  if (dFL == 0)
+    {
+      return dL;
+    }
+
+  ASSERT (dFL * rF (dR).first <= 0);
+
+  // the function is negative at dNeg and positive at dPos
+  double dNeg = dL, dPos = dR;
+  if (dFL > 0)
+    {
+      std::swap (dNeg, dPos);
+    }
+  double dX = dX0;
+  double dStep = dR - dL, dPrevStep = dStep;
+  for (unsigned iI = 0; iI < m_iMaxSteps; iI++)
+    {
+      std::pair<double, double> uF = rF (dX);
+      m_iEval++;
+      if (uF.first == 0)
+        {
+          return dX;
+        }
+      if (uF.first < 0)
+        {
+          dNeg = dX;
+        }
+      else
+        {
+          dPos = dX;
+        }
+      // bisection if Newton step leaves the bracket or the previous
+      // but one step was shorter
+      bool bBisect
+          = (((dX - dNeg) * uF.second - uF.first)
+                 * ((dX - dPos) * uF.second - uF.first)
+             >= 0)
+            || (std::abs (2. * uF.first) > std::abs (dPrevStep * uF.second));
+      dPrevStep = dStep;
+      double dY = bBisect ? 0.5 * (dNeg + dPos) : dX - uF.first / uF.second;
+      dStep = dY - dX;
+      if (std::abs (dStep) < m_dAbsErr + m_dRelErr * std::abs (dY))
+        {
+          return dY;
+        }
+      dX = dY;
+    }
+  return dX;
+}
+
+inline unsigned
+cfl::Newton::evaluations () const
+{
+  return m_iEval;
+}
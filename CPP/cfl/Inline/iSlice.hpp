@@ -324,6 +324,13 @@ cfl::rollback (const cfl::Slice &rSlice, unsigned iTime)
 
 inline cfl::MultiFunction
 cfl::interpolate (const cfl::Slice &rSlice)
+{
+  return MultiFunction (rSlice.model ().interpolate (rSlice),
+                        std::valarray<std::size_t> (std::size_t (0), 1));
+}
+
+inline cfl::MultiFunction
+cfl::greeks (const cfl::Slice &rSlice)
 {
   return rSlice.model ().interpolate (rSlice);
 }
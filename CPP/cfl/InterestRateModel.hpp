@@ -70,6 +70,38 @@ public:
    * event time with index \p iEventTime.
    */
   virtual Slice discount (unsigned iEventTime, double dBondMaturity) const = 0;
+
+  /**
+   * Constructs the discount factors with maturities \p rBondMaturities
+   * at event time with index \p iEventTime. The default implementation
+   * calls the previous function for every maturity. It should be
+   * overridden if the discount factors can be computed together.
+   *
+   * @param iEventTime The index of event time where the discount
+   * factors are constructed.
+   * @param rBondMaturities The maturities of the discount factors.
+   * @return The vector of discount factors with maturities \p
+   * rBondMaturities at event time with index \p iEventTime.
+   */
+  virtual std::vector<Slice>
+  discount (unsigned iEventTime,
+            const std::vector<double> &rBondMaturities) const;
+
+  /**
+   * Constructs the annuity for the payment schedule \p rPaymentTimes
+   * at event time with index \p iEventTime. The default
+   * implementation adds the discount factors one by one to the same
+   * slice. It should be overridden if the annuity can be accumulated
+   * without the construction of the discount factors.
+   *
+   * @param iEventTime The index of event time.
+   * @param rPaymentTimes The increasing vector of payment times.
+   * @return The annuity for the payment schedule \p rPaymentTimes at
+   * event time with index \p iEventTime.
+   * @see InterestRateModel::annuity
+   */
+  virtual Slice annuity (unsigned iEventTime,
+                         const std::vector<double> &rPaymentTimes) const;
 };
 
 /**
@@ -106,6 +138,15 @@ public:
    */
   const IModel &model () const;
 
+  /**
+   * Returns the implementation of the model. It is used by the
+   * functions that create new models from the existing ones, for
+   * example, after a change of the initial curves.
+   *
+   * @return The implementation of IInterestRateModel.
+   */
+  const IInterestRateModel &implementation () const;
+
   /**
    * Returns the vector of event times in the model.
    * The same as <code>model().eventTimes()</code>.
@@ -137,6 +178,31 @@ public:
    */
   Slice discount (unsigned iEventTime, double dBondMaturity) const;
 
+  /**
+   * @copydoc IInterestRateModel::discount(unsigned, const std::vector<double> &) const
+   */
+  std::vector<Slice>
+  discount (unsigned iEventTime,
+            const std::vector<double> &rBondMaturities) const;
+
+  /**
+   * Constructs the annuity for the payment schedule \p rPaymentTimes
+   * at event time with index \p iEventTime:
+   * \f[
+   * \sum_{k=1}^n (T_k - T_{k-1}) P(t, T_k),
+   * \f]
+   * where \f$t = T_0\f$ is the event time, \f$T_1<\dots<T_n\f$ are
+   * the payment times and \f$P(t,T)\f$ is the discount factor.
+   *
+   * @param iEventTime The index of event time.
+   * @param rPaymentTimes The increasing vector of payment times. The
+   * first payment time is greater than the event time.
+   * @return The annuity for the payment schedule \p rPaymentTimes at
+   * event time with index \p iEventTime.
+   */
+  Slice annuity (unsigned iEventTime,
+                 const std::vector<double> &rPaymentTimes) const;
+
   /**
    * Returns the value of state process with index \a iState
    * at the event time with index \a iEventTime.
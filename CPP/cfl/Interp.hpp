@@ -13,6 +13,7 @@
  */
 
 #include "cfl/Function.hpp"
+#include <valarray>
 #include <vector>
 
 namespace cfl
@@ -75,6 +76,20 @@ public:
    * @return The second derivative of the interpolated function.
    */
   virtual Function deriv2 () const = 0;
+
+  /**
+   * Returns the values of the interpolated function (\p iDeriv = 0)
+   * or of its derivative of order \p iDeriv (\p iDeriv = 1, 2) at the
+   * increasing arguments \p rArg. The default implementation
+   * evaluates the functions interp(), deriv() and deriv2()
+   * argument by argument.
+   *
+   * @param rArg The increasing array of arguments.
+   * @param iDeriv The order of the derivative.
+   * @return The array of values at \p rArg.
+   */
+  virtual std::valarray<double> values (const std::valarray<double> &rArg,
+                                        unsigned iDeriv) const;
 };
 
 /**
@@ -121,6 +136,12 @@ public:
    */
   Function deriv2 () const;
 
+  /**
+   * @copydoc IInterp::values()
+   */
+  std::valarray<double> values (const std::valarray<double> &rArg,
+                                unsigned iDeriv = 0) const;
+
 private:
   std::shared_ptr<IInterp> m_uP;
 };
@@ -132,6 +153,11 @@ private:
  * if the sizes of the input vectors of arguments and values
  * are too small.
  *
+ * The linear, cubic spline, Steffen and Akima interpolations keep
+ * immutable tables of polynomial coefficients. Their functions can be
+ * evaluated concurrently. The search for an interval takes
+ * constant time if the arguments are evenly spaced.
+ *
  * @see IInterp and Interp
  */
 namespace NInterp
@@ -0,0 +1,103 @@
+#ifndef __cflLeastSquares_hpp__
+#define __cflLeastSquares_hpp__
+
+/**
+ * @file LeastSquares.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Nonlinear least squares by Levenberg-Marquardt algorithm.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Macros.hpp"
+#include <functional>
+#include <vector>
+
+namespace cfl
+{
+/**
+ * @ingroup cflNumeric
+ *
+ * @defgroup cflLeastSquares Nonlinear least squares.
+ *
+ * This module contains the minimization of sums of squared residuals
+ * over a small number of parameters, such as the calibration of
+ * models to prices of options and the fits of yield curves.
+ *
+ * @{
+ */
+
+/**
+ * @brief Levenberg-Marquardt algorithm.
+ *
+ * The objective is \f$\chi^2(\theta) = \sum_i r_i^2(\theta)\f$. At
+ * every iteration the step \f$\delta\f$ solves
+ * \f[
+ *  (H + \mu \mathop{diag}(H) + \eta \mu I) \delta = -g,
+ * \f]
+ * where \f$g = J^\top r\f$, \f$H = J^\top J\f$, \f$J\f$ is the
+ * Jacobian of the residuals, and \f$\eta = \f$ cfl::EPS keeps the
+ * matrix positive definite. The damping \f$\mu\f$ grows until the
+ * step reduces \f$\chi^2\f$ and decreases after a successful step.
+ * The parameters are kept in the box \f$[a, b]\f$. We stop as soon
+ * as the largest change of a parameter is less than \f$\epsilon\f$,
+ * or the relative reduction of \f$\chi^2\f$ is less than \f$\delta\f$,
+ * or the step cannot reduce \f$\chi^2\f$.
+ */
+class Levenberg
+{
+public:
+  /**
+   * Computes the residuals and their Jacobian for the parameters \p
+   * rTheta and returns \f$\chi^2\f$ or infinity if the parameters
+   * are not admissible. The residuals and the Jacobian are kept by
+   * the caller.
+   */
+  typedef std::function<double (const std::vector<double> &rTheta)>
+      TAssign;
+
+  /**
+   * Writes the gradient \f$g = J^\top r\f$ and the row-major matrix
+   * \f$H = J^\top J\f$ for the last parameters given to TAssign.
+   */
+  typedef std::function<void (std::vector<double> &rGradient,
+                              std::vector<double> &rHessian)>
+      TNormal;
+
+  /**
+   * The constructor.
+   *
+   * @param dRelErr (\f$\delta\f$) The relative error of \f$\chi^2\f$.
+   * @param dStepErr (\f$\epsilon\f$) The absolute error of the
+   * parameters.
+   * @param dLower (\f$a\f$) The lower bound for the parameters.
+   * @param dUpper (\f$b\f$) The upper bound for the parameters.
+   * @param iMaxSteps The maximal number of iterations.
+   */
+  Levenberg (double dRelErr, double dStepErr, double dLower = -OMEGA,
+             double dUpper = OMEGA, unsigned iMaxSteps = IMAX);
+
+  /**
+   * Minimizes \f$\chi^2\f$ starting from \p rTheta. On exit, the
+   * residuals and the Jacobian kept by the caller correspond to the
+   * returned parameters.
+   *
+   * @param rAssign The residuals and the Jacobian.
+   * @param rNormal The normal equations.
+   * @param rTheta On entry, the initial guess; on exit, the solution.
+   * @return The minimal value of \f$\chi^2\f$.
+   */
+  double minimize (const TAssign &rAssign, const TNormal &rNormal,
+                   std::vector<double> &rTheta) const;
+
+private:
+  double m_dRelErr, m_dStepErr, m_dLower, m_dUpper;
+  unsigned m_iMaxSteps;
+};
+/** @} */
+} // namespace cfl
+
+#endif // of __cflLeastSquares_hpp__
@@ -0,0 +1,140 @@
+#ifndef __cflLocalVolModel_hpp__
+#define __cflLocalVolModel_hpp__
+
+/**
+ * @file LocalVolModel.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Implementation of local volatility model.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/AssetModel.hpp"
+#include "cfl/Diffusion.hpp"
+
+namespace cfl
+{
+/**
+ * @ingroup cflAssetModel
+ *
+ * @defgroup cflLocalVol Local volatility model for a single asset.
+ *
+ * This module contains implementation of the local volatility model
+ * for a single asset.
+ *
+ * @see cfl::AssetModel
+ * @{
+ */
+
+/**
+ * @brief  Local volatility model for a single asset.
+ *
+ * This namespace contains functions and classes related with the
+ * local volatility model for a single asset.
+ */
+namespace LocalVol
+{
+/**
+ * @brief  This class defines the parameters of the local volatility
+ * model.
+ *
+ * The set of parameters consists of discount and forward curves and
+ * the local volatility surface. The spot price evolves as
+ * \f[
+ *  dS_t = S_t\left(r(t) - q(t)\right) dt + S_t \sigma(t,S_t) dW_t,
+ *  \quad t\geq t_0,
+ * \f]
+ * where the deterministic rates \f$r\f$ and \f$q\f$ are defined by
+ * the discount and forward curves: \f$F(t,T) = S_t
+ * F(t_0,T)/F(t_0,t)\f$.
+ */
+class Data
+{
+public:
+  /**
+   * The initial discount curve \f$B(t_0,T)\f$, \f$T\geq t_0\f$.
+   *
+   */
+  Function discount;
+
+  /**
+   * The initial forward curve \f$F(t_0,T)\f$, \f$T\geq t_0\f$.
+   *
+   */
+  Function forward;
+
+  /**
+   * The local volatility: \a volatility(t) is the function
+   * \f$S\mapsto \sigma(t,S)\f$ of the spot price.
+   *
+   */
+  std::function<Function (double dTime)> volatility;
+
+  /**
+   * The initial time \f$t_0\f$ given as year fraction.
+   *
+   */
+  double initialTime;
+};
+
+/**
+ * Constructs the parameters of the local volatility model.
+ *
+ * @param rDiscount The initial discount curve \f$B(t_0,T)\f$, \f$T\geq t_0\f$.
+ * @param rForward The initial forward curve \f$F(t_0,T)\f$, \f$T\geq t_0\f$.
+ * @param rVolatility The local volatility: \a rVolatility(t) is the
+ * function \f$S\mapsto \sigma(t,S)\f$ of the spot price.
+ * @param dInitialTime The initial time given as year fraction.
+ */
+Data makeData (const Function &rDiscount, const Function &rForward,
+               const std::function<Function (double)> &rVolatility,
+               double dInitialTime);
+
+/**
+ * Constructs the parameters of the local volatility model where the
+ * local volatility \f$\sigma(S)\f$ does not depend on time.
+ *
+ * @param rDiscount The initial discount curve \f$B(t_0,T)\f$, \f$T\geq t_0\f$.
+ * @param rForward The initial forward curve \f$F(t_0,T)\f$, \f$T\geq t_0\f$.
+ * @param rVolatility The local volatility as the function of the spot price.
+ * @param dInitialTime The initial time given as year fraction.
+ */
+Data makeData (const Function &rDiscount, const Function &rForward,
+               const Function &rVolatility, double dInitialTime);
+
+/**
+ * Implements AssetModel as the local volatility model. The state
+ * process is the logarithm of the ratio of the spot price and its
+ * initial forward price: \f$X_t = \ln(S_t/F(t_0,t))\f$.
+ *
+ * @param rData The parameters of the local volatility model.
+ * @param dInterval The interval of initial values for relative
+ * changes in the spot price.
+ * @param dStepQuality The step quality of model implementation.
+ * @param dWidthQuality The width quality of model implementation.
+ * @param dTimeQuality The maximal time step equals 1/dTimeQuality.
+ * @return An implementation of AssetModel as the local volatility model.
+ */
+AssetModel model (const Data &rData, double dInterval, double dStepQuality,
+                  double dWidthQuality, double dTimeQuality);
+
+/**
+ * Implements AssetModel as the local volatility model.
+ *
+ * @param rData The parameters of the local volatility model.
+ * @param dInterval The interval of initial values for relative
+ * changes in the spot price.
+ * @param rDiffusion Constructor of the model of diffusion.
+ * @return An implementation of AssetModel as the local volatility model.
+ */
+AssetModel model (const Data &rData, double dInterval,
+                  const TDiffusion &rDiffusion);
+} // namespace LocalVol
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iLocalVolModel.hpp"
+#endif // of __cflLocalVolModel_hpp__
@@ -118,6 +118,21 @@ public:
    */
   virtual void rollback (Slice &rSlice, unsigned iEventTime) const = 0;
 
+  /**
+   * Applies the transpose of the rollback operator. It is used in
+   * the reverse (adjoint) computation of sensitivities.
+   *
+   * The default implementation throws an exception.
+   *
+   * @param rSlice Before the operation, this object represents the
+   * adjoint of the value of a security at an event time whose index
+   * is smaller than \p iEventTime. After the operation, it defines
+   * the adjoint of the payoff of this security at the event time with
+   * index \p iEventTime.
+   * @param iEventTime The index of the target event time for \p rSlice.
+   */
+  virtual void adjointRollback (Slice &rSlice, unsigned iEventTime) const;
+
   /**
    * Transforms \p rSlice into the indicator function of the event:
    * <code>rSlice >= dBarrier</code>.
@@ -0,0 +1,548 @@
+#ifndef __cflMonteCarlo_hpp__
+#define __cflMonteCarlo_hpp__
+
+/**
+ * @file MonteCarlo.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Monte Carlo simulation of financial models.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/BlackModel.hpp"
+#include "cfl/Exercise.hpp"
+#include "cfl/HullWhiteModel.hpp"
+#include <array>
+#include <memory>
+
+namespace cfl
+{
+/**
+ * @ingroup cflModel
+ *
+ * @defgroup cflMonteCarlo Monte Carlo simulation.
+ *
+ * This module contains the Monte Carlo simulation of the state
+ * processes of the Black and the Hull and White models. As in the
+ * lattice implementations, the state process is a Brownian motion
+ * \f$X\f$ with deterministic variance, and the prices are computed
+ * with respect to a numeraire \f$N_i = N(t_i, X_{t_i})\f$:
+ * \f[
+ * V_0 = N_0 \mathbb{E}\left[\sum_i \frac{P_i}{N_i}\right],
+ * \f]
+ * where \f$P_i\f$ is the cash flow at the event time \f$t_i\f$.
+ *
+ * The paths are generated in batches and are stored as structure of
+ * arrays: a vector of the states of all paths of the batch for every
+ * event time. Only one batch per thread is kept in memory; the
+ * payoffs are accumulated as the batches are completed. The normal
+ * variables of a path are obtained from the counter-based generator
+ * Philox4x32-10 with the number of the path as the counter, so the
+ * result does not depend on the number of threads and on the size of
+ * the batches.
+ *
+ * For smooth payoffs the quasi Monte Carlo method with the scrambled
+ * Sobol sequence and the Brownian bridge construction of the paths
+ * usually converges much faster; its error is estimated from
+ * independent randomized replications.
+ * @{
+ */
+
+/**
+ * @brief Monte Carlo simulation.
+ */
+namespace MonteCarlo
+{
+/**
+ * @brief  The interface class for a model used in Monte Carlo
+ * simulation.
+ *
+ * The functions of the state are evaluated for all paths of a batch.
+ *
+ * @see PathModel
+ */
+class IPathModel
+{
+public:
+  /**
+   * The virtual destructor.
+   */
+  virtual ~IPathModel () {}
+
+  /**
+   * Returns the vector of event times.
+   *
+   * @return The vector of event times. The first event time is the
+   * initial time.
+   */
+  virtual const std::vector<double> &eventTimes () const = 0;
+
+  /**
+   * Returns the total variance of the state process at the event
+   * time with index \p iEventTime.
+   *
+   * @param iEventTime The index of an event time.
+   * @return The variance of the state process at the event time.
+   */
+  virtual double variance (unsigned iEventTime) const = 0;
+
+  /**
+   * Returns the values of the numeraire at the event time with index
+   * \p iEventTime.
+   *
+   * @param iEventTime The index of an event time.
+   * @param rState The states of the paths at the event time.
+   * @return The values of the numeraire.
+   */
+  virtual std::valarray<double>
+  numeraire (unsigned iEventTime,
+             const std::valarray<double> &rState) const = 0;
+
+  /**
+   * Returns the prices of the discount bond with maturity \p
+   * dBondMaturity at the event time with index \p iEventTime.
+   *
+   * @param iEventTime The index of an event time.
+   * @param dBondMaturity The maturity of the discount bond.
+   * @param rState The states of the paths at the event time.
+   * @return The prices of the discount bond.
+   */
+  virtual std::valarray<double>
+  discount (unsigned iEventTime, double dBondMaturity,
+            const std::valarray<double> &rState) const = 0;
+
+  /**
+   * Returns the forward prices for the delivery time \p
+   * dForwardMaturity at the event time with index \p iEventTime. The
+   * default implementation throws NError::Range.
+   *
+   * @param iEventTime The index of an event time.
+   * @param dForwardMaturity The maturity of the forward contract.
+   * @param rState The states of the paths at the event time.
+   * @return The forward prices.
+   */
+  virtual std::valarray<double>
+  forward (unsigned iEventTime, double dForwardMaturity,
+           const std::valarray<double> &rState) const;
+};
+
+/**
+ * @brief  The concrete class for a model used in Monte Carlo
+ * simulation.
+ *
+ * It is constructed from a new implementation of IPathModel.
+ */
+class PathModel
+{
+public:
+  /**
+   * The constructor.
+   *
+   * @param pNewModel A pointer to new implementation of IPathModel.
+   */
+  PathModel (IPathModel *pNewModel = 0);
+
+  /**
+   * Returns the implementation of the model.
+   *
+   * @return The implementation of the model.
+   */
+  const IPathModel &model () const;
+
+private:
+  std::shared_ptr<IPathModel> m_pModel;
+};
+
+/**
+ * @brief  Scrambled Sobol sequence.
+ *
+ * The direction numbers are those of Joe and Kuo (the file
+ * new-joe-kuo-6.21201) with better two-dimensional projections; the
+ * dimension is at most 3667. The randomized replications of the
+ * sequence are obtained by the nested uniform (Owen) scrambling of
+ * the digits, implemented by hashing.
+ */
+class Sobol
+{
+public:
+  /**
+   * Constructs the Sobol sequence.
+   *
+   * @param iDimension The dimension of the points.
+   */
+  Sobol (unsigned iDimension);
+
+  /**
+   * Returns the dimension of the points.
+   *
+   * @return The dimension of the points.
+   */
+  unsigned dimension () const;
+
+  /**
+   * Computes the points with the numbers \p iFirst, \p iFirst + 1, ...
+   * of the scrambled sequence in the order of the Gray code. The
+   * points are stored by coordinates: \p rPoints[j][n] is the
+   * coordinate j of the point with the number \p iFirst + n. The
+   * direction numbers have 32 binary digits; hence, the numbers of
+   * the points are less than \f$2^{32}\f$.
+   *
+   * @param iFirst The number of the first point.
+   * @param iScramble The number of the randomized replication.
+   * @param rPoints The vector of coordinates with the size equal to
+   * the dimension. The sizes of its elements define the number of
+   * points.
+   */
+  void points (unsigned long iFirst, unsigned long iScramble,
+               std::vector<std::valarray<double> > &rPoints) const;
+
+private:
+  unsigned m_iDimension;
+  std::vector<unsigned> m_uDirection;
+};
+
+/**
+ * @brief  A batch of paths of the state process.
+ *
+ * The states are stored by event times.
+ */
+class Paths
+{
+public:
+  /**
+   * Constructs a batch of paths.
+   *
+   * @param rModel The model.
+   * @param iSize The number of paths.
+   */
+  Paths (const PathModel &rModel, unsigned iSize);
+
+  /**
+   * Returns the number of paths in the batch.
+   *
+   * @return The number of paths.
+   */
+  unsigned size () const;
+
+  /**
+   * Returns the vector of event times.
+   *
+   * @return The vector of event times.
+   */
+  const std::vector<double> &eventTimes () const;
+
+  /**
+   * Returns the states of the paths at the event time with index \p
+   * iEventTime.
+   *
+   * @param iEventTime The index of an event time.
+   * @return The states of the paths.
+   */
+  const std::valarray<double> &state (unsigned iEventTime) const;
+
+  /**
+   * @copydoc IPathModel::numeraire
+   */
+  std::valarray<double> numeraire (unsigned iEventTime) const;
+
+  /**
+   * @copydoc IPathModel::discount
+   */
+  std::valarray<double> discount (unsigned iEventTime,
+                                  double dBondMaturity) const;
+
+  /**
+   * @copydoc IPathModel::forward
+   */
+  std::valarray<double> forward (unsigned iEventTime,
+                                 double dForwardMaturity) const;
+
+  /**
+   * Returns the spot prices at the event time with index \p
+   * iEventTime.
+   *
+   * @param iEventTime The index of an event time.
+   * @return The spot prices.
+   */
+  std::valarray<double> spot (unsigned iEventTime) const;
+
+  /**
+   * Generates the paths with the numbers \p iFirst, \p iFirst + 1,
+   * ..., \p iFirst + size() - 1 of the stream \p iSeed. The memory
+   * of the batch is reused.
+   *
+   * @param iSeed The seed of the random numbers.
+   * @param iFirst The number of the first path of the batch.
+   */
+  void simulate (unsigned long iSeed, unsigned long iFirst);
+
+  /**
+   * Generates the paths from the points with the numbers \p iFirst,
+   * \p iFirst + 1, ..., \p iFirst + size() - 1 of the scrambled Sobol
+   * sequence. The paths are constructed by the Brownian bridge: the
+   * first coordinate defines the state at the last event time, the
+   * next coordinates define the states in the middle of the intervals
+   * obtained by the bisection.
+   *
+   * @param rSobol The Sobol sequence; its dimension equals the number
+   * of event times minus one.
+   * @param iScramble The number of the randomized replication.
+   * @param iFirst The number of the first path of the batch.
+   */
+  void simulate (const Sobol &rSobol, unsigned long iScramble,
+                 unsigned long iFirst);
+
+private:
+  PathModel m_uModel;
+  std::vector<std::valarray<double> > m_uState;
+  // the uniform variables of the Sobol points, allocated by the first
+  // simulation from the Sobol sequence
+  std::vector<std::valarray<double> > m_uZ;
+  std::valarray<double> m_uStd;
+  // the steps of the Brownian bridge: the event time, the left and
+  // the right neighbours, their weights and the standard deviation
+  std::vector<std::array<unsigned, 3> > m_uBridge;
+  std::vector<std::array<double, 3> > m_uWeight;
+};
+
+/**
+ * The payoff of a derivative security as the function of a batch of
+ * paths. It returns the sums of the cash flows divided by the values
+ * of the numeraire at the payment times, one value for every path.
+ */
+typedef std::function<std::valarray<double> (const Paths &rPaths)> TPayoff;
+
+/**
+ * Constructs the Monte Carlo implementation of Black model. The
+ * numeraire is the inverse of the discount factor.
+ *
+ * @param rData The parameters of Black model.
+ * @param rEventTimes The vector of event times. The first element
+ * is the initial time.
+ * @return The Monte Carlo implementation of Black model.
+ */
+PathModel black (const Black::Data &rData,
+                 const std::vector<double> &rEventTimes);
+
+/**
+ * Constructs the Monte Carlo implementation of Hull and White
+ * model. The numeraire is the discount bond with the last event time
+ * as maturity.
+ *
+ * @param rData The parameters of Hull and White model.
+ * @param rEventTimes The vector of event times. The first element
+ * is the initial time.
+ * @return The Monte Carlo implementation of Hull and White model.
+ */
+PathModel hullWhite (const HullWhite::Data &rData,
+                     const std::vector<double> &rEventTimes);
+
+/**
+ * Computes the price of a derivative security by Monte Carlo
+ * simulation. The batches of paths are distributed among the
+ * threads.
+ *
+ * @param rModel The model.
+ * @param rPayoff The payoff.
+ * @param iPaths The number of paths.
+ * @param iSeed The seed of the random numbers.
+ * @param iBatch The number of paths in one batch.
+ * @return The price and its standard error.
+ */
+std::valarray<double> price (const PathModel &rModel, const TPayoff &rPayoff,
+                             unsigned long iPaths, unsigned long iSeed = 0,
+                             unsigned iBatch = 1024);
+
+/**
+ * Computes the price of a derivative security by quasi Monte Carlo
+ * simulation with the scrambled Sobol sequence and the Brownian
+ * bridge. The error is estimated from the independent randomized
+ * replications of the sequence.
+ *
+ * @param rModel The model.
+ * @param rPayoff The payoff.
+ * @param iPaths The number of paths in one replication; the powers
+ * of 2 are preferable. The paths of all batches are at most
+ * \f$2^{32}\f$, the number of points of the Sobol sequence.
+ * @param iReplications The number of randomized replications.
+ * @param iSeed The seed of the scrambling.
+ * @param iBatch The number of paths in one batch.
+ * @return The price and its standard error.
+ */
+std::valarray<double>
+quasiPrice (const PathModel &rModel, const TPayoff &rPayoff,
+            unsigned long iPaths, unsigned iReplications = 16,
+            unsigned long iSeed = 0, unsigned iBatch = 1024);
+
+/**
+ * The function of a batch of paths at an event time. It is used for
+ * the values of exercise divided by the numeraire and for the
+ * regressors of the continuation values.
+ */
+typedef std::function<std::valarray<double> (const Paths &rPaths,
+                                             unsigned iEventTime)>
+    TPathFunction;
+
+/**
+ * @brief  The exercise boundary computed by the least-squares Monte
+ * Carlo method.
+ *
+ * The boundary is defined by the regressions of the continuation
+ * values on the basis functions of the regressor at every event time
+ * and for every number of the remaining exercise rights. It can be
+ * reused for the pricing with new paths of the same model.
+ */
+class Boundary
+{
+public:
+  /**
+   * Constructs the boundary.
+   *
+   * @param rEventTimes The vector of event times.
+   * @param rState The regressor.
+   * @param rBasis The vector of basis functions of the regressor.
+   * @param iRights The number of exercise rights.
+   */
+  Boundary (const std::vector<double> &rEventTimes,
+            const TPathFunction &rState, const std::vector<Function> &rBasis,
+            unsigned iRights);
+
+  /**
+   * Returns the vector of event times.
+   *
+   * @return The vector of event times.
+   */
+  const std::vector<double> &eventTimes () const;
+
+  /**
+   * Returns the number of exercise rights.
+   *
+   * @return The number of exercise rights.
+   */
+  unsigned rights () const;
+
+  /**
+   * Returns the estimated continuation values divided by the
+   * numeraire.
+   *
+   * @param rPaths The batch of paths.
+   * @param iEventTime The index of an event time.
+   * @param iRights The number of the remaining exercise rights.
+   * @return The continuation values for all paths of the batch.
+   */
+  std::valarray<double> continuation (const Paths &rPaths,
+                                      unsigned iEventTime,
+                                      unsigned iRights) const;
+
+  /**
+   * Returns the coefficients of the regression.
+   *
+   * @param iEventTime The index of an event time.
+   * @param iRights The number of the remaining exercise rights.
+   * @return The coefficients of the basis functions; they are zero
+   * if \p iRights is zero.
+   */
+  const std::valarray<double> &coefficients (unsigned iEventTime,
+                                             unsigned iRights) const;
+
+  /**
+   * Assigns the coefficients of the regression.
+   *
+   * @param iEventTime The index of an event time.
+   * @param iRights The number of the remaining exercise rights.
+   * @param rCoeff The coefficients of the basis functions.
+   */
+  void assign (unsigned iEventTime, unsigned iRights,
+               const std::valarray<double> &rCoeff);
+
+  /**
+   * Returns the values of the basis functions of the regressor. The
+   * value of the basis function j on the path n has the index
+   * n * (the number of basis functions) + j.
+   *
+   * @param rPaths The batch of paths.
+   * @param iEventTime The index of an event time.
+   * @param rBasis The values of the basis functions.
+   */
+  void basis (const Paths &rPaths, unsigned iEventTime,
+              std::valarray<double> &rBasis) const;
+
+  /**
+   * Returns the number of basis functions.
+   *
+   * @return The number of basis functions.
+   */
+  unsigned size () const;
+
+private:
+  std::vector<double> m_uEventTimes;
+  TPathFunction m_uState;
+  std::vector<Function> m_uBasis;
+  unsigned m_iRights;
+  std::vector<std::valarray<double> > m_uCoeff;
+};
+
+/**
+ * Computes the exercise boundary by the least-squares Monte Carlo
+ * method of Longstaff and Schwartz. The exercise is possible at the
+ * event times with positive indexes, at most one right at a time. At
+ * every event time the realized values of the optimal policy are
+ * regressed on the basis functions of the regressor over the paths
+ * where the exercise value is positive. The regressions are the
+ * linear fits of NFit::linear, constructed once for all event times;
+ * the fits of all numbers of rights at an event time are computed by
+ * Fit::batch. If a regression fails, for example, because there are
+ * fewer such paths than basis functions, then the continuation value
+ * at this event time is zero.
+ *
+ * @param rModel The model.
+ * @param rExercise The values of exercise divided by the numeraire.
+ * @param rState The regressor.
+ * @param rBasis The vector of basis functions of the regressor.
+ * @param iPaths The number of paths for the regression. These paths
+ * are kept in memory.
+ * @param iRights The number of exercise rights.
+ * @param iSeed The seed of the random numbers.
+ * @param iBatch The number of paths in one batch.
+ * @return The exercise boundary.
+ */
+Boundary boundary (const PathModel &rModel, const TPathFunction &rExercise,
+                   const TPathFunction &rState,
+                   const std::vector<Function> &rBasis, unsigned long iPaths,
+                   unsigned iRights = 1, unsigned long iSeed = 0,
+                   unsigned iBatch = 1024);
+
+/**
+ * Returns the payoff of the option with early exercise for the
+ * given exercise boundary. The payoff can be priced by
+ * MonteCarlo::price or MonteCarlo::quasiPrice with new paths; the
+ * result is biased low.
+ *
+ * @param rExercise The values of exercise divided by the numeraire.
+ * @param rBoundary The exercise boundary.
+ * @return The payoff of the option.
+ */
+TPayoff american (const TPathFunction &rExercise, const Boundary &rBoundary);
+
+/**
+ * Returns the payoff of the option with early exercise for the
+ * exercise region recorded in the backward induction on a lattice,
+ * see cfl::Exercise. The option is exercised at the first event time
+ * when the state process belongs to the exercise region. The event
+ * times of the lattice and of the paths should be the same.
+ *
+ * @param rExercise The values of exercise divided by the numeraire.
+ * @param rRegion The exercise region recorded for a payoff that
+ * depends on one state process.
+ * @return The payoff of the option.
+ */
+TPayoff american (const TPathFunction &rExercise, const Exercise &rRegion);
+} // namespace MonteCarlo
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iMonteCarlo.hpp"
+#endif // of __cflMonteCarlo_hpp__
@@ -0,0 +1,51 @@
+#ifndef __cflParallel_hpp__
+#define __cflParallel_hpp__
+
+/**
+ * @file Parallel.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Parallel execution of independent blocks of work.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <functional>
+
+namespace cfl
+{
+/**
+ * @ingroup cflCommonElements
+ *
+ * @defgroup cflParallel Parallel execution.
+ *
+ * This module contains a helper for the parallel execution of
+ * independent blocks of work, such as the rows and the columns of a
+ * two-dimensional grid.
+ * @{
+ */
+
+/**
+ * Splits the range \f$[0,n)\f$ into contiguous blocks and calls \p rF
+ * for every block. The first block is processed in the current
+ * thread and the others by a pool of worker threads that is started
+ * on the first call and is reused afterwards. The number of blocks
+ * does not exceed the number of hardware threads. If the range is
+ * small, then \p rF is called once in the current thread. The same
+ * holds for nested calls from \p rF. An exception thrown by \p rF is
+ * rethrown after all blocks have finished.
+ *
+ * @param iSize The size \f$n\f$ of the range.
+ * @param rF The function that processes the block \f$[iBegin,iEnd)\f$.
+ * Different blocks are processed concurrently.
+ * @param iMinBlock The minimal size of a block.
+ */
+void parallel (unsigned iSize,
+               const std::function<void (unsigned iBegin, unsigned iEnd)> &rF,
+               unsigned iMinBlock = 1);
+/** @} */
+} // namespace cfl
+
+#endif // of __cflParallel_hpp__
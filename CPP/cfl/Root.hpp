@@ -25,7 +25,10 @@ namespace cfl
  *
  * This module deals with bracketing algorithms for one-dimensional
  * root finding. These algorithms only require the computation of
- * function values.
+ * function values. The implementations of NRoot allocate the
+ * workspace of the solver once, with the object, and reuse it in all
+ * searches; a search that runs while another thread uses the
+ * workspace gets its own one.
  *
  * @{
  */
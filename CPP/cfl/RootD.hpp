@@ -25,7 +25,10 @@ namespace cfl
  *
  * This module deals with polishing algorithms for one-dimensional
  * root finding. These algorithms require the computation of both
- * the function and its derivatives.
+ * the function and its derivatives. The implementations of NRootD
+ * allocate the workspace of the solver once, with the object, and
+ * reuse it in all searches; a search that runs while another thread
+ * uses the workspace gets its own one.
  *
  * @{
  */
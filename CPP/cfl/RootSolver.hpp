@@ -0,0 +1,171 @@
+#ifndef __cflRootSolver_hpp__
+#define __cflRootSolver_hpp__
+
+/**
+ * @file RootSolver.hpp
+ * @author Dmitry Kramkov (kramkov@andrew.cmu.edu)
+ * @brief Reusable one-dimensional root solvers with warm starts.
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "cfl/Error.hpp"
+#include "cfl/Macros.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace cfl
+{
+/**
+ * @ingroup cflNumeric
+ *
+ * @defgroup cflRootSolver Reusable root solvers.
+ *
+ * This module contains one-dimensional root solvers for sequences of
+ * nearby equations, such as bootstrapping of curves, calibration of
+ * strips of options and implied volatilities along strikes. The
+ * solvers call the objective functions directly as template
+ * parameters, do not allocate memory and start from the previous
+ * solution or from a user supplied guess. Unlike cfl::Root and
+ * cfl::RootD, the objective does not have to be cfl::Function.
+ *
+ * @see cflRoot, cflRootD
+ * @{
+ */
+
+/**
+ * @brief The Brent-Dekker algorithm with bracketing from a guess.
+ *
+ * The root is bracketed, then the inverse quadratic interpolation
+ * is combined with bisection. We stop as soon as
+ * \f[
+ *  |a-b| < \epsilon + \delta \min(|a|,|b|),
+ * \f]
+ * where \f$[a,b]\f$ is the current working interval, or after \a
+ * iMaxSteps iterations.
+ */
+class Brent
+{
+public:
+  /**
+   * The constructor.
+   *
+   * @param dAbsErr (\f$\epsilon\f$) The absolute error for the root.
+   * @param dRelErr (\f$\delta\f$) The relative error for the root.
+   * @param iMaxSteps The maximal number of iterations.
+   */
+  Brent (double dAbsErr, double dRelErr, unsigned iMaxSteps = IMAX);
+
+  /**
+   * Finds the root of \p rF in the interval \f$[dL, dR]\f$. The values
+   * of \p rF at the end points have different signs.
+   *
+   * @param rF The function \f$x\mapsto f(x)\f$ called as
+   * <code>rF(dX)</code>.
+   * @param dL The left point of the interval.
+   * @param dR The right point of the interval.
+   * @return The root of \p rF.
+   */
+  template <class F> double find (const F &rF, double dL, double dR);
+
+  /**
+   * Finds the root of \p rF near the guess \p dX0. The interval
+   * \f$[dX0 - dStep, dX0 + dStep]\f$ is expanded geometrically until
+   * it brackets the root. A good guess is the solution of the
+   * previous, nearby, problem and a good step is the change between
+   * two previous solutions.
+   *
+   * @param rF The function \f$x\mapsto f(x)\f$ called as
+   * <code>rF(dX)</code>.
+   * @param dX0 The initial guess.
+   * @param dStep The half width of the initial interval.
+   * @return The root of \p rF.
+   */
+  template <class F> double findNear (const F &rF, double dX0, double dStep);
+
+  /**
+   * Returns the number of evaluations of the function in the last
+   * search.
+   *
+   * @return The number of evaluations.
+   */
+  unsigned evaluations () const;
+
+private:
+  template <class F>
+  double zeroin (const F &rF, double dA, double dFA, double dB, double dFB);
+
+  double m_dAbsErr, m_dRelErr;
+  unsigned m_iMaxSteps, m_iEval;
+};
+
+/**
+ * @brief Newton method safeguarded by bisection.
+ *
+ * The objective returns its value and derivative. If the Newton step
+ * leaves the current bracket of the root or does not reduce the
+ * bracket fast enough, then the bisection step is used. We stop as
+ * soon as
+ * \f[
+ *  |x_{n+1} - x_{n}| < \epsilon + \delta |x_{n+1}|
+ * \f]
+ * or after \a iMaxSteps iterations.
+ */
+class Newton
+{
+public:
+  /**
+   * The constructor.
+   *
+   * @param dAbsErr (\f$\epsilon\f$) The absolute error for the root.
+   * @param dRelErr (\f$\delta\f$) The relative error for the root.
+   * @param iMaxSteps The maximal number of iterations.
+   */
+  Newton (double dAbsErr, double dRelErr, unsigned iMaxSteps = IMAX);
+
+  /**
+   * Finds the root of \p rF by Newton method from the guess \p dX0.
+   * There is no safeguard.
+   *
+   * @param rF The function \f$x\mapsto (f(x), f'(x))\f$ called as
+   * <code>rF(dX)</code> and returning <code>std::pair<double,
+   * double></code>.
+   * @param dX0 The initial guess.
+   * @return The root of \p rF.
+   */
+  template <class F> double find (const F &rF, double dX0);
+
+  /**
+   * Finds the root of \p rF in the interval \f$[dL, dR]\f$ by Newton
+   * method from the guess \p dX0 safeguarded by bisection. The values
+   * of \p rF at the end points have different signs.
+   *
+   * @param rF The function \f$x\mapsto (f(x), f'(x))\f$ called as
+   * <code>rF(dX)</code> and returning <code>std::pair<double,
+   * double></code>.
+   * @param dX0 The initial guess from \f$[dL, dR]\f$.
+   * @param dL The left point of the interval.
+   * @param dR The right point of the interval.
+   * @return The root of \p rF.
+   */
+  template <class F>
+  double find (const F &rF, double dX0, double dL, double dR);
+
+  /**
+   * @copydoc Brent::evaluations
+   */
+  unsigned evaluations () const;
+
+private:
+  double m_dAbsErr, m_dRelErr;
+  unsigned m_iMaxSteps, m_iEval;
+};
+/** @} */
+} // namespace cfl
+
+#include "cfl/Inline/iRootSolver.hpp"
+#endif // of __cflRootSolver_hpp__
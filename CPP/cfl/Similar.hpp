@@ -51,6 +51,23 @@ typedef std::function<void (Slice &rSlice, unsigned iEventTime)> TRollback;
  */
 Model similar (const TRollback &rTargetRollback, const Model &rBase);
 
+/**
+ * Constructs the similar model given the implementations of the
+ * rollback operator and of its transpose in the setup of the base
+ * model. Deep copies of the inputs are kept inside of the result.
+ *
+ * @param rTargetRollback Runs the rollback operator of the target model in
+ * the framework of the base model.
+ * @param rTargetAdjointRollback Runs the transpose of the rollback
+ * operator of the target model in the framework of the base model. It
+ * moves \p rSlice forward to the event time with index \p iEventTime.
+ * @param rBase A constant reference to the base model.
+ * @return Model Implementation of the target model.
+ * @see IModel::adjointRollback
+ */
+Model similar (const TRollback &rTargetRollback,
+               const TRollback &rTargetAdjointRollback, const Model &rBase);
+
 /** @} */
 } // namespace cfl
 
@@ -532,10 +532,25 @@ Slice indicator (const Slice &rSlice, const Slice &rBarrier);
 Slice rollback (const Slice &rSlice, unsigned iEventTime);
 
 /**
- * @copydoc IModel::interpolate
+ * Returns the multifunction that interpolates \p rSlice with respect
+ * to the state processes on which \p rSlice depends. The range has
+ * dimension one: the value of the random payoff. The sensitivities
+ * computed by the model are given by cfl::greeks.
+ *
+ * @param rSlice A random variable in the model.
+ * @return The explicit functional dependence of the random payoff
+ * represented by \p rSlice on the state processes.
  */
 MultiFunction interpolate (const Slice &rSlice);
 
+/**
+ * @copydoc IModel::interpolate
+ *
+ * The components other than the value are computed only when they are
+ * requested.
+ */
+MultiFunction greeks (const Slice &rSlice);
+
 /**
  * Returns the multifunction that interpolates \p rSlice with respect to
  * state processes with indexes \p rStates. Other states are set to
@@ -584,6 +599,22 @@ MultiFunction interpolate (const Slice &rSlice, unsigned iStates);
  * processes.
  */
 std::valarray<double> atOrigin (const Slice &rSlice);
+
+/**
+ * Returns the components with indices \p rIndices of the value of
+ * random variable represented by \p rSlice and its sensitivities at
+ * the initial values of state processes. Only the requested
+ * sensitivities are computed.
+ *
+ * @param rSlice Some random payoff.
+ * @param rIndices The indices of the components. The index 0
+ * corresponds to the value.
+ * @return The components with indices \p rIndices of the value of
+ * random variable and its sensitivities at the initial values of
+ * state processes.
+ */
+std::valarray<double> atOrigin (const Slice &rSlice,
+                                const std::valarray<std::size_t> &rIndices);
 /** @} */
 } // namespace cfl
 
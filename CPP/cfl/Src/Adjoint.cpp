@@ -0,0 +1,677 @@
+#include "cfl/Adjoint.hpp"
+#include "cfl/Error.hpp"
+#include <cmath>
+
+using namespace cfl;
+using namespace std;
+
+namespace cflAdjoint
+{
+// the smoothed indicators couple a node only with its neighbours
+const unsigned c_iBand = 1;
+const unsigned c_iColors = 2 * c_iBand + 1;
+
+// the sharp indicator of the event rSlice > dBarrier
+Slice
+step (const Slice &rSlice, double dBarrier)
+{
+  Slice uStep (rSlice);
+  transform (begin (rSlice.values ()), end (rSlice.values ()),
+             begin (uStep.values ()),
+             [dBarrier] (double dX) { return (dX > dBarrier) ? 1. : 0.; });
+  return uStep;
+}
+
+double
+inner (const Slice &rX, const Slice &rY)
+{
+  return (rX * rY).values ().sum ();
+}
+
+void
+add (map<double, double> &rX, const map<double, double> &rY)
+{
+  for (const auto &rItem : rY)
+    {
+      rX[rItem.first] += rItem.second;
+    }
+}
+
+// the weights of the values of rSlice in atOrigin(rSlice)[0]
+Slice
+originWeights (const Slice &rSlice)
+{
+  const IModel &rModel = rSlice.model ();
+  unsigned iTime = rSlice.timeIndex ();
+  const vector<unsigned> &rDep = rSlice.dependence ();
+
+  if (rDep.size () == 0)
+    {
+      return Slice (&rModel, iTime, 1.);
+    }
+
+  Slice uW (rSlice);
+  valarray<double> &rW = uW.values ();
+  rW = 0.;
+
+  if (rDep.size () == 1)
+    {
+      // the origin is often a node of the grid
+      Slice uState = rModel.state (iTime, rDep.front ());
+      double dOrigin = rModel.origin ()[rDep.front ()];
+      const valarray<double> &rX = uState.values ();
+      ASSERT (rX.size () == rW.size ());
+      double dH = (rX.size () > 1) ? abs (rX[1] - rX[0]) : 1.;
+      for (unsigned iI = 0; iI < rX.size (); iI++)
+        {
+          if (abs (rX[iI] - dOrigin) < cfl::EPS * dH)
+            {
+              rW[iI] = 1.;
+              return uW;
+            }
+        }
+    }
+
+  // atOrigin is linear in the values
+  Slice uE (uW);
+  valarray<size_t> uValueIx (size_t (0), 1);
+  for (unsigned iI = 0; iI < rW.size (); iI++)
+    {
+      uE.values ()[iI] = 1.;
+      rW[iI] = atOrigin (uE, uValueIx)[0];
+      uE.values ()[iI] = 0.;
+    }
+  return uW;
+}
+
+// one half of the second derivative of rSlice with respect to the
+// state process; the derivative of the gaussian rollback with respect
+// to its variance
+Slice
+halfGamma (const Slice &rSlice)
+{
+  PRECONDITION (rSlice.dependence ().size () <= 1);
+
+  Slice uG (rSlice);
+  valarray<double> &rG = uG.values ();
+  rG = 0.;
+  if (rSlice.dependence ().size () == 0)
+    {
+      return uG;
+    }
+
+  const valarray<double> &rV = rSlice.values ();
+  Slice uState
+      = rSlice.model ().state (rSlice.timeIndex (), rSlice.dependence ()[0]);
+  const valarray<double> &rX = uState.values ();
+
+  ASSERT (rX.size () == rV.size ());
+
+  for (unsigned iI = 1; iI + 1 < rV.size (); iI++)
+    {
+      double dL = rX[iI] - rX[iI - 1];
+      double dR = rX[iI + 1] - rX[iI];
+      rG[iI] = ((rV[iI + 1] - rV[iI]) / dR - (rV[iI] - rV[iI - 1]) / dL)
+               / (dL + dR);
+    }
+  return uG;
+}
+
+// the transpose of the Jacobian of the smoothed indicator applied to
+// rAdjoint; we use coloring of the banded Jacobian
+Slice
+indicatorAdjoint (const Slice &rSlice, double dBarrier, const Slice &rAdjoint)
+{
+  PRECONDITION (rSlice.dependence ().size () <= 1);
+  PRECONDITION (rAdjoint.values ().size () == rSlice.values ().size ());
+
+  const valarray<double> &rV = rSlice.values ();
+  const valarray<double> &rA = rAdjoint.values ();
+  unsigned iSize = rV.size ();
+  double dH = 1E-6 * std::max (1., abs (rV).max ());
+
+  Slice uResult (rAdjoint);
+  valarray<double> &rResult = uResult.values ();
+  rResult = 0.;
+
+  for (unsigned iC = 0; iC < std::min (c_iColors, iSize); iC++)
+    {
+      Slice uUp (rSlice), uDown (rSlice);
+      for (unsigned iK = iC; iK < iSize; iK += c_iColors)
+        {
+          uUp.values ()[iK] += dH;
+          uDown.values ()[iK] -= dH;
+        }
+      valarray<double> uD = (indicator (uUp, dBarrier).values ()
+                             - indicator (uDown, dBarrier).values ())
+                            / (2. * dH);
+
+      // output node iM depends on the perturbed node iK of color iC
+      for (unsigned iM = 0; iM < iSize; iM++)
+        {
+          int iR = int ((iC + c_iColors * iSize - iM) % c_iColors);
+          if (iR > int (c_iBand))
+            {
+              iR -= c_iColors;
+            }
+          int iK = int (iM) + iR;
+          if ((iK >= 0) && (iK < int (iSize)))
+            {
+              rResult[iK] += rA[iM] * uD[iM];
+            }
+        }
+    }
+  return uResult;
+}
+} // namespace cflAdjoint
+
+using namespace cflAdjoint;
+
+// class TapeSlice
+
+cfl::TapeSlice::TapeSlice () : m_pTape (0), m_iNode (0) {}
+
+cfl::TapeSlice::TapeSlice (Tape *pTape, unsigned iNode, const Slice &rValue)
+    : m_pTape (pTape), m_iNode (iNode), m_uValue (rValue)
+{
+}
+
+void
+cfl::TapeSlice::rollback (unsigned iEventTime)
+{
+  PRECONDITION (iEventTime <= timeIndex ());
+
+  if (iEventTime == timeIndex ())
+    {
+      return;
+    }
+
+  unsigned iTime = timeIndex ();
+  Slice uValue (m_uValue);
+  uValue.rollback (iEventTime);
+  Tape &rTape = tape ();
+  unsigned iNode = m_iNode;
+  const IModel *pModel = &m_uValue.model ();
+
+  *this = rTape.record (
+      uValue, [&rTape, iNode, iTime, uValue, pModel] (const Slice &rA) {
+        Slice uA (rA);
+        pModel->adjointRollback (uA, iTime);
+        rTape.accumulate (iNode, uA);
+        const vector<double> &rTimes = pModel->eventTimes ();
+        if (rTape.m_bDiscountRollback)
+          {
+            // the rollback contains the factor D(t_j)/D(t_i)
+            double dA = inner (rA, uValue);
+            rTape.m_uDiscount[rTimes[iTime]] += dA;
+            rTape.m_uDiscount[rTimes[uValue.timeIndex ()]] -= dA;
+          }
+        if (rTape.m_bVarianceRollback)
+          {
+            // the variance of the rollback is Sigma(t_j) - Sigma(t_i)
+            double dA = inner (rA, halfGamma (uValue));
+            rTape.m_uVariance[rTimes[iTime]] += dA;
+            rTape.m_uVariance[rTimes[uValue.timeIndex ()]] -= dA;
+          }
+      });
+}
+
+// class Tape
+
+cfl::Tape::Tape (bool bDiscountRollback, bool bVarianceRollback)
+    : m_bDiscountRollback (bDiscountRollback),
+      m_bVarianceRollback (bVarianceRollback)
+{
+}
+
+TapeSlice
+cfl::Tape::record (const Slice &rValue, const TBackward &rBackward)
+{
+  Node uNode;
+  uNode.pModel = &rValue.model ();
+  uNode.iTime = rValue.timeIndex ();
+  uNode.uDependence = rValue.dependence ();
+  uNode.uBackward = rBackward;
+  m_uNodes.push_back (uNode);
+
+  return TapeSlice (this, m_uNodes.size () - 1, rValue);
+}
+
+TapeSlice
+cfl::Tape::input (const Slice &rValue)
+{
+  return record (rValue, TBackward ());
+}
+
+TapeSlice
+cfl::Tape::input (const Slice &rValue, const vector<Slice> &rDerivative)
+{
+  unsigned iParameters = rDerivative.size ();
+  if (m_uSensitivity.size () < iParameters)
+    {
+      valarray<double> uSensitivity (0., iParameters);
+      uSensitivity[slice (0, m_uSensitivity.size (), 1)] = m_uSensitivity;
+      m_uSensitivity.swap (uSensitivity);
+    }
+
+  return record (rValue, [this, rDerivative] (const Slice &rA) {
+    for (unsigned iI = 0; iI < rDerivative.size (); iI++)
+      {
+        m_uSensitivity[iI] += inner (rA, rDerivative[iI]);
+      }
+  });
+}
+
+TapeSlice
+cfl::Tape::discount (const Slice &rDiscount, double dMaturity)
+{
+  double dTime = rDiscount.model ().eventTimes ()[rDiscount.timeIndex ()];
+
+  PRECONDITION (dMaturity >= dTime);
+
+  return record (rDiscount, [this, rDiscount, dMaturity,
+                             dTime] (const Slice &rA) {
+    double dA = inner (rA, rDiscount);
+    m_uDiscount[dMaturity] += dA;
+    m_uDiscount[dTime] -= dA;
+  });
+}
+
+TapeSlice
+cfl::Tape::forward (const Slice &rForward, double dMaturity)
+{
+  return record (rForward, [this, rForward, dMaturity] (const Slice &rA) {
+    m_uForward[dMaturity] += inner (rA, rForward);
+  });
+}
+
+TapeSlice
+cfl::Tape::forward (const Slice &rForward, double dMaturity, double dShape)
+{
+  double dTime = rForward.model ().eventTimes ()[rForward.timeIndex ()];
+
+  PRECONDITION (dMaturity >= dTime);
+
+  return record (rForward, [this, rForward, dMaturity, dTime,
+                            dShape] (const Slice &rA) {
+    double dA = inner (rA, rForward);
+    m_uForward[dMaturity] += dA;
+    m_uVariance[dTime] -= 0.5 * dShape * dShape * dA;
+  });
+}
+
+void
+cfl::Tape::accumulate (const TapeSlice &rSlice, const Slice &rAdjoint)
+{
+  PRECONDITION (rSlice.m_pTape == this);
+
+  accumulate (rSlice.m_iNode, rAdjoint);
+}
+
+void
+cfl::Tape::accumulate (unsigned iNode, const Slice &rAdjoint)
+{
+  PRECONDITION (iNode < m_uAdjoint.size ());
+
+  const Node &rNode = m_uNodes[iNode];
+
+  PRECONDITION (&rAdjoint.model () == rNode.pModel);
+  PRECONDITION (rAdjoint.timeIndex () == rNode.iTime);
+
+  // the adjoint of a broadcast constant is the sum over the nodes
+  Slice uA = ((rNode.uDependence.size () == 0)
+              && (rAdjoint.dependence ().size () > 0))
+                 ? Slice (rNode.pModel, rNode.iTime, rAdjoint.values ().sum ())
+                 : rAdjoint;
+
+  if (m_uHasAdjoint[iNode])
+    {
+      m_uAdjoint[iNode] += uA;
+    }
+  else
+    {
+      m_uAdjoint[iNode] = uA;
+      m_uHasAdjoint[iNode] = true;
+    }
+}
+
+TapeSlice
+cfl::Tape::checkpoint (
+    const TapeSlice &rInput,
+    const std::function<TapeSlice (const TapeSlice &)> &rSegment)
+{
+  PRECONDITION (rInput.m_pTape == this);
+
+  Slice uOutput;
+  {
+    Tape uTape (m_bDiscountRollback, m_bVarianceRollback);
+    TapeSlice uOut = rSegment (uTape.input (rInput.value ()));
+
+    PRECONDITION (uOut.m_pTape == &uTape);
+
+    uOutput = uOut.value ();
+  }
+
+  unsigned iNode = rInput.m_iNode;
+  Slice uInput = rInput.value ();
+  bool bDiscountRollback = m_bDiscountRollback;
+  bool bVarianceRollback = m_bVarianceRollback;
+
+  return record (uOutput, [this, iNode, uInput, rSegment, bDiscountRollback,
+                           bVarianceRollback] (const Slice &rA) {
+    Tape uTape (bDiscountRollback, bVarianceRollback);
+    TapeSlice uIn = uTape.input (uInput);
+    TapeSlice uOut = rSegment (uIn);
+    uTape.backward (uOut, rA);
+    accumulate (iNode, uTape.adjoint (uIn));
+    merge (uTape);
+  });
+}
+
+void
+cfl::Tape::merge (const Tape &rTape)
+{
+  if (m_uSensitivity.size () < rTape.m_uSensitivity.size ())
+    {
+      valarray<double> uSensitivity (0., rTape.m_uSensitivity.size ());
+      uSensitivity[slice (0, m_uSensitivity.size (), 1)] = m_uSensitivity;
+      m_uSensitivity.swap (uSensitivity);
+    }
+  for (unsigned iI = 0; iI < rTape.m_uSensitivity.size (); iI++)
+    {
+      m_uSensitivity[iI] += rTape.m_uSensitivity[iI];
+    }
+  add (m_uDiscount, rTape.m_uDiscount);
+  add (m_uForward, rTape.m_uForward);
+  add (m_uVariance, rTape.m_uVariance);
+}
+
+void
+cfl::Tape::backward (const TapeSlice &rOutput)
+{
+  backward (rOutput, originWeights (rOutput.value ()));
+}
+
+void
+cfl::Tape::backward (const TapeSlice &rOutput, const Slice &rSeed)
+{
+  PRECONDITION (rOutput.m_pTape == this);
+
+  m_uAdjoint.assign (m_uNodes.size (), Slice ());
+  m_uHasAdjoint.assign (m_uNodes.size (), false);
+  m_uSensitivity = 0.;
+  m_uDiscount.clear ();
+  m_uForward.clear ();
+  m_uVariance.clear ();
+
+  accumulate (rOutput.m_iNode, rSeed);
+
+  for (unsigned iNode = rOutput.m_iNode + 1; iNode-- > 0;)
+    {
+      const Node &rNode = m_uNodes[iNode];
+      if (!(m_uHasAdjoint[iNode] && rNode.uBackward))
+        {
+          continue;
+        }
+      Slice &rA = m_uAdjoint[iNode];
+      if (rA.dependence () != rNode.uDependence)
+        {
+          rNode.pModel->addDependence (rA, rNode.uDependence);
+        }
+      rNode.uBackward (rA);
+      // only the adjoints of the inputs are kept
+      rA = Slice ();
+      m_uHasAdjoint[iNode] = false;
+    }
+}
+
+Slice
+cfl::Tape::adjoint (const TapeSlice &rInput) const
+{
+  PRECONDITION (rInput.m_pTape == this);
+  PRECONDITION (rInput.m_iNode < m_uAdjoint.size ());
+
+  const Node &rNode = m_uNodes[rInput.m_iNode];
+  if (!m_uHasAdjoint[rInput.m_iNode])
+    {
+      return Slice (rNode.pModel, rNode.iTime, 0.);
+    }
+  Slice uA (m_uAdjoint[rInput.m_iNode]);
+  if (uA.dependence () != rNode.uDependence)
+    {
+      rNode.pModel->addDependence (uA, rNode.uDependence);
+    }
+  return uA;
+}
+
+double
+cfl::Tape::discountSensitivity (const Function &rDerivative) const
+{
+  double dSum = 0.;
+  for (const auto &rItem : m_uDiscount)
+    {
+      dSum += rItem.second * rDerivative (rItem.first);
+    }
+  return dSum;
+}
+
+double
+cfl::Tape::forwardSensitivity (const Function &rDerivative) const
+{
+  double dSum = 0.;
+  for (const auto &rItem : m_uForward)
+    {
+      dSum += rItem.second * rDerivative (rItem.first);
+    }
+  return dSum;
+}
+
+double
+cfl::Tape::varianceSensitivity (const Function &rDerivative) const
+{
+  double dSum = 0.;
+  for (const auto &rItem : m_uVariance)
+    {
+      dSum += rItem.second * rDerivative (rItem.first);
+    }
+  return dSum;
+}
+
+// functions
+
+namespace cflAdjoint
+{
+Tape &
+commonTape (const TapeSlice &rX, const TapeSlice &rY)
+{
+  PRECONDITION (&rX.tape () == &rY.tape ());
+
+  return rX.tape ();
+}
+} // namespace cflAdjoint
+
+TapeSlice
+cfl::operator- (const TapeSlice &rSlice)
+{
+  Tape &rTape = rSlice.tape ();
+  return rTape.record (-rSlice.value (), [&rTape, rSlice] (const Slice &rA) {
+    rTape.accumulate (rSlice, -rA);
+  });
+}
+
+TapeSlice
+cfl::operator+ (const TapeSlice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = commonTape (rX, rY);
+  return rTape.record (rX.value () + rY.value (),
+                       [&rTape, rX, rY] (const Slice &rA) {
+                         rTape.accumulate (rX, rA);
+                         rTape.accumulate (rY, rA);
+                       });
+}
+
+TapeSlice
+cfl::operator- (const TapeSlice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = commonTape (rX, rY);
+  return rTape.record (rX.value () - rY.value (),
+                       [&rTape, rX, rY] (const Slice &rA) {
+                         rTape.accumulate (rX, rA);
+                         rTape.accumulate (rY, -rA);
+                       });
+}
+
+TapeSlice
+cfl::operator* (const TapeSlice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = commonTape (rX, rY);
+  return rTape.record (rX.value () * rY.value (),
+                       [&rTape, rX, rY] (const Slice &rA) {
+                         rTape.accumulate (rX, rA * rY.value ());
+                         rTape.accumulate (rY, rA * rX.value ());
+                       });
+}
+
+TapeSlice
+cfl::operator/ (const TapeSlice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = commonTape (rX, rY);
+  Slice uZ = rX.value () / rY.value ();
+  return rTape.record (uZ, [&rTape, rX, rY, uZ] (const Slice &rA) {
+    Slice uA = rA / rY.value ();
+    rTape.accumulate (rX, uA);
+    rTape.accumulate (rY, -uA * uZ);
+  });
+}
+
+TapeSlice
+cfl::operator+ (const TapeSlice &rX, const Slice &rY)
+{
+  Tape &rTape = rX.tape ();
+  return rTape.record (rX.value () + rY, [&rTape, rX] (const Slice &rA) {
+    rTape.accumulate (rX, rA);
+  });
+}
+
+TapeSlice
+cfl::operator+ (const Slice &rX, const TapeSlice &rY)
+{
+  return rY + rX;
+}
+
+TapeSlice
+cfl::operator- (const TapeSlice &rX, const Slice &rY)
+{
+  return rX + (-rY);
+}
+
+TapeSlice
+cfl::operator- (const Slice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = rY.tape ();
+  return rTape.record (rX - rY.value (), [&rTape, rY] (const Slice &rA) {
+    rTape.accumulate (rY, -rA);
+  });
+}
+
+TapeSlice
+cfl::operator* (const TapeSlice &rX, const Slice &rY)
+{
+  Tape &rTape = rX.tape ();
+  return rTape.record (rX.value () * rY, [&rTape, rX, rY] (const Slice &rA) {
+    rTape.accumulate (rX, rA * rY);
+  });
+}
+
+TapeSlice
+cfl::operator* (const Slice &rX, const TapeSlice &rY)
+{
+  return rY * rX;
+}
+
+TapeSlice
+cfl::operator/ (const TapeSlice &rX, const Slice &rY)
+{
+  Tape &rTape = rX.tape ();
+  return rTape.record (rX.value () / rY, [&rTape, rX, rY] (const Slice &rA) {
+    rTape.accumulate (rX, rA / rY);
+  });
+}
+
+TapeSlice
+cfl::operator/ (const Slice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = rY.tape ();
+  Slice uZ = rX / rY.value ();
+  return rTape.record (uZ, [&rTape, rY, uZ] (const Slice &rA) {
+    rTape.accumulate (rY, -rA * uZ / rY.value ());
+  });
+}
+
+TapeSlice
+cfl::max (const TapeSlice &rSlice, double dValue)
+{
+  Tape &rTape = rSlice.tape ();
+  Slice uStep = step (rSlice.value (), dValue);
+  return rTape.record (max (rSlice.value (), dValue),
+                       [&rTape, rSlice, uStep] (const Slice &rA) {
+                         rTape.accumulate (rSlice, rA * uStep);
+                       });
+}
+
+TapeSlice
+cfl::max (const TapeSlice &rX, const TapeSlice &rY)
+{
+  Tape &rTape = commonTape (rX, rY);
+  Slice uStep = step (rX.value () - rY.value (), 0.);
+  return rTape.record (max (rX.value (), rY.value ()),
+                       [&rTape, rX, rY, uStep] (const Slice &rA) {
+                         Slice uA = rA * uStep;
+                         rTape.accumulate (rX, uA);
+                         rTape.accumulate (rY, rA - uA);
+                       });
+}
+
+TapeSlice
+cfl::exp (const TapeSlice &rSlice)
+{
+  Tape &rTape = rSlice.tape ();
+  Slice uZ = exp (rSlice.value ());
+  return rTape.record (uZ, [&rTape, rSlice, uZ] (const Slice &rA) {
+    rTape.accumulate (rSlice, rA * uZ);
+  });
+}
+
+TapeSlice
+cfl::log (const TapeSlice &rSlice)
+{
+  Tape &rTape = rSlice.tape ();
+  return rTape.record (log (rSlice.value ()),
+                       [&rTape, rSlice] (const Slice &rA) {
+                         rTape.accumulate (rSlice, rA / rSlice.value ());
+                       });
+}
+
+TapeSlice
+cfl::pow (const TapeSlice &rSlice, double dPower)
+{
+  Tape &rTape = rSlice.tape ();
+  return rTape.record (
+      pow (rSlice.value (), dPower),
+      [&rTape, rSlice, dPower] (const Slice &rA) {
+        rTape.accumulate (rSlice,
+                          rA * (dPower * pow (rSlice.value (), dPower - 1.)));
+      });
+}
+
+TapeSlice
+cfl::indicator (const TapeSlice &rSlice, double dBarrier)
+{
+  Tape &rTape = rSlice.tape ();
+  return rTape.record (
+      indicator (rSlice.value (), dBarrier),
+      [&rTape, rSlice, dBarrier] (const Slice &rA) {
+        rTape.accumulate (rSlice,
+                          indicatorAdjoint (rSlice.value (), dBarrier, rA));
+      });
+}
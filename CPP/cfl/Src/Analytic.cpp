@@ -0,0 +1,509 @@
+#include "cfl/Analytic.hpp"
+#include "cfl/Error.hpp"
+#include "cfl/Parallel.hpp"
+#include "cfl/RootSolver.hpp"
+#include <cmath>
+#include <gsl/gsl_cdf.h>
+#include <limits>
+
+using namespace cfl;
+
+namespace cflAnalytic
+{
+double
+normal (double dX)
+{
+  return 0.5 * std::erfc (-dX * std::sqrt (0.5));
+}
+
+double
+density (double dX)
+{
+  return std::exp (-0.5 * dX * dX) / std::sqrt (2. * M_PI);
+}
+
+// the price as a function of the initial state; rF returns the
+// value, delta and gamma; vega equals dStd * gamma as for the
+// Brownian motion
+MultiFunction
+multiFunction (const std::function<std::valarray<double> (double)> &rF,
+               double dStd)
+{
+  std::function<std::valarray<double> (const std::valarray<double> &,
+                                       const std::valarray<size_t> &)>
+      uFF = [rF, dStd] (const std::valarray<double> &rX,
+                        const std::valarray<size_t> &rI) {
+        PRECONDITION (rX.size () == 1);
+
+        std::valarray<double> uV = rF (rX[0]);
+        std::valarray<double> uY (rI.size ());
+        for (unsigned iI = 0; iI < rI.size (); iI++)
+          {
+            PRECONDITION (rI[iI] < 4);
+
+            uY[iI] = (rI[iI] < 3) ? uV[rI[iI]] : dStd * uV[2];
+          }
+        return uY;
+      };
+  std::function<std::valarray<double> (const std::valarray<double> &)> uFX
+      = [uFF] (const std::valarray<double> &rX) {
+          return uFF (rX, std::valarray<size_t>{ 0, 1, 2, 3 });
+        };
+  std::function<bool (const std::valarray<double> &)> uBelongs
+      = [] (const std::valarray<double> &rX) { return rX.size () == 1; };
+
+  return MultiFunction (uFF, uFX, uBelongs, 1, 4);
+}
+
+// value, delta and gamma of the option on the discount bond with
+// maturity S; the prices of the discount bonds at the initial state x
+// are dPT exp(dBT x) and dPS exp(dBS x), dStd is the standard
+// deviation of the state at the maturity T of the option
+std::valarray<double>
+bondOption (double dX, double dPT, double dBT, double dPS, double dBS,
+            double dStrike, double dStd, bool bCall)
+{
+  double dT = dStrike * dPT * std::exp (dBT * dX);
+  double dS = dPS * std::exp (dBS * dX);
+  // the forward contract
+  std::valarray<double> uF
+      = { dS - dT, dBS * dS - dBT * dT, dBS * dBS * dS - dBT * dBT * dT };
+  double dV = (dBS - dBT) * dStd;
+  std::valarray<double> uC (0., 3);
+
+  if (dV < cfl::EPS)
+    {
+      if (uF[0] > 0)
+        {
+          uC = uF;
+        }
+    }
+  else
+    {
+      double dD1 = std::log (dS / dT) / dV + 0.5 * dV;
+      double dD2 = dD1 - dV;
+      double dN1 = normal (dD1);
+      double dN2 = normal (dD2);
+      uC[0] = dS * dN1 - dT * dN2;
+      uC[1] = dBS * dS * dN1 - dBT * dT * dN2;
+      uC[2] = dBS * dBS * dS * dN1 - dBT * dBT * dT * dN2
+              + (dBS - dBT) * dS * density (dD1) / dStd;
+    }
+
+  return bCall ? uC : std::valarray<double> (uC - uF);
+}
+
+// the normalized price of the call with log-moneyness dX = ln(F/K) <= 0
+// and total standard deviation dS:
+// b(x,s) = exp(x/2) N(x/s + s/2) - exp(-x/2) N(x/s - s/2)
+double
+normalizedCall (double dX, double dS)
+{
+  if (dS <= 0.)
+    {
+      return 0.;
+    }
+  double dD = dX / dS;
+  double dH = 0.5 * dS;
+  return std::exp (0.5 * dX) * normal (dD + dH)
+         - std::exp (-0.5 * dX) * normal (dD - dH);
+}
+
+// the derivative of the normalized price with respect to dS
+double
+normalizedVega (double dX, double dS)
+{
+  return std::exp (0.5 * dX) * density (dX / dS + 0.5 * dS);
+}
+
+// the maximal number of iterations; the bisection is used rarely
+const unsigned c_iMaxSteps = 64;
+
+// solves b(x_i, s_i) = beta_i for the quotes [iBegin, iEnd); the
+// quotes are processed together, and the converged quotes are removed
+// from the active set after every iteration
+void
+normalizedVol (const std::valarray<double> &rX,
+               const std::valarray<double> &rBeta, std::valarray<double> &rS,
+               double dErr, unsigned iBegin, unsigned iEnd)
+{
+  double dInf = std::numeric_limits<double>::infinity ();
+  unsigned iN = iEnd - iBegin;
+  // the brackets, the branches and the logarithms of the targets
+  std::vector<double> uLo (iN, 0.), uHi (iN, dInf), uLogBeta (iN, 0.);
+  std::vector<bool> uLower (iN, false);
+  std::vector<unsigned> uActive;
+  uActive.reserve (iN);
+
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      unsigned iQ = iBegin + iI;
+      double dX = rX[iQ];
+      double dBeta = rBeta[iQ];
+      if (std::isnan (rS[iQ]))
+        {
+          continue;
+        }
+      if (dBeta <= 0.)
+        {
+          rS[iQ] = 0.;
+          continue;
+        }
+      // b(x, .) is convex below and concave above the inflection point
+      double dSC = std::sqrt (-2. * dX);
+      double dBC = normalizedCall (dX, dSC);
+      if (dBeta < dBC)
+        {
+          uLower[iI] = true;
+          uHi[iI] = dSC;
+          uLogBeta[iI] = std::log (dBeta);
+          // ln b is close to -x^2/(2 s^2) for small s
+          rS[iQ] = dSC * std::sqrt (std::log (dBC) / uLogBeta[iI]);
+        }
+      else
+        {
+          uLo[iI] = dSC;
+          // exact for x = 0
+          double dU = (dBeta - dBC) / (std::exp (0.5 * dX) - dBC);
+          rS[iQ] = dSC + 2. * gsl_cdf_ugaussian_Pinv (0.5 * (1. + dU));
+        }
+      uActive.push_back (iI);
+    }
+
+  unsigned iStep = 0;
+  while ((uActive.size () > 0) && (iStep < c_iMaxSteps))
+    {
+      unsigned iNext = 0;
+      for (unsigned iI : uActive)
+        {
+          unsigned iQ = iBegin + iI;
+          double dX = rX[iQ];
+          double dS = rS[iQ];
+          double dB = normalizedCall (dX, dS);
+          // the first derivative of b in s and the ratios of the second
+          // and the third derivatives to the first one
+          double dV = density (dX / dS) * std::exp (-0.125 * dS * dS);
+          double dX2 = dX * dX;
+          double dH2 = dX2 / (dS * dS * dS) - 0.25 * dS;
+          double dH3 = dH2 * dH2 - 3. * dX2 / (dS * dS * dS * dS) - 0.25;
+          double dF, dDF;
+          if (uLower[iI])
+            {
+              if (!(dB > 0.))
+                {
+                  dF = -dInf;
+                  dDF = dInf;
+                }
+              else
+                {
+                  // the same for ln b
+                  double dR = dV / dB;
+                  dF = std::log (dB) - uLogBeta[iI];
+                  dDF = dR;
+                  dH3 = dH3 - 3. * dR * dH2 + 2. * dR * dR;
+                  dH2 = dH2 - dR;
+                }
+            }
+          else
+            {
+              dF = dB - rBeta[iQ];
+              dDF = dV;
+            }
+          if (dF > 0.)
+            {
+              uHi[iI] = dS;
+            }
+          else
+            {
+              uLo[iI] = dS;
+            }
+
+          double dNu = -dF / dDF;
+          double dDen = 1. + dNu * (dH2 + dH3 * dNu / 6.);
+          double dStep
+              = (dDen > 0.) ? dNu * (1. + 0.5 * dH2 * dNu) / dDen : dNu;
+          double dNew = dS + dStep;
+          if (!((dNew >= uLo[iI]) && (dNew <= uHi[iI])))
+            {
+              dNew = (uHi[iI] < dInf) ? 0.5 * (uLo[iI] + uHi[iI])
+                                      : 2. * std::max (dS, uLo[iI]);
+            }
+          rS[iQ] = dNew;
+          if ((dF != 0.) && !(std::abs (dNew - dS) <= dErr * dNew))
+            {
+              uActive[iNext++] = iI;
+            }
+        }
+      uActive.resize (iNext);
+      iStep++;
+    }
+}
+} // namespace cflAnalytic
+
+using namespace cflAnalytic;
+
+MultiFunction
+cfl::NAnalytic::forwardOption (const Black::Data &rData, double dStrike,
+                               double dMaturity, double dForwardMaturity,
+                               bool bCall)
+{
+  PRECONDITION (dMaturity >= rData.initialTime);
+  PRECONDITION (dForwardMaturity >= dMaturity);
+  PRECONDITION (dStrike > 0);
+
+  double dStd = rData.volatility (dMaturity)
+                * std::sqrt (dMaturity - rData.initialTime);
+  double dA = rData.shape (dForwardMaturity);
+  double dDiscount = rData.discount (dMaturity);
+  double dForward = rData.forward (dForwardMaturity);
+
+  std::function<std::valarray<double> (double)> uF = [dStrike, dStd, dA,
+                                                      dDiscount, dForward,
+                                                      bCall] (double dX) {
+    double dF = dForward * std::exp (dA * dX);
+    double dV = std::abs (dA) * dStd;
+    // the value and the derivatives with respect to the forward price
+    double dC, dDC, dGC;
+    if (dV < cfl::EPS)
+      {
+        bool bIn = (dF > dStrike);
+        dC = bIn ? dF - dStrike : 0.;
+        dDC = bIn ? 1. : 0.;
+        dGC = 0.;
+      }
+    else
+      {
+        double dD1 = std::log (dF / dStrike) / dV + 0.5 * dV;
+        double dN1 = normal (dD1);
+        dC = dF * dN1 - dStrike * normal (dD1 - dV);
+        dDC = dN1;
+        dGC = density (dD1) / (dF * dV);
+      }
+    if (!bCall)
+      {
+        dC -= dF - dStrike;
+        dDC -= 1.;
+      }
+    std::valarray<double> uV
+        = { dC, dA * dF * dDC, dA * dA * (dF * dDC + dF * dF * dGC) };
+    return std::valarray<double> (uV * dDiscount);
+  };
+
+  return multiFunction (uF, dStd);
+}
+
+MultiFunction
+cfl::NAnalytic::option (const Black::Data &rData, double dStrike,
+                        double dMaturity, bool bCall)
+{
+  return forwardOption (rData, dStrike, dMaturity, dMaturity, bCall);
+}
+
+MultiFunction
+cfl::NAnalytic::bondOption (const HullWhite::Data &rData,
+                            const std::vector<double> &rPaymentTimes,
+                            const std::vector<double> &rPayments,
+                            double dStrike, double dMaturity, bool bCall)
+{
+  PRECONDITION (dMaturity >= rData.initialTime);
+  PRECONDITION (rPaymentTimes.size () > 0);
+  PRECONDITION (rPaymentTimes.size () == rPayments.size ());
+  PRECONDITION (rPaymentTimes.front () > dMaturity);
+  PRECONDITION (std::equal (rPaymentTimes.begin () + 1, rPaymentTimes.end (),
+                            rPaymentTimes.begin (), std::greater<double> ()));
+  PRECONDITION (dStrike > 0);
+
+  double dStd = rData.volatility (dMaturity)
+                * std::sqrt (dMaturity - rData.initialTime);
+  double dA = rData.shape (rData.initialTime);
+  double dBT = rData.shape (dMaturity) - dA;
+  double dPT = rData.discount (dMaturity);
+  unsigned iN = rPaymentTimes.size ();
+  std::valarray<double> uB (iN), uP (iN), uC (iN);
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      PRECONDITION (rPayments[iI] > 0);
+
+      uB[iI] = rData.shape (rPaymentTimes[iI]) - dA;
+      uP[iI] = rData.discount (rPaymentTimes[iI]);
+      uC[iI] = rPayments[iI];
+    }
+
+  // the strikes of the options on the discount bonds are their
+  // prices at the maturity when the coupon bond is worth dStrike;
+  // they do not depend on the initial state
+  std::valarray<double> uStrike (dStrike / uC[0], 1);
+  if (iN > 1)
+    {
+      // the prices of the discount bonds at maturity as functions of
+      // the state
+      std::function<std::valarray<double> (double)> uBond
+          = [uB, uP, dBT, dPT, dStd] (double dZ) {
+              std::valarray<double> uBT (uB - dBT);
+              std::valarray<double> uE (uBT * dZ
+                                        - 0.5 * uBT * uBT * dStd * dStd);
+              return std::valarray<double> (uP / dPT * std::exp (uE));
+            };
+      auto uF = [&uBond, &uC, dStrike] (double dZ) {
+        return (uC * uBond (dZ)).sum () - dStrike;
+      };
+      double dZ = Brent (cfl::EPS, cfl::EPS).findNear (uF, 0., 1.);
+      // one step of Newton method
+      std::valarray<double> uBond0 = uC * uBond (dZ);
+      dZ -= (uBond0.sum () - dStrike) / (uBond0 * (uB - dBT)).sum ();
+      uStrike = uBond (dZ);
+    }
+
+  std::function<std::valarray<double> (double)> uF
+      = [uB, uP, uC, uStrike, dBT, dPT, dStd, bCall] (double dX) {
+          std::valarray<double> uV (0., 3);
+          for (unsigned iI = 0; iI < uC.size (); iI++)
+            {
+              uV += uC[iI]
+                    * cflAnalytic::bondOption (dX, dPT, dBT, uP[iI], uB[iI],
+                                               uStrike[iI], dStd, bCall);
+            }
+          return uV;
+        };
+
+  return multiFunction (uF, dStd);
+}
+
+MultiFunction
+cfl::NAnalytic::cap (const HullWhite::Data &rData, const Data::CashFlow &rCap)
+{
+  PRECONDITION (rCap.numberOfPayments > 0);
+
+  // the caplet for the period [t, t + period] is the put on the
+  // discount bond with the strike 1/(1 + rate * period) at t
+  double dCapFactor = 1. + rCap.rate * rCap.period;
+  double dA = rData.shape (rData.initialTime);
+  std::vector<std::valarray<double> > uCaplet;
+  double dTime = rData.initialTime;
+  for (unsigned iI = 0; iI < rCap.numberOfPayments; iI++)
+    {
+      double dStd
+          = rData.volatility (dTime) * std::sqrt (dTime - rData.initialTime);
+      uCaplet.push_back ({ rData.discount (dTime), rData.shape (dTime) - dA,
+                           rData.discount (dTime + rCap.period),
+                           rData.shape (dTime + rCap.period) - dA, dStd });
+      dTime += rCap.period;
+    }
+  double dStd = uCaplet.back ()[4];
+
+  std::function<std::valarray<double> (double)> uF
+      = [uCaplet, dCapFactor, dNotional = rCap.notional] (double dX) {
+          std::valarray<double> uV (0., 3);
+          for (const std::valarray<double> &rC : uCaplet)
+            {
+              uV += cflAnalytic::bondOption (dX, rC[0], rC[1], rC[2], rC[3],
+                                             1. / dCapFactor, rC[4], false);
+            }
+          return std::valarray<double> (uV * (dNotional * dCapFactor));
+        };
+
+  return multiFunction (uF, dStd);
+}
+
+MultiFunction
+cfl::NAnalytic::swaption (const HullWhite::Data &rData,
+                          const Data::Swap &rSwap, double dMaturity)
+{
+  PRECONDITION (rSwap.numberOfPayments > 0);
+
+  // the fixed leg together with the notional is the coupon bond;
+  // the float leg is worth the notional at maturity
+  std::vector<double> uPaymentTimes (rSwap.numberOfPayments);
+  std::vector<double> uPayments (rSwap.numberOfPayments,
+                                 rSwap.notional * rSwap.rate * rSwap.period);
+  double dTime = dMaturity;
+  for (double &rT : uPaymentTimes)
+    {
+      dTime += rSwap.period;
+      rT = dTime;
+    }
+  uPayments.back () += rSwap.notional;
+
+  return bondOption (rData, uPaymentTimes, uPayments, rSwap.notional,
+                     dMaturity, rSwap.payFloat);
+}
+
+double
+cfl::NAnalytic::black (double dForward, double dStrike, double dStd,
+                       double &rVega)
+{
+  PRECONDITION ((dForward > 0) && (dStrike > 0) && (dStd >= 0));
+
+  if (dStd < cfl::EPS)
+    {
+      rVega = 0.;
+      return std::max (dForward - dStrike, 0.);
+    }
+  double dX = std::log (dForward / dStrike);
+  double dScale = std::sqrt (dForward * dStrike);
+  rVega = dScale * normalizedVega (dX, dStd);
+  // b(x,s) = b(-x,s) + 2 sinh(x/2) by the put-call parity
+  double dB = normalizedCall (-std::abs (dX), dStd);
+  if (dX > 0)
+    {
+      dB += 2. * std::sinh (0.5 * dX);
+    }
+  return dScale * dB;
+}
+
+std::valarray<double>
+cfl::NAnalytic::impliedVol (const std::valarray<double> &rStrike,
+                            const std::valarray<double> &rMaturity,
+                            const std::valarray<double> &rDiscount,
+                            const std::valarray<double> &rForward,
+                            const std::valarray<double> &rPrice, bool bCall,
+                            double dErr)
+{
+  unsigned iN = rStrike.size ();
+
+  PRECONDITION (rMaturity.size () == iN);
+  PRECONDITION (rDiscount.size () == iN);
+  PRECONDITION (rForward.size () == iN);
+  PRECONDITION (rPrice.size () == iN);
+  PRECONDITION (dErr > 0);
+
+  // the normalized prices of the out-of-the-money calls
+  std::valarray<double> uX (iN), uBeta (iN), uS (0., iN);
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      PRECONDITION ((rStrike[iI] > 0) && (rMaturity[iI] > 0)
+                    && (rDiscount[iI] > 0) && (rForward[iI] > 0));
+
+      double dK = rStrike[iI];
+      double dF = rForward[iI];
+      double dC = rPrice[iI] / rDiscount[iI];
+      if (!bCall)
+        {
+          dC += dF - dK;
+        }
+      double dX = std::log (dF / dK);
+      double dBeta = dC / std::sqrt (dF * dK);
+      if (dX > 0.)
+        {
+          dBeta -= std::exp (0.5 * dX) - std::exp (-0.5 * dX);
+          dX = -dX;
+        }
+      uX[iI] = dX;
+      uBeta[iI] = dBeta;
+      // the bounds of no-arbitrage up to the rounding errors
+      if ((dBeta < -cfl::EPS * std::max (1., dC / std::sqrt (dF * dK)))
+          || (dBeta >= std::exp (0.5 * dX)))
+        {
+          uS[iI] = std::numeric_limits<double>::quiet_NaN ();
+        }
+    }
+
+  parallel (
+      iN,
+      [&] (unsigned iBegin, unsigned iEnd) {
+        normalizedVol (uX, uBeta, uS, dErr, iBegin, iEnd);
+      },
+      4096);
+
+  return uS / std::sqrt (rMaturity);
+}
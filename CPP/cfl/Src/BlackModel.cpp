@@ -1,7 +1,6 @@
 #include "cfl/BlackModel.hpp"
 #include "cfl/Data.hpp"
 #include "cfl/Error.hpp"
-#include "cfl/Similar.hpp"
 #include <limits>
 
 using namespace cfl::Black;
@@ -57,19 +56,27 @@ cfl::Black::makeData (const Function &rDiscount, const Function &rForward,
 // construction of Black model
 namespace cflBlack
 {
-TRollback
-rollback (const IModel &rModel, const Function &rDiscount)
+std::vector<double>
+variance (const Black::Data &rData, const std::vector<double> &rEventTimes)
 {
-  return [&rModel, &rDiscount] (Slice &rSlice, unsigned iTime) {
-    PRECONDITION (rSlice.timeIndex () >= iTime);
-    PRECONDITION (&rSlice.model () == &rModel);
-
-    double dMaturity = rModel.eventTimes ()[rSlice.timeIndex ()];
-    double dToday = rModel.eventTimes ()[iTime];
-    double dFactor = rDiscount (dMaturity) / rDiscount (dToday);
-    rSlice.rollback (iTime);
-    rSlice *= dFactor;
-  };
+  std::vector<double> uVar (rEventTimes.size ());
+  std::transform (rEventTimes.begin (), rEventTimes.end (), uVar.begin (),
+                  [&rData] (double dTime) {
+                    return std::pow (rData.volatility (dTime), 2);
+                  });
+  return uVar;
+}
+
+// the numeraire is the inverse of the discount factor
+std::vector<double>
+shift (const Black::Data &rData, const std::vector<double> &rEventTimes)
+{
+  std::vector<double> uShift (rEventTimes.size ());
+  std::transform (rEventTimes.begin (), rEventTimes.end (), uShift.begin (),
+                  [&rData] (double dTime) {
+                    return -std::log (rData.discount (dTime));
+                  });
+  return uShift;
 }
 
 class BlackModel : public IAssetModel
@@ -77,18 +84,42 @@ class BlackModel : public IAssetModel
 public:
   BlackModel (const Black::Data &rData, const std::vector<double> &rEventTimes,
               double dInterval, const TBrownian &rBrownian)
-      : m_uData (rData), m_dInterval (dInterval), m_uBrownian (rBrownian)
+      : m_uData (rData), m_dInterval (dInterval), m_uBrownian (rBrownian),
+        m_uVar (variance (rData, rEventTimes)),
+        m_uShift (shift (rData, rEventTimes))
   {
     ASSERT (rEventTimes.front () == rData.initialTime);
 
-    std::vector<double> uVar (rEventTimes.size ());
-    std::transform (rEventTimes.begin (), rEventTimes.end (), uVar.begin (),
-                    [&rData] (double dTime) {
-                      return std::pow (rData.volatility (dTime), 2);
-                    });
-    cfl::Model uBrownian = m_uBrownian (uVar, rEventTimes, dInterval);
-    TRollback uRollback = rollback (uBrownian.model (), m_uData.discount);
-    m_uModel = similar (uRollback, uBrownian);
+    std::vector<double> uSlope (rEventTimes.size (), 0.);
+    cfl::Model uBrownian = m_uBrownian (m_uVar, rEventTimes, dInterval);
+    m_uModel = numeraire (uBrownian, m_uShift, uSlope);
+  }
+
+  // the lattice of rModel with the discount and forward curves of
+  // rData; only the deterministic numeraire changes
+  BlackModel (const BlackModel &rModel, const Black::Data &rData)
+      : m_uData (rData), m_dInterval (rModel.m_dInterval),
+        m_uBrownian (rModel.m_uBrownian), m_uVar (rModel.m_uVar),
+        m_uShift (shift (rData, rModel.model ().eventTimes ()))
+  {
+    std::vector<double> uShift (m_uShift), uSlope (m_uShift.size (), 0.);
+    for (unsigned iI = 0; iI < uShift.size (); iI++)
+      {
+        uShift[iI] -= rModel.m_uShift[iI];
+      }
+    m_uModel = numeraire (rModel.m_uModel, uShift, uSlope);
+  }
+
+  IAssetModel *
+  rebind (const Black::Data &rData) const
+  {
+    const std::vector<double> &rEventTimes = model ().eventTimes ();
+    if ((rData.initialTime != m_uData.initialTime)
+        || (variance (rData, rEventTimes) != m_uVar))
+      {
+        return new BlackModel (rData, rEventTimes, m_dInterval, m_uBrownian);
+      }
+    return new BlackModel (*this, rData);
   }
 
   IAssetModel *
@@ -136,6 +167,7 @@ private:
   Black::Data m_uData;
   double m_dInterval;
   TBrownian m_uBrownian;
+  std::vector<double> m_uVar, m_uShift;
   cfl::Model m_uModel;
 };
 } // namespace cflBlack
@@ -150,3 +182,18 @@ cfl::Black::model (const Data &rData, double dInterval,
   return AssetModel (
       new cflBlack::BlackModel (rData, uEventTimes, dInterval, rBrownian));
 }
+
+// function cfl::Black::rebind
+AssetModel
+cfl::Black::rebind (const AssetModel &rModel, const Data &rData)
+{
+  const cflBlack::BlackModel *pModel
+      = dynamic_cast<const cflBlack::BlackModel *> (&rModel.implementation ());
+
+  if (!pModel)
+    {
+      throw (NError::range ("the model is not constructed by Black::model"));
+    }
+
+  return AssetModel (pModel->rebind (rData));
+}
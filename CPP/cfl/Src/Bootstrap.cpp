@@ -0,0 +1,467 @@
+#include "cfl/Bootstrap.hpp"
+#include "cfl/Error.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+using namespace cfl;
+
+namespace cflBootstrap
+{
+const double c_dErr = 1E-14;      // the error for the pillar log-discounts
+const unsigned c_iMaxIter = 64;   // the maximal number of Newton steps
+const unsigned c_iBuckets = 4;    // the buckets per interval of pillars
+
+// The integral G(x) over [0,x] of the deviation g of the forward rate
+// from the discrete forward rate in the monotone convex interpolation
+// of Hagan and West, where g(0) = g0, g(1) = g1 and G(1) = 0, together
+// with the partial derivatives of G(x) with respect to g0 and g1. The
+// regions of (g0,g1) are closed on the lines g0 = 0 and g1 = 0, where
+// G has a kink; there the derivatives are the one-sided derivatives
+// of the closed region.
+double
+integral (double dX, double dG0, double dG1, double &rD0, double &rD1)
+{
+  if ((dX == 0.) || (dX == 1.))
+    {
+      // G(0) = G(1) = 0 for all g0 and g1
+      rD0 = 0.;
+      rD1 = 0.;
+      return 0.;
+    }
+  if ((dG0 == 0.) && (dG1 == 0.))
+    {
+      rD0 = dX * (1. - dX) * (1. - dX);
+      rD1 = dX * dX * (dX - 1.);
+      return 0.;
+    }
+  if (((dG0 < 0.) && (-0.5 * dG0 <= dG1) && (dG1 <= -2. * dG0))
+      || ((dG0 > 0.) && (-0.5 * dG0 >= dG1) && (dG1 >= -2. * dG0)))
+    {
+      // quadratic g
+      rD0 = dX * (1. - dX) * (1. - dX);
+      rD1 = dX * dX * (dX - 1.);
+      return dG0 * rD0 + dG1 * rD1;
+    }
+  double dD = dG1 - dG0;
+  if (((dG0 <= 0.) && (dG1 > -2. * dG0))
+      || ((dG0 >= 0.) && (dG1 < -2. * dG0)))
+    {
+      // g = g0 on [0,eta]
+      double dEta = (dG1 + 2. * dG0) / dD;
+      if (dX <= dEta)
+        {
+          rD0 = dX;
+          rD1 = 0.;
+          return dG0 * dX;
+        }
+      double dU = dX - dEta;
+      double dW = 1. - dEta;
+      double dH = dU * dU * dU / (3. * dW * dW);
+      double dDH = 3. * (2. * dH / dW - dU * dU / (dW * dW)) / dD;
+      rD0 = dX - dH + dG1 * dDH;
+      rD1 = dH - dG0 * dDH;
+      return dG0 * dX + dD * dH;
+    }
+  if (((dG0 > 0.) && (dG1 <= 0.)) || ((dG0 < 0.) && (dG1 >= 0.)))
+    {
+      // g = g1 on [eta,1]
+      double dEta = 3. * dG1 / dD;
+      if (dX >= dEta)
+        {
+          rD0 = 0.;
+          rD1 = dX - 1.;
+          return dG1 * (dX - 1.);
+        }
+      double dU = dEta - dX;
+      double dF = dEta / 3. - dU * dU * dU / (3. * dEta * dEta);
+      double dDF = 1. / 3. - dU * dU / (dEta * dEta)
+                   + 2. * dU * dU * dU / (3. * dEta * dEta * dEta);
+      rD0 = dF - 3. * dG1 * dDF / dD;
+      rD1 = dX - dF + 3. * dG0 * dDF / dD;
+      return dG1 * dX - dD * dF;
+    }
+  // g0 and g1 have the same sign and g has the extremum A at eta
+  ASSERT (dG0 * dG1 > 0.);
+  double dS = dG0 + dG1;
+  double dEta = dG1 / dS;
+  double dA = -dG0 * dG1 / dS;
+  double dEta0 = -dG1 / (dS * dS);
+  double dEta1 = dG0 / (dS * dS);
+  double dA0 = -dG1 * dG1 / (dS * dS);
+  double dA1 = -dG0 * dG0 / (dS * dS);
+  if (dX <= dEta)
+    {
+      double dU = dEta - dX;
+      double dF = dEta / 3. - dU * dU * dU / (3. * dEta * dEta);
+      double dDF = 1. / 3. - dU * dU / (dEta * dEta)
+                   + 2. * dU * dU * dU / (3. * dEta * dEta * dEta);
+      rD0 = dX * dA0 + (1. - dA0) * dF + (dG0 - dA) * dDF * dEta0;
+      rD1 = dX * dA1 - dA1 * dF + (dG0 - dA) * dDF * dEta1;
+      return dA * dX + (dG0 - dA) * dF;
+    }
+  double dU = dX - dEta;
+  double dW = 1. - dEta;
+  double dH = dU * dU * dU / (3. * dW * dW);
+  double dDH = 2. * dH / dW - dU * dU / (dW * dW);
+  rD0 = dX * dA0 + (1. - dA0) * dEta / 3. + (dG0 - dA) * dEta0 / 3.
+        - dA0 * dH + (dG1 - dA) * dDH * dEta0;
+  rD1 = dX * dA1 - dA1 * dEta / 3. + (dG0 - dA) * dEta1 / 3.
+        + (1. - dA1) * dH + (dG1 - dA) * dDH * dEta1;
+  return dA * dX + (dG0 - dA) * dEta / 3. + (dG1 - dA) * dH;
+}
+
+// adds the coefficients of the forward rate at the pillar j with
+// respect to the discrete forward rates of the intervals i-1, i, i+1
+void
+addKnot (unsigned j, unsigned i, double dScale,
+         const std::vector<double> &rTau, double *pC)
+{
+  unsigned n = rTau.size () - 1;
+  auto add = [i, pC] (unsigned k, double dC) { pC[k + 1 - i] += dC; };
+  if (n == 1)
+    {
+      add (1, dScale);
+      return;
+    }
+  auto alpha = [&rTau] (unsigned k) {
+    return (rTau[k] - rTau[k - 1]) / (rTau[k + 1] - rTau[k - 1]);
+  };
+  if (j == 0)
+    {
+      double dA = alpha (1);
+      add (1, dScale * (1. + 0.5 * dA));
+      add (2, -dScale * 0.5 * dA);
+    }
+  else if (j == n)
+    {
+      double dA = alpha (n - 1);
+      add (n, dScale * (1.5 - 0.5 * dA));
+      add (n - 1, -dScale * 0.5 * (1. - dA));
+    }
+  else
+    {
+      double dA = alpha (j);
+      add (j + 1, dScale * dA);
+      add (j, dScale * (1. - dA));
+    }
+}
+
+// the discount curve for the solution
+struct Curve
+{
+  std::vector<double> uTau, uX, uG0, uG1;
+  double dForward, dScale;
+  std::vector<unsigned> uBucket;
+
+  double
+  logDiscount (double dTau) const
+  {
+    unsigned n = uTau.size () - 1;
+    if (dTau >= uTau[n])
+      {
+        return uX[n] - dForward * (dTau - uTau[n]);
+      }
+    unsigned iB = std::min<unsigned> (dTau * dScale, uBucket.size () - 1);
+    unsigned i = uBucket[iB];
+    while (uTau[i] < dTau)
+      {
+        i++;
+      }
+    double dH = uTau[i] - uTau[i - 1];
+    double dXi = (dTau - uTau[i - 1]) / dH;
+    double dLog = (1. - dXi) * uX[i - 1] + dXi * uX[i];
+    if (!uG0.empty ())
+      {
+        double dD0, dD1;
+        dLog -= dH * integral (dXi, uG0[i], uG1[i], dD0, dD1);
+      }
+    return dLog;
+  }
+};
+
+// solves rA x = rB, where rA has the lower bandwidth iL and the upper
+// bandwidth iQ; the row i of rA is kept in rA[i*(iL+iQ+1)+iL-i+j] for
+// the columns i-iL <= j <= i+iQ; rA and rB are overwritten
+void
+solve (std::vector<double> &rA, std::vector<double> &rB, unsigned iL,
+       unsigned iQ)
+{
+  unsigned n = rB.size ();
+  unsigned iW = iL + iQ + 1;
+  auto a = [&rA, iW, iL] (unsigned i, unsigned j) -> double & {
+    return rA[i * (iW - 1) + iL + j];
+  };
+  for (unsigned k = 0; k < n; k++)
+    {
+      double dP = a (k, k);
+      if (dP == 0.)
+        {
+          throw (NError::range ("singular Jacobian in bootstrap"));
+        }
+      unsigned iRows = std::min (n, k + iL + 1);
+      unsigned iEnd = std::min (n, k + iQ + 1);
+      for (unsigned i = k + 1; i < iRows; i++)
+        {
+          double dL = a (i, k) / dP;
+          if (dL != 0.)
+            {
+              for (unsigned j = k + 1; j < iEnd; j++)
+                {
+                  a (i, j) -= dL * a (k, j);
+                }
+              rB[i] -= dL * rB[k];
+            }
+        }
+    }
+  for (unsigned k = n; k-- > 0;)
+    {
+      unsigned iEnd = std::min (n, k + iQ + 1);
+      for (unsigned j = k + 1; j < iEnd; j++)
+        {
+          rB[k] -= a (k, j) * rB[j];
+        }
+      rB[k] /= a (k, k);
+    }
+}
+} // namespace cflBootstrap
+
+using namespace cflBootstrap;
+
+// class Bootstrap
+
+cfl::Bootstrap::Bootstrap (double dInitialTime, bool bMonotoneConvex)
+    : m_dInitialTime (dInitialTime), m_bMonotoneConvex (bMonotoneConvex),
+      m_iLower (0), m_iIter (0)
+{
+}
+
+void
+cfl::Bootstrap::addDeposit (double dMaturity)
+{
+  PRECONDITION (dMaturity > m_dInitialTime);
+  addSwap (dMaturity - m_dInitialTime, 1);
+}
+
+void
+cfl::Bootstrap::addSwap (double dPeriod, unsigned iNumberOfPayments)
+{
+  PRECONDITION ((dPeriod > 0) && (iNumberOfPayments > 0));
+  m_uPeriod.push_back (dPeriod);
+  m_uPayments.push_back (iNumberOfPayments);
+  m_uOrder.clear ();
+  m_uX.clear ();
+}
+
+void
+cfl::Bootstrap::setup ()
+{
+  unsigned n = m_uPeriod.size ();
+  PRECONDITION (n > 0);
+  m_uOrder.resize (n);
+  std::iota (m_uOrder.begin (), m_uOrder.end (), 0);
+  auto maturity
+      = [this] (unsigned j) { return m_uPeriod[j] * m_uPayments[j]; };
+  std::sort (m_uOrder.begin (), m_uOrder.end (),
+             [&maturity] (unsigned i, unsigned j) {
+               return maturity (i) < maturity (j);
+             });
+  m_uTau.assign (1, 0.);
+  for (unsigned p = 0; p < n; p++)
+    {
+      m_uTau.push_back (maturity (m_uOrder[p]));
+      PRECONDITION (m_uTau[p + 1] > m_uTau[p]);
+    }
+
+  m_uC0.assign (3 * (n + 1), 0.);
+  m_uC1.assign (3 * (n + 1), 0.);
+  for (unsigned i = 1; i <= n; i++)
+    {
+      addKnot (i - 1, i, 1., m_uTau, &m_uC0[3 * i]);
+      m_uC0[3 * i + 1] -= 1.;
+      addKnot (i, i, 1., m_uTau, &m_uC1[3 * i]);
+      m_uC1[3 * i + 1] -= 1.;
+    }
+
+  m_uPayRow.clear ();
+  m_uPayInterval.clear ();
+  m_uPayXi.clear ();
+  m_iLower = 0;
+  unsigned iBack = m_bMonotoneConvex ? 2 : 1;
+  for (unsigned p = 0; p < n; p++)
+    {
+      unsigned j = m_uOrder[p];
+      for (unsigned k = 1; k <= m_uPayments[j]; k++)
+        {
+          double dTau = (k == m_uPayments[j]) ? m_uTau[p + 1]
+                                              : k * m_uPeriod[j];
+          unsigned i = std::lower_bound (m_uTau.begin (), m_uTau.end (),
+                                         dTau)
+                       - m_uTau.begin ();
+          m_uPayRow.push_back (p + 1);
+          m_uPayInterval.push_back (i);
+          m_uPayXi.push_back ((dTau - m_uTau[i - 1])
+                              / (m_uTau[i] - m_uTau[i - 1]));
+          unsigned iFirst = (i > iBack) ? i - iBack : 1;
+          m_iLower = std::max (m_iLower, p + 1 - iFirst);
+        }
+    }
+}
+
+Function
+cfl::Bootstrap::discount (const std::vector<double> &rRates)
+{
+  PRECONDITION (rRates.size () == m_uPeriod.size ());
+  if (m_uOrder.empty ())
+    {
+      setup ();
+    }
+  unsigned n = m_uOrder.size ();
+  if (m_uX.empty ())
+    {
+      m_uX.assign (n + 1, 0.);
+      for (unsigned p = 1; p <= n; p++)
+        {
+          m_uX[p] = -std::log (1. + rRates[m_uOrder[p - 1]] * m_uTau[p]);
+        }
+    }
+
+  std::vector<double> uFd (n + 2, 0.), uG0, uG1;
+  if (m_bMonotoneConvex)
+    {
+      uG0.resize (n + 1);
+      uG1.resize (n + 1);
+    }
+  // the Jacobian is kept as a band matrix
+  unsigned iQ = m_bMonotoneConvex ? 1 : 0;
+  unsigned iW = m_iLower + iQ + 1;
+  std::vector<double> uR (n), uJ (n * iW);
+  // computes the deviations of the forward rates at the ends of the
+  // intervals
+  auto forwards = [&] () {
+    for (unsigned i = 1; i <= n; i++)
+      {
+        uFd[i] = (m_uX[i - 1] - m_uX[i]) / (m_uTau[i] - m_uTau[i - 1]);
+      }
+    for (unsigned i = 1; i < uG0.size (); i++)
+      {
+        uG0[i] = m_uC0[3 * i] * uFd[i - 1] + m_uC0[3 * i + 1] * uFd[i]
+                 + m_uC0[3 * i + 2] * uFd[i + 1];
+        uG1[i] = m_uC1[3 * i] * uFd[i - 1] + m_uC1[3 * i + 1] * uFd[i]
+                 + m_uC1[3 * i + 2] * uFd[i + 1];
+      }
+  };
+
+  m_iIter = 0;
+  double dStep = 0.;
+  do
+    {
+      if (m_iIter == c_iMaxIter)
+        {
+          throw (NError::range ("bootstrap of discount curve"));
+        }
+      m_iIter++;
+      forwards ();
+      std::fill (uR.begin (), uR.end (), -1.);
+      std::fill (uJ.begin (), uJ.end (), 0.);
+      for (unsigned k = 0; k < m_uPayRow.size (); k++)
+        {
+          unsigned p = m_uPayRow[k];
+          unsigned j = m_uOrder[p - 1];
+          double dC = rRates[j] * m_uPeriod[j];
+          if ((k + 1 == m_uPayRow.size ()) || (m_uPayRow[k + 1] != p))
+            {
+              dC += 1.;
+            }
+          unsigned i = m_uPayInterval[k];
+          double dXi = m_uPayXi[k];
+          double dH = m_uTau[i] - m_uTau[i - 1];
+          // the gradient of ln D with respect to x[i-2], ..., x[i+1]
+          double uGrad[4] = { 0., 1. - dXi, dXi, 0. };
+          double dLog = (1. - dXi) * m_uX[i - 1] + dXi * m_uX[i];
+          if (m_bMonotoneConvex)
+            {
+              double dD0, dD1;
+              dLog -= dH * integral (dXi, uG0[i], uG1[i], dD0, dD1);
+              for (unsigned l = 0; l < 3; l++)
+                {
+                  unsigned m = i + l - 1;
+                  if ((m == 0) || (m > n))
+                    {
+                      continue;
+                    }
+                  double dW = -dH
+                              * (dD0 * m_uC0[3 * i + l]
+                                 + dD1 * m_uC1[3 * i + l])
+                              / (m_uTau[m] - m_uTau[m - 1]);
+                  uGrad[l] += dW;
+                  uGrad[l + 1] -= dW;
+                }
+            }
+          double dV = dC * std::exp (dLog);
+          uR[p - 1] += dV;
+          for (unsigned l = 0; l < 4; l++)
+            {
+              unsigned m = i + l - 2;
+              if ((i + l >= 3) && (m <= n) && (uGrad[l] != 0.))
+                {
+                  uJ[(p - 1) * (iW - 1) + m_iLower + m - 1] += dV * uGrad[l];
+                }
+            }
+        }
+      for (unsigned p = 0; p < n; p++)
+        {
+          uR[p] = -uR[p];
+        }
+      solve (uJ, uR, m_iLower, iQ);
+      dStep = 0.;
+      for (unsigned p = 1; p <= n; p++)
+        {
+          m_uX[p] += uR[p - 1];
+          dStep = std::max (dStep, std::abs (uR[p - 1]));
+        }
+    }
+  while (dStep > c_dErr);
+  forwards ();
+
+  auto pCurve = std::make_shared<Curve> ();
+  pCurve->uTau = m_uTau;
+  pCurve->uX = m_uX;
+  pCurve->uG0 = uG0;
+  pCurve->uG1 = uG1;
+  if (m_bMonotoneConvex)
+    {
+      pCurve->dForward = 0.;
+      double uC[3] = { 0., 0., 0. };
+      addKnot (n, n, 1., m_uTau, uC);
+      for (unsigned l = 0; l < 3; l++)
+        {
+          pCurve->dForward += uC[l] * uFd[n + l - 1];
+        }
+    }
+  else
+    {
+      pCurve->dForward = uFd[n];
+    }
+  unsigned iBuckets = c_iBuckets * n;
+  pCurve->dScale = iBuckets / m_uTau[n];
+  pCurve->uBucket.resize (iBuckets);
+  unsigned i = 1;
+  for (unsigned iB = 0; iB < iBuckets; iB++)
+    {
+      double dTau = iB / pCurve->dScale;
+      while (m_uTau[i] < dTau)
+        {
+          i++;
+        }
+      pCurve->uBucket[iB] = i;
+    }
+
+  double dT0 = m_dInitialTime;
+  return Function (
+      [pCurve, dT0] (double dT) {
+        return std::exp (pCurve->logDiscount (dT - dT0));
+      },
+      dT0);
+}
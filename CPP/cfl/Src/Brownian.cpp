@@ -2,24 +2,27 @@
 #include "cfl/GaussRollback.hpp"
 #include "cfl/Ind.hpp"
 #include "cfl/Interp.hpp"
+#include "cfl/Similar.hpp"
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <mutex>
 #include <numeric>
 
 using namespace cfl;
 
 namespace cflBrownian
 {
-class Model : public cfl::IModel
+// the grid and all operations except the rollbacks
+class Base : public cfl::IModel
 {
 public:
-  Model (const std::function<double (double)> &rH,
-         const std::function<double (double)> &rWidth,
-         const std::function<unsigned (double)> &rSize,
-         const GaussRollback &rRollback, const Ind &rInd,
-         const Interp &rInterp, const std::vector<double> &rVar,
-         const std::vector<double> &rEventTimes, double dInterval);
+  Base (const std::function<double (double)> &rH,
+        const std::function<double (double)> &rWidth,
+        const std::function<unsigned (double)> &rSize,
+        const GaussRollback &rRollback, const Ind &rInd,
+        const Interp &rInterp, const std::vector<double> &rVar,
+        const std::vector<double> &rEventTimes, double dInterval);
 
   const std::vector<double> &
   eventTimes () const
@@ -62,8 +65,6 @@ public:
   void addDependence (Slice &rSlice,
                       const std::vector<unsigned> &rDependence) const;
 
-  void rollback (Slice &rSlice, unsigned iTime) const;
-
   void
   indicator (Slice &rSlice, double dBarrier) const
   {
@@ -72,78 +73,244 @@ public:
 
   MultiFunction interpolate (const Slice &rSlice) const;
 
-private:
+protected:
   std::function<double (double)> m_uWidth;
   GaussRollback m_uGaussRollback;
   Ind m_uInd;
   Interp m_uInterp;
   std::vector<double> m_uTotalVar, m_uEventTimes;
   std::vector<unsigned> m_uSize;
-  double m_dH;
+  double m_dH, m_dInterval;
 };
-} // namespace cflBrownian
 
-using namespace cflBrownian;
+// the number of steps of the grid added on each side of the interval
+// of initial values in the interpolation
+const unsigned c_iMargin = 8;
 
-// CLASS cflBrownian::Model
+// numeraire policies: multiply() rescales the values on the grid of
+// the event time iTime by dFactor * exp(dPower * b_i * x), where
+// dPower is 1 or -1; assign() is called once with the sizes of the
+// grids and the step
 
-double
-minVar (const std::vector<double> &rVar)
+// the numeraire equals one
+class Unit
 {
-  double dMinVar = std::inner_product (
-      rVar.begin () + 1, rVar.end (), rVar.begin (), cfl::OMEGA,
-      [] (double dX, double dY) { return std::min (dX, dY); },
-      std::minus<double> ());
+public:
+  static const bool c_bState = false;
 
-  ASSERT (dMinVar > cfl::EPS);
+  void
+  assign (const std::vector<unsigned> &rSize, double dH)
+  {
+  }
 
-  return dMinVar;
-}
+  double
+  shift (unsigned iTime) const
+  {
+    return 0.;
+  }
 
-cflBrownian::Model::Model (const std::function<double (double)> &rH,
-                           const std::function<double (double)> &rWidth,
-                           const std::function<unsigned (double)> &rSize,
-                           const GaussRollback &rRollback, const Ind &rInd,
-                           const Interp &rInterp,
-                           const std::vector<double> &rVar,
-                           const std::vector<double> &rEventTimes,
-                           double dInterval)
-    : m_uWidth (rWidth), m_uGaussRollback (rRollback), m_uInd (rInd),
-      m_uInterp (rInterp), m_uTotalVar (rVar.size ()),
-      m_uEventTimes (rEventTimes), m_uSize (rEventTimes.size ())
+  void
+  multiply (std::valarray<double> &rValues, double dFactor, unsigned iTime,
+            double dPower) const
+  {
+  }
+};
 
+// the numeraire does not depend on the state
+class Deterministic
 {
-  PRECONDITION (rEventTimes.size () == rVar.size ());
-  PRECONDITION (std::equal (m_uEventTimes.begin () + 1, m_uEventTimes.end (),
-                            m_uEventTimes.begin (), std::greater<double> ()));
+public:
+  static const bool c_bState = false;
+
+  Deterministic (const std::vector<double> &rShift) : m_uShift (rShift) {}
+
+  void
+  assign (const std::vector<unsigned> &rSize, double dH)
+  {
+  }
+
+  double
+  shift (unsigned iTime) const
+  {
+    return m_uShift[iTime];
+  }
+
+  void
+  multiply (std::valarray<double> &rValues, double dFactor, unsigned iTime,
+            double dPower) const
+  {
+    if (dFactor != 1.)
+      {
+        rValues *= dFactor;
+      }
+  }
+
+private:
+  std::vector<double> m_uShift;
+};
+
+// the logarithm of the numeraire is affine in the state; the values
+// exp(b_i x) and exp(-b_i x) on the grids are computed in advance
+class LogAffine
+{
+public:
+  static const bool c_bState = true;
+
+  LogAffine (const std::vector<double> &rShift,
+             const std::vector<double> &rSlope)
+      : m_uShift (rShift), m_uSlope (rSlope)
+  {
+  }
+
+  // the numeraire multiplied by exp(a_i); the values on the grids
+  // are kept
+  LogAffine (const LogAffine &rNumeraire, const std::vector<double> &rShift)
+      : LogAffine (rNumeraire)
+  {
+    PRECONDITION (rShift.size () == m_uShift.size ());
+
+    for (unsigned iI = 0; iI < m_uShift.size (); iI++)
+      {
+        m_uShift[iI] += rShift[iI];
+      }
+  }
+
+  void
+  assign (const std::vector<unsigned> &rSize, double dH)
+  {
+    PRECONDITION (rSize.size () == m_uSlope.size ());
+
+    if (m_uUp.size () == rSize.size ())
+      {
+        // the values are inherited from the model with the same grids
+        return;
+      }
+
+    m_uUp.resize (rSize.size ());
+    m_uDown.resize (rSize.size ());
+    for (unsigned iI = 0; iI < rSize.size (); iI++)
+      {
+        std::valarray<double> uX (rSize[iI]);
+        double dX = -dH * (rSize[iI] - 1) / 2.;
+        for (double &rX : uX)
+          {
+            rX = dX;
+            dX += dH;
+          }
+        m_uUp[iI] = std::exp (m_uSlope[iI] * uX);
+        m_uDown[iI] = 1. / m_uUp[iI];
+      }
+  }
+
+  double
+  shift (unsigned iTime) const
+  {
+    return m_uShift[iTime];
+  }
+
+  double
+  slope (unsigned iTime) const
+  {
+    return m_uSlope[iTime];
+  }
+
+  void
+  multiply (std::valarray<double> &rValues, double dFactor, unsigned iTime,
+            double dPower) const
+  {
+    PRECONDITION (std::abs (dPower) == 1.);
+
+    const std::valarray<double> &rN
+        = (dPower > 0) ? m_uUp[iTime] : m_uDown[iTime];
+
+    ASSERT (rN.size () == rValues.size ());
+
+    for (unsigned iI = 0; iI < rValues.size (); iI++)
+      {
+        rValues[iI] *= dFactor * rN[iI];
+      }
+  }
+
+private:
+  std::vector<double> m_uShift, m_uSlope;
+  std::vector<std::valarray<double> > m_uUp, m_uDown;
+};
 
-  double dToday = rEventTimes.front ();
-  std::transform (rVar.begin (), rVar.end (), rEventTimes.begin (),
-                  m_uTotalVar.begin (), [dToday] (double dVar, double dTime) {
-                    ASSERT (dTime >= dToday);
-                    return dVar * (dTime - dToday);
-                  });
+// the model of Brownian motion under the numeraire TNumeraire
+template <class TNumeraire> class Model : public Base
+{
+public:
+  Model (const std::function<double (double)> &rH,
+         const std::function<double (double)> &rWidth,
+         const std::function<unsigned (double)> &rSize,
+         const GaussRollback &rRollback, const Ind &rInd,
+         const Interp &rInterp, const std::vector<double> &rVar,
+         const std::vector<double> &rEventTimes, double dInterval,
+         const TNumeraire &rNumeraire)
+      : Base (rH, rWidth, rSize, rRollback, rInd, rInterp, rVar, rEventTimes,
+              dInterval),
+        m_uNumeraire (rNumeraire)
+  {
+    m_uNumeraire.assign (m_uSize, m_dH);
+  }
+
+  Model (const Base &rBase, const TNumeraire &rNumeraire)
+      : Base (rBase), m_uNumeraire (rNumeraire)
+  {
+    m_uNumeraire.assign (m_uSize, m_dH);
+  }
+
+  const TNumeraire &
+  numeraire () const
+  {
+    return m_uNumeraire;
+  }
+
+  void rollback (Slice &rSlice, unsigned iTime) const;
+
+  void adjointRollback (Slice &rSlice, unsigned iTime) const;
+
+private:
+  TNumeraire m_uNumeraire;
+};
 
-  ASSERT (std::equal (m_uTotalVar.begin () + 1, m_uTotalVar.end (),
-                      m_uTotalVar.begin (), std::greater<double> ()));
+// delta and gamma are computed once on the first request
+struct Greeks
+{
+  std::once_flag uFlag;
+  std::vector<Function> uF;
+};
 
-  double dMinVar = minVar (m_uTotalVar);
-  m_dH = rH (dMinVar);
+std::vector<Function> greeks (const std::valarray<double> &rArg,
+                              const std::valarray<double> &rVal,
+                              const std::slice &rWindow, double dH,
+                              const Interp &rInterp);
+} // namespace cflBrownian
 
-  std::transform (m_uTotalVar.begin (), m_uTotalVar.end (), m_uSize.begin (),
-                  [&rSize, &rWidth, dH = m_dH, dInterval] (double dVar) {
-                    double dW = rWidth (dVar);
+using namespace cflBrownian;
 
-                    ASSERT (dW > 0);
+// CLASS cflBrownian::Base
 
-                    double dSize
-                        = std::max ((dInterval + dW) / dH, 2.) + cfl::EPS;
-                    unsigned iSize = rSize (dSize);
+cflBrownian::Base::Base (const std::function<double (double)> &rH,
+                         const std::function<double (double)> &rWidth,
+                         const std::function<unsigned (double)> &rSize,
+                         const GaussRollback &rRollback, const Ind &rInd,
+                         const Interp &rInterp,
+                         const std::vector<double> &rVar,
+                         const std::vector<double> &rEventTimes,
+                         double dInterval)
+    : m_uWidth (rWidth), m_uGaussRollback (rRollback), m_uInd (rInd),
+      m_uInterp (rInterp), m_uEventTimes (rEventTimes),
+      m_dInterval (dInterval)
 
-                    ASSERT (iSize * dH > dInterval + dW);
+{
+  PRECONDITION (rEventTimes.size () == rVar.size ());
+  PRECONDITION (std::equal (m_uEventTimes.begin () + 1, m_uEventTimes.end (),
+                            m_uEventTimes.begin (), std::greater<double> ()));
 
-                    return iSize;
-                  });
+  m_uTotalVar = cfl::Grid::totalVar (rVar, rEventTimes);
+  m_dH = rH (cfl::Grid::minVar (m_uTotalVar));
+  m_uSize = cfl::Grid::sizes (m_uTotalVar, m_dH, dInterval, rWidth, rSize);
 
   POSTCONDITION (std::equal (m_uSize.begin () + 1, m_uSize.end (),
                              m_uSize.begin (),
@@ -151,7 +318,7 @@ cflBrownian::Model::Model (const std::function<double (double)> &rH,
 }
 
 Slice
-cflBrownian::Model::state (unsigned iTime, unsigned iState) const
+cflBrownian::Base::state (unsigned iTime, unsigned iState) const
 {
 
   PRECONDITION (iState == 0);
@@ -169,7 +336,7 @@ cflBrownian::Model::state (unsigned iTime, unsigned iState) const
 }
 
 void
-cflBrownian::Model::addDependence (
+cflBrownian::Base::addDependence (
     Slice &rSlice, const std::vector<unsigned> &rDependence) const
 {
   PRECONDITION (rDependence.size () <= 1);
@@ -184,17 +351,26 @@ cflBrownian::Model::addDependence (
     }
 }
 
+// CLASS cflBrownian::Model
+
+template <class TNumeraire>
 void
-cflBrownian::Model::rollback (Slice &rSlice, unsigned iTime) const
+cflBrownian::Model<TNumeraire>::rollback (Slice &rSlice, unsigned iTime) const
 {
   PRECONDITION (rSlice.dependence ().size () <= 1);
   PRECONDITION (&rSlice.model () == this);
   PRECONDITION (rSlice.timeIndex () > iTime);
 
-  double dVar = m_uTotalVar[rSlice.timeIndex ()] - m_uTotalVar[iTime];
+  unsigned iFrom = rSlice.timeIndex ();
+  double dVar = m_uTotalVar[iFrom] - m_uTotalVar[iTime];
 
   ASSERT (dVar > VAR_EPS);
 
+  if (TNumeraire::c_bState)
+    {
+      addDependence (rSlice, std::vector<unsigned> (1, 0));
+    }
+
   std::valarray<double> &rValues = rSlice.values ();
 
   ASSERT (rValues.size () > 0);
@@ -205,6 +381,7 @@ cflBrownian::Model::rollback (Slice &rSlice, unsigned iTime) const
     {
       ASSERT (m_dH * m_dH <= 1.5001 * dVar); // at least one uniform step
 
+      m_uNumeraire.multiply (rValues, 1., iFrom, -1.);
       GaussRollback uRoll (m_uGaussRollback);
       uRoll.assign (rValues.size (), m_dH, dVar);
       uRoll.rollback (rValues);
@@ -214,29 +391,171 @@ cflBrownian::Model::rollback (Slice &rSlice, unsigned iTime) const
 
   ASSERT (iSize1 <= rValues.size ());
 
+  double dFactor
+      = std::exp (m_uNumeraire.shift (iTime) - m_uNumeraire.shift (iFrom));
   if (iSize1 < rValues.size ())
     {
       unsigned iI = (rValues.size () - iSize1) / 2;
       std::valarray<double> uT (rValues[std::slice (iI, iSize1, 1)]);
+      m_uNumeraire.multiply (uT, dFactor, iTime, 1.);
       rSlice.assign (iTime, rSlice.dependence (), uT);
     }
   else
     {
+      m_uNumeraire.multiply (rValues, dFactor, iTime, 1.);
       rSlice.assign (iTime, rSlice.dependence (), rValues);
     }
 }
 
+// the Gaussian kernel is symmetric: the transpose of the rollback
+// extends the adjoint by zeros and applies the same kernel; the
+// rescalings by the numeraire are applied in the reverse order
+template <class TNumeraire>
+void
+cflBrownian::Model<TNumeraire>::adjointRollback (Slice &rSlice,
+                                                 unsigned iTime) const
+{
+  PRECONDITION (rSlice.dependence ().size () <= 1);
+  PRECONDITION (&rSlice.model () == this);
+  PRECONDITION (rSlice.timeIndex () < iTime);
+
+  unsigned iFrom = rSlice.timeIndex ();
+  double dFactor
+      = std::exp (m_uNumeraire.shift (iFrom) - m_uNumeraire.shift (iTime));
+
+  if (TNumeraire::c_bState)
+    {
+      addDependence (rSlice, std::vector<unsigned> (1, 0));
+    }
+
+  if (rSlice.values ().size () == 1)
+    {
+      std::valarray<double> uValues (rSlice.values ());
+      m_uNumeraire.multiply (uValues, dFactor, iTime, -1.);
+      rSlice.assign (iTime, rSlice.dependence (), uValues);
+      return;
+    }
+
+  double dVar = m_uTotalVar[iTime] - m_uTotalVar[iFrom];
+
+  ASSERT (dVar > VAR_EPS);
+
+  std::valarray<double> &rValues = rSlice.values ();
+  unsigned iSize = numberOfNodes (iTime, rSlice.dependence ());
+
+  ASSERT (iSize >= rValues.size ());
+
+  m_uNumeraire.multiply (rValues, 1., iFrom, 1.);
+  std::valarray<double> uValues (0., iSize);
+  uValues[std::slice ((iSize - rValues.size ()) / 2, rValues.size (), 1)]
+      = rValues;
+
+  GaussRollback uRoll (m_uGaussRollback);
+  uRoll.assign (uValues.size (), m_dH, dVar);
+  uRoll.rollback (uValues);
+  m_uNumeraire.multiply (uValues, dFactor, iTime, -1.);
+  rSlice.assign (iTime, rSlice.dependence (), uValues);
+}
+
+// delta and gamma are returned by GaussRollback::rollback over two
+// small variances on the whole grid; the explicit scheme with p = 1/6
+// has the same fourth moment as the gaussian kernel, as the formula
+// for gamma requires, and the bias of order dVar is removed by the
+// extrapolation; only the window of initial values is interpolated
+std::vector<Function>
+cflBrownian::greeks (const std::valarray<double> &rArg,
+                     const std::valarray<double> &rVal,
+                     const std::slice &rWindow, double dH,
+                     const Interp &rInterp)
+{
+  PRECONDITION (rArg.size () == rVal.size ());
+
+  // two and four steps of the scheme
+  double dSmooth = (1. - cfl::EPS) * 2. * dH * dH / 3.;
+  std::valarray<double> uV1 (rVal), uD1, uG1, uV2 (rVal), uD2, uG2;
+  GaussRollback uRoll (NGaussRollback::expl (1. / 6.));
+  uRoll.assign (rVal.size (), dH, dSmooth);
+  uRoll.rollback (uV1, uD1, uG1);
+  uRoll.assign (rVal.size (), dH, 2. * dSmooth);
+  uRoll.rollback (uV2, uD2, uG2);
+
+  std::vector<std::valarray<double> > uGreeks{ 2. * uD1 - uD2,
+                                               2. * uG1 - uG2 };
+  std::valarray<double> uArg (rArg[rWindow]);
+  std::vector<Function> uF;
+  for (const std::valarray<double> &rG : uGreeks)
+    {
+      std::valarray<double> uG (rG[rWindow]);
+      Interp uInterp (rInterp);
+      uInterp.assign (std::begin (uArg), std::end (uArg), std::begin (uG));
+      uF.push_back (uInterp.interp ());
+    }
+  return uF;
+}
+
 MultiFunction
-cflBrownian::Model::interpolate (const Slice &rSlice) const
+cflBrownian::Base::interpolate (const Slice &rSlice) const
 {
-  Slice uState = state (rSlice.timeIndex (), 0);
-  const std::valarray<double> &rArg = uState.values ();
-  const std::valarray<double> &rVal = rSlice.values ();
+  unsigned iTime = rSlice.timeIndex ();
+  Slice uState = state (iTime, 0);
+  const std::valarray<double> &rState = uState.values ();
+  const std::valarray<double> &rValues = rSlice.values ();
+
+  ASSERT (rState.size () == rValues.size ());
+
+  // only the window of initial values is interpolated
+  double dHalf = 0.5 * m_dInterval + c_iMargin * m_dH;
+  unsigned iFirst = std::lower_bound (std::begin (rState), std::end (rState),
+                                      -dHalf)
+                    - std::begin (rState);
+  unsigned iSize = rState.size () - 2 * iFirst;
+  if (iSize < 3)
+    {
+      iFirst = 0;
+      iSize = rState.size ();
+    }
+  std::slice uWindow (iFirst, iSize, 1);
+  std::valarray<double> uArg (rState[uWindow]);
+  std::valarray<double> uVal (rValues[uWindow]);
+
   Interp uInterp (m_uInterp);
-  uInterp.assign (std::begin (rArg), std::end (rArg), std::begin (rVal));
+  uInterp.assign (std::begin (uArg), std::end (uArg), std::begin (uVal));
   Function uF = uInterp.interp ();
 
-  return MultiFunction (uF);
+  std::shared_ptr<Greeks> pGreeks (new Greeks ());
+  std::function<const std::vector<Function> &()> uGreeks
+      = [pGreeks, uArg = rState, uVal = rValues, uWindow, dH = m_dH,
+         uBase = m_uInterp] () -> const std::vector<Function> & {
+    std::call_once (pGreeks->uFlag, [&] () {
+      pGreeks->uF = greeks (uArg, uVal, uWindow, dH, uBase);
+    });
+    return pGreeks->uF;
+  };
+
+  std::function<std::valarray<double> (const std::valarray<double> &,
+                                       const std::valarray<size_t> &)>
+      uFF = [uF, uGreeks] (const std::valarray<double> &rX,
+                           const std::valarray<size_t> &rI) {
+        PRECONDITION (rX.size () == 1);
+
+        std::valarray<double> uY (rI.size ());
+        for (unsigned iI = 0; iI < rI.size (); iI++)
+          {
+            PRECONDITION (rI[iI] < 3);
+
+            uY[iI] = (rI[iI] == 0) ? uF (rX[0])
+                                   : uGreeks ()[rI[iI] - 1](rX[0]);
+          }
+        return uY;
+      };
+  std::function<std::valarray<double> (const std::valarray<double> &)> uFX
+      = [uFF] (const std::valarray<double> &rX) {
+          return uFF (rX, std::valarray<size_t>{ 0, 1, 2 });
+        };
+  std::function<bool (const std::valarray<double> &)> uBelongs
+      = [uF] (const std::valarray<double> &rX) { return uF.belongs (rX[0]); };
+
+  return MultiFunction (uFF, uFX, uBelongs, 1, 3);
 }
 
 // constructor of model for Brownian motion
@@ -251,9 +570,9 @@ cfl::brownian (const std::function<double (double)> &rH,
   return [rH, rWidth, rSize, rRollback, rInd,
           rInterp] (const std::vector<double> &rVar,
                     const std::vector<double> &rEventTimes, double dInterval) {
-    return cfl::Model (new cflBrownian::Model (rH, rWidth, rSize, rRollback,
-                                               rInd, rInterp, rVar,
-                                               rEventTimes, dInterval));
+    return cfl::Model (new cflBrownian::Model<Unit> (
+        rH, rWidth, rSize, rRollback, rInd, rInterp, rVar, rEventTimes,
+        dInterval, Unit ()));
   };
 }
 
@@ -268,3 +587,101 @@ cfl::brownian (double dStepQuality, double dWidthQuality,
                    Grid::widthGauss (dWidthQuality), rSize, rRollback, rInd,
                    rInterp);
 }
+
+// change of numeraire
+
+cfl::Model
+cfl::numeraire (const cfl::Model &rBrownian, const std::vector<double> &rShift,
+                const std::vector<double> &rSlope)
+{
+  PRECONDITION (rShift.size () == rBrownian.eventTimes ().size ());
+  PRECONDITION (rSlope.size () == rShift.size ());
+
+  bool bState = std::any_of (rSlope.begin (), rSlope.end (),
+                             [] (double dB) { return dB != 0.; });
+  const cflBrownian::Model<Unit> *pBrownian
+      = dynamic_cast<const cflBrownian::Model<Unit> *> (&rBrownian.model ());
+
+  if (pBrownian)
+    {
+      if (bState)
+        {
+          return cfl::Model (new cflBrownian::Model<LogAffine> (
+              *pBrownian, LogAffine (rShift, rSlope)));
+        }
+      return cfl::Model (new cflBrownian::Model<Deterministic> (
+          *pBrownian, Deterministic (rShift)));
+    }
+
+  // the numeraires of the fused models are multiplied: the shifts and
+  // the slopes are added
+  const cflBrownian::Model<Deterministic> *pDeterministic
+      = dynamic_cast<const cflBrownian::Model<Deterministic> *> (
+          &rBrownian.model ());
+
+  if (pDeterministic)
+    {
+      std::vector<double> uShift (rShift);
+      for (unsigned iI = 0; iI < uShift.size (); iI++)
+        {
+          uShift[iI] += pDeterministic->numeraire ().shift (iI);
+        }
+      if (bState)
+        {
+          return cfl::Model (new cflBrownian::Model<LogAffine> (
+              *pDeterministic, LogAffine (uShift, rSlope)));
+        }
+      return cfl::Model (new cflBrownian::Model<Deterministic> (
+          *pDeterministic, Deterministic (uShift)));
+    }
+
+  const cflBrownian::Model<LogAffine> *pLogAffine
+      = dynamic_cast<const cflBrownian::Model<LogAffine> *> (
+          &rBrownian.model ());
+
+  if (pLogAffine)
+    {
+      const LogAffine &rNumeraire = pLogAffine->numeraire ();
+      if (!bState)
+        {
+          // the values of exp(b_i x) on the grids are reused
+          return cfl::Model (new cflBrownian::Model<LogAffine> (
+              *pLogAffine, LogAffine (rNumeraire, rShift)));
+        }
+      std::vector<double> uShift (rShift), uSlope (rSlope);
+      for (unsigned iI = 0; iI < uShift.size (); iI++)
+        {
+          uShift[iI] += rNumeraire.shift (iI);
+          uSlope[iI] += rNumeraire.slope (iI);
+        }
+      return cfl::Model (new cflBrownian::Model<LogAffine> (
+          *pLogAffine, LogAffine (uShift, uSlope)));
+    }
+
+  // general models: the numeraire is applied by the similar model
+  const IModel &rBase = rBrownian.model ();
+  std::function<void (Slice &, unsigned, double)> uMultiply
+      = [&rBase, rSlope, bState] (Slice &rSlice, unsigned iTime,
+                                  double dPower) {
+          if (bState)
+            {
+              rSlice *= exp (rBase.state (iTime, 0) * (dPower * rSlope[iTime]));
+            }
+        };
+  TRollback uRollback = [rShift, uMultiply] (Slice &rSlice, unsigned iTime) {
+    unsigned iFrom = rSlice.timeIndex ();
+    uMultiply (rSlice, iFrom, -1.);
+    rSlice.rollback (iTime);
+    uMultiply (rSlice, iTime, 1.);
+    rSlice *= std::exp (rShift[iTime] - rShift[iFrom]);
+  };
+  TRollback uAdjoint
+      = [&rBase, rShift, uMultiply] (Slice &rSlice, unsigned iTime) {
+          unsigned iFrom = rSlice.timeIndex ();
+          uMultiply (rSlice, iFrom, 1.);
+          rBase.adjointRollback (rSlice, iTime);
+          uMultiply (rSlice, iTime, -1.);
+          rSlice *= std::exp (rShift[iFrom] - rShift[iTime]);
+        };
+  return similar (uRollback, uAdjoint, rBrownian);
+}
@@ -0,0 +1,639 @@
+#include "cfl/Brownian.hpp"
+#include "cfl/GaussRollback.hpp"
+#include "cfl/Ind.hpp"
+#include "cfl/Interp.hpp"
+#include "cfl/Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gsl/gsl_fft_complex.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <gsl/gsl_fft_real.h>
+#include <memory>
+#include <numeric>
+
+using namespace cfl;
+
+namespace cflBrownian2
+{
+// the number of extra nodes on each side of the interval of initial
+// values used by the interpolation
+const unsigned c_iMargin = 8;
+
+// the minimal number of rows or columns processed by one thread
+const unsigned c_iMinBlock = 16;
+
+// the grid for one of the Brownian motions
+class Grid
+{
+public:
+  Grid () {}
+
+  Grid (const std::function<double (double)> &rH,
+        const std::function<double (double)> &rWidth,
+        const std::function<unsigned (double)> &rSize,
+        const std::vector<double> &rVar,
+        const std::vector<double> &rEventTimes, double dInterval);
+
+  std::valarray<double> state (unsigned iTime) const;
+
+  // the indexes of the window of initial values used by the
+  // interpolation
+  std::pair<unsigned, unsigned> window (unsigned iTime) const;
+
+  std::vector<double> totalVar;
+  double h;
+  std::vector<unsigned> size;
+  double interval;
+};
+
+// the bicubic Hermite interpolation on a uniform rectangular grid;
+// the first derivatives and the cross derivative at the nodes are
+// given by the one-dimensional interpolations along the rows and the
+// columns and are computed once
+class Bicubic
+{
+public:
+  Bicubic (const std::valarray<double> &rArg0,
+           const std::valarray<double> &rArg1,
+           const std::valarray<double> &rVal, const Interp &rInterp);
+
+  double operator() (double dX0, double dX1) const;
+
+  bool
+  belongs (double dX0, double dX1) const
+  {
+    return (dX0 >= m_dX0) && (dX0 <= m_dX0 + m_dH0 * (m_iSize0 - 1))
+           && (dX1 >= m_dX1) && (dX1 <= m_dX1 + m_dH1 * (m_iSize1 - 1));
+  }
+
+private:
+  double m_dX0, m_dX1, m_dH0, m_dH1;
+  unsigned m_iSize0, m_iSize1;
+  // the values and the derivatives in x0, x1 and x0 x1, row-major
+  std::valarray<double> m_uF, m_uF0, m_uF1, m_uF01;
+};
+
+class Model : public cfl::IModel
+{
+public:
+  Model (const std::function<double (double)> &rH,
+         const std::function<double (double)> &rWidth,
+         const std::function<unsigned (double)> &rSize,
+         const GaussRollback &rRollback, const Ind &rInd,
+         const Interp &rInterp, const std::vector<double> &rVar1,
+         const std::vector<double> &rVar2, double dCorrelation,
+         const std::vector<double> &rEventTimes,
+         const std::valarray<double> &rInterval);
+
+  const std::vector<double> &
+  eventTimes () const
+  {
+    return m_uEventTimes;
+  }
+
+  unsigned
+  numberOfStates () const
+  {
+    return 2;
+  }
+
+  unsigned numberOfNodes (unsigned iTime,
+                          const std::vector<unsigned> &rDependence) const;
+
+  std::valarray<double>
+  origin () const
+  {
+    return std::valarray<double> (0., 2);
+  }
+
+  Slice state (unsigned iTime, unsigned iState) const;
+
+  void addDependence (Slice &rSlice,
+                      const std::vector<unsigned> &rDependence) const;
+
+  void rollback (Slice &rSlice, unsigned iTime) const;
+
+  void indicator (Slice &rSlice, double dBarrier) const;
+
+  MultiFunction interpolate (const Slice &rSlice) const;
+
+private:
+  void rollback2 (std::valarray<double> &rValues, unsigned iFrom,
+                  unsigned iTime) const;
+
+  GaussRollback m_uGaussRollback;
+  Ind m_uInd;
+  Interp m_uInterp;
+  std::vector<double> m_uEventTimes;
+  double m_dCorrelation;
+  Grid m_uGrid[2];
+};
+
+bool
+isPower2 (unsigned iSize)
+{
+  return (iSize > 0) && ((iSize & (iSize - 1)) == 0);
+}
+} // namespace cflBrownian2
+
+using namespace cflBrownian2;
+
+// CLASS cflBrownian2::Bicubic
+
+cflBrownian2::Bicubic::Bicubic (const std::valarray<double> &rArg0,
+                                const std::valarray<double> &rArg1,
+                                const std::valarray<double> &rVal,
+                                const Interp &rInterp)
+    : m_dX0 (rArg0[0]), m_dX1 (rArg1[0]), m_iSize0 (rArg0.size ()),
+      m_iSize1 (rArg1.size ()), m_uF (rVal), m_uF0 (rVal.size ()),
+      m_uF1 (rVal.size ()), m_uF01 (rVal.size ())
+{
+  PRECONDITION ((m_iSize0 > 1) && (m_iSize1 > 1));
+  PRECONDITION (rVal.size () == m_iSize0 * m_iSize1);
+
+  m_dH0 = rArg0[1] - rArg0[0];
+  m_dH1 = rArg1[1] - rArg1[0];
+
+  // the derivatives of the interpolations of rV along the lines
+  // given by rS
+  auto uDeriv = [&rInterp] (const std::valarray<double> &rArg,
+                            const std::valarray<double> &rV,
+                            std::valarray<double> &rD, const std::slice &rS) {
+    std::valarray<double> uV (rV[rS]);
+    Interp uInterp (rInterp);
+    uInterp.assign (std::begin (rArg), std::end (rArg), std::begin (uV));
+    rD[rS] = uInterp.values (rArg, 1);
+  };
+  for (unsigned iI = 0; iI < m_iSize0; iI++)
+    {
+      uDeriv (rArg1, m_uF, m_uF1, std::slice (iI * m_iSize1, m_iSize1, 1));
+    }
+  for (unsigned iJ = 0; iJ < m_iSize1; iJ++)
+    {
+      std::slice uS (iJ, m_iSize0, m_iSize1);
+      uDeriv (rArg0, m_uF, m_uF0, uS);
+      uDeriv (rArg0, m_uF1, m_uF01, uS);
+    }
+}
+
+double
+cflBrownian2::Bicubic::operator() (double dX0, double dX1) const
+{
+  PRECONDITION (belongs (dX0, dX1));
+
+  // the cell and the relative position there
+  double dT = (dX0 - m_dX0) / m_dH0;
+  double dU = (dX1 - m_dX1) / m_dH1;
+  unsigned iI = std::min (unsigned (dT), m_iSize0 - 2);
+  unsigned iJ = std::min (unsigned (dU), m_iSize1 - 2);
+  dT -= iI;
+  dU -= iJ;
+
+  // the Hermite basis for the values and for the derivatives at the
+  // left and the right ends
+  double dT2 = dT * dT, dU2 = dU * dU;
+  double uH0[2] = { 1. - dT2 * (3. - 2. * dT), dT2 * (3. - 2. * dT) };
+  double uG0[2]
+      = { dT * (1. - dT) * (1. - dT) * m_dH0, dT2 * (dT - 1.) * m_dH0 };
+  double uH1[2] = { 1. - dU2 * (3. - 2. * dU), dU2 * (3. - 2. * dU) };
+  double uG1[2]
+      = { dU * (1. - dU) * (1. - dU) * m_dH1, dU2 * (dU - 1.) * m_dH1 };
+
+  double dY = 0.;
+  for (unsigned iA = 0; iA < 2; iA++)
+    {
+      for (unsigned iB = 0; iB < 2; iB++)
+        {
+          unsigned iK = (iI + iA) * m_iSize1 + iJ + iB;
+          dY += uH0[iA] * (uH1[iB] * m_uF[iK] + uG1[iB] * m_uF1[iK])
+                + uG0[iA] * (uH1[iB] * m_uF0[iK] + uG1[iB] * m_uF01[iK]);
+        }
+    }
+  return dY;
+}
+
+// CLASS cflBrownian2::Grid
+
+cflBrownian2::Grid::Grid (const std::function<double (double)> &rH,
+                          const std::function<double (double)> &rWidth,
+                          const std::function<unsigned (double)> &rSize,
+                          const std::vector<double> &rVar,
+                          const std::vector<double> &rEventTimes,
+                          double dInterval)
+    : totalVar (cfl::Grid::totalVar (rVar, rEventTimes)),
+      h (rH (cfl::Grid::minVar (totalVar))),
+      size (cfl::Grid::sizes (totalVar, h, dInterval, rWidth, rSize)),
+      interval (dInterval)
+{
+}
+
+std::valarray<double>
+cflBrownian2::Grid::state (unsigned iTime) const
+{
+  std::valarray<double> uX (size[iTime]);
+  double dX = -h * (size[iTime] - 1) / 2.;
+  for (double &rX : uX)
+    {
+      rX = dX;
+      dX += h;
+    }
+  return uX;
+}
+
+std::pair<unsigned, unsigned>
+cflBrownian2::Grid::window (unsigned iTime) const
+{
+  std::valarray<double> uX = state (iTime);
+  double dHalf = 0.5 * interval + c_iMargin * h;
+  unsigned iFirst
+      = std::lower_bound (std::begin (uX), std::end (uX), -dHalf)
+        - std::begin (uX);
+
+  return std::make_pair (iFirst, uX.size () - 2 * iFirst);
+}
+
+// CLASS cflBrownian2::Model
+
+cflBrownian2::Model::Model (const std::function<double (double)> &rH,
+                            const std::function<double (double)> &rWidth,
+                            const std::function<unsigned (double)> &rSize,
+                            const GaussRollback &rRollback, const Ind &rInd,
+                            const Interp &rInterp,
+                            const std::vector<double> &rVar1,
+                            const std::vector<double> &rVar2,
+                            double dCorrelation,
+                            const std::vector<double> &rEventTimes,
+                            const std::valarray<double> &rInterval)
+    : m_uGaussRollback (rRollback), m_uInd (rInd), m_uInterp (rInterp),
+      m_uEventTimes (rEventTimes), m_dCorrelation (dCorrelation)
+{
+  PRECONDITION (std::abs (dCorrelation) <= 1.);
+  PRECONDITION (rInterval.size () == 2);
+  PRECONDITION (std::equal (m_uEventTimes.begin () + 1, m_uEventTimes.end (),
+                            m_uEventTimes.begin (), std::greater<double> ()));
+
+  m_uGrid[0] = Grid (rH, rWidth, rSize, rVar1, rEventTimes, rInterval[0]);
+  m_uGrid[1] = Grid (rH, rWidth, rSize, rVar2, rEventTimes, rInterval[1]);
+}
+
+unsigned
+cflBrownian2::Model::numberOfNodes (
+    unsigned iTime, const std::vector<unsigned> &rDependence) const
+{
+  PRECONDITION (rDependence.size () <= 2);
+
+  unsigned iSize = 1;
+  for (unsigned iState : rDependence)
+    {
+      PRECONDITION (iState < 2);
+
+      iSize *= m_uGrid[iState].size[iTime];
+    }
+  return iSize;
+}
+
+Slice
+cflBrownian2::Model::state (unsigned iTime, unsigned iState) const
+{
+  PRECONDITION (iState < 2);
+
+  return Slice (*this, iTime, std::vector<unsigned> (1, iState),
+                m_uGrid[iState].state (iTime));
+}
+
+// a payoff on the two-dimensional grid is stored by rows: the first
+// index corresponds to the first Brownian motion
+void
+cflBrownian2::Model::addDependence (
+    Slice &rSlice, const std::vector<unsigned> &rDependence) const
+{
+  PRECONDITION (rDependence.size () <= 2);
+
+  const std::vector<unsigned> &rOld = rSlice.dependence ();
+  std::vector<unsigned> uNew;
+  std::set_union (rOld.begin (), rOld.end (), rDependence.begin (),
+                  rDependence.end (), std::back_inserter (uNew));
+
+  if (uNew.size () == rOld.size ())
+    {
+      return;
+    }
+
+  unsigned iTime = rSlice.timeIndex ();
+  const std::valarray<double> &rValues = rSlice.values ();
+  std::valarray<double> uValues (numberOfNodes (iTime, uNew));
+
+  if (rOld.size () == 0)
+    {
+      uValues = rValues[0];
+    }
+  else
+    {
+      ASSERT ((rOld.size () == 1) && (uNew.size () == 2));
+
+      unsigned iSize0 = m_uGrid[0].size[iTime];
+      unsigned iSize1 = m_uGrid[1].size[iTime];
+      if (rOld.front () == 0)
+        {
+          for (unsigned iI = 0; iI < iSize0; iI++)
+            {
+              uValues[std::slice (iI * iSize1, iSize1, 1)] = rValues[iI];
+            }
+        }
+      else
+        {
+          for (unsigned iI = 0; iI < iSize0; iI++)
+            {
+              uValues[std::slice (iI * iSize1, iSize1, 1)] = rValues;
+            }
+        }
+    }
+  rSlice.assign (uNew, uValues);
+}
+
+void
+cflBrownian2::Model::rollback (Slice &rSlice, unsigned iTime) const
+{
+  PRECONDITION (&rSlice.model () == this);
+  PRECONDITION (rSlice.timeIndex () > iTime);
+
+  unsigned iFrom = rSlice.timeIndex ();
+  const std::vector<unsigned> &rDependence = rSlice.dependence ();
+  std::valarray<double> &rValues = rSlice.values ();
+
+  if (rDependence.size () == 0)
+    {
+      rSlice.assign (iTime, rDependence, rValues);
+      return;
+    }
+
+  if (rDependence.size () == 1)
+    {
+      const Grid &rGrid = m_uGrid[rDependence.front ()];
+      double dVar = rGrid.totalVar[iFrom] - rGrid.totalVar[iTime];
+
+      ASSERT (dVar > VAR_EPS);
+      ASSERT (rGrid.h * rGrid.h <= 1.5001 * dVar);
+
+      GaussRollback uRoll (m_uGaussRollback);
+      uRoll.assign (rValues.size (), rGrid.h, dVar);
+      uRoll.rollback (rValues);
+
+      unsigned iSize = rGrid.size[iTime];
+      std::valarray<double> uT (
+          rValues[std::slice ((rValues.size () - iSize) / 2, iSize, 1)]);
+      rSlice.assign (iTime, rDependence, uT);
+      return;
+    }
+
+  rollback2 (rValues, iFrom, iTime);
+
+  unsigned iSize0 = m_uGrid[0].size[iFrom];
+  unsigned iSize1 = m_uGrid[1].size[iFrom];
+  unsigned iNew0 = m_uGrid[0].size[iTime];
+  unsigned iNew1 = m_uGrid[1].size[iTime];
+  unsigned iFirst0 = (iSize0 - iNew0) / 2;
+  unsigned iFirst1 = (iSize1 - iNew1) / 2;
+  std::valarray<double> uT (iNew0 * iNew1);
+  for (unsigned iI = 0; iI < iNew0; iI++)
+    {
+      uT[std::slice (iI * iNew1, iNew1, 1)] = rValues[std::slice (
+          (iI + iFirst0) * iSize1 + iFirst1, iNew1, 1)];
+    }
+  rSlice.assign (iTime, rDependence, uT);
+}
+
+// the tensor Fast Fourier Transform: the real transform of the rows
+// followed by the complex transform of the columns; the Fourier
+// coefficients are multiplied by the characteristic function of the
+// Gaussian increment
+void
+cflBrownian2::Model::rollback2 (std::valarray<double> &rValues,
+                                unsigned iFrom, unsigned iTime) const
+{
+  const Grid &rGrid0 = m_uGrid[0];
+  const Grid &rGrid1 = m_uGrid[1];
+  unsigned iSize0 = rGrid0.size[iFrom];
+  unsigned iSize1 = rGrid1.size[iFrom];
+
+  PRECONDITION (rValues.size () == iSize0 * iSize1);
+  PRECONDITION (isPower2 (iSize0) && isPower2 (iSize1));
+
+  double dVar0 = rGrid0.totalVar[iFrom] - rGrid0.totalVar[iTime];
+  double dVar1 = rGrid1.totalVar[iFrom] - rGrid1.totalVar[iTime];
+  double dCov = m_dCorrelation * std::sqrt (dVar0 * dVar1);
+
+  ASSERT ((dVar0 > VAR_EPS) && (dVar1 > VAR_EPS));
+
+  double *pValues = &rValues[0];
+  cfl::parallel (
+      iSize0,
+      [pValues, iSize1] (unsigned iBegin, unsigned iEnd) {
+        for (unsigned iI = iBegin; iI < iEnd; iI++)
+          {
+            gsl_fft_real_radix2_transform (pValues + iI * iSize1, 1, iSize1);
+          }
+      },
+      c_iMinBlock);
+
+  // the frequencies of the columns are 0, ..., iSize1/2; at the
+  // Nyquist frequencies the mixed term is omitted to keep the result
+  // real
+  double dW0 = 2. * M_PI / (iSize0 * rGrid0.h);
+  double dW1 = 2. * M_PI / (iSize1 * rGrid1.h);
+  unsigned iHalf0 = iSize0 / 2;
+  unsigned iHalf1 = iSize1 / 2;
+  cfl::parallel (
+      iHalf1 + 1,
+      [=] (unsigned iBegin, unsigned iEnd) {
+        std::valarray<double> uColumn (2 * iSize0);
+        for (unsigned iK = iBegin; iK < iEnd; iK++)
+          {
+            bool bReal = (iK == 0) || (iK == iHalf1);
+            for (unsigned iI = 0; iI < iSize0; iI++)
+              {
+                uColumn[2 * iI] = pValues[iI * iSize1 + iK];
+                uColumn[2 * iI + 1]
+                    = bReal ? 0. : pValues[iI * iSize1 + iSize1 - iK];
+              }
+            gsl_fft_complex_radix2_forward (&uColumn[0], 1, iSize0);
+            double dX1 = iK * dW1;
+            for (unsigned iI = 0; iI < iSize0; iI++)
+              {
+                double dX0 = ((iI <= iHalf0) ? double (iI)
+                                             : double (iI) - iSize0)
+                             * dW0;
+                double dCross
+                    = (bReal || (iI == iHalf0)) ? 0. : 2. * dCov * dX0 * dX1;
+                double dW = std::exp (-0.5
+                                      * (dVar0 * dX0 * dX0 + dCross
+                                         + dVar1 * dX1 * dX1));
+                uColumn[2 * iI] *= dW;
+                uColumn[2 * iI + 1] *= dW;
+              }
+            gsl_fft_complex_radix2_inverse (&uColumn[0], 1, iSize0);
+            for (unsigned iI = 0; iI < iSize0; iI++)
+              {
+                pValues[iI * iSize1 + iK] = uColumn[2 * iI];
+                if (!bReal)
+                  {
+                    pValues[iI * iSize1 + iSize1 - iK] = uColumn[2 * iI + 1];
+                  }
+              }
+          }
+      },
+      c_iMinBlock);
+
+  cfl::parallel (
+      iSize0,
+      [pValues, iSize1] (unsigned iBegin, unsigned iEnd) {
+        for (unsigned iI = iBegin; iI < iEnd; iI++)
+          {
+            gsl_fft_halfcomplex_radix2_inverse (pValues + iI * iSize1, 1,
+                                                iSize1);
+          }
+      },
+      c_iMinBlock);
+}
+
+void
+cflBrownian2::Model::indicator (Slice &rSlice, double dBarrier) const
+{
+  const std::vector<unsigned> &rDependence = rSlice.dependence ();
+  std::valarray<double> &rValues = rSlice.values ();
+
+  if (rDependence.size () < 2)
+    {
+      m_uInd.indicator (rValues, dBarrier);
+      return;
+    }
+
+  // the average of the indicators along the rows and along the
+  // columns
+  unsigned iSize1 = m_uGrid[1].size[rSlice.timeIndex ()];
+  unsigned iSize0 = rValues.size () / iSize1;
+  std::valarray<double> uColumns (rValues);
+  std::valarray<double> *pRows = &rValues;
+  std::valarray<double> *pColumns = &uColumns;
+  const Ind &rInd = m_uInd;
+  cfl::parallel (
+      iSize0,
+      [pRows, iSize1, &rInd, dBarrier] (unsigned iBegin, unsigned iEnd) {
+        for (unsigned iI = iBegin; iI < iEnd; iI++)
+          {
+            std::slice uS (iI * iSize1, iSize1, 1);
+            std::valarray<double> uRow ((*pRows)[uS]);
+            rInd.indicator (uRow, dBarrier);
+            (*pRows)[uS] = uRow;
+          }
+      },
+      c_iMinBlock);
+  cfl::parallel (
+      iSize1,
+      [pColumns, iSize0, iSize1, &rInd, dBarrier] (unsigned iBegin,
+                                                   unsigned iEnd) {
+        for (unsigned iJ = iBegin; iJ < iEnd; iJ++)
+          {
+            std::slice uS (iJ, iSize0, iSize1);
+            std::valarray<double> uColumn ((*pColumns)[uS]);
+            rInd.indicator (uColumn, dBarrier);
+            (*pColumns)[uS] = uColumn;
+          }
+      },
+      c_iMinBlock);
+  rValues += uColumns;
+  rValues *= 0.5;
+}
+
+MultiFunction
+cflBrownian2::Model::interpolate (const Slice &rSlice) const
+{
+  unsigned iTime = rSlice.timeIndex ();
+  const std::vector<unsigned> &rDependence = rSlice.dependence ();
+  const std::valarray<double> &rValues = rSlice.values ();
+
+  PRECONDITION (rDependence.size () > 0);
+
+  if (rDependence.size () == 1)
+    {
+      const Grid &rGrid = m_uGrid[rDependence.front ()];
+      std::pair<unsigned, unsigned> uW = rGrid.window (iTime);
+      std::valarray<double> uArg (
+          rGrid.state (iTime)[std::slice (uW.first, uW.second, 1)]);
+      std::valarray<double> uVal (
+          rValues[std::slice (uW.first, uW.second, 1)]);
+      Interp uInterp (m_uInterp);
+      uInterp.assign (std::begin (uArg), std::end (uArg), std::begin (uVal));
+
+      return MultiFunction (uInterp.interp ());
+    }
+
+  std::pair<unsigned, unsigned> uW0 = m_uGrid[0].window (iTime);
+  std::pair<unsigned, unsigned> uW1 = m_uGrid[1].window (iTime);
+  unsigned iSize1 = m_uGrid[1].size[iTime];
+  std::valarray<double> uArg0 (
+      m_uGrid[0].state (iTime)[std::slice (uW0.first, uW0.second, 1)]);
+  std::valarray<double> uArg1 (
+      m_uGrid[1].state (iTime)[std::slice (uW1.first, uW1.second, 1)]);
+  std::valarray<double> uVal (uW0.second * uW1.second);
+  for (unsigned iI = 0; iI < uW0.second; iI++)
+    {
+      uVal[std::slice (iI * uW1.second, uW1.second, 1)] = rValues[std::slice (
+          (uW0.first + iI) * iSize1 + uW1.first, uW1.second, 1)];
+    }
+  std::shared_ptr<const Bicubic> pF (
+      new Bicubic (uArg0, uArg1, uVal, m_uInterp));
+
+  std::function<std::valarray<double> (const std::valarray<double> &)> uF
+      = [pF] (const std::valarray<double> &rX) {
+          PRECONDITION (rX.size () == 2);
+
+          return std::valarray<double> ((*pF) (rX[0], rX[1]), 1);
+        };
+  std::function<bool (const std::valarray<double> &)> uBelongs
+      = [pF] (const std::valarray<double> &rX) {
+          return (rX.size () == 2) && pF->belongs (rX[0], rX[1]);
+        };
+  std::function<std::valarray<double> (const std::valarray<double> &,
+                                       const std::valarray<size_t> &)>
+      uFF = [uF] (const std::valarray<double> &rX,
+                  const std::valarray<size_t> &rI) {
+        PRECONDITION ((rI.size () == 0) || (rI.max () == 0));
+
+        return std::valarray<double> (uF (rX)[0], rI.size ());
+      };
+
+  return MultiFunction (uFF, uF, uBelongs, 2, 1);
+}
+
+// constructor of model with two Brownian motions
+
+cfl::TBrownian2
+cfl::brownian2 (const std::function<double (double)> &rH,
+                const std::function<double (double)> &rWidth,
+                const std::function<unsigned (double)> &rSize,
+                const GaussRollback &rRollback, const Ind &rInd,
+                const Interp &rInterp)
+{
+  return [rH, rWidth, rSize, rRollback, rInd, rInterp] (
+             const std::vector<double> &rVar1,
+             const std::vector<double> &rVar2, double dCorrelation,
+             const std::vector<double> &rEventTimes,
+             const std::valarray<double> &rInterval) {
+    return cfl::Model (new cflBrownian2::Model (
+        rH, rWidth, rSize, rRollback, rInd, rInterp, rVar1, rVar2,
+        dCorrelation, rEventTimes, rInterval));
+  };
+}
+
+cfl::TBrownian2
+cfl::brownian2 (double dStepQuality, double dWidthQuality,
+                unsigned iUniformSteps,
+                const std::function<unsigned (double)> &rSize,
+                const GaussRollback &rRollback, const Ind &rInd,
+                const Interp &rInterp)
+{
+  return brownian2 (cfl::Grid::step (dStepQuality, iUniformSteps),
+                    cfl::Grid::widthGauss (dWidthQuality), rSize, rRollback,
+                    rInd, rInterp);
+}
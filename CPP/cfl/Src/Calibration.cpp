@@ -0,0 +1,659 @@
+#include "cfl/Calibration.hpp"
+#include "cfl/Analytic.hpp"
+#include "cfl/Error.hpp"
+#include "cfl/LeastSquares.hpp"
+#include "cfl/Parallel.hpp"
+#include "cfl/RootSolver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+using namespace cfl;
+
+namespace cflCalibration
+{
+const double c_dSeries = 1E-4;      // the bound for the Taylor series
+const double c_dVolGuess = 0.01;    // the guess for the short-term vol
+const unsigned c_iMaxDoubling = 64; // the search of the bracket
+const unsigned c_iMinBlock = 16;    // the options priced in one thread
+
+// E(x) = (exp(x)-1)/x and its derivative
+void
+expRatio (double dX, double &rE, double &rDE)
+{
+  if (std::abs (dX) < c_dSeries)
+    {
+      rE = 1. + dX * (0.5 + dX / 6.);
+      rDE = 0.5 + dX * (1. / 3. + dX / 8.);
+    }
+  else
+    {
+      double dM = std::expm1 (dX);
+      rE = dM / dX;
+      rDE = (dX * (dM + 1.) - dM) / (dX * dX);
+    }
+}
+
+// the option with maturity T on the coupon bond; pF are the forward
+// values at T of the payments, pV are their volatilities; the values
+// of the payments at T are pF[i] exp(pV[i] y - pV[i]^2/2) for the
+// standard normal y; the strikes of Jamshidian correspond to the
+// exercise boundary y = rY; returns the forward price of the option
+// and writes the forward vegas to pVega
+double
+option (const double *pF, const double *pV, unsigned iN, double dStrike,
+        bool bCall, double &rY, double *pVega)
+{
+  double dForward = std::accumulate (pF, pF + iN, 0.) - dStrike;
+  if (!bCall)
+    {
+      dForward = -dForward;
+    }
+  // the volatilities increase with the payment time
+  if (pV[iN - 1] < cfl::EPS)
+    {
+      std::fill (pVega, pVega + iN, 0.);
+      return std::max (dForward, 0.);
+    }
+  // the logarithm of the value of the bond is convex in y; hence,
+  // Newton method converges monotonically after the first step
+  double dLogK = std::log (dStrike);
+  auto uBond = [pF, pV, iN, dLogK] (double dY) {
+    double dB = 0., dDB = 0.;
+    for (unsigned iI = 0; iI < iN; iI++)
+      {
+        double dP = pF[iI] * std::exp (pV[iI] * (dY - 0.5 * pV[iI]));
+        dB += dP;
+        dDB += pV[iI] * dP;
+      }
+    return std::pair<double, double> (std::log (dB) - dLogK, dDB / dB);
+  };
+  rY = Newton (cfl::EPS, 0.).find (uBond, rY);
+
+  // the options on the payments with the strikes of Jamshidian
+  double dC = 0.;
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      double dK = pF[iI] * std::exp (pV[iI] * (rY - 0.5 * pV[iI]));
+      dC += NAnalytic::black (pF[iI], dK, pV[iI], pVega[iI]);
+    }
+  return bCall ? dC : dC + dForward;
+}
+
+// the normal equations of the least squares for two parameters; rJ0
+// and rJ1 are the derivatives of the residuals rRes
+Levenberg::TNormal
+normal (const std::valarray<double> &rRes, const std::valarray<double> &rJ0,
+        const std::valarray<double> &rJ1)
+{
+  return [&rRes, &rJ0, &rJ1] (std::vector<double> &rG,
+                              std::vector<double> &rH) {
+    rG[0] = (rJ0 * rRes).sum ();
+    rG[1] = (rJ1 * rRes).sum ();
+    rH[0] = (rJ0 * rJ0).sum ();
+    rH[1] = rH[2] = (rJ0 * rJ1).sum ();
+    rH[3] = (rJ1 * rJ1).sum ();
+  };
+}
+
+// the bootstrap of the standard deviations of a model from the quotes
+// with maturities rMaturity; the quotes with the same maturity form a
+// group; for every group, we find the standard deviation at its
+// maturity by Newton method inside the bracket obtained by doubling;
+// rError (iK, dStd) returns the weighted pricing error of the quote
+// iK and its derivative in the standard deviation; the groups are
+// independent and are solved in parallel; writes the distinct times
+// to maturity to rTau
+std::vector<double>
+bootstrap (const std::vector<double> &rMaturity, double dInitialTime,
+           double dErr,
+           const std::function<std::pair<double, double> (unsigned, double)>
+               &rError,
+           std::vector<double> &rTau)
+{
+  // the groups of quotes with the same maturity
+  unsigned iN = rMaturity.size ();
+  std::vector<unsigned> uOrder (iN);
+  std::iota (uOrder.begin (), uOrder.end (), 0);
+  std::stable_sort (uOrder.begin (), uOrder.end (),
+                    [&rMaturity] (unsigned iI, unsigned iJ) {
+                      return rMaturity[iI] < rMaturity[iJ];
+                    });
+  std::vector<unsigned> uFirst (1, 0);
+  for (unsigned iI = 1; iI < iN; iI++)
+    {
+      if (rMaturity[uOrder[iI]] > rMaturity[uOrder[iI - 1]])
+        {
+          uFirst.push_back (iI);
+        }
+    }
+  uFirst.push_back (iN);
+  unsigned iGroups = uFirst.size () - 1;
+  rTau.resize (iGroups);
+  for (unsigned iG = 0; iG < iGroups; iG++)
+    {
+      rTau[iG] = rMaturity[uOrder[uFirst[iG]]] - dInitialTime;
+      PRECONDITION (rTau[iG] > 0);
+    }
+
+  std::vector<double> uStd (iGroups);
+  parallel (iGroups, [&] (unsigned iBegin, unsigned iEnd) {
+    for (unsigned iG = iBegin; iG < iEnd; iG++)
+      {
+        // the weighted sum of pricing errors and its derivative
+        auto uError = [&] (double dStd) {
+          double dF = 0., dDF = 0.;
+          for (unsigned iQ = uFirst[iG]; iQ < uFirst[iG + 1]; iQ++)
+            {
+              std::pair<double, double> uE = rError (uOrder[iQ], dStd);
+              dF += uE.first;
+              dDF += uE.second;
+            }
+          return std::pair<double, double> (dF, dDF);
+        };
+        if (uError (0.).first > 0)
+          {
+            throw (NError::range ("the price is below the intrinsic value"));
+          }
+        double dL = 0.;
+        double dR = c_dVolGuess * std::sqrt (rTau[iG]);
+        unsigned iStep = 0;
+        while (uError (dR).first < 0)
+          {
+            if (iStep == c_iMaxDoubling)
+              {
+                throw (NError::range ("the price is above the upper bound"));
+              }
+            iStep++;
+            dL = dR;
+            dR *= 2.;
+          }
+        uStd[iG] = Newton (dErr * dR, dErr)
+                       .find (uError, 0.5 * (dL + dR), dL, dR);
+      }
+  });
+  return uStd;
+}
+} // namespace cflCalibration
+
+using namespace cflCalibration;
+
+// class HullWhite::Basket
+
+cfl::HullWhite::Basket::Basket (const Function &rDiscount,
+                                double dInitialTime)
+    : m_uDiscount (rDiscount), m_dInitialTime (dInitialTime),
+      m_uFirstPay (1, 0), m_uFirstOption (1, 0)
+{
+}
+
+void
+cfl::HullWhite::Basket::addCap (const cfl::Data::CashFlow &rCap,
+                                double dPrice, double dWeight)
+{
+  PRECONDITION (rCap.numberOfPayments > 0);
+  PRECONDITION (dWeight > 0);
+
+  // the caplet for the period [t, t + period] is the put on the
+  // discount bond with the strike 1/(1 + rate * period) at t
+  double dCapFactor = 1. + rCap.rate * rCap.period;
+  double dTime = m_dInitialTime;
+  for (unsigned iI = 0; iI < rCap.numberOfPayments; iI++)
+    {
+      double dDiscount = m_uDiscount (dTime);
+      double dPayTime = dTime + rCap.period;
+      m_uMaturity.push_back (dTime);
+      m_uDiscountT.push_back (dDiscount);
+      m_uStrike.push_back (rCap.notional);
+      m_uCall.push_back (false);
+      m_uPayTime.push_back (dPayTime);
+      m_uForward.push_back (rCap.notional * dCapFactor
+                            * m_uDiscount (dPayTime) / dDiscount);
+      m_uFirstPay.push_back (m_uPayTime.size ());
+      dTime = dPayTime;
+    }
+  m_uQuote.push_back (dPrice);
+  m_uWeight.push_back (dWeight);
+  m_uFirstOption.push_back (m_uMaturity.size ());
+}
+
+void
+cfl::HullWhite::Basket::addSwaption (const cfl::Data::Swap &rSwap,
+                                     double dMaturity, double dPrice,
+                                     double dWeight)
+{
+  PRECONDITION (rSwap.numberOfPayments > 0);
+  PRECONDITION (dMaturity >= m_dInitialTime);
+  PRECONDITION (dWeight > 0);
+
+  // the fixed leg together with the notional is the coupon bond;
+  // the float leg is worth the notional at maturity
+  double dDiscount = m_uDiscount (dMaturity);
+  m_uMaturity.push_back (dMaturity);
+  m_uDiscountT.push_back (dDiscount);
+  m_uStrike.push_back (rSwap.notional);
+  m_uCall.push_back (rSwap.payFloat);
+  double dCoupon = rSwap.notional * rSwap.rate * rSwap.period;
+  for (unsigned iI = 1; iI <= rSwap.numberOfPayments; iI++)
+    {
+      double dPayTime = dMaturity + iI * rSwap.period;
+      m_uPayTime.push_back (dPayTime);
+      m_uForward.push_back (dCoupon * m_uDiscount (dPayTime) / dDiscount);
+    }
+  m_uForward.back () += rSwap.notional * m_uDiscount (m_uPayTime.back ())
+                        / dDiscount;
+  m_uFirstPay.push_back (m_uPayTime.size ());
+  m_uQuote.push_back (dPrice);
+  m_uWeight.push_back (dWeight);
+  m_uFirstOption.push_back (m_uMaturity.size ());
+}
+
+void
+cfl::HullWhite::Basket::options (const std::vector<double> &rV,
+                                 std::vector<double> &rY,
+                                 std::vector<double> &rPrice,
+                                 std::vector<double> &rVega, unsigned iBegin,
+                                 unsigned iEnd) const
+{
+  for (unsigned iK = iBegin; iK < iEnd; iK++)
+    {
+      unsigned iP = m_uFirstPay[iK];
+      double dPrice = option (&m_uForward[iP], &rV[iP],
+                              m_uFirstPay[iK + 1] - iP, m_uStrike[iK],
+                              m_uCall[iK], rY[iK], &rVega[iP]);
+      rPrice[iK] = m_uDiscountT[iK] * dPrice;
+      for (unsigned iI = iP; iI < m_uFirstPay[iK + 1]; iI++)
+        {
+          rVega[iI] *= m_uDiscountT[iK];
+        }
+    }
+}
+
+std::valarray<double>
+cfl::HullWhite::Basket::quotes (const std::vector<double> &rPrice) const
+{
+  std::valarray<double> uQuote (0., size ());
+  for (unsigned iJ = 0; iJ < size (); iJ++)
+    {
+      uQuote[iJ] = std::accumulate (rPrice.begin () + m_uFirstOption[iJ],
+                                    rPrice.begin () + m_uFirstOption[iJ + 1],
+                                    0.);
+    }
+  return uQuote;
+}
+
+std::valarray<double>
+cfl::HullWhite::Basket::price (const HullWhite::Data &rData) const
+{
+  PRECONDITION (std::abs (rData.initialTime - m_dInitialTime) < cfl::EPS);
+
+  unsigned iOptions = m_uMaturity.size ();
+  std::vector<double> uV (m_uPayTime.size ()), uVega (uV.size ());
+  std::vector<double> uY (iOptions, 0.), uPrice (iOptions);
+  for (unsigned iK = 0; iK < iOptions; iK++)
+    {
+      double dT = m_uMaturity[iK];
+      double dStd = rData.volatility (dT) * std::sqrt (dT - m_dInitialTime);
+      double dA = rData.shape (dT);
+      for (unsigned iI = m_uFirstPay[iK]; iI < m_uFirstPay[iK + 1]; iI++)
+        {
+          uV[iI] = (rData.shape (m_uPayTime[iI]) - dA) * dStd;
+        }
+    }
+  parallel (
+      iOptions,
+      [&] (unsigned iBegin, unsigned iEnd) {
+        options (uV, uY, uPrice, uVega, iBegin, iEnd);
+      },
+      c_iMinBlock);
+
+  return quotes (uPrice);
+}
+
+cfl::HullWhite::Data
+cfl::HullWhite::Basket::calibrate (double &rSigma, double &rLambda,
+                                   double dErr) const
+{
+  PRECONDITION (size () > 0);
+  PRECONDITION (rSigma > 0);
+
+  unsigned iN = size ();
+  unsigned iOptions = m_uMaturity.size ();
+  unsigned iPays = m_uPayTime.size ();
+  std::vector<double> uV (iPays), uDV (iPays), uVega (iPays);
+  std::vector<double> uY (iOptions, 0.), uPrice (iOptions);
+  std::valarray<double> uSW (std::sqrt (std::valarray<double> (
+      m_uWeight.data (), m_uWeight.size ())));
+  std::valarray<double> uRes (iN), uJS (iN), uJL (iN);
+
+  // the residuals and the Jacobian for the parameters (log sigma,
+  // lambda); returns chi2
+  auto uAssign = [&] (const std::vector<double> &rTheta) {
+    double dSigma = std::exp (rTheta[0]);
+    double dLambda = rTheta[1];
+    double dE, dDE;
+    for (unsigned iK = 0; iK < iOptions; iK++)
+      {
+        // the variance Q(T) of the state process and the derivative
+        // of log Q in lambda
+        double dTau = m_uMaturity[iK] - m_dInitialTime;
+        expRatio (2. * dLambda * dTau, dE, dDE);
+        double dStd = dSigma * std::sqrt (dTau * dE);
+        double dDLogStd = dTau * dDE / dE;
+        double dDecay = std::exp (-dLambda * dTau);
+        for (unsigned iI = m_uFirstPay[iK]; iI < m_uFirstPay[iK + 1]; iI++)
+          {
+            // A(S) - A(T) = exp(-lambda tau) (S - T) E(-lambda (S - T))
+            double dS = m_uPayTime[iI] - m_uMaturity[iK];
+            expRatio (-dLambda * dS, dE, dDE);
+            uV[iI] = dDecay * dS * dE * dStd;
+            uDV[iI] = uV[iI] * (dDLogStd - dTau - dS * dDE / dE);
+          }
+      }
+    parallel (
+        iOptions,
+        [&] (unsigned iBegin, unsigned iEnd) {
+          options (uV, uY, uPrice, uVega, iBegin, iEnd);
+        },
+        c_iMinBlock);
+    for (unsigned iJ = 0; iJ < iN; iJ++)
+      {
+        double dP = 0., dJS = 0., dJL = 0.;
+        for (unsigned iK = m_uFirstOption[iJ]; iK < m_uFirstOption[iJ + 1];
+             iK++)
+          {
+            dP += uPrice[iK];
+            for (unsigned iI = m_uFirstPay[iK]; iI < m_uFirstPay[iK + 1];
+                 iI++)
+              {
+                dJS += uVega[iI] * uV[iI];
+                dJL += uVega[iI] * uDV[iI];
+              }
+          }
+        uRes[iJ] = uSW[iJ] * (dP - m_uQuote[iJ]);
+        uJS[iJ] = uSW[iJ] * dJS;
+        uJL[iJ] = uSW[iJ] * dJL;
+      }
+    return (uRes * uRes).sum ();
+  };
+
+  std::vector<double> uTheta = { std::log (rSigma), rLambda };
+  Levenberg (dErr, cfl::EPS)
+      .minimize (uAssign, normal (uRes, uJS, uJL), uTheta);
+
+  rSigma = std::exp (uTheta[0]);
+  rLambda = uTheta[1];
+  return makeData (m_uDiscount, rSigma, rLambda, m_dInitialTime);
+}
+
+cfl::HullWhite::Data
+cfl::HullWhite::Basket::bootstrap (double dLambda, double dErr) const
+{
+  PRECONDITION (size () > 0);
+  PRECONDITION (m_uMaturity.size () == size ());
+
+  unsigned iN = size ();
+
+  // the volatilities of the payments per unit of standard deviation
+  // of the state process
+  Data uUnit = makeData (m_uDiscount, 1., dLambda, m_dInitialTime);
+  std::vector<double> uB (m_uPayTime.size ());
+  for (unsigned iK = 0; iK < iN; iK++)
+    {
+      PRECONDITION (m_uMaturity[iK] > m_dInitialTime);
+
+      double dA = uUnit.shape (m_uMaturity[iK]);
+      for (unsigned iI = m_uFirstPay[iK]; iI < m_uFirstPay[iK + 1]; iI++)
+        {
+          uB[iI] = uUnit.shape (m_uPayTime[iI]) - dA;
+        }
+    }
+
+  // the standard deviations of the state process at the maturities
+  std::vector<double> uV (uB.size ()), uVega (uB.size ());
+  std::vector<double> uY (iN, 0.), uPrice (iN);
+  auto uError = [&] (unsigned iK, double dStd) {
+    unsigned iP = m_uFirstPay[iK], iEndP = m_uFirstPay[iK + 1];
+    for (unsigned iI = iP; iI < iEndP; iI++)
+      {
+        uV[iI] = uB[iI] * dStd;
+      }
+    options (uV, uY, uPrice, uVega, iK, iK + 1);
+    return std::pair<double, double> (
+        m_uWeight[iK] * (uPrice[iK] - m_uQuote[iK]),
+        m_uWeight[iK]
+            * std::inner_product (&uVega[iP], &uVega[0] + iEndP, &uB[iP],
+                                  0.));
+  };
+  std::vector<double> uTau;
+  std::vector<double> uStd = cflCalibration::bootstrap (
+      m_uMaturity, m_dInitialTime, dErr, uError, uTau);
+  unsigned iGroups = uTau.size ();
+
+  // the short-term volatilities from the increments of the variance
+  // of the state process
+  std::vector<double> uQ (iGroups), uVar (iGroups);
+  double dTau0 = 0., dQ0 = 0., dE, dDE;
+  for (unsigned iG = 0; iG < iGroups; iG++)
+    {
+      uQ[iG] = uStd[iG] * uStd[iG];
+      if (uQ[iG] < dQ0 * (1. - cfl::EPS))
+        {
+          throw (NError::range ("decreasing variance of the state process"));
+        }
+      expRatio (2. * dLambda * (uTau[iG] - dTau0), dE, dDE);
+      uVar[iG] = std::max (uQ[iG] - dQ0, 0.)
+                 / (std::exp (2. * dLambda * dTau0) * (uTau[iG] - dTau0) * dE);
+      dTau0 = uTau[iG];
+      dQ0 = uQ[iG];
+    }
+
+  double dInitialTime = m_dInitialTime;
+  std::function<double (double)> uVol = [uTau, uQ, uVar, dLambda,
+                                         dInitialTime] (double dT) {
+    PRECONDITION (dT >= dInitialTime);
+
+    double dTau = dT - dInitialTime;
+    if (dTau <= 0.)
+      {
+        return std::sqrt (uVar.front ());
+      }
+    unsigned iG = std::lower_bound (uTau.begin (), uTau.end (), dTau)
+                  - uTau.begin ();
+    double dQ = (iG > 0) ? uQ[iG - 1] : 0.;
+    double dTau0 = (iG > 0) ? uTau[iG - 1] : 0.;
+    double dVar = uVar[std::min<unsigned> (iG, uVar.size () - 1)];
+    double dE, dDE;
+    expRatio (2. * dLambda * (dTau - dTau0), dE, dDE);
+    dQ += dVar * std::exp (2. * dLambda * dTau0) * (dTau - dTau0) * dE;
+    return std::sqrt (dQ / dTau);
+  };
+
+  return makeData (m_uDiscount, Function (uVol, dInitialTime), uUnit.shape,
+                   dInitialTime);
+}
+
+// class Black::Basket
+
+cfl::Black::Basket::Basket (const Function &rDiscount,
+                            const Function &rForward, double dInitialTime)
+    : m_uDiscount (rDiscount), m_uForward (rForward),
+      m_dInitialTime (dInitialTime)
+{
+}
+
+void
+cfl::Black::Basket::addOption (double dStrike, double dMaturity, bool bCall,
+                               double dPrice, double dWeight)
+{
+  PRECONDITION (dStrike > 0);
+  PRECONDITION (dMaturity >= m_dInitialTime);
+  PRECONDITION (dWeight > 0);
+
+  m_uMaturity.push_back (dMaturity);
+  m_uDiscountT.push_back (m_uDiscount (dMaturity));
+  m_uForwardT.push_back (m_uForward (dMaturity));
+  m_uStrike.push_back (dStrike);
+  m_uCall.push_back (bCall);
+  m_uQuote.push_back (dPrice);
+  m_uWeight.push_back (dWeight);
+}
+
+void
+cfl::Black::Basket::options (const std::vector<double> &rV,
+                             std::vector<double> &rPrice,
+                             std::vector<double> &rVega, unsigned iBegin,
+                             unsigned iEnd) const
+{
+  for (unsigned iK = iBegin; iK < iEnd; iK++)
+    {
+      double dF = m_uForwardT[iK];
+      double dK = m_uStrike[iK];
+      // the derivative in the total variance from the one in the
+      // standard deviation
+      double dStd = std::sqrt (rV[iK]);
+      double dPrice = NAnalytic::black (dF, dK, dStd, rVega[iK]);
+      rVega[iK] = (dStd > 0) ? 0.5 * rVega[iK] / dStd : 0.;
+      if (!m_uCall[iK])
+        {
+          dPrice -= dF - dK;
+        }
+      rPrice[iK] = m_uDiscountT[iK] * dPrice;
+      rVega[iK] *= m_uDiscountT[iK];
+    }
+}
+
+std::valarray<double>
+cfl::Black::Basket::price (const Black::Data &rData) const
+{
+  PRECONDITION (std::abs (rData.initialTime - m_dInitialTime) < cfl::EPS);
+
+  unsigned iN = size ();
+  std::vector<double> uV (iN), uPrice (iN), uVega (iN);
+  for (unsigned iK = 0; iK < iN; iK++)
+    {
+      double dT = m_uMaturity[iK];
+      double dVol = rData.shape (dT) * rData.volatility (dT);
+      uV[iK] = dVol * dVol * (dT - m_dInitialTime);
+    }
+  parallel (
+      iN,
+      [&] (unsigned iBegin, unsigned iEnd) {
+        options (uV, uPrice, uVega, iBegin, iEnd);
+      },
+      c_iMinBlock);
+
+  return std::valarray<double> (uPrice.data (), iN);
+}
+
+cfl::Black::Data
+cfl::Black::Basket::calibrate (double &rKappa, double &rLambda,
+                               double dErr) const
+{
+  PRECONDITION (size () > 0);
+  PRECONDITION (rKappa > 0);
+
+  unsigned iN = size ();
+  std::vector<double> uV (iN), uDV (iN), uPrice (iN), uVega (iN);
+  std::valarray<double> uSW (std::sqrt (std::valarray<double> (
+      m_uWeight.data (), m_uWeight.size ())));
+  std::valarray<double> uRes (iN), uJK (iN), uJL (iN);
+
+  // the residuals and the Jacobian for the parameters (log kappa,
+  // lambda); returns chi2
+  auto uAssign = [&] (const std::vector<double> &rTheta) {
+    double dKappa2 = std::exp (2. * rTheta[0]);
+    double dLambda = rTheta[1];
+    parallel (
+        iN,
+        [&] (unsigned iBegin, unsigned iEnd) {
+          double dE, dDE;
+          for (unsigned iK = iBegin; iK < iEnd; iK++)
+            {
+              // V = kappa^2 tau E(-2 lambda tau)
+              double dTau = m_uMaturity[iK] - m_dInitialTime;
+              expRatio (-2. * dLambda * dTau, dE, dDE);
+              uV[iK] = dKappa2 * dTau * dE;
+              uDV[iK] = -2. * dKappa2 * dTau * dTau * dDE;
+            }
+          options (uV, uPrice, uVega, iBegin, iEnd);
+          for (unsigned iK = iBegin; iK < iEnd; iK++)
+            {
+              uRes[iK] = uSW[iK] * (uPrice[iK] - m_uQuote[iK]);
+              uJK[iK] = uSW[iK] * uVega[iK] * 2. * uV[iK];
+              uJL[iK] = uSW[iK] * uVega[iK] * uDV[iK];
+            }
+        },
+        c_iMinBlock);
+    return (uRes * uRes).sum ();
+  };
+
+  std::vector<double> uTheta = { std::log (rKappa), rLambda };
+  Levenberg (dErr, cfl::EPS)
+      .minimize (uAssign, normal (uRes, uJK, uJL), uTheta);
+
+  rKappa = std::exp (uTheta[0]);
+  rLambda = uTheta[1];
+  return makeData (m_uDiscount, m_uForward, rKappa, rLambda, m_dInitialTime);
+}
+
+cfl::Black::Data
+cfl::Black::Basket::bootstrap (double dErr) const
+{
+  PRECONDITION (size () > 0);
+
+  unsigned iN = size ();
+
+  // the standard deviations at the maturities
+  std::vector<double> uV (iN), uPrice (iN), uVega (iN);
+  auto uError = [&] (unsigned iK, double dStd) {
+    uV[iK] = dStd * dStd;
+    options (uV, uPrice, uVega, iK, iK + 1);
+    return std::pair<double, double> (
+        m_uWeight[iK] * (uPrice[iK] - m_uQuote[iK]),
+        m_uWeight[iK] * uVega[iK] * 2. * dStd);
+  };
+  std::vector<double> uTau;
+  std::vector<double> uStd = cflCalibration::bootstrap (
+      m_uMaturity, m_dInitialTime, dErr, uError, uTau);
+  unsigned iGroups = uTau.size ();
+
+  // the total variances and the variances per unit of time between
+  // the maturities
+  std::vector<double> uTotal (iGroups), uVar (iGroups);
+  double dTau0 = 0., dTotal0 = 0.;
+  for (unsigned iG = 0; iG < iGroups; iG++)
+    {
+      uTotal[iG] = uStd[iG] * uStd[iG];
+      if (uTotal[iG] < dTotal0 * (1. - cfl::EPS))
+        {
+          throw (NError::range ("decreasing total variance"));
+        }
+      uVar[iG] = std::max (uTotal[iG] - dTotal0, 0.) / (uTau[iG] - dTau0);
+      dTau0 = uTau[iG];
+      dTotal0 = uTotal[iG];
+    }
+
+  double dInitialTime = m_dInitialTime;
+  std::function<double (double)> uVol
+      = [uTau, uTotal, uVar, dInitialTime] (double dT) {
+          PRECONDITION (dT >= dInitialTime);
+
+          double dTau = dT - dInitialTime;
+          if (dTau <= 0.)
+            {
+              return std::sqrt (uVar.front ());
+            }
+          unsigned iG = std::lower_bound (uTau.begin (), uTau.end (), dTau)
+                        - uTau.begin ();
+          double dTotal = (iG > 0) ? uTotal[iG - 1] : 0.;
+          double dTau0 = (iG > 0) ? uTau[iG - 1] : 0.;
+          dTotal += uVar[std::min<unsigned> (iG, uVar.size () - 1)]
+                    * (dTau - dTau0);
+          return std::sqrt (dTotal / dTau);
+        };
+
+  return makeData (m_uDiscount, m_uForward, Function (uVol, dInitialTime),
+                   dInitialTime);
+}
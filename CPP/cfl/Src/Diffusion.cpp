@@ -0,0 +1,506 @@
+#include "cfl/Diffusion.hpp"
+#include "cfl/Grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace cfl;
+
+namespace cflDiffusion
+{
+// the factorization of the tridiagonal matrix with the
+// subdiagonal a, the diagonal b, and the superdiagonal c by the
+// Thomas algorithm
+class Factor
+{
+public:
+  void
+  assign (const std::valarray<double> &rA, const std::valarray<double> &rB,
+          const std::valarray<double> &rC)
+  {
+    unsigned iSize = rB.size ();
+    m_uL.resize (iSize);
+    m_uInvD.resize (iSize);
+    m_uC = rC;
+    m_uL[0] = 0.;
+    m_uInvD[0] = 1. / rB[0];
+    for (unsigned iI = 1; iI < iSize; iI++)
+      {
+        m_uL[iI] = rA[iI] * m_uInvD[iI - 1];
+        double dD = rB[iI] - m_uL[iI] * rC[iI - 1];
+
+        ASSERT (std::abs (dD) > cfl::EPS);
+
+        m_uInvD[iI] = 1. / dD;
+      }
+  }
+
+  // solves the system in place
+  void
+  solve (double *pValues) const
+  {
+    unsigned iSize = m_uInvD.size ();
+    for (unsigned iI = 1; iI < iSize; iI++)
+      {
+        pValues[iI] -= m_uL[iI] * pValues[iI - 1];
+      }
+    pValues[iSize - 1] *= m_uInvD[iSize - 1];
+    for (unsigned iI = iSize - 1; iI > 0; iI--)
+      {
+        pValues[iI - 1]
+            = (pValues[iI - 1] - m_uC[iI - 1] * pValues[iI]) * m_uInvD[iI - 1];
+      }
+  }
+
+private:
+  std::valarray<double> m_uL, m_uInvD, m_uC;
+};
+
+// one time step of the theta scheme: the tridiagonal matrix of dt
+// times the generator and the factors of the implicit part of the
+// step and of the implicit half-step
+class Step
+{
+public:
+  void assign (const std::valarray<double> &rDrift,
+               const std::valarray<double> &rVolatility,
+               const std::valarray<double> &rRate, double dH, double dT,
+               double dTheta);
+
+  // values += dFactor * L * values, uses pBuffer as scratch
+  void
+  explicitStep (double *pValues, double dFactor, double *pBuffer) const
+  {
+    unsigned iSize = m_uB.size ();
+    pBuffer[0] = m_uB[0] * pValues[0] + m_uC[0] * pValues[1];
+    for (unsigned iI = 1; iI + 1 < iSize; iI++)
+      {
+        pBuffer[iI] = m_uA[iI] * pValues[iI - 1] + m_uB[iI] * pValues[iI]
+                      + m_uC[iI] * pValues[iI + 1];
+      }
+    pBuffer[iSize - 1] = m_uA[iSize - 1] * pValues[iSize - 2]
+                         + m_uB[iSize - 1] * pValues[iSize - 1];
+    for (unsigned iI = 0; iI < iSize; iI++)
+      {
+        pValues[iI] += dFactor * pBuffer[iI];
+      }
+  }
+
+  std::valarray<double> m_uA, m_uB, m_uC;
+  Factor m_uTheta, m_uHalf;
+};
+
+void
+Step::assign (const std::valarray<double> &rDrift,
+              const std::valarray<double> &rVolatility,
+              const std::valarray<double> &rRate, double dH, double dT,
+              double dTheta)
+{
+  unsigned iSize = rDrift.size ();
+
+  PRECONDITION ((rVolatility.size () == iSize) && (rRate.size () == iSize));
+  PRECONDITION (iSize >= 3);
+
+  m_uA.resize (iSize);
+  m_uB.resize (iSize);
+  m_uC.resize (iSize);
+  for (unsigned iI = 0; iI < iSize; iI++)
+    {
+      double dR = rRate[iI];
+      if ((iI == 0) || (iI + 1 == iSize))
+        {
+          // at the boundaries the values are only discounted
+          m_uA[iI] = m_uC[iI] = 0.;
+          m_uB[iI] = -dT * dR;
+          continue;
+        }
+      double dDiff = 0.5 * rVolatility[iI] * rVolatility[iI] / (dH * dH);
+      double dConv = 0.5 * rDrift[iI] / dH;
+      m_uA[iI] = dT * (dDiff - dConv);
+      m_uB[iI] = -dT * (2. * dDiff + dR);
+      m_uC[iI] = dT * (dDiff + dConv);
+    }
+
+  m_uTheta.assign (-dTheta * m_uA, 1. - dTheta * m_uB, -dTheta * m_uC);
+  m_uHalf.assign (-0.5 * m_uA, 1. - 0.5 * m_uB, -0.5 * m_uC);
+}
+
+// the backward operator between two event times: the time steps with
+// the coefficients evaluated at their middles; a discount rate that
+// does not depend on the state is applied exactly after the steps
+struct Operator
+{
+  std::vector<Step> uSteps;
+  double dTheta, dDiscount;
+  bool bState;
+};
+
+// the operator is computed once on the first request
+struct Cache
+{
+  std::once_flag uFlag;
+  Operator uOperator;
+};
+
+class Model : public cfl::IModel
+{
+public:
+  Model (double dH, const std::function<double (double)> &rWidth,
+         double dTimeQuality, double dTheta, unsigned iImplicitSteps,
+         const Ind &rInd, const Interp &rInterp, const TCoefficient &rDrift,
+         const TCoefficient &rVolatility, const TCoefficient &rRate,
+         const std::vector<double> &rVar,
+         const std::vector<double> &rEventTimes, double dInterval);
+
+  const std::vector<double> &
+  eventTimes () const
+  {
+    return m_uEventTimes;
+  }
+
+  unsigned
+  numberOfStates () const
+  {
+    return 1;
+  }
+
+  unsigned
+  numberOfNodes (unsigned iTime,
+                 const std::vector<unsigned> &rDependence) const
+  {
+    PRECONDITION (rDependence.size () <= 1);
+
+    return (rDependence.size () == 0) ? 1 : m_uSize[iTime];
+  }
+
+  std::valarray<double>
+  origin () const
+  {
+    return std::valarray<double> (0., 1);
+  }
+
+  Slice state (unsigned iTime, unsigned iState) const;
+
+  void addDependence (Slice &rSlice,
+                      const std::vector<unsigned> &rDependence) const;
+
+  void rollback (Slice &rSlice, unsigned iTime) const;
+
+  void
+  indicator (Slice &rSlice, double dBarrier) const
+  {
+    m_uInd.indicator (rSlice.values (), dBarrier);
+  }
+
+  MultiFunction interpolate (const Slice &rSlice) const;
+
+private:
+  std::valarray<double> grid (unsigned iTime) const;
+
+  // the steps of the rollback over the interval on the window of the
+  // grid that starts at pValues; pBuffer is the scratch space
+  void rollback (const Operator &rOp, double *pValues, double *pBuffer,
+                 unsigned &rImplicit) const;
+
+  // the operator between the event times iTime and iTime + 1
+  const Operator &op (unsigned iTime) const;
+
+  double m_dH, m_dTimeQuality, m_dTheta;
+  unsigned m_iImplicitSteps;
+  Ind m_uInd;
+  Interp m_uInterp;
+  TCoefficient m_uDrift, m_uVolatility, m_uRate;
+  std::vector<double> m_uEventTimes;
+  std::vector<unsigned> m_uSize;
+  std::unique_ptr<Cache[]> m_pCache;
+};
+} // namespace cflDiffusion
+
+using namespace cflDiffusion;
+
+// CLASS cflDiffusion::Model
+
+cflDiffusion::Model::Model (
+    double dH, const std::function<double (double)> &rWidth,
+    double dTimeQuality, double dTheta, unsigned iImplicitSteps,
+    const Ind &rInd, const Interp &rInterp, const TCoefficient &rDrift,
+    const TCoefficient &rVolatility, const TCoefficient &rRate,
+    const std::vector<double> &rVar, const std::vector<double> &rEventTimes,
+    double dInterval)
+    : m_dH (dH), m_dTimeQuality (dTimeQuality), m_dTheta (dTheta),
+      m_iImplicitSteps (iImplicitSteps), m_uInd (rInd), m_uInterp (rInterp),
+      m_uDrift (rDrift), m_uVolatility (rVolatility), m_uRate (rRate),
+      m_uEventTimes (rEventTimes), m_uSize (rEventTimes.size ()),
+      m_pCache (new Cache[rEventTimes.size ()])
+{
+  PRECONDITION (rEventTimes.size () == rVar.size ());
+  PRECONDITION (std::equal (m_uEventTimes.begin () + 1, m_uEventTimes.end (),
+                            m_uEventTimes.begin (), std::greater<double> ()));
+  PRECONDITION ((dTheta >= 0.5) && (dTheta <= 1.));
+  PRECONDITION (dH > 0);
+
+  // the grid has 2m + 1 nodes
+  double dToday = rEventTimes.front ();
+  for (unsigned iI = 0; iI < m_uSize.size (); iI++)
+    {
+      double dTotalVar = rVar[iI] * (rEventTimes[iI] - dToday);
+      double dHalf = 0.5 * (dInterval + rWidth (dTotalVar));
+      unsigned iHalf = std::max (std::ceil (dHalf / dH), 1.);
+      m_uSize[iI] = 2 * iHalf + 1;
+    }
+
+  POSTCONDITION (std::equal (m_uSize.begin () + 1, m_uSize.end (),
+                             m_uSize.begin (),
+                             std::greater_equal<unsigned> ()));
+}
+
+std::valarray<double>
+cflDiffusion::Model::grid (unsigned iTime) const
+{
+  unsigned iSize = m_uSize[iTime];
+  std::valarray<double> uX (iSize);
+  double dX = -m_dH * (iSize - 1) / 2.;
+  for (double &rX : uX)
+    {
+      rX = dX;
+      dX += m_dH;
+    }
+  return uX;
+}
+
+const Operator &
+cflDiffusion::Model::op (unsigned iTime) const
+{
+  PRECONDITION (iTime + 1 < m_uEventTimes.size ());
+
+  Cache &rCache = m_pCache[iTime];
+  std::call_once (rCache.uFlag, [this, iTime, &rCache] () {
+    double dInterval = m_uEventTimes[iTime + 1] - m_uEventTimes[iTime];
+    unsigned iSteps
+        = std::max (std::ceil (dInterval * m_dTimeQuality - cfl::EPS), 1.);
+    double dT = dInterval / iSteps;
+    std::valarray<double> uX = grid (iTime + 1);
+
+    std::vector<std::valarray<double> > uRate (iSteps);
+    Operator &rOp = rCache.uOperator;
+    rOp.dTheta = m_dTheta;
+    rOp.bState = false;
+    for (unsigned iI = 0; iI < iSteps; iI++)
+      {
+        uRate[iI] = m_uRate (m_uEventTimes[iTime] + (iI + 0.5) * dT, uX);
+        rOp.bState = rOp.bState
+                     || (uRate[iI].max () - uRate[iI].min () > cfl::EPS);
+      }
+
+    // the discount rate is applied exactly if it is constant on the
+    // grid at all steps
+    double dLogDiscount = 0.;
+    std::valarray<double> uZero (0., uX.size ());
+    rOp.uSteps.resize (iSteps);
+    for (unsigned iI = 0; iI < iSteps; iI++)
+      {
+        double dTime = m_uEventTimes[iTime] + (iI + 0.5) * dT;
+        dLogDiscount -= uRate[iI][0] * dT;
+        rOp.uSteps[iI].assign (m_uDrift (dTime, uX),
+                               m_uVolatility (dTime, uX),
+                               rOp.bState ? uRate[iI] : uZero, m_dH, dT,
+                               m_dTheta);
+      }
+    rOp.dDiscount = rOp.bState ? 1. : std::exp (dLogDiscount);
+  });
+  return rCache.uOperator;
+}
+
+Slice
+cflDiffusion::Model::state (unsigned iTime, unsigned iState) const
+{
+  PRECONDITION (iState == 0);
+
+  return Slice (*this, iTime, std::vector<unsigned> (1, 0), grid (iTime));
+}
+
+void
+cflDiffusion::Model::addDependence (
+    Slice &rSlice, const std::vector<unsigned> &rDependence) const
+{
+  PRECONDITION (rDependence.size () <= 1);
+
+  if ((rSlice.dependence ().size () == 0) && (rDependence.size () == 1))
+    {
+      ASSERT (rSlice.values ().size () == 1);
+
+      std::valarray<double> uValues (rSlice.values ()[0],
+                                     m_uSize[rSlice.timeIndex ()]);
+      rSlice.assign (rDependence, uValues);
+    }
+}
+
+void
+cflDiffusion::Model::rollback (const Operator &rOp, double *pValues,
+                               double *pBuffer, unsigned &rImplicit) const
+{
+  // the steps go backward in time
+  for (auto pStep = rOp.uSteps.rbegin (); pStep != rOp.uSteps.rend ();
+       ++pStep)
+    {
+      if (rImplicit > 0)
+        {
+          pStep->m_uHalf.solve (pValues);
+          pStep->m_uHalf.solve (pValues);
+          rImplicit--;
+        }
+      else
+        {
+          if (rOp.dTheta < 1.)
+            {
+              pStep->explicitStep (pValues, 1. - rOp.dTheta, pBuffer);
+            }
+          pStep->m_uTheta.solve (pValues);
+        }
+    }
+  if (rOp.dDiscount != 1.)
+    {
+      unsigned iSize = rOp.uSteps.front ().m_uB.size ();
+      for (unsigned iI = 0; iI < iSize; iI++)
+        {
+          pValues[iI] *= rOp.dDiscount;
+        }
+    }
+}
+
+void
+cflDiffusion::Model::rollback (Slice &rSlice, unsigned iTime) const
+{
+  PRECONDITION (&rSlice.model () == this);
+  PRECONDITION (rSlice.timeIndex () > iTime);
+
+  unsigned iFrom = rSlice.timeIndex ();
+
+  // a constant remains constant if the discount rate does not depend
+  // on the state
+  if (rSlice.dependence ().size () == 0)
+    {
+      double dDiscount = 1.;
+      for (unsigned iI = iTime; (iI < iFrom) && (dDiscount > 0); iI++)
+        {
+          dDiscount = op (iI).bState ? 0. : dDiscount * op (iI).dDiscount;
+        }
+      if (dDiscount > 0)
+        {
+          rSlice.values () *= dDiscount;
+          rSlice.assign (iTime, rSlice.dependence (), rSlice.values ());
+          return;
+        }
+      addDependence (rSlice, std::vector<unsigned> (1, 0));
+    }
+
+  // the values are rolled back in place; the window of the grid moves
+  // to the center when the grid shrinks; the scratch space belongs to
+  // the call, so that slices can be rolled back in parallel
+  std::valarray<double> &rValues = rSlice.values ();
+  std::valarray<double> uBuffer (rValues.size ());
+  unsigned iFirst = 0;
+  unsigned iImplicit = m_iImplicitSteps;
+  for (unsigned iI = iFrom; iI > iTime; iI--)
+    {
+      ASSERT (iFirst + m_uSize[iI] <= rValues.size ());
+
+      rollback (op (iI - 1), &rValues[iFirst], &uBuffer[0], iImplicit);
+      iFirst += (m_uSize[iI] - m_uSize[iI - 1]) / 2;
+    }
+
+  unsigned iSize = m_uSize[iTime];
+  if (iSize < rValues.size ())
+    {
+      std::valarray<double> uValues (rValues[std::slice (iFirst, iSize, 1)]);
+      rSlice.assign (iTime, rSlice.dependence (), uValues);
+    }
+  else
+    {
+      rSlice.assign (iTime, rSlice.dependence (), rValues);
+    }
+}
+
+MultiFunction
+cflDiffusion::Model::interpolate (const Slice &rSlice) const
+{
+  unsigned iTime = rSlice.timeIndex ();
+  std::valarray<double> uState = grid (iTime);
+  const std::valarray<double> &rValues = rSlice.values ();
+  unsigned iSize = rValues.size ();
+
+  ASSERT ((uState.size () == iSize) && (iSize >= 3));
+
+  // delta and gamma are the differences on the whole grid, one-sided
+  // for delta at the ends
+  std::vector<std::valarray<double> > uVal (3, std::valarray<double> (iSize));
+  uVal[0] = rValues;
+  uVal[1][0] = (rValues[1] - rValues[0]) / m_dH;
+  uVal[1][iSize - 1] = (rValues[iSize - 1] - rValues[iSize - 2]) / m_dH;
+  for (unsigned iI = 1; iI + 1 < iSize; iI++)
+    {
+      uVal[1][iI] = 0.5 * (rValues[iI + 1] - rValues[iI - 1]) / m_dH;
+      uVal[2][iI] = (rValues[iI + 1] - 2. * rValues[iI] + rValues[iI - 1])
+                    / (m_dH * m_dH);
+    }
+  uVal[2][0] = uVal[2][1];
+  uVal[2][iSize - 1] = uVal[2][iSize - 2];
+
+  std::vector<Function> uF;
+  for (const std::valarray<double> &rV : uVal)
+    {
+      Interp uInterp (m_uInterp);
+      uInterp.assign (std::begin (uState), std::end (uState), std::begin (rV));
+      uF.push_back (uInterp.interp ());
+    }
+
+  std::function<std::valarray<double> (const std::valarray<double> &,
+                                       const std::valarray<size_t> &)>
+      uFF = [uF] (const std::valarray<double> &rX,
+                  const std::valarray<size_t> &rI) {
+        PRECONDITION (rX.size () == 1);
+
+        std::valarray<double> uY (rI.size ());
+        for (unsigned iI = 0; iI < rI.size (); iI++)
+          {
+            PRECONDITION (rI[iI] < 3);
+
+            uY[iI] = uF[rI[iI]](rX[0]);
+          }
+        return uY;
+      };
+  std::function<std::valarray<double> (const std::valarray<double> &)> uFX
+      = [uFF] (const std::valarray<double> &rX) {
+          return uFF (rX, std::valarray<size_t>{ 0, 1, 2 });
+        };
+  std::function<bool (const std::valarray<double> &)> uBelongs
+      = [uF] (const std::valarray<double> &rX) {
+          return uF.front ().belongs (rX[0]);
+        };
+
+  return MultiFunction (uFF, uFX, uBelongs, 1, 3);
+}
+
+// constructor of model for diffusion
+
+cfl::TDiffusion
+cfl::diffusion (double dStepQuality, double dWidthQuality,
+                double dTimeQuality, double dTheta, unsigned iImplicitSteps,
+                const Ind &rInd, const Interp &rInterp)
+{
+  PRECONDITION ((dStepQuality > 0) && (dTimeQuality > 0));
+
+  double dH = 1. / dStepQuality;
+  std::function<double (double)> uWidth = Grid::widthGauss (dWidthQuality);
+
+  return [dH, uWidth, dTimeQuality, dTheta, iImplicitSteps, rInd, rInterp] (
+             const TCoefficient &rDrift, const TCoefficient &rVolatility,
+             const TCoefficient &rRate, const std::vector<double> &rVar,
+             const std::vector<double> &rEventTimes, double dInterval) {
+    return cfl::Model (new cflDiffusion::Model (
+        dH, uWidth, dTimeQuality, dTheta, iImplicitSteps, rInd, rInterp,
+        rDrift, rVolatility, rRate, rVar, rEventTimes, dInterval));
+  };
+}
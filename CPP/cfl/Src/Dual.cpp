@@ -0,0 +1,499 @@
+#include "cfl/Dual.hpp"
+#include "cfl/Error.hpp"
+#include <cmath>
+
+using namespace cfl;
+using namespace std;
+
+namespace cflDual
+{
+// an object without tangents is a constant: we add zero tangents
+void
+align (valarray<double> &rX, const valarray<double> &rY)
+{
+  PRECONDITION ((rX.size () == rY.size ()) || (rX.size () == 0)
+                || (rY.size () == 0));
+
+  if (rX.size () < rY.size ())
+    {
+      rX.resize (rY.size (), 0.);
+    }
+}
+
+void
+align (vector<Function> &rX, const vector<Function> &rY)
+{
+  PRECONDITION ((rX.size () == rY.size ()) || (rX.size () == 0)
+                || (rY.size () == 0));
+
+  if (rX.size () < rY.size ())
+    {
+      rX.resize (rY.size (), Function (0.));
+    }
+}
+
+void
+align (const Slice &rValue, vector<Slice> &rX, const vector<Slice> &rY)
+{
+  PRECONDITION ((rX.size () == rY.size ()) || (rX.size () == 0)
+                || (rY.size () == 0));
+
+  if (rX.size () < rY.size ())
+    {
+      rX.resize (rY.size (), Slice (&rValue.model (), rValue.timeIndex (), 0.));
+    }
+}
+
+// the sharp indicator of the event rSlice > dBarrier
+Slice
+step (const Slice &rSlice, double dBarrier)
+{
+  Slice uStep (rSlice);
+  transform (begin (rSlice.values ()), end (rSlice.values ()),
+             begin (uStep.values ()),
+             [dBarrier] (double dX) { return (dX > dBarrier) ? 1. : 0.; });
+  return uStep;
+}
+
+double
+maxAbs (const Slice &rSlice)
+{
+  return abs (rSlice.values ()).max ();
+}
+} // namespace cflDual
+
+using namespace cflDual;
+
+// class Dual
+
+cfl::Dual::Dual (double dValue, unsigned iParameters)
+    : m_dValue (dValue), m_uTangent (0., iParameters)
+{
+}
+
+cfl::Dual::Dual (double dValue, const valarray<double> &rTangent)
+    : m_dValue (dValue), m_uTangent (rTangent)
+{
+}
+
+cfl::Dual::Dual (double dValue, unsigned iParameters, unsigned iParameter)
+    : m_dValue (dValue), m_uTangent (0., iParameters)
+{
+  PRECONDITION (iParameter < iParameters);
+
+  m_uTangent[iParameter] = 1.;
+}
+
+Dual &
+cfl::Dual::operator+= (const Dual &rDual)
+{
+  align (m_uTangent, rDual.m_uTangent);
+  if (rDual.m_uTangent.size () > 0)
+    {
+      m_uTangent += rDual.m_uTangent;
+    }
+  m_dValue += rDual.m_dValue;
+
+  return *this;
+}
+
+Dual &
+cfl::Dual::operator-= (const Dual &rDual)
+{
+  align (m_uTangent, rDual.m_uTangent);
+  if (rDual.m_uTangent.size () > 0)
+    {
+      m_uTangent -= rDual.m_uTangent;
+    }
+  m_dValue -= rDual.m_dValue;
+
+  return *this;
+}
+
+Dual &
+cfl::Dual::operator*= (const Dual &rDual)
+{
+  align (m_uTangent, rDual.m_uTangent);
+  m_uTangent *= rDual.m_dValue;
+  if (rDual.m_uTangent.size () > 0)
+    {
+      m_uTangent += m_dValue * rDual.m_uTangent;
+    }
+  m_dValue *= rDual.m_dValue;
+
+  return *this;
+}
+
+Dual &
+cfl::Dual::operator/= (const Dual &rDual)
+{
+  align (m_uTangent, rDual.m_uTangent);
+  m_dValue /= rDual.m_dValue;
+  if (rDual.m_uTangent.size () > 0)
+    {
+      m_uTangent -= m_dValue * rDual.m_uTangent;
+    }
+  m_uTangent /= rDual.m_dValue;
+
+  return *this;
+}
+
+Dual
+cfl::exp (const Dual &rX)
+{
+  double dV = std::exp (rX.value ());
+  return Dual (dV, rX.tangent () * dV);
+}
+
+Dual
+cfl::log (const Dual &rX)
+{
+  return Dual (std::log (rX.value ()), rX.tangent () / rX.value ());
+}
+
+Dual
+cfl::pow (const Dual &rX, double dPower)
+{
+  return Dual (std::pow (rX.value (), dPower),
+               rX.tangent () * (dPower * std::pow (rX.value (), dPower - 1.)));
+}
+
+// class DualFunction
+
+cfl::DualFunction::DualFunction (const Function &rValue) : m_uValue (rValue) {}
+
+cfl::DualFunction::DualFunction (const Function &rValue,
+                                 const vector<Function> &rTangent)
+    : m_uValue (rValue), m_uTangent (rTangent)
+{
+}
+
+Dual
+cfl::DualFunction::operator() (double dX) const
+{
+  valarray<double> uTangent (m_uTangent.size ());
+  transform (m_uTangent.begin (), m_uTangent.end (), begin (uTangent),
+             [dX] (const Function &rF) { return rF (dX); });
+
+  return Dual (m_uValue (dX), uTangent);
+}
+
+DualFunction &
+cfl::DualFunction::operator+= (const DualFunction &rF)
+{
+  align (m_uTangent, rF.m_uTangent);
+  for (unsigned iI = 0; iI < rF.m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] += rF.m_uTangent[iI];
+    }
+  m_uValue += rF.m_uValue;
+
+  return *this;
+}
+
+DualFunction &
+cfl::DualFunction::operator-= (const DualFunction &rF)
+{
+  align (m_uTangent, rF.m_uTangent);
+  for (unsigned iI = 0; iI < rF.m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] -= rF.m_uTangent[iI];
+    }
+  m_uValue -= rF.m_uValue;
+
+  return *this;
+}
+
+DualFunction &
+cfl::DualFunction::operator*= (const DualFunction &rF)
+{
+  align (m_uTangent, rF.m_uTangent);
+  for (unsigned iI = 0; iI < m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] *= rF.m_uValue;
+      if (rF.m_uTangent.size () > 0)
+        {
+          m_uTangent[iI] += m_uValue * rF.m_uTangent[iI];
+        }
+    }
+  m_uValue *= rF.m_uValue;
+
+  return *this;
+}
+
+DualFunction &
+cfl::DualFunction::operator/= (const DualFunction &rF)
+{
+  align (m_uTangent, rF.m_uTangent);
+  m_uValue /= rF.m_uValue;
+  for (unsigned iI = 0; iI < m_uTangent.size (); iI++)
+    {
+      if (rF.m_uTangent.size () > 0)
+        {
+          m_uTangent[iI] -= m_uValue * rF.m_uTangent[iI];
+        }
+      m_uTangent[iI] /= rF.m_uValue;
+    }
+
+  return *this;
+}
+
+DualFunction
+cfl::exp (const DualFunction &rF)
+{
+  Function uValue = exp (rF.value ());
+  vector<Function> uTangent (rF.tangent ());
+  for (Function &rT : uTangent)
+    {
+      rT *= uValue;
+    }
+  return DualFunction (uValue, uTangent);
+}
+
+DualFunction
+cfl::log (const DualFunction &rF)
+{
+  vector<Function> uTangent (rF.tangent ());
+  for (Function &rT : uTangent)
+    {
+      rT /= rF.value ();
+    }
+  return DualFunction (log (rF.value ()), uTangent);
+}
+
+DualFunction
+cfl::pow (const DualFunction &rF, double dPower)
+{
+  Function uDeriv = dPower * pow (rF.value (), dPower - 1.);
+  vector<Function> uTangent (rF.tangent ());
+  for (Function &rT : uTangent)
+    {
+      rT *= uDeriv;
+    }
+  return DualFunction (pow (rF.value (), dPower), uTangent);
+}
+
+// class DualSlice
+
+cfl::DualSlice::DualSlice (const Slice &rValue) : m_uValue (rValue) {}
+
+cfl::DualSlice::DualSlice (const Slice &rValue, const vector<Slice> &rTangent)
+    : m_uValue (rValue), m_uTangent (rTangent)
+{
+  PRECONDITION (all_of (rTangent.begin (), rTangent.end (),
+                        [&rValue] (const Slice &rT) {
+                          return (&rT.model () == &rValue.model ())
+                                 && (rT.timeIndex () == rValue.timeIndex ());
+                        }));
+}
+
+cfl::DualSlice::DualSlice (const IModel &rModel, unsigned iEventTime,
+                           const Dual &rValue)
+    : m_uValue (&rModel, iEventTime, rValue.value ())
+{
+  const valarray<double> &rTangent = rValue.tangent ();
+  m_uTangent.reserve (rTangent.size ());
+  for (double dT : rTangent)
+    {
+      m_uTangent.push_back (Slice (&rModel, iEventTime, dT));
+    }
+}
+
+DualSlice &
+cfl::DualSlice::operator+= (const DualSlice &rSlice)
+{
+  align (m_uValue, m_uTangent, rSlice.m_uTangent);
+  for (unsigned iI = 0; iI < rSlice.m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] += rSlice.m_uTangent[iI];
+    }
+  m_uValue += rSlice.m_uValue;
+
+  return *this;
+}
+
+DualSlice &
+cfl::DualSlice::operator-= (const DualSlice &rSlice)
+{
+  align (m_uValue, m_uTangent, rSlice.m_uTangent);
+  for (unsigned iI = 0; iI < rSlice.m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] -= rSlice.m_uTangent[iI];
+    }
+  m_uValue -= rSlice.m_uValue;
+
+  return *this;
+}
+
+DualSlice &
+cfl::DualSlice::operator*= (const DualSlice &rSlice)
+{
+  align (m_uValue, m_uTangent, rSlice.m_uTangent);
+  for (unsigned iI = 0; iI < m_uTangent.size (); iI++)
+    {
+      m_uTangent[iI] *= rSlice.m_uValue;
+      if (rSlice.m_uTangent.size () > 0)
+        {
+          m_uTangent[iI] += m_uValue * rSlice.m_uTangent[iI];
+        }
+    }
+  m_uValue *= rSlice.m_uValue;
+
+  return *this;
+}
+
+DualSlice &
+cfl::DualSlice::operator/= (const DualSlice &rSlice)
+{
+  align (m_uValue, m_uTangent, rSlice.m_uTangent);
+  m_uValue /= rSlice.m_uValue;
+  for (unsigned iI = 0; iI < m_uTangent.size (); iI++)
+    {
+      if (rSlice.m_uTangent.size () > 0)
+        {
+          m_uTangent[iI] -= m_uValue * rSlice.m_uTangent[iI];
+        }
+      m_uTangent[iI] /= rSlice.m_uValue;
+    }
+
+  return *this;
+}
+
+void
+cfl::DualSlice::rollback (unsigned iEventTime)
+{
+  m_uValue.rollback (iEventTime);
+  for (Slice &rT : m_uTangent)
+    {
+      rT.rollback (iEventTime);
+    }
+}
+
+DualSlice
+cfl::max (const DualSlice &rSlice, double dValue)
+{
+  Slice uStep = step (rSlice.value (), dValue);
+  vector<Slice> uTangent (rSlice.tangent ());
+  for (Slice &rT : uTangent)
+    {
+      rT *= uStep;
+    }
+  return DualSlice (max (rSlice.value (), dValue), uTangent);
+}
+
+DualSlice
+cfl::max (const DualSlice &rX, const DualSlice &rY)
+{
+  Slice uStep = step (rX.value () - rY.value (), 0.);
+  DualSlice uZ (rY);
+  uZ += (rX - rY) * uStep;
+  return DualSlice (max (rX.value (), rY.value ()), uZ.tangent ());
+}
+
+DualSlice
+cfl::exp (const DualSlice &rSlice)
+{
+  Slice uValue = exp (rSlice.value ());
+  vector<Slice> uTangent (rSlice.tangent ());
+  for (Slice &rT : uTangent)
+    {
+      rT *= uValue;
+    }
+  return DualSlice (uValue, uTangent);
+}
+
+DualSlice
+cfl::log (const DualSlice &rSlice)
+{
+  vector<Slice> uTangent (rSlice.tangent ());
+  for (Slice &rT : uTangent)
+    {
+      rT /= rSlice.value ();
+    }
+  return DualSlice (log (rSlice.value ()), uTangent);
+}
+
+DualSlice
+cfl::pow (const DualSlice &rSlice, double dPower)
+{
+  Slice uDeriv = dPower * pow (rSlice.value (), dPower - 1.);
+  vector<Slice> uTangent (rSlice.tangent ());
+  for (Slice &rT : uTangent)
+    {
+      rT *= uDeriv;
+    }
+  return DualSlice (pow (rSlice.value (), dPower), uTangent);
+}
+
+DualSlice
+cfl::indicator (const DualSlice &rSlice, double dBarrier)
+{
+  const Slice &rValue = rSlice.value ();
+  vector<Slice> uTangent (rSlice.tangent ());
+  double dScale = std::max (1., maxAbs (rValue));
+  for (Slice &rT : uTangent)
+    {
+      double dT = maxAbs (rT);
+      if (dT < cfl::EPS)
+        {
+          rT = 0.;
+          continue;
+        }
+      // central difference of the smoothed indicator of the model
+      double dH = 1E-6 * dScale / dT;
+      rT = (indicator (rValue + dH * rT, dBarrier)
+            - indicator (rValue - dH * rT, dBarrier))
+           / (2. * dH);
+    }
+  return DualSlice (indicator (rValue, dBarrier), uTangent);
+}
+
+MultiFunction
+cfl::interpolate (const DualSlice &rSlice)
+{
+  unsigned iStates = rSlice.value ().model ().numberOfStates ();
+  vector<MultiFunction> uF (1, interpolate (rSlice.value (), iStates));
+  for (const Slice &rT : rSlice.tangent ())
+    {
+      uF.push_back (interpolate (rT, iStates));
+    }
+
+  std::function<valarray<double> (const valarray<double> &,
+                                  const valarray<size_t> &)>
+      uFF = [uF] (const valarray<double> &rX, const valarray<size_t> &rI) {
+        valarray<double> uY (rI.size ());
+        for (unsigned iI = 0; iI < rI.size (); iI++)
+          {
+            uY[iI] = uF[rI[iI]] (rX, valarray<size_t> (size_t (0), 1))[0];
+          }
+        return uY;
+      };
+  std::function<valarray<double> (const valarray<double> &)> uFX
+      = [uF] (const valarray<double> &rX) {
+          valarray<double> uY (uF.size ());
+          for (unsigned iI = 0; iI < uF.size (); iI++)
+            {
+              uY[iI] = uF[iI] (rX, valarray<size_t> (size_t (0), 1))[0];
+            }
+          return uY;
+        };
+  std::function<bool (const valarray<double> &)> uBelongs
+      = [uF0 = uF.front ()] (const valarray<double> &rX) {
+          return uF0.belongs (rX);
+        };
+
+  return MultiFunction (uFF, uFX, uBelongs, iStates, uF.size ());
+}
+
+valarray<double>
+cfl::atOrigin (const DualSlice &rSlice)
+{
+  valarray<double> uValue (1 + rSlice.tangent ().size ());
+  valarray<size_t> uValueIx (size_t (0), 1);
+  uValue[0] = atOrigin (rSlice.value (), uValueIx)[0];
+  for (unsigned iI = 0; iI < rSlice.tangent ().size (); iI++)
+    {
+      uValue[iI + 1] = atOrigin (rSlice.tangent ()[iI], uValueIx)[0];
+    }
+  return uValue;
+}
@@ -0,0 +1,165 @@
+#include "cfl/Exercise.hpp"
+#include "cfl/Error.hpp"
+#include <limits>
+
+using namespace cfl;
+using namespace std;
+
+// class Exercise
+
+cfl::Exercise::Exercise () : m_bReplay (false) {}
+
+Slice
+cfl::Exercise::max (const Slice &rHold, const Slice &rExercise)
+{
+  PRECONDITION (&rHold.model () == &rExercise.model ());
+  PRECONDITION (rHold.timeIndex () == rExercise.timeIndex ());
+
+  // the arguments get the same dependence on the states; the addition
+  // of zero does not change the values
+  Slice uZero = rExercise - rHold;
+  uZero.values () = 0.;
+  Slice uHold (rHold);
+  uHold += uZero;
+  Slice uExercise (rExercise);
+  uExercise += uZero;
+
+  const IModel &rModel = rHold.model ();
+  unsigned iTime = uHold.timeIndex ();
+  const vector<unsigned> &rDep = uHold.dependence ();
+  valarray<double> &rH = uHold.values ();
+  const valarray<double> &rE = uExercise.values ();
+
+  ASSERT (rH.size () == rE.size ());
+
+  valarray<double> uState;
+  if (rDep.size () == 1)
+    {
+      uState = rModel.state (iTime, rDep.front ()).values ();
+
+      ASSERT (uState.size () == rH.size ());
+    }
+
+  if (m_bReplay)
+    {
+      // the indexes of the regions refer to the recorded event times
+      PRECONDITION (m_uEventTimes == rModel.eventTimes ());
+      PRECONDITION (iTime < m_uRegion.size ());
+
+      const Region &rRegion = m_uRegion[iTime];
+
+      PRECONDITION (rRegion.iSize > 0);
+
+      if ((rDep.size () == 1) && rRegion.bState)
+        {
+          // the grid of a perturbed model may be different
+          valarray<bool> uIn = exercise (iTime, uState);
+          for (unsigned iI = 0; iI < rH.size (); iI++)
+            {
+              if (uIn[iI])
+                {
+                  rH[iI] = rE[iI];
+                }
+            }
+          return uHold;
+        }
+
+      PRECONDITION (rRegion.iSize == rH.size ());
+
+      for (const pair<unsigned, unsigned> &rNodes : rRegion.uNodes)
+        {
+          for (unsigned iI = rNodes.first; iI < rNodes.second; iI++)
+            {
+              rH[iI] = rE[iI];
+            }
+        }
+      return uHold;
+    }
+
+  if (m_uEventTimes != rModel.eventTimes ())
+    {
+      m_uEventTimes = rModel.eventTimes ();
+      m_uRegion.assign (m_uEventTimes.size (), Region ());
+    }
+
+  Region &rRegion = m_uRegion[iTime];
+  rRegion.iSize = rH.size ();
+  rRegion.bState = (rDep.size () <= 1);
+  rRegion.uNodes.clear ();
+  rRegion.uStates.clear ();
+
+  unsigned iI = 0;
+  while (iI < rH.size ())
+    {
+      if (!(rE[iI] > rH[iI]))
+        {
+          iI++;
+          continue;
+        }
+      unsigned iFirst = iI;
+      while ((iI < rH.size ()) && (rE[iI] > rH[iI]))
+        {
+          rH[iI] = rE[iI];
+          iI++;
+        }
+      rRegion.uNodes.push_back (make_pair (iFirst, iI));
+      if (rRegion.bState)
+        {
+          double dInf = numeric_limits<double>::infinity ();
+          double dLower = -dInf, dUpper = dInf;
+          if (uState.size () > 0)
+            {
+              if (iFirst > 0)
+                {
+                  dLower = 0.5 * (uState[iFirst - 1] + uState[iFirst]);
+                }
+              if (iI < uState.size ())
+                {
+                  dUpper = 0.5 * (uState[iI - 1] + uState[iI]);
+                }
+            }
+          rRegion.uStates.push_back (make_pair (dLower, dUpper));
+        }
+    }
+
+  return uHold;
+}
+
+const std::vector<std::pair<unsigned, unsigned> > &
+cfl::Exercise::nodes (unsigned iTime) const
+{
+  static const vector<pair<unsigned, unsigned> > c_uEmpty;
+
+  return (iTime < m_uRegion.size ()) ? m_uRegion[iTime].uNodes : c_uEmpty;
+}
+
+std::valarray<bool>
+cfl::Exercise::exercise (unsigned iTime,
+                         const std::valarray<double> &rState) const
+{
+  valarray<bool> uIn (false, rState.size ());
+  if ((iTime >= m_uRegion.size ()) || (m_uRegion[iTime].iSize == 0))
+    {
+      return uIn;
+    }
+
+  const Region &rRegion = m_uRegion[iTime];
+
+  if (!rRegion.bState)
+    {
+      throw (NError::range ("exercise region for several states"));
+    }
+
+  for (unsigned iI = 0; iI < rState.size (); iI++)
+    {
+      for (const pair<double, double> &rStates : rRegion.uStates)
+        {
+          if ((rState[iI] >= rStates.first) && (rState[iI] < rStates.second))
+            {
+              uIn[iI] = true;
+              break;
+            }
+        }
+    }
+  return uIn;
+}
@@ -1,11 +1,11 @@
 #include "cfl/Fit.hpp"
 #include "cfl/Error.hpp"
+#include "cfl/LeastSquares.hpp"
+#include "cfl/Parallel.hpp"
 #include <algorithm>
 #include <cmath>
-#include <gsl/gsl_blas.h>
-#include <gsl/gsl_bspline.h>
-#include <gsl/gsl_fit.h>
-#include <gsl/gsl_multifit.h>
+#include <limits>
+#include <mutex>
 #include <numeric>
 
 using namespace cfl;
@@ -15,6 +15,105 @@ using namespace std;
 
 cfl::Fit::Fit (IFit *pNewP) : m_uP (pNewP) {}
 
+namespace cflFit
+{
+// the data sets in one thread
+const unsigned c_iMinBatchBlock = 8;
+} // namespace cflFit
+
+cfl::FitBatch
+cfl::Fit::batch (const std::vector<double> &rDate,
+                 const std::vector<double> &rArg,
+                 const std::vector<double> &rVal,
+                 const std::vector<double> &rWt, bool bChi2) const
+{
+  PRECONDITION (rArg.size () == rDate.size ());
+  PRECONDITION (rVal.size () == rDate.size ());
+  PRECONDITION (rWt.size () == rDate.size ());
+
+  // the data sets are the runs of equal dates
+  std::vector<unsigned> uFirst;
+  for (unsigned iI = 0; iI < rDate.size (); iI++)
+    {
+      if ((iI == 0) || (rDate[iI] != rDate[iI - 1]))
+        {
+          uFirst.push_back (iI);
+        }
+    }
+  unsigned iSets = uFirst.size ();
+  uFirst.push_back (rDate.size ());
+
+  FitBatch uBatch;
+  uBatch.date.resize (iSets);
+  for (unsigned iK = 0; iK < iSets; iK++)
+    {
+      uBatch.date[iK] = rDate[uFirst[iK]];
+    }
+  uBatch.chi2.resize (iSets, std::numeric_limits<double>::quiet_NaN ());
+  uBatch.size = 0;
+
+  // fits the data sets [iBegin, iEnd) with the buffers and the fit
+  // of one thread; returns the index of the first successful fit if
+  // bFirst
+  auto uFit = [&] (unsigned iBegin, unsigned iEnd, bool bFirst) {
+    std::vector<double> uArg, uVal, uWt;
+    std::unique_ptr<IFit> pFit;
+    for (unsigned iK = iBegin; iK < iEnd; iK++)
+      {
+        uArg.assign (rArg.begin () + uFirst[iK],
+                     rArg.begin () + uFirst[iK + 1]);
+        uVal.assign (rVal.begin () + uFirst[iK],
+                     rVal.begin () + uFirst[iK + 1]);
+        uWt.assign (rWt.begin () + uFirst[iK], rWt.begin () + uFirst[iK + 1]);
+        try
+          {
+            FitParam uParam;
+            if (pFit)
+              {
+                uParam = pFit->refit (uArg, uVal, uWt, bChi2);
+              }
+            else
+              {
+                pFit.reset (m_uP->newObject (uArg, uVal, uWt, bChi2));
+                uParam = pFit->param ();
+              }
+            if (bFirst)
+              {
+                uBatch.size = uParam.fit.size ();
+                uBatch.fit.resize (
+                    iSets * uBatch.size,
+                    std::numeric_limits<double>::quiet_NaN ());
+              }
+            ASSERT (uParam.fit.size () == uBatch.size);
+            uBatch.fit[std::slice (iK * uBatch.size, uBatch.size, 1)]
+                = uParam.fit;
+            uBatch.chi2[iK] = uParam.chi2;
+            if (bFirst)
+              {
+                return iK;
+              }
+          }
+        catch (const std::exception &)
+          {
+          }
+      }
+    return iEnd;
+  };
+
+  // the first successful fit determines the number of coefficients
+  unsigned iStart = uFit (0, iSets, true) + 1;
+  if (iStart < iSets)
+    {
+      parallel (
+          iSets - iStart,
+          [&] (unsigned iBegin, unsigned iEnd) {
+            uFit (iStart + iBegin, iStart + iEnd, false);
+          },
+          cflFit::c_iMinBatchBlock);
+    }
+  return uBatch;
+}
+
 // Checking domains
 
 bool
@@ -38,92 +137,482 @@ belongs (const std::vector<Function> &rBaseF, const Function &rFreeF,
       [&rBaseF, &rFreeF] (double dX) { return belongs (rBaseF, rFreeF, dX); });
 }
 
-FitParam
-fitParam (const gsl_vector *pC, const gsl_matrix *pCov, double dChi2)
+// the weighted least-squares problem in the factored form
+
+namespace cflFit
+{
+// The QR factor of the problem min |W^{1/2}(y - Xc)|: the upper
+// triangular matrix R, the vector z = Q'W^{1/2}y, and the residual
+// chi2. The nodes are added and removed by the rank-one updates and
+// downdates of LINPACK (dchud, dchdd).
+class QR
 {
-  FitParam uParam;
-  unsigned iSize = pC->size;
-  uParam.fit = std::valarray<double> (pC->data, iSize);
-  uParam.cov = std::valarray<double> (pCov->data, iSize * iSize);
-  uParam.chi2 = dChi2;
+public:
+  explicit QR (unsigned iP)
+      : m_iP (iP), m_iN (0), m_uR (iP * iP, 0.), m_uZ (iP, 0.), m_dChi2 (0.),
+        m_uX (iP)
+  {
+  }
 
-  return uParam;
-}
+  // removes all nodes
+  void
+  clear ()
+  {
+    std::fill (m_uR.begin (), m_uR.end (), 0.);
+    std::fill (m_uZ.begin (), m_uZ.end (), 0.);
+    m_dChi2 = 0.;
+    m_iN = 0;
+  }
 
-// class LinFit
+  void
+  add (const double *pX, double dY, double dW)
+  {
+    double dS = std::sqrt (dW);
+    std::vector<double> &uX = m_uX;
+    std::transform (pX, pX + m_iP, uX.begin (),
+                    [dS] (double dX) { return dS * dX; });
+    double dZeta = dS * dY;
+    for (unsigned iJ = 0; iJ < m_iP; iJ++)
+      {
+        double dR = std::hypot (r (iJ, iJ), uX[iJ]);
+        if (dR == 0)
+          {
+            continue;
+          }
+        double dC = r (iJ, iJ) / dR;
+        double dSin = uX[iJ] / dR;
+        for (unsigned iK = iJ; iK < m_iP; iK++)
+          {
+            double dT = dC * r (iJ, iK) + dSin * uX[iK];
+            uX[iK] = dC * uX[iK] - dSin * r (iJ, iK);
+            r (iJ, iK) = dT;
+          }
+        double dT = dC * m_uZ[iJ] + dSin * dZeta;
+        dZeta = dC * dZeta - dSin * m_uZ[iJ];
+        m_uZ[iJ] = dT;
+      }
+    m_dChi2 += dZeta * dZeta;
+    m_iN++;
+  }
 
-class LinFit : public cfl::IFit
+  void
+  remove (const double *pX, double dY, double dW)
+  {
+    PRECONDITION (m_iN > 0);
+
+    double dS = std::sqrt (dW);
+    std::vector<double> uA (m_iP);
+    std::transform (pX, pX + m_iP, uA.begin (),
+                    [dS] (double dX) { return dS * dX; });
+    solveTransposed (uA.data ());
+    double dAlpha
+        = std::inner_product (uA.begin (), uA.end (), uA.begin (), 0.);
+    if (!(dAlpha < 1.))
+      {
+        throw (NError::range ("the fit becomes singular after removal"));
+      }
+    std::vector<double> uC (m_iP), uS (m_iP);
+    double dNorm = std::sqrt (1. - dAlpha);
+    for (unsigned iI = m_iP; iI-- > 0;)
+      {
+        double dScale = dNorm + std::abs (uA[iI]);
+        double dA = dNorm / dScale;
+        double dB = uA[iI] / dScale;
+        dNorm = std::hypot (dA, dB);
+        uC[iI] = dA / dNorm;
+        uS[iI] = dB / dNorm;
+        dNorm *= dScale;
+      }
+    for (unsigned iJ = 0; iJ < m_iP; iJ++)
+      {
+        double dX = 0.;
+        for (unsigned iI = iJ + 1; iI-- > 0;)
+          {
+            double dT = uC[iI] * dX + uS[iI] * r (iI, iJ);
+            r (iI, iJ) = uC[iI] * r (iI, iJ) - uS[iI] * dX;
+            dX = dT;
+          }
+      }
+    double dZeta = dS * dY;
+    for (unsigned iJ = 0; iJ < m_iP; iJ++)
+      {
+        m_uZ[iJ] = (m_uZ[iJ] - uS[iJ] * dZeta) / uC[iJ];
+        dZeta = uC[iJ] * dZeta - uS[iJ] * m_uZ[iJ];
+      }
+    m_dChi2 = std::max (m_dChi2 - dZeta * dZeta, 0.);
+    m_iN--;
+  }
+
+  // the fitted coefficients
+  std::valarray<double>
+  coeff () const
+  {
+    std::valarray<double> uC (m_uZ.data (), m_iP);
+    for (unsigned iI = m_iP; iI-- > 0;)
+      {
+        for (unsigned iJ = iI + 1; iJ < m_iP; iJ++)
+          {
+            uC[iI] -= r (iI, iJ) * uC[iJ];
+          }
+        uC[iI] /= r (iI, iI);
+      }
+    return uC;
+  }
+
+  // x'(R'R)^{-1}x; pA is the workspace of the size p
+  double
+  var (const double *pX, double *pA) const
+  {
+    std::copy (pX, pX + m_iP, pA);
+    solveTransposed (pA);
+    return std::inner_product (pA, pA + m_iP, pA, 0.);
+  }
+
+  // x_i'(R'R)^{-1}x_i for the rows x_i of the row-based matrix pX
+  void
+  var (const double *pX, unsigned iRows, double *pV) const
+  {
+    std::vector<double> uA (m_iP);
+    for (unsigned iI = 0; iI < iRows; iI++)
+      {
+        std::copy (pX + iI * m_iP, pX + (iI + 1) * m_iP, uA.begin ());
+        solveTransposed (uA.data ());
+        pV[iI] = std::inner_product (uA.begin (), uA.end (), uA.begin (), 0.);
+      }
+  }
+
+  // (R'R)^{-1}
+  std::valarray<double>
+  cov () const
+  {
+    std::valarray<double> uCov (m_iP * m_iP);
+    std::vector<double> uA (m_iP);
+    for (unsigned iJ = 0; iJ < m_iP; iJ++)
+      {
+        std::fill (uA.begin (), uA.end (), 0.);
+        uA[iJ] = 1.;
+        solveTransposed (uA.data ());
+        for (unsigned iI = m_iP; iI-- > 0;)
+          {
+            for (unsigned iK = iI + 1; iK < m_iP; iK++)
+              {
+                uA[iI] -= r (iI, iK) * uA[iK];
+              }
+            uA[iI] /= r (iI, iI);
+          }
+        for (unsigned iI = 0; iI < m_iP; iI++)
+          {
+            uCov[iI * m_iP + iJ] = uA[iI];
+          }
+      }
+    return uCov;
+  }
+
+  // checks that the coefficients are determined by the nodes: the
+  // rank is deficient if |r_kk| <= eps * |r_11| * max(n, p), where eps
+  // is the machine precision and, as the columns are not pivoted,
+  // |r_11| is replaced by the largest diagonal element
+  void
+  check () const
+  {
+    double dMax = 0.;
+    for (unsigned iI = 0; iI < m_iP; iI++)
+      {
+        dMax = std::max (dMax, std::abs (r (iI, iI)));
+      }
+    double dTol = std::numeric_limits<double>::epsilon () * dMax
+                  * std::max (m_iN, m_iP);
+    for (unsigned iI = 0; iI < m_iP; iI++)
+      {
+        if (!(std::abs (r (iI, iI)) > dTol))
+          {
+            throw (NError::range ("degenerate basis of the linear fit"));
+          }
+      }
+  }
+
+  double
+  chi2 () const
+  {
+    return m_dChi2;
+  }
+
+  // the normalizing variance of the fit
+  double
+  scale (bool bChi2) const
+  {
+    if (!bChi2)
+      {
+        return 1.;
+      }
+    if (m_iN <= m_iP)
+      {
+        throw (NError::size ("not enough nodes for linear fit"));
+      }
+    return m_dChi2 / (m_iN - m_iP);
+  }
+
+private:
+  double &
+  r (unsigned iI, unsigned iJ)
+  {
+    return m_uR[iI * m_iP + iJ];
+  }
+
+  double
+  r (unsigned iI, unsigned iJ) const
+  {
+    return m_uR[iI * m_iP + iJ];
+  }
+
+  // solves R'a = x in place
+  void
+  solveTransposed (double *pA) const
+  {
+    for (unsigned iJ = 0; iJ < m_iP; iJ++)
+      {
+        for (unsigned iI = 0; iI < iJ; iI++)
+          {
+            pA[iJ] -= r (iI, iJ) * pA[iI];
+          }
+        pA[iJ] /= r (iJ, iJ);
+      }
+  }
+
+  unsigned m_iP, m_iN;
+  std::vector<double> m_uR, m_uZ;
+  double m_dChi2;
+  // the scratch row of add()
+  std::vector<double> m_uX;
+};
+
+// the scratch space of the closures of the fits: small sizes are
+// kept on the stack; the closures can be called from several threads
+// and from each other
+const unsigned c_iScratch = 32;
+
+class Scratch
 {
 public:
-  LinFit (const std::vector<Function> &rBaseF, const Function &rFreeF)
-      : m_uBaseF (rBaseF), m_uFreeF (rFreeF),
-        m_uCov (gsl_matrix_alloc (rBaseF.size (), rBaseF.size ()),
-                &gsl_matrix_free),
-        m_uC (gsl_vector_alloc (rBaseF.size ()), &gsl_vector_free)
+  explicit Scratch (unsigned iSize) : m_pData (m_uStack)
   {
-    PRECONDITION (rBaseF.size () > 0);
+    if (iSize > c_iScratch)
+      {
+        m_uHeap.resize (iSize);
+        m_pData = m_uHeap.data ();
+      }
   }
 
-  LinFit (const std::vector<Function> &rBaseF, const Function &rFreeF,
-          const std::vector<double> &rArg, const std::vector<double> &rVal,
-          const std::vector<double> &rWt, bool bChi2)
-      : LinFit (rBaseF, rFreeF)
+  Scratch (const Scratch &) = delete;
+  Scratch &operator= (const Scratch &) = delete;
+
+  double *
+  data ()
   {
+    return m_pData;
+  }
+
+private:
+  double m_uStack[c_iScratch];
+  std::vector<double> m_uHeap;
+  double *m_pData;
+};
+
+// the values of the basis functions
+void
+values (const std::vector<Function> &rBaseF, double dX, double *pV)
+{
+  std::transform (rBaseF.begin (), rBaseF.end (), pV,
+                  [dX] (const Function &rF) { return rF (dX); });
+}
+
+std::vector<double>
+values (const std::vector<Function> &rBaseF, double dX)
+{
+  std::vector<double> uV (rBaseF.size ());
+  values (rBaseF, dX, uV.data ());
+  return uV;
+}
+
+// the number of grids kept for the fits with the same basis
+const unsigned c_iGrids = 4;
+
+// the values of the basis functions (the row-based matrix with the
+// rows for the arguments) and of the free function on the grid
+struct Grid
+{
+  std::vector<double> arg, basis, free;
+};
+
+// the last grids of the fits with the same basis; the object is
+// shared by these fits and can be used by several threads
+class GridCache
+{
+public:
+  std::shared_ptr<const Grid>
+  get (const std::vector<Function> &rBaseF, const Function &rFreeF,
+       const std::vector<double> &rArg)
+  {
+    {
+      std::lock_guard<std::mutex> uLock (m_uMutex);
+      auto itGrid = std::find_if (
+          m_uGrids.begin (), m_uGrids.end (),
+          [&rArg] (const std::shared_ptr<const Grid> &rGrid) {
+            return rGrid->arg == rArg;
+          });
+      if (itGrid != m_uGrids.end ())
+        {
+          std::shared_ptr<const Grid> pGrid = *itGrid;
+          m_uGrids.erase (itGrid);
+          m_uGrids.insert (m_uGrids.begin (), pGrid);
+          return pGrid;
+        }
+    }
     PRECONDITION (belongs (rBaseF, rFreeF, rArg));
-    PRECONDITION (std::all_of (rWt.begin (), rWt.end (),
-                               [] (double dW) { return dW > 0; }));
-    PRECONDITION ((rArg.size () == rVal.size ()) && (rArg.size () > 0)
-                  && (rArg.size () == rWt.size ()));
-    PRECONDITION (rBaseF.size () < rArg.size ());
 
-    if (rArg.size () <= rBaseF.size ())
+    // the basis functions are evaluated column by column
+    unsigned iM = rBaseF.size ();
+    std::shared_ptr<Grid> pGrid = std::make_shared<Grid> ();
+    pGrid->arg = rArg;
+    pGrid->basis.resize (rArg.size () * iM);
+    pGrid->free.resize (rArg.size ());
+    for (unsigned iJ = 0; iJ < iM; iJ++)
       {
-        throw (cfl::NError::size ("not enough nodes for linear fit"));
+        const Function &rF = rBaseF[iJ];
+        for (unsigned iI = 0; iI < rArg.size (); iI++)
+          {
+            pGrid->basis[iI * iM + iJ] = rF (rArg[iI]);
+          }
+      }
+    std::transform (rArg.begin (), rArg.end (), pGrid->free.begin (),
+                    [&rFreeF] (double dX) { return rFreeF (dX); });
+
+    std::lock_guard<std::mutex> uLock (m_uMutex);
+    m_uGrids.insert (m_uGrids.begin (), pGrid);
+    if (m_uGrids.size () > c_iGrids)
+      {
+        m_uGrids.pop_back ();
       }
+    return pGrid;
+  }
 
-    std::unique_ptr<gsl_multifit_linear_workspace,
-                    decltype (&gsl_multifit_linear_free)>
-        uFit (gsl_multifit_linear_alloc (rArg.size (), m_uBaseF.size ()),
-              &gsl_multifit_linear_free);
+private:
+  std::mutex m_uMutex;
+  std::vector<std::shared_ptr<const Grid> > m_uGrids;
+};
+} // namespace cflFit
 
-    std::vector<double> uX (rArg.size () * rBaseF.size ());
-    std::vector<double>::iterator itRowX = uX.begin ();
-    std::for_each (rArg.begin (), rArg.end (), [&itRowX, &rBaseF] (double dT) {
-      std::transform (rBaseF.begin (), rBaseF.end (), itRowX,
-                      [dT] (const cfl::Function &rF) { return rF (dT); });
-      itRowX += rBaseF.size ();
-    });
+// class IFit
+
+IFit *
+cfl::IFit::update (double dArg, double dVal, double dWt) const
+{
+  throw (NError::range ("the fit does not support updates"));
+}
 
-    ASSERT (itRowX == uX.end ());
+IFit *
+cfl::IFit::remove (double dArg, double dVal, double dWt) const
+{
+  throw (NError::range ("the fit does not support updates"));
+}
 
-    gsl_matrix_const_view uXv = gsl_matrix_const_view_array (
-        uX.data (), rArg.size (), rBaseF.size ());
+FitParam
+cfl::IFit::refit (const std::vector<double> &rArg,
+                  const std::vector<double> &rVal,
+                  const std::vector<double> &rW, bool bChi2)
+{
+  std::unique_ptr<IFit> pFit (newObject (rArg, rVal, rW, bChi2));
+  return pFit->param ();
+}
 
-    gsl_vector_const_view uW
-        = gsl_vector_const_view_array (rWt.data (), rWt.size ());
+std::valarray<double>
+cfl::IFit::fitValues (const std::vector<double> &rArg) const
+{
+  Function uFit = fit ();
+  std::valarray<double> uV (rArg.size ());
+  std::transform (rArg.begin (), rArg.end (), std::begin (uV),
+                  [&uFit] (double dX) { return uFit (dX); });
+  return uV;
+}
 
-    std::vector<double> uY (rArg.size ());
-    std::transform (
-        rArg.begin (), rArg.end (), rVal.begin (), uY.begin (),
-        [&rFreeF] (double dX, double dY) { return dY - rFreeF (dX); });
-    gsl_vector_const_view uYv
-        = gsl_vector_const_view_array (uY.data (), uY.size ());
+std::valarray<double>
+cfl::IFit::errValues (const std::vector<double> &rArg) const
+{
+  Function uErr = err ();
+  std::valarray<double> uV (rArg.size ());
+  std::transform (rArg.begin (), rArg.end (), std::begin (uV),
+                  [&uErr] (double dX) { return uErr (dX); });
+  return uV;
+}
 
-    gsl_multifit_wlinear (&uXv.matrix, &uW.vector, &uYv.vector, m_uC.get (),
-                          m_uCov.get (), &m_dChi2, uFit.get ());
+// class LinFit
 
-    if (bChi2)
-      {
-        double dVar = m_dChi2 / (rArg.size () - rBaseF.size ());
-        gsl_matrix_scale (m_uCov.get (), dVar);
-      }
+class LinFit : public cfl::IFit
+{
+public:
+  LinFit (const std::vector<Function> &rBaseF, const Function &rFreeF)
+      : m_uBaseF (rBaseF), m_uFreeF (rFreeF),
+        m_pQR (std::make_shared<cflFit::QR> (rBaseF.size ())),
+        m_bChi2 (true), m_dVar (1.),
+        m_pGrids (std::make_shared<cflFit::GridCache> ())
+  {
+    PRECONDITION (rBaseF.size () > 0);
+  }
+
+  // the new fit shares the grids with rFit
+  LinFit (const LinFit &rFit, const std::vector<double> &rArg,
+          const std::vector<double> &rVal, const std::vector<double> &rWt,
+          bool bChi2)
+      : m_uBaseF (rFit.m_uBaseF), m_uFreeF (rFit.m_uFreeF),
+        m_pQR (std::make_shared<cflFit::QR> (m_uBaseF.size ())),
+        m_bChi2 (bChi2), m_dVar (1.),
+        m_pGrids (rFit.m_pGrids)
+  {
+    assign (rArg, rVal, rWt);
   }
 
   IFit *
   newObject (const std::vector<double> &rArg, const std::vector<double> &rVal,
              const std::vector<double> &rWt, bool bChi2) const
   {
-    return new LinFit (m_uBaseF, m_uFreeF, rArg, rVal, rWt, bChi2);
+    return new LinFit (*this, rArg, rVal, rWt, bChi2);
+  }
+
+  FitParam
+  refit (const std::vector<double> &rArg, const std::vector<double> &rVal,
+         const std::vector<double> &rWt, bool bChi2)
+  {
+    m_bChi2 = bChi2;
+    assign (rArg, rVal, rWt);
+    return param ();
+  }
+
+  IFit *
+  update (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (belongs (m_uBaseF, m_uFreeF, dArg));
+    PRECONDITION (dWt > 0);
+
+    std::unique_ptr<LinFit> pFit (new LinFit (*this));
+    pFit->m_pQR = std::make_shared<cflFit::QR> (*m_pQR);
+    pFit->m_pQR->add (cflFit::values (m_uBaseF, dArg).data (),
+                     dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
+  }
+
+  IFit *
+  remove (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (belongs (m_uBaseF, m_uFreeF, dArg));
+    PRECONDITION (dWt > 0);
+
+    std::unique_ptr<LinFit> pFit (new LinFit (*this));
+    pFit->m_pQR = std::make_shared<cflFit::QR> (*m_pQR);
+    pFit->m_pQR->remove (cflFit::values (m_uBaseF, dArg).data (),
+                        dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
   }
 
   Function
@@ -131,16 +620,11 @@ public:
   {
     std::function<double (double)> uFit
         = [uBase = m_uBaseF, uG = m_uFreeF, uC = m_uC] (double dX) {
-            std::vector<double> uV (uBase.size ());
-
-            std::transform (uBase.begin (), uBase.end (), uV.begin (),
-                            [dX] (const Function &rF) { return rF (dX); });
-            gsl_vector_const_view uU
-                = gsl_vector_const_view_array (uV.data (), uV.size ());
-            double dY;
-            gsl_blas_ddot (&uU.vector, uC.get (), &dY);
-            dY += uG (dX);
-
+            double dY = uG (dX);
+            for (unsigned iJ = 0; iJ < uBase.size (); iJ++)
+              {
+                dY += uC[iJ] * uBase[iJ](dX);
+              }
             return dY;
           };
 
@@ -152,43 +636,110 @@ public:
   Function
   err () const
   {
-    std::function<double (double)> uErr = [uBase = m_uBaseF,
-                                           uCov = m_uCov] (double dX) {
-      std::vector<double> uV (uBase.size ());
-
-      std::transform (uBase.begin (), uBase.end (), uV.begin (),
-                      [dX] (const Function &rF) { return rF (dX); });
-
-      std::vector<double> uU (uV);
-      gsl_vector_const_view uUView
-          = gsl_vector_const_view_array (uU.data (), uU.size ());
-      gsl_vector_view uVView = gsl_vector_view_array (uV.data (), uV.size ());
-      gsl_blas_dsymv (CblasUpper, 1., uCov.get (), &uUView.vector, 0.,
-                      &uVView.vector);
-      gsl_blas_ddot (&uUView.vector, &uVView.vector, &dX);
-
-      ASSERT (dX >= 0);
-
-      return std::sqrt (dX);
-    };
+    // the factor is shared with the fit
+    std::shared_ptr<const cflFit::QR> pQR = m_pQR;
+    std::function<double (double)> uErr
+        = [uBase = m_uBaseF, pQR, dVar = m_dVar] (double dX) {
+            unsigned iM = uBase.size ();
+            cflFit::Scratch uScratch (2 * iM);
+            double *pV = uScratch.data ();
+            cflFit::values (uBase, dX, pV);
+            return std::sqrt (dVar * pQR->var (pV, pV + iM));
+          };
 
     return Function (uErr, [uBase = m_uBaseF, uG = m_uFreeF] (double dX) {
       return belongs (uBase, uG, dX);
     });
   }
 
+  std::valarray<double>
+  fitValues (const std::vector<double> &rArg) const
+  {
+    std::shared_ptr<const cflFit::Grid> pGrid
+        = m_pGrids->get (m_uBaseF, m_uFreeF, rArg);
+    unsigned iM = m_uBaseF.size ();
+    std::valarray<double> uV (pGrid->free.data (), rArg.size ());
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
+      {
+        const double *pX = &pGrid->basis[iI * iM];
+        uV[iI] = std::inner_product (pX, pX + iM, std::begin (m_uC), uV[iI]);
+      }
+    return uV;
+  }
+
+  std::valarray<double>
+  errValues (const std::vector<double> &rArg) const
+  {
+    std::shared_ptr<const cflFit::Grid> pGrid
+        = m_pGrids->get (m_uBaseF, m_uFreeF, rArg);
+    std::valarray<double> uV (rArg.size ());
+    m_pQR->var (pGrid->basis.data (), rArg.size (), std::begin (uV));
+    return std::sqrt (m_dVar * uV);
+  }
+
   FitParam
   param () const
   {
-    return fitParam (m_uC.get (), m_uCov.get (), m_dChi2);
+    FitParam uParam;
+    uParam.fit = m_uC;
+    uParam.cov = m_dVar * m_pQR->cov ();
+    uParam.chi2 = m_pQR->chi2 ();
+
+    return uParam;
   }
 
 private:
+  // fits the nodes with the buffers of the object
+  void
+  assign (const std::vector<double> &rArg, const std::vector<double> &rVal,
+          const std::vector<double> &rWt)
+  {
+    PRECONDITION (belongs (m_uBaseF, m_uFreeF, rArg));
+    PRECONDITION (std::all_of (rWt.begin (), rWt.end (),
+                               [] (double dW) { return dW > 0; }));
+    PRECONDITION ((rArg.size () == rVal.size ()) && (rArg.size () > 0)
+                  && (rArg.size () == rWt.size ()));
+    PRECONDITION (m_uBaseF.size () < rArg.size ());
+
+    if (rArg.size () <= m_uBaseF.size ())
+      {
+        throw (cfl::NError::size ("not enough nodes for linear fit"));
+      }
+
+    // the factor can be kept by the closures of err()
+    if (m_pQR.use_count () > 1)
+      {
+        m_pQR = std::make_shared<cflFit::QR> (m_uBaseF.size ());
+      }
+    m_pQR->clear ();
+    m_uX.resize (m_uBaseF.size ());
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
+      {
+        cflFit::values (m_uBaseF, rArg[iI], m_uX.data ());
+        m_pQR->add (m_uX.data (), rVal[iI] - m_uFreeF (rArg[iI]), rWt[iI]);
+      }
+    refresh ();
+  }
+
+  void
+  refresh ()
+  {
+    m_pQR->check ();
+    m_uC = m_pQR->coeff ();
+    m_dVar = m_pQR->scale (m_bChi2);
+  }
+
   std::vector<Function> m_uBaseF;
   Function m_uFreeF;
-  std::shared_ptr<gsl_matrix> m_uCov;
-  std::shared_ptr<gsl_vector> m_uC;
-  double m_dChi2;
+  // the factor is shared with the copies and the closures of err()
+  // and is not changed after the fit
+  std::shared_ptr<cflFit::QR> m_pQR;
+  bool m_bChi2;
+  std::valarray<double> m_uC;
+  double m_dVar;
+  std::shared_ptr<cflFit::GridCache> m_pGrids;
+  // the values of the basis functions at a node
+  std::vector<double> m_uX;
 };
 
 // linear multi-dim
@@ -205,7 +756,7 @@ class OneDimFit : public IFit
 {
 public:
   OneDimFit (const Function &rBaseF, const Function rFreeF)
-      : m_uBaseF (rBaseF), m_uFreeF (rFreeF)
+      : m_uBaseF (rBaseF), m_uFreeF (rFreeF), m_uQR (1), m_bChi2 (true)
   {
   }
 
@@ -223,23 +774,13 @@ public:
                   && (rArg.size () == rWt.size ()));
     PRECONDITION (rArg.size () > 1);
 
-    std::vector<double> uX (rArg.size ());
-    std::transform (rArg.begin (), rArg.end (), uX.begin (),
-                    [&rBaseF] (double dT) { return rBaseF (dT); });
-
-    std::vector<double> uY (rArg.size ());
-    std::transform (
-        rArg.begin (), rArg.end (), rVal.begin (), uY.begin (),
-        [&rFreeF] (double dX, double dY) { return dY - rFreeF (dX); });
-
-    gsl_fit_wmul (uX.data (), 1, rWt.data (), 1, uY.data (), 1, rArg.size (),
-                  &m_dC, &m_dVar, &m_dChi2);
-
-    if (bChi2)
+    m_bChi2 = bChi2;
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
       {
-        double dVar = m_dChi2 / (rArg.size () - 1);
-        m_dVar *= dVar;
+        double dX = m_uBaseF (rArg[iI]);
+        m_uQR.add (&dX, rVal[iI] - m_uFreeF (rArg[iI]), rWt[iI]);
       }
+    refresh ();
   }
 
   IFit *
@@ -249,6 +790,30 @@ public:
     return new OneDimFit (m_uBaseF, m_uFreeF, rArg, rVal, rWt, bChi2);
   }
 
+  IFit *
+  update (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (m_uBaseF.belongs (dArg) && (dWt > 0));
+
+    std::unique_ptr<OneDimFit> pFit (new OneDimFit (*this));
+    double dX = m_uBaseF (dArg);
+    pFit->m_uQR.add (&dX, dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
+  }
+
+  IFit *
+  remove (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (m_uBaseF.belongs (dArg) && (dWt > 0));
+
+    std::unique_ptr<OneDimFit> pFit (new OneDimFit (*this));
+    double dX = m_uBaseF (dArg);
+    pFit->m_uQR.remove (&dX, dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
+  }
+
   Function
   fit () const
   {
@@ -267,14 +832,24 @@ public:
     FitParam uParam;
     uParam.fit = std::valarray<double> (m_dC, 1);
     uParam.cov = std::valarray<double> (m_dVar, 1);
-    uParam.chi2 = m_dChi2;
+    uParam.chi2 = m_uQR.chi2 ();
 
     return uParam;
   }
 
 private:
+  void
+  refresh ()
+  {
+    m_uQR.check ();
+    m_dC = m_uQR.coeff ()[0];
+    m_dVar = m_uQR.scale (m_bChi2) * m_uQR.cov ()[0];
+  }
+
   Function m_uBaseF, m_uFreeF;
-  double m_dC, m_dVar, m_dChi2;
+  cflFit::QR m_uQR;
+  bool m_bChi2;
+  double m_dC, m_dVar;
 };
 
 // linear one-dim
@@ -291,7 +866,7 @@ class Regression : public IFit
 {
 public:
   Regression (const Function &rBaseF, const Function rFreeF)
-      : m_uBaseF (rBaseF), m_uFreeF (rFreeF)
+      : m_uBaseF (rBaseF), m_uFreeF (rFreeF), m_uQR (2), m_bChi2 (true)
   {
   }
 
@@ -309,35 +884,13 @@ public:
                   && (rArg.size () == rWt.size ()));
     PRECONDITION (rArg.size () > 1);
 
-    std::vector<double> uX (rArg.size ());
-    std::transform (rArg.begin (), rArg.end (), uX.begin (),
-                    [&rBaseF] (double dT) { return rBaseF (dT); });
-
-    std::vector<double> uY (rArg.size ());
-    std::transform (
-        rArg.begin (), rArg.end (), rVal.begin (), uY.begin (),
-        [&rFreeF] (double dX, double dY) { return dY - rFreeF (dX); });
-
-    m_uParam.fit.resize (2);
-    m_uParam.cov.resize (4);
-
-    double *pC0 = &m_uParam.fit[0];
-    double *pC1 = &m_uParam.fit[1];
-    double *pCov00 = &m_uParam.cov[0];
-    double *pCov01 = &m_uParam.cov[1];
-    double *pCov11 = &m_uParam.cov[3];
-    double *pChi2 = &m_uParam.chi2;
-
-    gsl_fit_wlinear (uX.data (), 1, rWt.data (), 1, uY.data (), 1,
-                     rArg.size (), pC0, pC1, pCov00, pCov01, pCov11, pChi2);
-
-    m_uParam.cov[2] = m_uParam.cov[1];
-
-    if (bChi2)
+    m_bChi2 = bChi2;
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
       {
-        double dVar = m_uParam.chi2 / (rArg.size () - 2.);
-        m_uParam.cov *= dVar;
+        double uX[] = { 1., m_uBaseF (rArg[iI]) };
+        m_uQR.add (uX, rVal[iI] - m_uFreeF (rArg[iI]), rWt[iI]);
       }
+    refresh ();
   }
 
   IFit *
@@ -347,6 +900,30 @@ public:
     return new Regression (m_uBaseF, m_uFreeF, rArg, rVal, rWt, bChi2);
   }
 
+  IFit *
+  update (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (m_uBaseF.belongs (dArg) && (dWt > 0));
+
+    std::unique_ptr<Regression> pFit (new Regression (*this));
+    double uX[] = { 1., m_uBaseF (dArg) };
+    pFit->m_uQR.add (uX, dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
+  }
+
+  IFit *
+  remove (double dArg, double dVal, double dWt) const
+  {
+    PRECONDITION (m_uBaseF.belongs (dArg) && (dWt > 0));
+
+    std::unique_ptr<Regression> pFit (new Regression (*this));
+    double uX[] = { 1., m_uBaseF (dArg) };
+    pFit->m_uQR.remove (uX, dVal - m_uFreeF (dArg), dWt);
+    pFit->refresh ();
+    return pFit.release ();
+  }
+
   Function
   fit () const
   {
@@ -358,23 +935,12 @@ public:
   {
     std::function<double (double)> uErr = [uBase = m_uBaseF,
                                            uCov = m_uParam.cov] (double dX) {
-      std::vector<double> uV (2);
-      uV.front () = 1.;
-      uV.back () = uBase (dX);
-
-      std::vector<double> uU (uV);
-      gsl_vector_const_view uUView
-          = gsl_vector_const_view_array (uU.data (), uU.size ());
-      gsl_vector_view uVView = gsl_vector_view_array (uV.data (), uV.size ());
-      gsl_matrix_const_view uCovView
-          = gsl_matrix_const_view_array (&uCov[0], 2, 2);
-      gsl_blas_dsymv (CblasUpper, 1., &uCovView.matrix, &uUView.vector, 0.,
-                      &uVView.vector);
-      gsl_blas_ddot (&uUView.vector, &uVView.vector, &dX);
-
-      ASSERT (dX >= 0);
-
-      return std::sqrt (dX);
+      double dG = uBase (dX);
+      double dV = uCov[0] + 2. * uCov[1] * dG + uCov[3] * dG * dG;
+
+      ASSERT (dV >= -cfl::EPS);
+
+      return std::sqrt (std::max (dV, 0.));
     };
 
     return Function (uErr, [uBase = m_uBaseF, uG = m_uFreeF] (double dX) {
@@ -389,7 +955,18 @@ public:
   }
 
 private:
+  void
+  refresh ()
+  {
+    m_uQR.check ();
+    m_uParam.fit = m_uQR.coeff ();
+    m_uParam.cov = m_uQR.scale (m_bChi2) * m_uQR.cov ();
+    m_uParam.chi2 = m_uQR.chi2 ();
+  }
+
   Function m_uBaseF, m_uFreeF;
+  cflFit::QR m_uQR;
+  bool m_bChi2;
   FitParam m_uParam;
 };
 
@@ -404,29 +981,159 @@ cfl::NFit::linear_regression (const cfl::Function &rBaseF,
 
 // class BSpline
 
+namespace cflBSpline
+{
+// the knots: the end points of the breakpoints are repeated iOrder
+// times
+std::vector<double>
+knots (unsigned iOrder, const std::vector<double> &rPoints)
+{
+  std::vector<double> uKnots (iOrder - 1, rPoints.front ());
+  uKnots.insert (uKnots.end (), rPoints.begin (), rPoints.end ());
+  uKnots.insert (uKnots.end (), iOrder - 1, rPoints.back ());
+  return uKnots;
+}
+
+// computes the iOrder basis splines that do not vanish at dX by the
+// recurrence of Cox and de Boor and returns the index of the first
+// one; pW is the workspace of the size 2*iOrder
+unsigned
+basis (double dX, unsigned iOrder, const std::vector<double> &rKnots,
+       double *pB, double *pW)
+{
+  unsigned iD = iOrder - 1;
+  unsigned iF = rKnots.size () - iOrder;
+  unsigned iSpan
+      = std::upper_bound (rKnots.begin (), rKnots.begin () + iF, dX)
+        - rKnots.begin ();
+  iSpan = std::min (std::max (iSpan, iD + 1), iF) - 1;
+
+  double *pLeft = pW;
+  double *pRight = pW + iOrder;
+  pB[0] = 1.;
+  for (unsigned iJ = 1; iJ <= iD; iJ++)
+    {
+      pLeft[iJ] = dX - rKnots[iSpan + 1 - iJ];
+      pRight[iJ] = rKnots[iSpan + iJ] - dX;
+      double dSaved = 0.;
+      for (unsigned iR = 0; iR < iJ; iR++)
+        {
+          double dT = pB[iR] / (pRight[iR + 1] + pLeft[iJ - iR]);
+          pB[iR] = dSaved + pRight[iR + 1] * dT;
+          dSaved = pLeft[iJ - iR] * dT;
+        }
+      pB[iJ] = dSaved;
+    }
+  return iSpan - iD;
+}
+
+// the symmetric band matrix of the size iF with iK diagonals: the
+// element (i, i-d), 0 <= d < iK, has the index i*iK+d
+
+// replaces the matrix by its Cholesky factor; returns false if the
+// matrix is not positive definite
+bool
+cholesky (std::vector<double> &rA, unsigned iF, unsigned iK)
+{
+  for (unsigned iI = 0; iI < iF; iI++)
+    {
+      unsigned iJ0 = (iI + 1 > iK) ? iI + 1 - iK : 0;
+      for (unsigned iJ = iJ0; iJ <= iI; iJ++)
+        {
+          double dS = rA[iI * iK + iI - iJ];
+          for (unsigned iM = iJ0; iM < iJ; iM++)
+            {
+              dS -= rA[iI * iK + iI - iM] * rA[iJ * iK + iJ - iM];
+            }
+          if (iJ < iI)
+            {
+              rA[iI * iK + iI - iJ] = dS / rA[iJ * iK];
+            }
+          else
+            {
+              if (!(dS > 0))
+                {
+                  return false;
+                }
+              rA[iI * iK] = std::sqrt (dS);
+            }
+        }
+    }
+  return true;
+}
+
+// solves L L' x = b in place for the band Cholesky factor L
+void
+solve (const std::vector<double> &rL, unsigned iF, unsigned iK, double *pX)
+{
+  for (unsigned iI = 0; iI < iF; iI++)
+    {
+      unsigned iJ0 = (iI + 1 > iK) ? iI + 1 - iK : 0;
+      for (unsigned iJ = iJ0; iJ < iI; iJ++)
+        {
+          pX[iI] -= rL[iI * iK + iI - iJ] * pX[iJ];
+        }
+      pX[iI] /= rL[iI * iK];
+    }
+  for (unsigned iI = iF; iI-- > 0;)
+    {
+      unsigned iJ1 = std::min (iI + iK, iF);
+      for (unsigned iJ = iI + 1; iJ < iJ1; iJ++)
+        {
+          pX[iI] -= rL[iJ * iK + iJ - iI] * pX[iJ];
+        }
+      pX[iI] /= rL[iI * iK];
+    }
+}
+
+// the band of the inverse matrix from its Cholesky factor by the
+// recurrence of Takahashi
+std::vector<double>
+inverse (const std::vector<double> &rL, unsigned iF, unsigned iK)
+{
+  std::vector<double> uS (rL.size (), 0.);
+  for (unsigned iI = iF; iI-- > 0;)
+    {
+      unsigned iM1 = std::min (iI + iK, iF);
+      for (unsigned iJ = iM1; iJ-- > iI;)
+        {
+          double dS = (iJ == iI) ? 1. / rL[iI * iK] : 0.;
+          for (unsigned iM = iI + 1; iM < iM1; iM++)
+            {
+              double dSMJ = (iM >= iJ) ? uS[iM * iK + iM - iJ]
+                                       : uS[iJ * iK + iJ - iM];
+              dS -= rL[iM * iK + iM - iI] * dSMJ;
+            }
+          uS[iJ * iK + iJ - iI] = dS / rL[iI * iK];
+        }
+    }
+  return uS;
+}
+} // namespace cflBSpline
+
 class BSpline : public IFit
 {
 public:
   BSpline (unsigned iOrder, const std::vector<double> &rPoints)
-      : m_iOrder (iOrder), m_uPoints (rPoints)
+      : m_iOrder (iOrder), m_iF (iOrder + rPoints.size () - 2),
+        m_uPoints (rPoints),
+        m_uKnots (std::make_shared<const std::vector<double> > (
+            cflBSpline::knots (iOrder, rPoints))),
+        m_dVar (1.), m_dChi2 (0.)
   {
-    m_iF = iOrder + rPoints.size () - 2;
-    m_uBSpline.reset (gsl_bspline_alloc (iOrder, rPoints.size ()),
-                      &gsl_bspline_free);
-
-    ASSERT (m_iF == gsl_bspline_ncoeffs (m_uBSpline.get ()));
-
-    m_uCov.reset (gsl_matrix_alloc (m_iF, m_iF), &gsl_matrix_free);
-    m_uC.reset (gsl_vector_alloc (m_iF), &gsl_vector_free);
-    gsl_vector_const_view uVec
-        = gsl_vector_const_view_array (rPoints.data (), rPoints.size ());
-    gsl_bspline_knots (&uVec.vector, m_uBSpline.get ());
+    PRECONDITION (iOrder > 0);
+    PRECONDITION (rPoints.size () > 1);
+    PRECONDITION (std::is_sorted (rPoints.begin (), rPoints.end (),
+                                  std::less_equal<double> ()));
   }
 
-  BSpline (unsigned iOrder, const std::vector<double> &rPoints,
-           const std::vector<double> &rArg, const std::vector<double> &rVal,
-           const std::vector<double> &rWt, bool bChi2)
-      : BSpline (iOrder, rPoints)
+  // the new fit shares the knots with rBSpline
+  BSpline (const BSpline &rBSpline, const std::vector<double> &rArg,
+           const std::vector<double> &rVal, const std::vector<double> &rWt,
+           bool bChi2)
+      : m_iOrder (rBSpline.m_iOrder), m_iF (rBSpline.m_iF),
+        m_uPoints (rBSpline.m_uPoints), m_uKnots (rBSpline.m_uKnots),
+        m_dVar (1.), m_dChi2 (0.)
   {
     PRECONDITION ((rArg.size () == rVal.size ()) && (rArg.size () > 0));
     PRECONDITION (rArg.size () == rWt.size ());
@@ -437,101 +1144,186 @@ public:
         throw (NError::size ("not enough nodes for fitting with B-splines"));
       }
 
-    std::unique_ptr<gsl_multifit_linear_workspace,
-                    decltype (&gsl_multifit_linear_free)>
-        uFit (gsl_multifit_linear_alloc (rArg.size (), m_iF),
-              &gsl_multifit_linear_free);
-
-    std::unique_ptr<gsl_matrix, decltype (&gsl_matrix_free)> uX (
-        gsl_matrix_alloc (rArg.size (), m_iF), &gsl_matrix_free);
-    for (unsigned i = 0; i < rArg.size (); i++)
+    // the normal equations in the band form
+    unsigned iK = m_iOrder;
+    std::vector<double> uL (m_iF * iK, 0.);
+    std::vector<double> uC (m_iF, 0.);
+    std::vector<double> uB (iK), uW (2 * iK);
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
       {
-        gsl_vector_view uV = gsl_matrix_row (uX.get (), i);
-        gsl_bspline_eval (rArg[i], &uV.vector, m_uBSpline.get ());
+        unsigned iStart = cflBSpline::basis (rArg[iI], iK, *m_uKnots,
+                                             uB.data (), uW.data ());
+        for (unsigned iA = 0; iA < iK; iA++)
+          {
+            double dWB = rWt[iI] * uB[iA];
+            uC[iStart + iA] += dWB * rVal[iI];
+            for (unsigned iB = 0; iB <= iA; iB++)
+              {
+                uL[(iStart + iA) * iK + iA - iB] += dWB * uB[iB];
+              }
+          }
       }
-    gsl_vector_const_view uW
-        = gsl_vector_const_view_array (rWt.data (), rWt.size ());
-    gsl_vector_const_view uY
-        = gsl_vector_const_view_array (rVal.data (), rVal.size ());
-
-    gsl_multifit_wlinear (uX.get (), &uW.vector, &uY.vector, m_uC.get (),
-                          m_uCov.get (), &m_dChi2, uFit.get ());
+    if (!cflBSpline::cholesky (uL, m_iF, iK))
+      {
+        throw (NError::size (
+            "not enough nodes between breakpoints for B-spline fit"));
+      }
+    cflBSpline::solve (uL, m_iF, iK, uC.data ());
 
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
+      {
+        unsigned iStart = cflBSpline::basis (rArg[iI], iK, *m_uKnots,
+                                             uB.data (), uW.data ());
+        double dE = rVal[iI]
+                    - std::inner_product (uB.begin (), uB.end (),
+                                          uC.begin () + iStart, 0.);
+        m_dChi2 += rWt[iI] * dE * dE;
+      }
     if (bChi2)
       {
-        double dVar = m_dChi2 / (rArg.size () - m_iF);
-        gsl_matrix_scale (m_uCov.get (), dVar);
+        m_dVar = m_dChi2 / (rArg.size () - m_iF);
       }
+    m_uC = std::make_shared<const std::vector<double> > (std::move (uC));
+    m_uL = std::make_shared<const std::vector<double> > (std::move (uL));
   }
 
   IFit *
   newObject (const std::vector<double> &rArg, const std::vector<double> &rVal,
              const std::vector<double> &rWt, bool bChi2) const
   {
-    return new BSpline (m_iOrder, m_uPoints, rArg, rVal, rWt, bChi2);
+    return new BSpline (*this, rArg, rVal, rWt, bChi2);
   }
 
   Function
   fit () const
   {
-    std::function<double (double)> uFit = [uC = m_uC, uBS = m_uBSpline,
-                                           iK = m_iOrder] (double dX) {
-      std::vector<double> uF (iK);
-      gsl_vector_view uViewF = gsl_vector_view_array (uF.data (), uF.size ());
-      unsigned long iStart, iEnd;
-      gsl_bspline_eval_nonzero (dX, &uViewF.vector, &iStart, &iEnd,
-                                uBS.get ());
-
-      ASSERT (iStart + iK == iEnd + 1);
+    PRECONDITION (m_uC);
 
-      gsl_vector_view uViewG = gsl_vector_subvector (uC.get (), iStart, iK);
-      gsl_blas_ddot (&uViewG.vector, &uViewF.vector, &dX);
-      return dX;
-    };
+    std::function<double (double)> uFit
+        = [uC = m_uC, uKnots = m_uKnots, iK = m_iOrder] (double dX) {
+            cflFit::Scratch uScratch (3 * iK);
+            double *pB = uScratch.data ();
+            unsigned iStart
+                = cflBSpline::basis (dX, iK, *uKnots, pB, pB + iK);
+            return std::inner_product (pB, pB + iK, uC->begin () + iStart,
+                                       0.);
+          };
     return Function (uFit, m_uPoints.front (), m_uPoints.back ());
   }
 
   Function
   err () const
   {
-    std::function<double (double)> uErr = [uCov = m_uCov, uB = m_uBSpline,
-                                           iK = m_iOrder] (double dX) {
-      PRECONDITION (uCov->size1 == uCov->size2);
-
-      std::vector<double> uF (iK);
-      gsl_vector_view uFView = gsl_vector_view_array (uF.data (), uF.size ());
-      unsigned long iStart, iEnd;
-      gsl_bspline_eval_nonzero (dX, &uFView.vector, &iStart, &iEnd, uB.get ());
-
-      ASSERT (iStart + iK == iEnd + 1);
-
-      std::vector<double> uG (uF);
-      gsl_vector_view uGView = gsl_vector_view_array (uG.data (), uG.size ());
-      gsl_matrix_view uCovView
-          = gsl_matrix_submatrix (uCov.get (), iStart, iStart, iK, iK);
-      gsl_blas_dsymv (CblasUpper, 1., &uCovView.matrix, &uGView.vector, 0.,
-                      &uFView.vector);
-      gsl_blas_ddot (&uFView.vector, &uGView.vector, &dX);
-
-      return std::sqrt (dX);
+    PRECONDITION (m_uL);
+
+    // only the band of the covariance matrix is needed
+    std::shared_ptr<const std::vector<double> > uCov
+        = std::make_shared<const std::vector<double> > (
+            cflBSpline::inverse (*m_uL, m_iF, m_iOrder));
+    std::function<double (double)> uErr = [uCov, uKnots = m_uKnots,
+                                           iK = m_iOrder,
+                                           dVar = m_dVar] (double dX) {
+      cflFit::Scratch uScratch (3 * iK);
+      double *pB = uScratch.data ();
+      unsigned iStart = cflBSpline::basis (dX, iK, *uKnots, pB, pB + iK);
+      double dV = 0.;
+      for (unsigned iA = 0; iA < iK; iA++)
+        {
+          dV += pB[iA] * pB[iA] * (*uCov)[(iStart + iA) * iK];
+          for (unsigned iB = 0; iB < iA; iB++)
+            {
+              dV += 2. * pB[iA] * pB[iB]
+                    * (*uCov)[(iStart + iA) * iK + iA - iB];
+            }
+        }
+      return std::sqrt (std::max (dVar * dV, 0.));
     };
 
     return Function (uErr, m_uPoints.front (), m_uPoints.back ());
   }
 
+  std::valarray<double>
+  fitValues (const std::vector<double> &rArg) const
+  {
+    PRECONDITION (m_uC);
+    PRECONDITION (std::all_of (rArg.begin (), rArg.end (), [this] (double dX) {
+      return (dX >= m_uPoints.front ()) && (dX <= m_uPoints.back ());
+    }));
+
+    unsigned iK = m_iOrder;
+    std::vector<double> uB (iK), uW (2 * iK);
+    std::valarray<double> uV (rArg.size ());
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
+      {
+        unsigned iStart = cflBSpline::basis (rArg[iI], iK, *m_uKnots,
+                                             uB.data (), uW.data ());
+        uV[iI] = std::inner_product (uB.begin (), uB.end (),
+                                     m_uC->begin () + iStart, 0.);
+      }
+    return uV;
+  }
+
+  std::valarray<double>
+  errValues (const std::vector<double> &rArg) const
+  {
+    PRECONDITION (m_uL);
+    PRECONDITION (std::all_of (rArg.begin (), rArg.end (), [this] (double dX) {
+      return (dX >= m_uPoints.front ()) && (dX <= m_uPoints.back ());
+    }));
+
+    unsigned iK = m_iOrder;
+    std::vector<double> uCov = cflBSpline::inverse (*m_uL, m_iF, iK);
+    std::vector<double> uB (iK), uW (2 * iK);
+    std::valarray<double> uV (rArg.size ());
+    for (unsigned iI = 0; iI < rArg.size (); iI++)
+      {
+        unsigned iStart = cflBSpline::basis (rArg[iI], iK, *m_uKnots,
+                                             uB.data (), uW.data ());
+        double dV = 0.;
+        for (unsigned iA = 0; iA < iK; iA++)
+          {
+            const double *pCov = &uCov[(iStart + iA) * iK];
+            double dS = 0.5 * uB[iA] * pCov[0];
+            for (unsigned iB = 0; iB < iA; iB++)
+              {
+                dS += uB[iB] * pCov[iA - iB];
+              }
+            dV += 2. * uB[iA] * dS;
+          }
+        uV[iI] = std::sqrt (std::max (m_dVar * dV, 0.));
+      }
+    return uV;
+  }
+
   FitParam
   param () const
   {
-    return fitParam (m_uC.get (), m_uCov.get (), m_dChi2);
+    PRECONDITION (m_uC && m_uL);
+
+    FitParam uParam;
+    uParam.fit = std::valarray<double> (m_uC->data (), m_iF);
+    uParam.cov.resize (m_iF * m_iF);
+    std::vector<double> uX (m_iF);
+    for (unsigned iJ = 0; iJ < m_iF; iJ++)
+      {
+        std::fill (uX.begin (), uX.end (), 0.);
+        uX[iJ] = 1.;
+        cflBSpline::solve (*m_uL, m_iF, m_iOrder, uX.data ());
+        for (unsigned iI = 0; iI < m_iF; iI++)
+          {
+            uParam.cov[iI * m_iF + iJ] = m_dVar * uX[iI];
+          }
+      }
+    uParam.chi2 = m_dChi2;
+
+    return uParam;
   }
 
 private:
   unsigned m_iOrder, m_iF;
   std::vector<double> m_uPoints;
-  std::shared_ptr<gsl_bspline_workspace> m_uBSpline;
-  std::shared_ptr<gsl_matrix> m_uCov;
-  std::shared_ptr<gsl_vector> m_uC;
-  double m_dChi2;
+  std::shared_ptr<const std::vector<double> > m_uKnots, m_uC, m_uL;
+  double m_dVar, m_dChi2;
 };
 
 // bspline
@@ -561,3 +1353,576 @@ cfl::NFit::bspline (unsigned iOrder, double dL, double dR, unsigned iPoints)
 
   return Fit (new BSpline (iOrder, uPoints));
 }
+
+// class ExpFit
+
+namespace cflExpFit
+{
+// the shapes of the yield curves of Nelson-Siegel and Svensson; u =
+// lambda * (t - t0)
+const unsigned c_iConst = 0;          // 1
+const unsigned c_iShape1 = 1;         // (1-exp(-u))/u
+const unsigned c_iShape2 = 2;         // (1-exp(-u))/u - exp(-u)
+const double c_dMinLambda = 1E-3;     // the bounds for lambda
+const double c_dMaxLambda = 1E+2;     //
+const double c_dSingular = 1E-10;     // the collinearity of the basis
+const unsigned c_iMinStartBlock = 4;  // the starts in one thread
+
+// the basis function: the shape and the index of its lambda
+struct Basis
+{
+  unsigned iShape, iLambda;
+};
+
+// the value of the shape and its derivative with respect to
+// log(lambda)
+void
+shape (unsigned iShape, double dU, double &rV, double &rD)
+{
+  if (iShape == c_iConst)
+    {
+      rV = 1.;
+      rD = 0.;
+      return;
+    }
+  double dE = std::exp (-dU);
+  double dA = (dU > cfl::EPS) ? -std::expm1 (-dU) / dU : 1. - 0.5 * dU;
+  // u * A'(u) = exp(-u) - A(u)
+  if (iShape == c_iShape1)
+    {
+      rV = dA;
+      rD = dE - dA;
+    }
+  else
+    {
+      ASSERT (iShape == c_iShape2);
+
+      rV = dA - dE;
+      rD = dE * (1. + dU) - dA;
+    }
+}
+
+// inverts the square matrix of the size iN in place by Gauss-Jordan
+// elimination; returns false if the matrix is singular
+bool
+invert (std::vector<double> &rA, unsigned iN)
+{
+  std::vector<unsigned> uPerm (iN);
+  std::iota (uPerm.begin (), uPerm.end (), 0);
+  for (unsigned iK = 0; iK < iN; iK++)
+    {
+      unsigned iP = iK;
+      for (unsigned iI = iK + 1; iI < iN; iI++)
+        {
+          if (std::abs (rA[iI * iN + iK]) > std::abs (rA[iP * iN + iK]))
+            {
+              iP = iI;
+            }
+        }
+      if (!(std::abs (rA[iP * iN + iK]) > 0))
+        {
+          return false;
+        }
+      if (iP != iK)
+        {
+          std::swap_ranges (rA.begin () + iP * iN, rA.begin () + (iP + 1) * iN,
+                            rA.begin () + iK * iN);
+          std::swap (uPerm[iP], uPerm[iK]);
+        }
+      double dPivot = 1. / rA[iK * iN + iK];
+      rA[iK * iN + iK] = 1.;
+      for (unsigned iJ = 0; iJ < iN; iJ++)
+        {
+          rA[iK * iN + iJ] *= dPivot;
+        }
+      for (unsigned iI = 0; iI < iN; iI++)
+        {
+          if (iI == iK)
+            {
+              continue;
+            }
+          double dF = rA[iI * iN + iK];
+          rA[iI * iN + iK] = 0.;
+          for (unsigned iJ = 0; iJ < iN; iJ++)
+            {
+              rA[iI * iN + iJ] -= dF * rA[iK * iN + iJ];
+            }
+        }
+    }
+  // the columns are permuted as the rows of the original matrix
+  std::vector<double> uA (rA);
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      for (unsigned iJ = 0; iJ < iN; iJ++)
+        {
+          rA[iI * iN + uPerm[iJ]] = uA[iI * iN + iJ];
+        }
+    }
+  return true;
+}
+
+// variable projection: for given lambdas the coefficients of the
+// basis are found by the linear least-squares; the residual is
+// minimized over log(lambda) by Levenberg-Marquardt method
+class VarPro
+{
+public:
+  VarPro (const std::vector<Basis> &rBasis, unsigned iLambdas)
+      : m_rBasis (rBasis), m_pX (nullptr), m_iN (0), m_iM (rBasis.size ()),
+        m_iP (iLambdas), m_uR (m_iM * m_iM), m_uC (m_iM)
+  {
+  }
+
+  // sets the data of the problem; the buffers keep their capacity
+  // for the next data sets
+  void
+  data (const std::vector<double> &rX, const std::vector<double> &rY,
+        const std::vector<double> &rW)
+  {
+    m_pX = &rX;
+    m_iN = rX.size ();
+    m_uY.resize (m_iN);
+    m_uSW.resize (m_iN);
+    m_uQ.resize (m_iN * m_iM);
+    m_uD.resize (m_iN * m_iM);
+    m_uRes.resize (m_iN);
+    m_uJ.resize (m_iN * m_iP);
+    m_uV.resize (m_iN);
+    std::transform (rW.begin (), rW.end (), m_uSW.begin (),
+                    [] (double dW) { return std::sqrt (dW); });
+    std::transform (rY.begin (), rY.end (), m_uSW.begin (), m_uY.begin (),
+                    std::multiplies<double> ());
+  }
+
+  // solves the linear problem for given log(lambda); returns chi2
+  // or infinity if the basis is degenerate
+  double
+  assign (const std::vector<double> &rTheta)
+  {
+    const double dInf = std::numeric_limits<double>::infinity ();
+    for (unsigned iJ = 0; iJ < m_iM; iJ++)
+      {
+        double dL = std::exp (rTheta[m_rBasis[iJ].iLambda]);
+        double *pQ = &m_uQ[iJ * m_iN];
+        double *pD = &m_uD[iJ * m_iN];
+        for (unsigned iI = 0; iI < m_iN; iI++)
+          {
+            shape (m_rBasis[iJ].iShape, dL * (*m_pX)[iI], pQ[iI], pD[iI]);
+            pQ[iI] *= m_uSW[iI];
+            pD[iI] *= m_uSW[iI];
+          }
+      }
+    // modified Gram-Schmidt with reorthogonalization
+    std::fill (m_uR.begin (), m_uR.end (), 0.);
+    for (unsigned iJ = 0; iJ < m_iM; iJ++)
+      {
+        double *pQ = &m_uQ[iJ * m_iN];
+        double dNorm = norm (pQ);
+        for (unsigned iPass = 0; iPass < 2; iPass++)
+          {
+            for (unsigned iK = 0; iK < iJ; iK++)
+              {
+                const double *pK = &m_uQ[iK * m_iN];
+                double dH = dot (pK, pQ);
+                m_uR[iK * m_iM + iJ] += dH;
+                for (unsigned iI = 0; iI < m_iN; iI++)
+                  {
+                    pQ[iI] -= dH * pK[iI];
+                  }
+              }
+          }
+        double dR = norm (pQ);
+        if (!(dR > c_dSingular * dNorm))
+          {
+            return dInf;
+          }
+        m_uR[iJ * m_iM + iJ] = dR;
+        for (unsigned iI = 0; iI < m_iN; iI++)
+          {
+            pQ[iI] /= dR;
+          }
+      }
+    // the coefficients and the residual
+    std::copy (m_uY.begin (), m_uY.end (), m_uRes.begin ());
+    project (m_uRes.data (), m_uC.data ());
+    for (unsigned iJ = m_iM; iJ-- > 0;)
+      {
+        for (unsigned iK = iJ + 1; iK < m_iM; iK++)
+          {
+            m_uC[iJ] -= m_uR[iJ * m_iM + iK] * m_uC[iK];
+          }
+        m_uC[iJ] /= m_uR[iJ * m_iM + iJ];
+      }
+    // the Jacobian of the residual of Golub and Pereyra:
+    // -P(dPhi/dtheta)c - (Phi^+)'(dPhi/dtheta)'r, where P is the
+    // projection on the orthogonal complement of the basis and Phi^+
+    // = R^{-1}Q' is the pseudo-inverse of the basis
+    std::fill (m_uJ.begin (), m_uJ.end (), 0.);
+    for (unsigned iJ = 0; iJ < m_iM; iJ++)
+      {
+        double *pJ = &m_uJ[m_rBasis[iJ].iLambda * m_iN];
+        const double *pD = &m_uD[iJ * m_iN];
+        for (unsigned iI = 0; iI < m_iN; iI++)
+          {
+            pJ[iI] -= m_uC[iJ] * pD[iI];
+          }
+      }
+    for (unsigned iK = 0; iK < m_iP; iK++)
+      {
+        double *pJ = &m_uJ[iK * m_iN];
+        project (pJ, m_uV.data ());
+        // z = R'^{-1} w, where w_j = (dPhi_j/dtheta_k)'r
+        for (unsigned iJ = 0; iJ < m_iM; iJ++)
+          {
+            double dW = (m_rBasis[iJ].iLambda == iK)
+                            ? dot (&m_uD[iJ * m_iN], m_uRes.data ())
+                            : 0.;
+            for (unsigned iL = 0; iL < iJ; iL++)
+              {
+                dW -= m_uR[iL * m_iM + iJ] * m_uV[iL];
+              }
+            m_uV[iJ] = dW / m_uR[iJ * m_iM + iJ];
+          }
+        for (unsigned iJ = 0; iJ < m_iM; iJ++)
+          {
+            const double *pQ = &m_uQ[iJ * m_iN];
+            for (unsigned iI = 0; iI < m_iN; iI++)
+              {
+                pJ[iI] -= m_uV[iJ] * pQ[iI];
+              }
+          }
+      }
+    return dot (m_uRes.data (), m_uRes.data ());
+  }
+
+  // minimizes chi2 starting from rTheta; returns chi2
+  double
+  minimize (std::vector<double> &rTheta)
+  {
+    auto uAssign = [this] (const std::vector<double> &rT) {
+      return assign (rT);
+    };
+    auto uNormal = [this] (std::vector<double> &rG, std::vector<double> &rH) {
+      for (unsigned iK = 0; iK < m_iP; iK++)
+        {
+          rG[iK] = dot (&m_uJ[iK * m_iN], m_uRes.data ());
+          for (unsigned iL = 0; iL < m_iP; iL++)
+            {
+              rH[iK * m_iP + iL] = dot (&m_uJ[iK * m_iN], &m_uJ[iL * m_iN]);
+            }
+        }
+    };
+    Levenberg uLevenberg (cfl::EPS, cfl::EPS, std::log (c_dMinLambda),
+                          std::log (c_dMaxLambda));
+    return uLevenberg.minimize (uAssign, uNormal, rTheta);
+  }
+
+  const std::vector<double> &
+  coeff () const
+  {
+    return m_uC;
+  }
+
+private:
+  double
+  dot (const double *pA, const double *pB) const
+  {
+    return std::inner_product (pA, pA + m_iN, pB, 0.);
+  }
+
+  double
+  norm (const double *pA) const
+  {
+    return std::sqrt (dot (pA, pA));
+  }
+
+  // replaces pV by its projection on the orthogonal complement of the
+  // basis; pZ gets the coordinates of the removed part
+  void
+  project (double *pV, double *pZ) const
+  {
+    for (unsigned iK = 0; iK < m_iM; iK++)
+      {
+        const double *pQ = &m_uQ[iK * m_iN];
+        pZ[iK] = dot (pQ, pV);
+        for (unsigned iI = 0; iI < m_iN; iI++)
+          {
+            pV[iI] -= pZ[iK] * pQ[iI];
+          }
+      }
+  }
+
+  const std::vector<Basis> &m_rBasis;
+  const std::vector<double> *m_pX;
+  unsigned m_iN, m_iM, m_iP;
+  std::vector<double> m_uY, m_uSW, m_uQ, m_uD, m_uR, m_uC, m_uRes, m_uJ,
+      m_uV;
+};
+
+// the values of the basis functions followed by the derivatives of
+// the fit with respect to lambdas
+std::vector<double>
+gradient (const std::vector<Basis> &rBasis, const std::valarray<double> &rP,
+          double dX)
+{
+  unsigned iM = rBasis.size ();
+  std::vector<double> uG (rP.size (), 0.);
+  for (unsigned iJ = 0; iJ < iM; iJ++)
+    {
+      double dL = rP[iM + rBasis[iJ].iLambda];
+      double dD;
+      shape (rBasis[iJ].iShape, dL * dX, uG[iJ], dD);
+      uG[iM + rBasis[iJ].iLambda] += rP[iJ] * dD / dL;
+    }
+  return uG;
+}
+} // namespace cflExpFit
+
+class ExpFit : public IFit
+{
+public:
+  ExpFit (const std::vector<cflExpFit::Basis> &rBasis, unsigned iLambdas,
+          double dInitialTime, const std::vector<double> &rStart)
+      : m_uBasis (rBasis), m_iLambdas (iLambdas), m_dT0 (dInitialTime),
+        m_uStart (rStart)
+  {
+    PRECONDITION (iLambdas > 0);
+    PRECONDITION ((rStart.size () > 0) && (rStart.size () % iLambdas == 0));
+  }
+
+  ExpFit (const std::vector<cflExpFit::Basis> &rBasis, unsigned iLambdas,
+          double dInitialTime, const std::vector<double> &rStart,
+          const std::vector<double> &rArg, const std::vector<double> &rVal,
+          const std::vector<double> &rWt, bool bChi2)
+      : ExpFit (rBasis, iLambdas, dInitialTime, rStart)
+  {
+    assign (rArg, rVal, rWt, bChi2);
+  }
+
+  IFit *
+  newObject (const std::vector<double> &rArg, const std::vector<double> &rVal,
+             const std::vector<double> &rWt, bool bChi2) const
+  {
+    return new ExpFit (m_uBasis, m_iLambdas, m_dT0, m_uStart, rArg, rVal,
+                       rWt, bChi2);
+  }
+
+  FitParam
+  refit (const std::vector<double> &rArg, const std::vector<double> &rVal,
+         const std::vector<double> &rWt, bool bChi2)
+  {
+    assign (rArg, rVal, rWt, bChi2);
+    return m_uParam;
+  }
+
+  Function
+  fit () const
+  {
+    std::function<double (double)> uFit
+        = [uBasis = m_uBasis, uP = m_uParam.fit, dT0 = m_dT0] (double dT) {
+            std::vector<double> uG
+                = cflExpFit::gradient (uBasis, uP, dT - dT0);
+            return std::inner_product (uG.begin (),
+                                       uG.begin () + uBasis.size (),
+                                       std::begin (uP), 0.);
+          };
+    return Function (uFit, m_dT0);
+  }
+
+  Function
+  err () const
+  {
+    std::function<double (double)> uErr
+        = [uBasis = m_uBasis, uP = m_uParam.fit, uCov = m_uParam.cov,
+           dT0 = m_dT0] (double dT) {
+            std::vector<double> uG
+                = cflExpFit::gradient (uBasis, uP, dT - dT0);
+            double dV = 0.;
+            for (unsigned iK = 0; iK < uG.size (); iK++)
+              {
+                for (unsigned iL = 0; iL < uG.size (); iL++)
+                  {
+                    dV += uG[iK] * uCov[iK * uG.size () + iL] * uG[iL];
+                  }
+              }
+
+            ASSERT (dV >= -cfl::EPS);
+
+            return std::sqrt (std::max (dV, 0.));
+          };
+    return Function (uErr, m_dT0);
+  }
+
+  FitParam
+  param () const
+  {
+    return m_uParam;
+  }
+
+private:
+  // fits the data with the workspaces of the object
+  void
+  assign (const std::vector<double> &rArg, const std::vector<double> &rVal,
+          const std::vector<double> &rWt, bool bChi2)
+  {
+    using namespace cflExpFit;
+
+    PRECONDITION ((rArg.size () == rVal.size ())
+                  && (rArg.size () == rWt.size ()));
+    PRECONDITION (std::all_of (rArg.begin (), rArg.end (),
+                               [dT0 = m_dT0] (double dT) {
+                                 return dT >= dT0;
+                               }));
+    PRECONDITION (std::all_of (rWt.begin (), rWt.end (),
+                               [] (double dW) { return dW > 0; }));
+
+    unsigned iM = m_uBasis.size ();
+    unsigned iP = iM + m_iLambdas;
+    if (rArg.size () <= iP)
+      {
+        throw (NError::size ("not enough nodes for nonlinear fit"));
+      }
+
+    std::vector<double> &uX = m_uX;
+    uX.resize (rArg.size ());
+    std::transform (rArg.begin (), rArg.end (), uX.begin (),
+                    [dT0 = m_dT0] (double dT) { return dT - dT0; });
+
+    // independent starts in parallel
+    unsigned iStarts = m_uStart.size () / m_iLambdas;
+    std::vector<std::vector<double> > uTheta (iStarts);
+    std::vector<double> uChi2 (iStarts);
+    parallel (
+        iStarts,
+        [&] (unsigned iBegin, unsigned iEnd) {
+          std::unique_ptr<VarPro> pVarPro = take ();
+          pVarPro->data (uX, rVal, rWt);
+          for (unsigned iS = iBegin; iS < iEnd; iS++)
+            {
+              uTheta[iS].resize (m_iLambdas);
+              std::transform (m_uStart.begin () + iS * m_iLambdas,
+                              m_uStart.begin () + (iS + 1) * m_iLambdas,
+                              uTheta[iS].begin (),
+                              [] (double dL) { return std::log (dL); });
+              uChi2[iS] = pVarPro->minimize (uTheta[iS]);
+            }
+          give (std::move (pVarPro));
+        },
+        c_iMinStartBlock);
+    unsigned iBest
+        = std::min_element (uChi2.begin (), uChi2.end ()) - uChi2.begin ();
+    if (!std::isfinite (uChi2[iBest]))
+      {
+        throw (NError::range ("degenerate basis in nonlinear fit"));
+      }
+
+    std::unique_ptr<VarPro> pVarPro = take ();
+    pVarPro->data (uX, rVal, rWt);
+    m_uParam.chi2 = pVarPro->assign (uTheta[iBest]);
+    m_uParam.fit.resize (iP);
+    std::copy (pVarPro->coeff ().begin (), pVarPro->coeff ().end (),
+               std::begin (m_uParam.fit));
+    give (std::move (pVarPro));
+    std::transform (uTheta[iBest].begin (), uTheta[iBest].end (),
+                    std::begin (m_uParam.fit) + iM,
+                    [] (double dT) { return std::exp (dT); });
+
+    // the covariance of the linearized problem
+    std::vector<double> uF (iP * iP, 0.);
+    for (unsigned iI = 0; iI < uX.size (); iI++)
+      {
+        std::vector<double> uG = gradient (m_uBasis, m_uParam.fit, uX[iI]);
+        for (unsigned iK = 0; iK < iP; iK++)
+          {
+            for (unsigned iL = 0; iL < iP; iL++)
+              {
+                uF[iK * iP + iL] += rWt[iI] * uG[iK] * uG[iL];
+              }
+          }
+      }
+    if (!invert (uF, iP))
+      {
+        throw (NError::range ("singular covariance in nonlinear fit"));
+      }
+    m_uParam.cov = std::valarray<double> (uF.data (), uF.size ());
+    if (bChi2)
+      {
+        double dVar = m_uParam.chi2 / (rArg.size () - iP);
+        m_uParam.cov *= dVar;
+      }
+  }
+
+  // takes a workspace of the variable projection from the pool
+  std::unique_ptr<cflExpFit::VarPro>
+  take ()
+  {
+    std::lock_guard<std::mutex> uLock (m_uMutex);
+    if (m_uWork.empty ())
+      {
+        return std::unique_ptr<cflExpFit::VarPro> (
+            new cflExpFit::VarPro (m_uBasis, m_iLambdas));
+      }
+    std::unique_ptr<cflExpFit::VarPro> pVarPro = std::move (m_uWork.back ());
+    m_uWork.pop_back ();
+    return pVarPro;
+  }
+
+  // returns the workspace to the pool
+  void
+  give (std::unique_ptr<cflExpFit::VarPro> pVarPro)
+  {
+    std::lock_guard<std::mutex> uLock (m_uMutex);
+    m_uWork.push_back (std::move (pVarPro));
+  }
+
+  std::vector<cflExpFit::Basis> m_uBasis;
+  unsigned m_iLambdas;
+  double m_dT0;
+  std::vector<double> m_uStart;
+  FitParam m_uParam;
+  // the shifted arguments and the workspaces of the starts; every
+  // thread takes its own workspace
+  std::vector<double> m_uX;
+  std::vector<std::unique_ptr<cflExpFit::VarPro> > m_uWork;
+  std::mutex m_uMutex;
+};
+
+// Nelson-Siegel and Svensson
+
+cfl::Fit
+cfl::NFit::nelsonSiegel (double dInitialTime)
+{
+  using namespace cflExpFit;
+
+  std::vector<Basis> uBasis
+      = { { c_iConst, 0 }, { c_iShape1, 0 }, { c_iShape2, 0 } };
+  std::vector<double> uStart = { 0.05, 0.1, 0.2, 0.4, 0.8, 1.6, 3.2 };
+
+  return Fit (new ExpFit (uBasis, 1, dInitialTime, uStart));
+}
+
+cfl::Fit
+cfl::NFit::svensson (double dInitialTime)
+{
+  using namespace cflExpFit;
+
+  std::vector<Basis> uBasis = { { c_iConst, 0 },
+                                { c_iShape1, 0 },
+                                { c_iShape2, 0 },
+                                { c_iShape2, 1 } };
+  std::vector<double> uLambda = { 0.05, 0.2, 0.8, 3.2 };
+  std::vector<double> uStart;
+  for (double dL1 : uLambda)
+    {
+      for (double dL2 : uLambda)
+        {
+          if (dL1 != dL2)
+            {
+              uStart.push_back (dL1);
+              uStart.push_back (dL2);
+            }
+        }
+    }
+
+  return Fit (new ExpFit (uBasis, 2, dInitialTime, uStart));
+}
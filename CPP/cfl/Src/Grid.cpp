@@ -1,4 +1,6 @@
 #include "cfl/Grid.hpp"
+#include <algorithm>
+#include <numeric>
 
 std::function<double (double)>
 cfl::Grid::widthGauss (double dWidthQuality)
@@ -53,3 +55,60 @@ cfl::Grid::size2 ()
     return iSize;
   };
 }
+
+std::vector<double>
+cfl::Grid::totalVar (const std::vector<double> &rVar,
+                     const std::vector<double> &rEventTimes)
+{
+  PRECONDITION (rEventTimes.size () == rVar.size ());
+
+  std::vector<double> uTotalVar (rVar.size ());
+  double dToday = rEventTimes.front ();
+  std::transform (rVar.begin (), rVar.end (), rEventTimes.begin (),
+                  uTotalVar.begin (), [dToday] (double dVar, double dTime) {
+                    ASSERT (dTime >= dToday);
+                    return dVar * (dTime - dToday);
+                  });
+
+  POSTCONDITION (std::equal (uTotalVar.begin () + 1, uTotalVar.end (),
+                             uTotalVar.begin (), std::greater<double> ()));
+
+  return uTotalVar;
+}
+
+double
+cfl::Grid::minVar (const std::vector<double> &rTotalVar)
+{
+  double dMinVar = std::inner_product (
+      rTotalVar.begin () + 1, rTotalVar.end (), rTotalVar.begin (),
+      cfl::OMEGA, [] (double dX, double dY) { return std::min (dX, dY); },
+      std::minus<double> ());
+
+  ASSERT (dMinVar > cfl::EPS);
+
+  return dMinVar;
+}
+
+std::vector<unsigned>
+cfl::Grid::sizes (const std::vector<double> &rTotalVar, double dH,
+                  double dInterval,
+                  const std::function<double (double)> &rWidth,
+                  const std::function<unsigned (double)> &rSize)
+{
+  std::vector<unsigned> uSize (rTotalVar.size ());
+  std::transform (rTotalVar.begin (), rTotalVar.end (), uSize.begin (),
+                  [&rSize, &rWidth, dH, dInterval] (double dVar) {
+                    double dW = rWidth (dVar);
+
+                    ASSERT (dW > 0);
+
+                    double dSize
+                        = std::max ((dInterval + dW) / dH, 2.) + cfl::EPS;
+                    unsigned iSize = rSize (dSize);
+
+                    ASSERT (iSize * dH > dInterval + dW);
+
+                    return iSize;
+                  });
+  return uSize;
+}
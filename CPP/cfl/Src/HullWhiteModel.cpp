@@ -1,7 +1,7 @@
 #include "cfl/HullWhiteModel.hpp"
 #include "cfl/Data.hpp"
 #include "cfl/Error.hpp"
-#include "cfl/Similar.hpp"
+#include <algorithm>
 #include <limits>
 
 using namespace cfl::HullWhite;
@@ -54,39 +54,157 @@ cfl::HullWhite::makeData (const Function &rDiscount, double dSigma,
 // construction of Hull and White model
 namespace cflHullWhite
 {
+// the discount factors at the event time iTime are c exp(b x), where
+// x is the state; the state is a symmetric uniform grid, so
+// exp(b x) is computed by a recurrence from exp(b h), where h is the
+// step of the grid, and a single maturity costs two exponents
+class Discount
+{
+public:
+  Discount (unsigned iTime, const cfl::HullWhite::Data &rData,
+            const IModel &rModel)
+      : m_rData (rData), m_uState (rModel.state (iTime, 0))
+  {
+    PRECONDITION (iTime < rModel.eventTimes ().size ());
+
+    m_dRefTime = rModel.eventTimes ()[iTime];
+    m_dA = rData.shape (m_dRefTime);
+    m_dC = rData.shape (rModel.eventTimes ().back ());
+    m_dVar = std::pow (rData.volatility (m_dRefTime), 2)
+             * (m_dRefTime - rData.initialTime);
+    m_dRefDiscount = rData.discount (m_dRefTime);
+
+    const std::valarray<double> &rX = m_uState.values ();
+    m_iMid = rX.size () / 2;
+    m_dMid = rX[m_iMid];
+    m_dH = (rX.size () > 1) ? rX[1] - rX[0] : 0.;
+
+    ASSERT (std::abs (rX[rX.size () - 1] - rX[0] - m_dH * (rX.size () - 1))
+            <= cfl::EPS * (1. + std::abs (rX[0])));
+  }
+
+  // adds dWeight times the discount factor with maturity dMaturity
+  // to rSum
+  void
+  add (std::valarray<double> &rSum, double dMaturity, double dWeight) const
+  {
+    PRECONDITION (dMaturity >= m_dRefTime);
+    PRECONDITION (rSum.size () == m_uState.values ().size ());
+
+    double dB = m_rData.shape (dMaturity) - m_dA;
+    double dCoeff = dWeight * m_rData.discount (dMaturity) / m_dRefDiscount
+                    * std::exp (-0.5 * dB * (2. * m_dA + dB - 2. * m_dC)
+                                * m_dVar);
+    double dE = std::exp (dB * m_dH);
+    double dD = dCoeff * std::exp (dB * m_dMid);
+    for (unsigned iI = m_iMid; iI < rSum.size (); iI++)
+      {
+        rSum[iI] += dD;
+        dD *= dE;
+      }
+    dE = 1. / dE;
+    dD = dCoeff * std::exp (dB * m_dMid) * dE;
+    for (unsigned iI = m_iMid; iI-- > 0;)
+      {
+        rSum[iI] += dD;
+        dD *= dE;
+      }
+  }
+
+  Slice
+  slice (const std::valarray<double> &rValues) const
+  {
+    return Slice (m_uState.model (), m_uState.timeIndex (),
+                  m_uState.dependence (), rValues);
+  }
+
+  unsigned
+  size () const
+  {
+    return m_uState.values ().size ();
+  }
+
+private:
+  const cfl::HullWhite::Data &m_rData;
+  Slice m_uState;
+  double m_dRefTime, m_dA, m_dC, m_dVar, m_dRefDiscount, m_dMid, m_dH;
+  unsigned m_iMid;
+};
+
 Slice
 discount (unsigned iTime, double dMaturity, const cfl::HullWhite::Data &rData,
           const IModel &rModel)
 {
-  PRECONDITION (iTime < rModel.eventTimes ().size ());
-  PRECONDITION (dMaturity >= rModel.eventTimes ()[iTime]);
+  Discount uDiscount (iTime, rData, rModel);
+  std::valarray<double> uD (0., uDiscount.size ());
+  uDiscount.add (uD, dMaturity, 1.);
+  return uDiscount.slice (uD);
+}
 
-  double dRefTime = rModel.eventTimes ()[iTime];
-  double dA = rData.shape (dRefTime);
-  double dB = rData.shape (dMaturity);
-  double dC = rData.shape (rModel.eventTimes ().back ());
-  double dVar = std::pow (rData.volatility (dRefTime), 2)
-                * (dRefTime - rData.initialTime);
-  double dForwardDiscount
-      = rData.discount (dMaturity) / rData.discount (dRefTime);
-  Slice uDiscount = exp (rModel.state (iTime, 0) * (dB - dA));
-  uDiscount *= (dForwardDiscount
-                * std::exp (-0.5 * (dB - dA) * (dA + dB - 2. * dC) * dVar));
-  return uDiscount;
+std::vector<Slice>
+discount (unsigned iTime, const std::vector<double> &rMaturities,
+          const cfl::HullWhite::Data &rData, const IModel &rModel)
+{
+  Discount uDiscount (iTime, rData, rModel);
+  std::vector<Slice> uD;
+  uD.reserve (rMaturities.size ());
+  for (double dMaturity : rMaturities)
+    {
+      std::valarray<double> uValues (0., uDiscount.size ());
+      uDiscount.add (uValues, dMaturity, 1.);
+      uD.push_back (uDiscount.slice (uValues));
+    }
+  return uD;
 }
 
-TRollback
-rollback (const IModel &rModel, const HullWhite::Data &rData)
+// the annuity is accumulated in a single buffer
+Slice
+annuity (unsigned iTime, const std::vector<double> &rPaymentTimes,
+         const cfl::HullWhite::Data &rData, const IModel &rModel)
 {
-  return [&rModel, &rData] (Slice &rSlice, unsigned iTime) {
-    PRECONDITION (rSlice.timeIndex () >= iTime);
-    PRECONDITION (&rSlice.model () == &rModel);
-
-    double dMaturity = rModel.eventTimes ().back ();
-    rSlice /= discount (rSlice.timeIndex (), dMaturity, rData, rModel);
-    rSlice.rollback (iTime);
-    rSlice *= discount (iTime, dMaturity, rData, rModel);
-  };
+  Discount uDiscount (iTime, rData, rModel);
+  std::valarray<double> uAnnuity (0., uDiscount.size ());
+  double dStart = rModel.eventTimes ()[iTime];
+  for (double dPayment : rPaymentTimes)
+    {
+      uDiscount.add (uAnnuity, dPayment, dPayment - dStart);
+      dStart = dPayment;
+    }
+  return uDiscount.slice (uAnnuity);
+}
+
+std::vector<double>
+variance (const HullWhite::Data &rData, const std::vector<double> &rEventTimes)
+{
+  std::vector<double> uVar (rEventTimes.size ());
+  std::transform (rEventTimes.begin (), rEventTimes.end (), uVar.begin (),
+                  [&rData] (double dTime) {
+                    return std::pow (rData.volatility (dTime), 2);
+                  });
+  return uVar;
+}
+
+// the numeraire is the price of the discount bond with the last event
+// time as maturity; its logarithm is a_i + b_i x
+void
+numeraire (const HullWhite::Data &rData, const std::vector<double> &rVar,
+           const std::vector<double> &rEventTimes, std::vector<double> &rShift,
+           std::vector<double> &rSlope)
+{
+  double dMaturity = rEventTimes.back ();
+  double dB = rData.shape (dMaturity);
+  rShift.resize (rEventTimes.size ());
+  rSlope.resize (rEventTimes.size ());
+  for (unsigned iI = 0; iI < rEventTimes.size (); iI++)
+    {
+      double dRefTime = rEventTimes[iI];
+      double dA = rData.shape (dRefTime);
+      double dVar = rVar[iI] * (dRefTime - rData.initialTime);
+      rShift[iI]
+          = std::log (rData.discount (dMaturity) / rData.discount (dRefTime))
+            + 0.5 * (dB - dA) * (dB - dA) * dVar;
+      rSlope[iI] = dB - dA;
+    }
 }
 
 class Model : public IInterestRateModel
@@ -94,18 +212,51 @@ class Model : public IInterestRateModel
 public:
   Model (const HullWhite::Data &rData, const std::vector<double> &rEventTimes,
          double dInterval, const TBrownian &rBrownian)
-      : m_uData (rData), m_dInterval (dInterval), m_uBrownian (rBrownian)
+      : m_uData (rData), m_dInterval (dInterval), m_uBrownian (rBrownian),
+        m_uVar (variance (rData, rEventTimes))
   {
     PRECONDITION (rEventTimes.front () == rData.initialTime);
 
-    std::vector<double> uVar (rEventTimes.size ());
-    std::transform (rEventTimes.begin (), rEventTimes.end (), uVar.begin (),
-                    [&rData] (double dTime) {
-                      return std::pow (rData.volatility (dTime), 2);
-                    });
-    cfl::Model uBrownian = m_uBrownian (uVar, rEventTimes, dInterval);
-    TRollback uRollback = rollback (uBrownian.model (), m_uData);
-    m_uModel = similar (uRollback, uBrownian);
+    std::vector<double> uSlope;
+    cflHullWhite::numeraire (rData, m_uVar, rEventTimes, m_uShift, uSlope);
+    cfl::Model uBrownian = m_uBrownian (m_uVar, rEventTimes, dInterval);
+    m_uModel = cfl::numeraire (uBrownian, m_uShift, uSlope);
+  }
+
+  // the lattice of rModel with the discount curve of rData; the
+  // slopes of the numeraire are the same and only the shifts change
+  Model (const Model &rModel, const HullWhite::Data &rData)
+      : m_uData (rData), m_dInterval (rModel.m_dInterval),
+        m_uBrownian (rModel.m_uBrownian), m_uVar (rModel.m_uVar)
+  {
+    std::vector<double> uSlope;
+    cflHullWhite::numeraire (rData, m_uVar, rModel.model ().eventTimes (),
+                             m_uShift, uSlope);
+    std::vector<double> uShift (m_uShift);
+    for (unsigned iI = 0; iI < uShift.size (); iI++)
+      {
+        uShift[iI] -= rModel.m_uShift[iI];
+      }
+    std::fill (uSlope.begin (), uSlope.end (), 0.);
+    m_uModel = cfl::numeraire (rModel.m_uModel, uShift, uSlope);
+  }
+
+  IInterestRateModel *
+  rebind (const HullWhite::Data &rData) const
+  {
+    const std::vector<double> &rEventTimes = model ().eventTimes ();
+    bool bSame = (rData.initialTime == m_uData.initialTime)
+                 && (variance (rData, rEventTimes) == m_uVar)
+                 && std::all_of (rEventTimes.begin (), rEventTimes.end (),
+                                 [&] (double dTime) {
+                                   return rData.shape (dTime)
+                                          == m_uData.shape (dTime);
+                                 });
+    if (!bSame)
+      {
+        return new Model (rData, rEventTimes, m_dInterval, m_uBrownian);
+      }
+    return new Model (*this, rData);
   }
 
   IInterestRateModel *
@@ -135,10 +286,23 @@ public:
     return cflHullWhite::discount (iTime, dMaturity, m_uData, model ());
   }
 
+  std::vector<Slice>
+  discount (unsigned iTime, const std::vector<double> &rMaturities) const
+  {
+    return cflHullWhite::discount (iTime, rMaturities, m_uData, model ());
+  }
+
+  Slice
+  annuity (unsigned iTime, const std::vector<double> &rPaymentTimes) const
+  {
+    return cflHullWhite::annuity (iTime, rPaymentTimes, m_uData, model ());
+  }
+
 private:
   HullWhite::Data m_uData;
   double m_dInterval;
   TBrownian m_uBrownian;
+  std::vector<double> m_uVar, m_uShift;
   cfl::Model m_uModel;
 };
 } // namespace cflHullWhite
@@ -153,3 +317,20 @@ cfl::HullWhite::model (const HullWhite::Data &rData, double dInterval,
   return InterestRateModel (
       new cflHullWhite::Model (rData, uEventTimes, dInterval, rBrownian));
 }
+
+// function cfl::HullWhite::rebind
+InterestRateModel
+cfl::HullWhite::rebind (const InterestRateModel &rModel,
+                        const HullWhite::Data &rData)
+{
+  const cflHullWhite::Model *pModel
+      = dynamic_cast<const cflHullWhite::Model *> (&rModel.implementation ());
+
+  if (!pModel)
+    {
+      throw (
+          NError::range ("the model is not constructed by HullWhite::model"));
+    }
+
+  return InterestRateModel (pModel->rebind (rData));
+}
@@ -1,4 +1,5 @@
 #include "cfl/InterestRateModel.hpp"
+#include <algorithm>
 
 using namespace cfl;
 
@@ -6,3 +7,45 @@ cfl::InterestRateModel::InterestRateModel (IInterestRateModel *pNewModel)
     : m_pModel (pNewModel)
 {
 }
+
+// class IInterestRateModel
+
+std::vector<Slice>
+cfl::IInterestRateModel::discount (
+    unsigned iTime, const std::vector<double> &rBondMaturities) const
+{
+  std::vector<Slice> uDiscount;
+  uDiscount.reserve (rBondMaturities.size ());
+  for (double dMaturity : rBondMaturities)
+    {
+      uDiscount.push_back (discount (iTime, dMaturity));
+    }
+  return uDiscount;
+}
+
+Slice
+cfl::IInterestRateModel::annuity (
+    unsigned iTime, const std::vector<double> &rPaymentTimes) const
+{
+  Slice uAnnuity (&model (), iTime, 0.);
+  double dStart = model ().eventTimes ()[iTime];
+  for (double dPayment : rPaymentTimes)
+    {
+      uAnnuity += discount (iTime, dPayment) * (dPayment - dStart);
+      dStart = dPayment;
+    }
+  return uAnnuity;
+}
+
+// class InterestRateModel
+
+Slice
+cfl::InterestRateModel::annuity (unsigned iTime,
+                                 const std::vector<double> &rPaymentTimes) const
+{
+  PRECONDITION (rPaymentTimes.size () > 0);
+  PRECONDITION (std::equal (rPaymentTimes.begin () + 1, rPaymentTimes.end (),
+                            rPaymentTimes.begin (), std::greater<double> ()));
+
+  return m_pModel->annuity (iTime, rPaymentTimes);
+}
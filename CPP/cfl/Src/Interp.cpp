@@ -1,9 +1,26 @@
 #include "cfl/Interp.hpp"
 #include "cfl/Error.hpp"
+#include "cfl/Macros.hpp"
+#include <algorithm>
+#include <cmath>
 #include <gsl/gsl_spline.h>
 
 using namespace cfl;
 
+// class IInterp
+
+std::valarray<double>
+cfl::IInterp::values (const std::valarray<double> &rArg, unsigned iDeriv) const
+{
+  PRECONDITION (iDeriv <= 2);
+
+  Function uF = (iDeriv == 0) ? interp () : (iDeriv == 1) ? deriv () : deriv2 ();
+  std::valarray<double> uVal (rArg.size ());
+  std::transform (std::begin (rArg), std::end (rArg), std::begin (uVal),
+                  [&uF] (double dX) { return uF (dX); });
+  return uVal;
+}
+
 // class Interp
 
 cfl::Interp::Interp (IInterp *pNewP) : m_uP (pNewP) {}
@@ -84,30 +101,418 @@ private:
   double m_dL, m_dR;
 };
 
+// piecewise cubic interpolation
+
+namespace cflInterp
+{
+enum class Type
+{
+  linear,
+  cspline,
+  steffen,
+  akima
+};
+
+// the same thresholds as for the interpolation types of GSL
+unsigned
+minSize (Type eType)
+{
+  switch (eType)
+    {
+    case Type::linear:
+      return 2;
+    case Type::akima:
+      return 5;
+    default:
+      return 3;
+    }
+}
+
+// Immutable table of coefficients of the cubic polynomials
+// a + b h + c h^2 + d h^3, where h = x - x_i and x_i <= x <= x_(i+1).
+class Spline
+{
+public:
+  Spline (const std::vector<double> &rArg, const std::vector<double> &rVal,
+          Type eType);
+
+  unsigned
+  bin (double dX) const
+  {
+    if (m_dInvStep > 0)
+      {
+        double dI = (dX - m_uX.front ()) * m_dInvStep;
+        dI = (dI > 0.) ? dI : 0.;
+        dI = (dI < m_dLast) ? dI : m_dLast;
+        return static_cast<unsigned> (dI);
+      }
+    // branchless binary search over the left ends of intervals
+    const double *pX = m_uX.data ();
+    unsigned iLength = m_uX.size () - 1;
+    while (iLength > 1)
+      {
+        unsigned iHalf = iLength / 2;
+        pX = (pX[iHalf] <= dX) ? pX + iHalf : pX;
+        iLength -= iHalf;
+      }
+    return pX - m_uX.data ();
+  }
+
+  template <unsigned iDeriv>
+  double
+  eval (unsigned iI, double dX) const
+  {
+    const double *pC = m_uC.data () + 4 * iI;
+    double dH = dX - m_uX[iI];
+    if constexpr (iDeriv == 0)
+      {
+        return pC[0] + dH * (pC[1] + dH * (pC[2] + dH * pC[3]));
+      }
+    else if constexpr (iDeriv == 1)
+      {
+        return pC[1] + dH * (2. * pC[2] + 3. * dH * pC[3]);
+      }
+    else
+      {
+        return 2. * pC[2] + 6. * dH * pC[3];
+      }
+  }
+
+  template <unsigned iDeriv>
+  double
+  eval (double dX) const
+  {
+    return eval<iDeriv> (bin (dX), dX);
+  }
+
+  template <unsigned iDeriv>
+  void
+  eval (const std::valarray<double> &rArg, std::valarray<double> &rVal) const
+  {
+    if (rArg.size () == 0)
+      {
+        return;
+      }
+    if (m_dInvStep > 0)
+      {
+        for (unsigned iK = 0; iK < rArg.size (); iK++)
+          {
+            rVal[iK] = eval<iDeriv> (rArg[iK]);
+          }
+        return;
+      }
+    // the arguments are sorted: we walk the knots together with them
+    unsigned iI = bin (rArg[0]);
+    unsigned iLast = m_uX.size () - 2;
+    for (unsigned iK = 0; iK < rArg.size (); iK++)
+      {
+        while ((iI < iLast) && (m_uX[iI + 1] <= rArg[iK]))
+          {
+            iI++;
+          }
+        rVal[iK] = eval<iDeriv> (iI, rArg[iK]);
+      }
+  }
+
+private:
+  void hermite (const std::vector<double> &rVal,
+                const std::vector<double> &rSlope);
+  void linear (const std::vector<double> &rVal);
+  void cspline (const std::vector<double> &rVal);
+  void steffen (const std::vector<double> &rVal);
+  void akima (const std::vector<double> &rVal);
+
+  std::vector<double> m_uX, m_uC;
+  double m_dInvStep, m_dLast;
+};
+
+Spline::Spline (const std::vector<double> &rArg,
+                const std::vector<double> &rVal, Type eType)
+    : m_uX (rArg), m_uC (4 * (rArg.size () - 1)), m_dInvStep (0.),
+      m_dLast (rArg.size () - 2)
+{
+  PRECONDITION ((rArg.size () == rVal.size ()) && (rArg.size () >= 2));
+  PRECONDITION (
+      std::is_sorted (rArg.begin (), rArg.end (), std::less_equal<double> ()));
+
+  // if size is not sufficient we do linear interpolation
+  if (rArg.size () <= minSize (eType))
+    {
+      eType = Type::linear;
+    }
+  switch (eType)
+    {
+    case Type::linear:
+      linear (rVal);
+      break;
+    case Type::cspline:
+      cspline (rVal);
+      break;
+    case Type::steffen:
+      steffen (rVal);
+      break;
+    case Type::akima:
+      akima (rVal);
+      break;
+    }
+
+  // constant time search on evenly spaced arguments
+  unsigned iN = m_uX.size () - 1;
+  double dStep = (m_uX.back () - m_uX.front ()) / iN;
+  bool bUniform = true;
+  for (unsigned iI = 1; bUniform && (iI < iN); iI++)
+    {
+      bUniform = std::abs (m_uX[iI] - m_uX.front () - iI * dStep)
+                 <= cfl::EPS * dStep;
+    }
+  if (bUniform)
+    {
+      m_dInvStep = 1. / dStep;
+    }
+}
+
+void
+Spline::linear (const std::vector<double> &rVal)
+{
+  for (unsigned iI = 0; iI + 1 < m_uX.size (); iI++)
+    {
+      double *pC = m_uC.data () + 4 * iI;
+      pC[0] = rVal[iI];
+      pC[1] = (rVal[iI + 1] - rVal[iI]) / (m_uX[iI + 1] - m_uX[iI]);
+      pC[2] = 0.;
+      pC[3] = 0.;
+    }
+}
+
+// cubic polynomials from the values and the derivatives at the nodes
+void
+Spline::hermite (const std::vector<double> &rVal,
+                 const std::vector<double> &rSlope)
+{
+  for (unsigned iI = 0; iI + 1 < m_uX.size (); iI++)
+    {
+      double *pC = m_uC.data () + 4 * iI;
+      double dH = m_uX[iI + 1] - m_uX[iI];
+      double dS = (rVal[iI + 1] - rVal[iI]) / dH;
+      pC[0] = rVal[iI];
+      pC[1] = rSlope[iI];
+      pC[2] = (3. * dS - 2. * rSlope[iI] - rSlope[iI + 1]) / dH;
+      pC[3] = (rSlope[iI] + rSlope[iI + 1] - 2. * dS) / (dH * dH);
+    }
+}
+
+// natural cubic spline
+void
+Spline::cspline (const std::vector<double> &rVal)
+{
+  unsigned iN = m_uX.size ();
+  std::vector<double> uH (iN - 1), uS (iN - 1);
+  for (unsigned iI = 0; iI + 1 < iN; iI++)
+    {
+      uH[iI] = m_uX[iI + 1] - m_uX[iI];
+      uS[iI] = (rVal[iI + 1] - rVal[iI]) / uH[iI];
+    }
+
+  // tridiagonal system for the halves of the second derivatives
+  std::vector<double> uC (iN, 0.), uDiag (iN, 0.);
+  for (unsigned iI = 1; iI + 1 < iN; iI++)
+    {
+      uDiag[iI] = 2. * (uH[iI - 1] + uH[iI]);
+      uC[iI] = 3. * (uS[iI] - uS[iI - 1]);
+      if (iI > 1)
+        {
+          double dW = uH[iI - 1] / uDiag[iI - 1];
+          uDiag[iI] -= dW * uH[iI - 1];
+          uC[iI] -= dW * uC[iI - 1];
+        }
+    }
+  for (unsigned iI = iN - 2; iI > 0; iI--)
+    {
+      uC[iI] = (uC[iI] - uH[iI] * uC[iI + 1]) / uDiag[iI];
+    }
+
+  for (unsigned iI = 0; iI + 1 < iN; iI++)
+    {
+      double *pC = m_uC.data () + 4 * iI;
+      pC[0] = rVal[iI];
+      pC[1] = uS[iI] - uH[iI] * (uC[iI + 1] + 2. * uC[iI]) / 3.;
+      pC[2] = uC[iI];
+      pC[3] = (uC[iI + 1] - uC[iI]) / (3. * uH[iI]);
+    }
+}
+
+// monotone interpolation of Steffen (1990) with the boundary
+// conditions of GSL: the end slopes are the slopes of the end segments
+void
+Spline::steffen (const std::vector<double> &rVal)
+{
+  unsigned iN = m_uX.size ();
+  std::vector<double> uH (iN - 1), uS (iN - 1), uSlope (iN);
+  for (unsigned iI = 0; iI + 1 < iN; iI++)
+    {
+      uH[iI] = m_uX[iI + 1] - m_uX[iI];
+      uS[iI] = (rVal[iI + 1] - rVal[iI]) / uH[iI];
+    }
+
+  uSlope[0] = uS[0];
+  for (unsigned iI = 1; iI + 1 < iN; iI++)
+    {
+      double dP = (uS[iI - 1] * uH[iI] + uS[iI] * uH[iI - 1])
+                  / (uH[iI - 1] + uH[iI]);
+      uSlope[iI] = (std::copysign (1., uS[iI - 1]) + std::copysign (1., uS[iI]))
+                   * std::min ({ std::abs (uS[iI - 1]), std::abs (uS[iI]),
+                                 0.5 * std::abs (dP) });
+    }
+  uSlope[iN - 1] = uS[iN - 2];
+
+  hermite (rVal, uSlope);
+}
+
+// Akima (1970) interpolation with the boundary conditions of GSL
+void
+Spline::akima (const std::vector<double> &rVal)
+{
+  unsigned iN = m_uX.size ();
+  // uM[iI + 2] is the slope of the segment iI, -2 <= iI <= iN
+  std::vector<double> uM (iN + 3);
+  for (unsigned iI = 0; iI + 1 < iN; iI++)
+    {
+      uM[iI + 2] = (rVal[iI + 1] - rVal[iI]) / (m_uX[iI + 1] - m_uX[iI]);
+    }
+  uM[0] = 3. * uM[2] - 2. * uM[3];
+  uM[1] = 2. * uM[2] - uM[3];
+  uM[iN + 1] = 2. * uM[iN] - uM[iN - 1];
+  uM[iN + 2] = 3. * uM[iN] - 2. * uM[iN - 1];
+
+  for (unsigned iI = 0; iI + 1 < iN; iI++)
+    {
+      const double *pM = uM.data () + iI + 2;
+      double *pC = m_uC.data () + 4 * iI;
+      pC[0] = rVal[iI];
+      double dNE = std::abs (pM[1] - pM[0]) + std::abs (pM[-1] - pM[-2]);
+      if (dNE == 0.)
+        {
+          pC[1] = pM[0];
+          pC[2] = 0.;
+          pC[3] = 0.;
+          continue;
+        }
+      double dH = m_uX[iI + 1] - m_uX[iI];
+      double dNENext = std::abs (pM[2] - pM[1]) + std::abs (pM[0] - pM[-1]);
+      double dAlpha = std::abs (pM[-1] - pM[-2]) / dNE;
+      double dSlopeNext = pM[0];
+      if (dNENext != 0.)
+        {
+          double dAlphaNext = std::abs (pM[0] - pM[-1]) / dNENext;
+          dSlopeNext = (1. - dAlphaNext) * pM[0] + dAlphaNext * pM[1];
+        }
+      pC[1] = (1. - dAlpha) * pM[-1] + dAlpha * pM[0];
+      pC[2] = (3. * pM[0] - 2. * pC[1] - dSlopeNext) / dH;
+      pC[3] = (pC[1] + dSlopeNext - 2. * pM[0]) / (dH * dH);
+    }
+}
+
+// class Interp_Spline
+
+class Interp_Spline : public IInterp
+{
+public:
+  Interp_Spline (Type eType) : m_eType (eType) {}
+
+  Interp_Spline (const std::vector<double> &rArg,
+                 const std::vector<double> &rVal, Type eType)
+      : m_eType (eType), m_uS (new Spline (rArg, rVal, eType)),
+        m_dL (rArg.front ()), m_dR (rArg.back ())
+  {
+  }
+
+  IInterp *
+  newObject (const std::vector<double> &rArg,
+             const std::vector<double> &rVal) const
+  {
+    return new Interp_Spline (rArg, rVal, m_eType);
+  }
+
+  Function
+  interp () const
+  {
+    return function<0> ();
+  }
+
+  Function
+  deriv () const
+  {
+    return function<1> ();
+  }
+
+  Function
+  deriv2 () const
+  {
+    return function<2> ();
+  }
+
+  std::valarray<double>
+  values (const std::valarray<double> &rArg, unsigned iDeriv) const
+  {
+    PRECONDITION (iDeriv <= 2);
+    PRECONDITION (std::is_sorted (std::begin (rArg), std::end (rArg)));
+
+    std::valarray<double> uVal (rArg.size ());
+    switch (iDeriv)
+      {
+      case 0:
+        m_uS->eval<0> (rArg, uVal);
+        break;
+      case 1:
+        m_uS->eval<1> (rArg, uVal);
+        break;
+      default:
+        m_uS->eval<2> (rArg, uVal);
+      }
+    return uVal;
+  }
+
+private:
+  template <unsigned iDeriv>
+  Function
+  function () const
+  {
+    std::function<double (double)> uF
+        = [uS = m_uS] (double dX) { return uS->eval<iDeriv> (dX); };
+
+    return Function (uF, m_dL, m_dR);
+  }
+
+  Type m_eType;
+  std::shared_ptr<const Spline> m_uS;
+  double m_dL, m_dR;
+};
+} // namespace cflInterp
+
 // functions from NInterp
 
 cfl::Interp
 cfl::NInterp::linear ()
 {
-  return Interp (new Interp_GSL (gsl_interp_linear));
+  return Interp (new cflInterp::Interp_Spline (cflInterp::Type::linear));
 }
 
 cfl::Interp
 cfl::NInterp::cspline ()
 {
-  return Interp (new Interp_GSL (gsl_interp_cspline));
+  return Interp (new cflInterp::Interp_Spline (cflInterp::Type::cspline));
 }
 
 cfl::Interp
 cfl::NInterp::steffen ()
 {
-  return Interp (new Interp_GSL (gsl_interp_steffen));
+  return Interp (new cflInterp::Interp_Spline (cflInterp::Type::steffen));
 }
 
 cfl::Interp
 cfl::NInterp::akima ()
 {
-  return Interp (new Interp_GSL (gsl_interp_akima));
+  return Interp (new cflInterp::Interp_Spline (cflInterp::Type::akima));
 }
 
 cfl::Interp
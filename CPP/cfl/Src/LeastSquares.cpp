@@ -0,0 +1,139 @@
+#include "cfl/LeastSquares.hpp"
+#include "cfl/Error.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace cfl;
+
+namespace cflLeastSquares
+{
+const double c_dMaxMu = 1E+12; // the damping of the steps
+const double c_dMu = 1E-3;     // the initial damping
+
+// solves rA x = -rG for the symmetric positive definite matrix rA by
+// Cholesky decomposition in place; returns false if rA is not
+// positive definite
+bool
+solve (std::vector<double> &rA, const std::vector<double> &rG,
+       std::vector<double> &rX)
+{
+  unsigned iN = rG.size ();
+  for (unsigned iJ = 0; iJ < iN; iJ++)
+    {
+      double dD = rA[iJ * iN + iJ];
+      for (unsigned iK = 0; iK < iJ; iK++)
+        {
+          dD -= rA[iJ * iN + iK] * rA[iJ * iN + iK];
+        }
+      if (!(dD > 0))
+        {
+          return false;
+        }
+      dD = std::sqrt (dD);
+      rA[iJ * iN + iJ] = dD;
+      for (unsigned iI = iJ + 1; iI < iN; iI++)
+        {
+          double dS = rA[iI * iN + iJ];
+          for (unsigned iK = 0; iK < iJ; iK++)
+            {
+              dS -= rA[iI * iN + iK] * rA[iJ * iN + iK];
+            }
+          rA[iI * iN + iJ] = dS / dD;
+        }
+    }
+  for (unsigned iI = 0; iI < iN; iI++)
+    {
+      double dS = -rG[iI];
+      for (unsigned iK = 0; iK < iI; iK++)
+        {
+          dS -= rA[iI * iN + iK] * rX[iK];
+        }
+      rX[iI] = dS / rA[iI * iN + iI];
+    }
+  for (unsigned iI = iN; iI-- > 0;)
+    {
+      double dS = rX[iI];
+      for (unsigned iK = iI + 1; iK < iN; iK++)
+        {
+          dS -= rA[iK * iN + iI] * rX[iK];
+        }
+      rX[iI] = dS / rA[iI * iN + iI];
+    }
+  return true;
+}
+} // namespace cflLeastSquares
+
+using namespace cflLeastSquares;
+
+// class Levenberg
+
+cfl::Levenberg::Levenberg (double dRelErr, double dStepErr, double dLower,
+                           double dUpper, unsigned iMaxSteps)
+    : m_dRelErr (dRelErr), m_dStepErr (dStepErr), m_dLower (dLower),
+      m_dUpper (dUpper), m_iMaxSteps (iMaxSteps)
+{
+  PRECONDITION ((dRelErr >= 0) && (dStepErr >= 0));
+  PRECONDITION (dLower < dUpper);
+}
+
+double
+cfl::Levenberg::minimize (const TAssign &rAssign, const TNormal &rNormal,
+                          std::vector<double> &rTheta) const
+{
+  double dChi2 = rAssign (rTheta);
+  if (!std::isfinite (dChi2))
+    {
+      return dChi2;
+    }
+  unsigned iP = rTheta.size ();
+  std::vector<double> uH (iP * iP), uA (iP * iP), uG (iP), uDelta (iP);
+  std::vector<double> uTheta (iP);
+  double dMu = c_dMu;
+  for (unsigned iIter = 0; (iIter < m_iMaxSteps) && (dChi2 > 0); iIter++)
+    {
+      rNormal (uG, uH);
+      double dChi2New = dChi2;
+      double dStep = 0.;
+      while (dMu < c_dMaxMu)
+        {
+          uA = uH;
+          for (unsigned iK = 0; iK < iP; iK++)
+            {
+              uA[iK * iP + iK] *= 1. + dMu;
+              uA[iK * iP + iK] += cfl::EPS * dMu;
+            }
+          if (solve (uA, uG, uDelta))
+            {
+              dStep = 0.;
+              for (unsigned iK = 0; iK < iP; iK++)
+                {
+                  uTheta[iK] = std::min (
+                      std::max (rTheta[iK] + uDelta[iK], m_dLower), m_dUpper);
+                  dStep = std::max (dStep, std::abs (uTheta[iK] - rTheta[iK]));
+                }
+              dChi2New = rAssign (uTheta);
+              if (dChi2New < dChi2)
+                {
+                  break;
+                }
+            }
+          dMu *= 4.;
+        }
+      if (!(dChi2New < dChi2))
+        {
+          // no progress: we restore the state at rTheta
+          rAssign (rTheta);
+          break;
+        }
+      dMu = std::max (dMu / 12., cfl::EPS);
+      rTheta = uTheta;
+      bool bStop = (dStep < m_dStepErr)
+                   || (dChi2 - dChi2New <= m_dRelErr * dChi2New);
+      dChi2 = dChi2New;
+      if (bStop)
+        {
+          break;
+        }
+    }
+  return dChi2;
+}
@@ -0,0 +1,146 @@
+#include "cfl/LocalVolModel.hpp"
+#include "cfl/Brownian.hpp"
+#include "cfl/Error.hpp"
+#include <cmath>
+
+using namespace cfl::LocalVol;
+using namespace cfl;
+
+// class LocalVol::Data
+cfl::LocalVol::Data
+cfl::LocalVol::makeData (const Function &rDiscount, const Function &rForward,
+                         const std::function<Function (double)> &rVolatility,
+                         double dInitialTime)
+{
+  cfl::LocalVol::Data uData;
+  uData.discount = rDiscount;
+  uData.forward = rForward;
+  uData.volatility = rVolatility;
+  uData.initialTime = dInitialTime;
+
+  return uData;
+}
+
+cfl::LocalVol::Data
+cfl::LocalVol::makeData (const Function &rDiscount, const Function &rForward,
+                         const Function &rVolatility, double dInitialTime)
+{
+  std::function<Function (double)> uVolatility
+      = [rVolatility] (double dTime) { return rVolatility; };
+
+  return makeData (rDiscount, rForward, uVolatility, dInitialTime);
+}
+
+// construction of local volatility model
+namespace cflLocalVol
+{
+class LocalVolModel : public IAssetModel
+{
+public:
+  LocalVolModel (const LocalVol::Data &rData,
+                 const std::vector<double> &rEventTimes, double dInterval,
+                 const TDiffusion &rDiffusion)
+      : m_uData (rData), m_dInterval (dInterval), m_uDiffusion (rDiffusion)
+  {
+    ASSERT (rEventTimes.front () == rData.initialTime);
+
+    // the state is the logarithm of the spot price divided by its
+    // initial forward price; it has the drift -0.5 * sigma^2
+    TCoefficient uVolatility = [rData] (double dTime,
+                                        const std::valarray<double> &rX) {
+      Function uVol = rData.volatility (dTime);
+      double dForward = rData.forward (dTime);
+      std::valarray<double> uSigma (rX.size ());
+      for (unsigned iI = 0; iI < rX.size (); iI++)
+        {
+          uSigma[iI] = uVol (dForward * std::exp (rX[iI]));
+        }
+      return uSigma;
+    };
+    TCoefficient uDrift = [uVolatility] (double dTime,
+                                         const std::valarray<double> &rX) {
+      std::valarray<double> uSigma = uVolatility (dTime, rX);
+      return std::valarray<double> (-0.5 * uSigma * uSigma);
+    };
+    TCoefficient uRate = [] (double dTime, const std::valarray<double> &rX) {
+      return std::valarray<double> (0., rX.size ());
+    };
+
+    // the grid is defined by the local volatility at the forward
+    // price
+    std::vector<double> uVar (rEventTimes.size ());
+    double dTotalVar = 0.;
+    uVar.front () = std::pow (
+        rData.volatility (rData.initialTime) (rData.forward (rData.initialTime)),
+        2);
+    for (unsigned iI = 1; iI < rEventTimes.size (); iI++)
+      {
+        double dTime = 0.5 * (rEventTimes[iI - 1] + rEventTimes[iI]);
+        double dSigma = rData.volatility (dTime) (rData.forward (dTime));
+        dTotalVar += dSigma * dSigma * (rEventTimes[iI] - rEventTimes[iI - 1]);
+        uVar[iI] = dTotalVar / (rEventTimes[iI] - rData.initialTime);
+      }
+
+    // the numeraire is the inverse of the discount factor
+    std::vector<double> uShift (rEventTimes.size ());
+    std::transform (rEventTimes.begin (), rEventTimes.end (), uShift.begin (),
+                    [&rData] (double dTime) {
+                      return -std::log (rData.discount (dTime));
+                    });
+    std::vector<double> uSlope (rEventTimes.size (), 0.);
+    cfl::Model uDiffusion = m_uDiffusion (uDrift, uVolatility, uRate, uVar,
+                                          rEventTimes, dInterval);
+    m_uModel = numeraire (uDiffusion, uShift, uSlope);
+  }
+
+  IAssetModel *
+  newModel (const std::vector<double> &rEventTimes) const
+  {
+    return new LocalVolModel (m_uData, rEventTimes, m_dInterval,
+                              m_uDiffusion);
+  }
+
+  const IModel &
+  model () const
+  {
+    return m_uModel.model ();
+  }
+
+  Slice
+  discount (unsigned iTime, double dMaturity) const
+  {
+    double dTime = model ().eventTimes ()[iTime];
+    double dFactor = m_uData.discount (dMaturity) / m_uData.discount (dTime);
+    return Slice (&model (), iTime, dFactor);
+  }
+
+  Slice
+  forward (unsigned iTime, double dForwardMaturity) const
+  {
+    PRECONDITION (iTime < model ().eventTimes ().size ());
+    PRECONDITION (dForwardMaturity >= model ().eventTimes ()[iTime]);
+
+    // forward price = F(t_0,T) * exp(state)
+    double dForward = m_uData.forward (dForwardMaturity);
+
+    return exp (model ().state (iTime, 0)) * dForward;
+  }
+
+private:
+  LocalVol::Data m_uData;
+  double m_dInterval;
+  TDiffusion m_uDiffusion;
+  cfl::Model m_uModel;
+};
+} // namespace cflLocalVol
+
+// function cfl::LocalVol::model
+AssetModel
+cfl::LocalVol::model (const Data &rData, double dInterval,
+                      const TDiffusion &rDiffusion)
+{
+  std::vector<double> uEventTimes (1, rData.initialTime);
+
+  return AssetModel (new cflLocalVol::LocalVolModel (rData, uEventTimes,
+                                                     dInterval, rDiffusion));
+}
@@ -1,8 +1,17 @@
 #include "cfl/Model.hpp"
+#include "cfl/Error.hpp"
 #include "cfl/Slice.hpp"
 
 using namespace cfl;
 
+// class IModel
+
+void
+cfl::IModel::adjointRollback (Slice &, unsigned) const
+{
+  throw (NError::range ("adjoint rollback"));
+}
+
 // class Model
 
 cfl::Model::Model (IModel *pNewModel) : m_pModel (pNewModel) {}
@@ -0,0 +1,848 @@
+#include "cfl/MonteCarlo.hpp"
+#include "cfl/Error.hpp"
+#include "cfl/Fit.hpp"
+#include "cfl/Parallel.hpp"
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <gsl/gsl_cdf.h>
+
+using namespace cfl;
+using namespace cfl::MonteCarlo;
+
+namespace cflMonteCarlo
+{
+// counter-based generator Philox4x32-10 of Salmon, Moraes, Dror and
+// Shaw
+class Philox
+{
+public:
+  Philox (unsigned long iSeed)
+      : m_iKey0 (uint32_t (iSeed)), m_iKey1 (uint32_t (uint64_t (iSeed) >> 32))
+  {
+  }
+
+  // four independent standard normal variables for the counter
+  void
+  normal (unsigned long iPath, unsigned iBlock, double *pZ) const
+  {
+    uint32_t uC[4] = { uint32_t (iPath), uint32_t (uint64_t (iPath) >> 32),
+                       uint32_t (iBlock), 0 };
+    uint32_t iK0 = m_iKey0, iK1 = m_iKey1;
+    for (unsigned iR = 0; iR < 10; iR++)
+      {
+        uint64_t iP0 = uint64_t (0xD2511F53) * uC[0];
+        uint64_t iP1 = uint64_t (0xCD9E8D57) * uC[2];
+        uint32_t uN[4] = { uint32_t (iP1 >> 32) ^ uC[1] ^ iK0, uint32_t (iP1),
+                           uint32_t (iP0 >> 32) ^ uC[3] ^ iK1,
+                           uint32_t (iP0) };
+        std::copy (uN, uN + 4, uC);
+        iK0 += 0x9E3779B9;
+        iK1 += 0xBB67AE85;
+      }
+    // the Box-Muller transform of uniforms in (0,1)
+    for (unsigned iI = 0; iI < 4; iI += 2)
+      {
+        double dU1 = (uC[iI] + 0.5) * c_dScale;
+        double dU2 = (uC[iI + 1] + 0.5) * c_dScale;
+        double dR = std::sqrt (-2. * std::log (dU1));
+        pZ[iI] = dR * std::cos (2. * M_PI * dU2);
+        pZ[iI + 1] = dR * std::sin (2. * M_PI * dU2);
+      }
+  }
+
+private:
+  static constexpr double c_dScale = 1. / 4294967296.;
+  uint32_t m_iKey0, m_iKey1;
+};
+
+// the number of binary digits of the Sobol points
+const unsigned c_iBits = 32;
+
+// the mixing function of splitmix64
+uint64_t
+hash (uint64_t iX)
+{
+  iX += 0x9E3779B97F4A7C15ULL;
+  iX = (iX ^ (iX >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  iX = (iX ^ (iX >> 27)) * 0x94D049BB133111EBULL;
+  return iX ^ (iX >> 31);
+}
+
+uint32_t
+reverse (uint32_t iX)
+{
+  iX = ((iX >> 1) & 0x55555555u) | ((iX & 0x55555555u) << 1);
+  iX = ((iX >> 2) & 0x33333333u) | ((iX & 0x33333333u) << 2);
+  iX = ((iX >> 4) & 0x0F0F0F0Fu) | ((iX & 0x0F0F0F0Fu) << 4);
+  iX = ((iX >> 8) & 0x00FF00FFu) | ((iX & 0x00FF00FFu) << 8);
+  return (iX >> 16) | (iX << 16);
+}
+
+// nested uniform scrambling: in the reversed order of digits every
+// digit is flipped by a hash of the previous digits (Laine and
+// Karras, Burley)
+uint32_t
+scramble (uint32_t iX, uint32_t iSeed)
+{
+  iX = reverse (iX);
+  iX += iSeed;
+  iX ^= iX * 0x6C50B47Cu;
+  iX ^= iX * 0xB82F1E52u;
+  iX ^= iX * 0xC7AFE638u;
+  iX ^= iX * 0x8D22F6E6u;
+  return reverse (iX);
+}
+
+// the direction numbers of Joe and Kuo, see SobolTable.cpp
+extern const unsigned c_iSobolDimension;
+extern const unsigned short c_uJoeKuo[];
+
+// the scalar product of the blocks of size iM that start at iX and iY
+double
+dot (const std::valarray<double> &rX, unsigned iX,
+     const std::valarray<double> &rY, unsigned iY, unsigned iM)
+{
+  double dS = 0.;
+  for (unsigned iJ = 0; iJ < iM; iJ++)
+    {
+      dS += rX[iX + iJ] * rY[iY + iJ];
+    }
+  return dS;
+}
+
+// the state is the Brownian motion with the variance of the lattice
+// implementation
+std::vector<double>
+variance (const Function &rVolatility, const std::vector<double> &rEventTimes)
+{
+  std::vector<double> uVar (rEventTimes.size ());
+  std::transform (rEventTimes.begin (), rEventTimes.end (), uVar.begin (),
+                  [&rVolatility, dToday = rEventTimes.front ()] (double dTime) {
+                    return std::pow (rVolatility (dTime), 2) * (dTime - dToday);
+                  });
+
+  POSTCONDITION (std::equal (uVar.begin () + 1, uVar.end (), uVar.begin (),
+                             std::greater_equal<double> ()));
+
+  return uVar;
+}
+
+class BlackModel : public IPathModel
+{
+public:
+  BlackModel (const Black::Data &rData, const std::vector<double> &rEventTimes)
+      : m_uData (rData), m_uEventTimes (rEventTimes),
+        m_uVar (cflMonteCarlo::variance (rData.volatility, rEventTimes))
+  {
+    PRECONDITION (rEventTimes.front () == rData.initialTime);
+  }
+
+  const std::vector<double> &
+  eventTimes () const
+  {
+    return m_uEventTimes;
+  }
+
+  double
+  variance (unsigned iTime) const
+  {
+    return m_uVar[iTime];
+  }
+
+  // the numeraire is the inverse of the discount factor
+  std::valarray<double>
+  numeraire (unsigned iTime, const std::valarray<double> &rState) const
+  {
+    return std::valarray<double> (1. / m_uData.discount (m_uEventTimes[iTime]),
+                                  rState.size ());
+  }
+
+  std::valarray<double>
+  discount (unsigned iTime, double dMaturity,
+            const std::valarray<double> &rState) const
+  {
+    double dTime = m_uEventTimes[iTime];
+
+    PRECONDITION (dMaturity >= dTime);
+
+    return std::valarray<double> (m_uData.discount (dMaturity)
+                                      / m_uData.discount (dTime),
+                                  rState.size ());
+  }
+
+  std::valarray<double>
+  forward (unsigned iTime, double dMaturity,
+           const std::valarray<double> &rState) const
+  {
+    PRECONDITION (dMaturity >= m_uEventTimes[iTime]);
+
+    // forward price = exp(shape * state + c);
+    double dShape = m_uData.shape (dMaturity);
+    double dC = std::log (m_uData.forward (dMaturity))
+                - 0.5 * dShape * dShape * m_uVar[iTime];
+
+    return std::exp (rState * dShape + dC);
+  }
+
+private:
+  Black::Data m_uData;
+  std::vector<double> m_uEventTimes, m_uVar;
+};
+
+class HullWhiteModel : public IPathModel
+{
+public:
+  HullWhiteModel (const HullWhite::Data &rData,
+                  const std::vector<double> &rEventTimes)
+      : m_uData (rData), m_uEventTimes (rEventTimes),
+        m_uVar (cflMonteCarlo::variance (rData.volatility, rEventTimes)),
+        m_dC (rData.shape (rEventTimes.back ()))
+  {
+    PRECONDITION (rEventTimes.front () == rData.initialTime);
+  }
+
+  const std::vector<double> &
+  eventTimes () const
+  {
+    return m_uEventTimes;
+  }
+
+  double
+  variance (unsigned iTime) const
+  {
+    return m_uVar[iTime];
+  }
+
+  // the numeraire is the discount bond with the last event time as
+  // maturity
+  std::valarray<double>
+  numeraire (unsigned iTime, const std::valarray<double> &rState) const
+  {
+    return discount (iTime, m_uEventTimes.back (), rState);
+  }
+
+  std::valarray<double>
+  discount (unsigned iTime, double dMaturity,
+            const std::valarray<double> &rState) const
+  {
+    double dTime = m_uEventTimes[iTime];
+
+    PRECONDITION (dMaturity >= dTime);
+
+    double dA = m_uData.shape (dTime);
+    double dB = m_uData.shape (dMaturity);
+    double dC = std::log (m_uData.discount (dMaturity)
+                          / m_uData.discount (dTime))
+                - 0.5 * (dB - dA) * (dA + dB - 2. * m_dC) * m_uVar[iTime];
+
+    return std::exp (rState * (dB - dA) + dC);
+  }
+
+private:
+  HullWhite::Data m_uData;
+  std::vector<double> m_uEventTimes, m_uVar;
+  double m_dC;
+};
+} // namespace cflMonteCarlo
+
+using namespace cflMonteCarlo;
+
+// class IPathModel
+
+std::valarray<double>
+cfl::MonteCarlo::IPathModel::forward (unsigned, double,
+                                      const std::valarray<double> &) const
+{
+  throw (NError::range ("forward price"));
+}
+
+// class PathModel
+
+cfl::MonteCarlo::PathModel::PathModel (IPathModel *pNewModel)
+    : m_pModel (pNewModel)
+{
+}
+
+// class Paths
+
+cfl::MonteCarlo::Paths::Paths (const PathModel &rModel, unsigned iSize)
+    : m_uModel (rModel),
+      m_uState (rModel.model ().eventTimes ().size (),
+                std::valarray<double> (0., iSize)),
+      m_uStd (0., m_uState.size ())
+{
+  PRECONDITION (iSize > 0);
+
+  const IPathModel &rM = rModel.model ();
+  for (unsigned iI = 1; iI < m_uStd.size (); iI++)
+    {
+      m_uStd[iI] = std::sqrt (rM.variance (iI) - rM.variance (iI - 1));
+    }
+
+  // the Brownian bridge fills the intervals in the order of bisection
+  unsigned iLast = m_uState.size () - 1;
+  if (iLast == 0)
+    {
+      return;
+    }
+  m_uBridge.push_back ({ iLast, 0, 0 });
+  m_uWeight.push_back ({ 0., 0., std::sqrt (rM.variance (iLast)) });
+  std::deque<std::pair<unsigned, unsigned> > uIntervals (1, { 0, iLast });
+  while (!uIntervals.empty ())
+    {
+      unsigned iL = uIntervals.front ().first;
+      unsigned iR = uIntervals.front ().second;
+      uIntervals.pop_front ();
+      if (iR - iL < 2)
+        {
+          continue;
+        }
+      unsigned iM = (iL + iR) / 2;
+      double dL = rM.variance (iM) - rM.variance (iL);
+      double dR = rM.variance (iR) - rM.variance (iM);
+      double dV = dL + dR;
+      m_uBridge.push_back ({ iM, iL, iR });
+      if (dV > cfl::VAR_EPS)
+        {
+          m_uWeight.push_back ({ dR / dV, dL / dV, std::sqrt (dL * dR / dV) });
+        }
+      else
+        {
+          m_uWeight.push_back ({ 1., 0., 0. });
+        }
+      uIntervals.push_back ({ iL, iM });
+      uIntervals.push_back ({ iM, iR });
+    }
+
+  POSTCONDITION (m_uBridge.size () == iLast);
+}
+
+void
+cfl::MonteCarlo::Paths::simulate (unsigned long iSeed, unsigned long iFirst)
+{
+  Philox uGen (iSeed);
+  unsigned iSteps = m_uState.size () - 1;
+  double uZ[4];
+  for (unsigned iP = 0; iP < size (); iP++)
+    {
+      for (unsigned iI = 0; iI < iSteps; iI++)
+        {
+          if (iI % 4 == 0)
+            {
+              uGen.normal (iFirst + iP, iI / 4, uZ);
+            }
+          m_uState[iI + 1][iP]
+              = m_uState[iI][iP] + m_uStd[iI + 1] * uZ[iI % 4];
+        }
+    }
+}
+
+void
+cfl::MonteCarlo::Paths::simulate (const Sobol &rSobol,
+                                  unsigned long iScramble,
+                                  unsigned long iFirst)
+{
+  PRECONDITION (rSobol.dimension () == m_uBridge.size ());
+
+  // the uniform variables are needed only for the Sobol points
+  if (m_uZ.size () != m_uBridge.size ())
+    {
+      m_uZ.assign (m_uBridge.size (), std::valarray<double> (size ()));
+    }
+  rSobol.points (iFirst, iScramble, m_uZ);
+  for (unsigned iJ = 0; iJ < m_uBridge.size (); iJ++)
+    {
+      std::valarray<double> &rZ = m_uZ[iJ];
+      const std::array<unsigned, 3> &rB = m_uBridge[iJ];
+      const std::array<double, 3> &rW = m_uWeight[iJ];
+      std::valarray<double> &rState = m_uState[rB[0]];
+      const std::valarray<double> &rLeft = m_uState[rB[1]];
+      const std::valarray<double> &rRight = m_uState[rB[2]];
+      for (unsigned iP = 0; iP < rZ.size (); iP++)
+        {
+          rState[iP] = rW[0] * rLeft[iP] + rW[1] * rRight[iP]
+                       + rW[2] * gsl_cdf_ugaussian_Pinv (rZ[iP]);
+        }
+    }
+}
+
+// class Sobol
+
+cfl::MonteCarlo::Sobol::Sobol (unsigned iDimension)
+    : m_iDimension (iDimension), m_uDirection (iDimension * c_iBits)
+{
+  PRECONDITION (iDimension <= c_iSobolDimension);
+  // the first coordinate is the van der Corput sequence
+  for (unsigned iK = 0; (iK < c_iBits) && (iDimension > 0); iK++)
+    {
+      m_uDirection[iK] = 1u << (c_iBits - 1 - iK);
+    }
+
+  // the primitive polynomials and the initial direction numbers m_k
+  // of Joe and Kuo
+  const unsigned short *pData = c_uJoeKuo;
+  for (unsigned iJ = 1; iJ < iDimension; iJ++)
+    {
+      unsigned iDeg = pData[0];
+      uint64_t iP = (uint64_t (1) << iDeg) | (uint64_t (pData[1]) << 1) | 1;
+      std::vector<uint64_t> uM (c_iBits);
+      for (unsigned iK = 0; iK < c_iBits; iK++)
+        {
+          if (iK < iDeg)
+            {
+              uM[iK] = pData[2 + iK];
+              continue;
+            }
+          uM[iK] = uM[iK - iDeg] ^ (uM[iK - iDeg] << iDeg);
+          for (unsigned iL = 1; iL < iDeg; iL++)
+            {
+              if ((iP >> (iDeg - iL)) & 1)
+                {
+                  uM[iK] ^= uM[iK - iL] << iL;
+                }
+            }
+        }
+      pData += 2 + iDeg;
+      for (unsigned iK = 0; iK < c_iBits; iK++)
+        {
+          m_uDirection[iJ * c_iBits + iK]
+              = unsigned (uM[iK] << (c_iBits - 1 - iK));
+        }
+    }
+}
+
+void
+cfl::MonteCarlo::Sobol::points (
+    unsigned long iFirst, unsigned long iScramble,
+    std::vector<std::valarray<double> > &rPoints) const
+{
+  PRECONDITION (rPoints.size () == m_iDimension);
+  // the direction numbers have c_iBits binary digits
+  PRECONDITION ((m_iDimension == 0)
+                || (uint64_t (iFirst) + rPoints.front ().size ()
+                    <= (uint64_t (1) << c_iBits)));
+
+  const double c_dScale = 1. / 4294967296.;
+  for (unsigned iJ = 0; iJ < m_iDimension; iJ++)
+    {
+      const unsigned *pV = &m_uDirection[iJ * c_iBits];
+      uint32_t iSeed = uint32_t (hash (hash (iScramble) ^ iJ));
+      std::valarray<double> &rU = rPoints[iJ];
+      // the point with the Gray code of iFirst
+      uint64_t iGray = uint64_t (iFirst) ^ (uint64_t (iFirst) >> 1);
+      uint32_t iX = 0;
+      for (unsigned iK = 0; iGray; iK++, iGray >>= 1)
+        {
+          if (iGray & 1)
+            {
+              iX ^= pV[iK];
+            }
+        }
+      for (unsigned iN = 0; iN < rU.size (); iN++)
+        {
+          if (iN > 0)
+            {
+              uint64_t iIndex = uint64_t (iFirst) + iN;
+              unsigned iK = 0;
+              while (!((iIndex >> iK) & 1))
+                {
+                  iK++;
+                }
+              iX ^= pV[iK];
+            }
+          rU[iN] = (scramble (iX, iSeed) + 0.5) * c_dScale;
+        }
+    }
+}
+
+// function price
+
+std::valarray<double>
+cfl::MonteCarlo::price (const PathModel &rModel, const TPayoff &rPayoff,
+                        unsigned long iPaths, unsigned long iSeed,
+                        unsigned iBatch)
+{
+  PRECONDITION ((iPaths > 1) && (iBatch > 0));
+
+  // the sums over the batches are added in the same order for any
+  // number of threads
+  unsigned iBatches = (iPaths + iBatch - 1) / iBatch;
+  std::valarray<double> uSum (0., iBatches), uSum2 (0., iBatches);
+  cfl::parallel (iBatches, [&] (unsigned iBegin, unsigned iEnd) {
+    Paths uPaths (rModel, iBatch);
+    for (unsigned iB = iBegin; iB < iEnd; iB++)
+      {
+        unsigned long iFirst = (unsigned long)iB * iBatch;
+        uPaths.simulate (iSeed, iFirst);
+        std::valarray<double> uV = rPayoff (uPaths);
+
+        ASSERT (uV.size () == iBatch);
+
+        unsigned iSize = std::min<unsigned long> (iBatch, iPaths - iFirst);
+        for (unsigned iI = 0; iI < iSize; iI++)
+          {
+            uSum[iB] += uV[iI];
+            uSum2[iB] += uV[iI] * uV[iI];
+          }
+      }
+  });
+
+  double dMean = uSum.sum () / iPaths;
+  double dVar = (uSum2.sum () / iPaths - dMean * dMean) * iPaths / (iPaths - 1.);
+  double dN0
+      = rModel.model ().numeraire (0, std::valarray<double> (0., 1))[0];
+  std::valarray<double> uPrice
+      = { dN0 * dMean, dN0 * std::sqrt (std::max (dVar, 0.) / iPaths) };
+
+  return uPrice;
+}
+
+// Monte Carlo models
+
+PathModel
+cfl::MonteCarlo::black (const Black::Data &rData,
+                        const std::vector<double> &rEventTimes)
+{
+  return PathModel (new cflMonteCarlo::BlackModel (rData, rEventTimes));
+}
+
+PathModel
+cfl::MonteCarlo::hullWhite (const HullWhite::Data &rData,
+                            const std::vector<double> &rEventTimes)
+{
+  return PathModel (new cflMonteCarlo::HullWhiteModel (rData, rEventTimes));
+}
+
+std::valarray<double>
+cfl::MonteCarlo::quasiPrice (const PathModel &rModel, const TPayoff &rPayoff,
+                             unsigned long iPaths, unsigned iReplications,
+                             unsigned long iSeed, unsigned iBatch)
+{
+  PRECONDITION ((iPaths > 0) && (iBatch > 0) && (iReplications > 1));
+
+  Sobol uSobol (rModel.model ().eventTimes ().size () - 1);
+  unsigned iBatches = (iPaths + iBatch - 1) / iBatch;
+  // the numbers of the Sobol points are less than 2^32
+  PRECONDITION (uint64_t (iBatches) * iBatch <= (uint64_t (1) << c_iBits));
+  std::valarray<double> uSum (0., iBatches * iReplications);
+  cfl::parallel (iBatches * iReplications, [&] (unsigned iBegin,
+                                                unsigned iEnd) {
+    Paths uPaths (rModel, iBatch);
+    for (unsigned iI = iBegin; iI < iEnd; iI++)
+      {
+        unsigned iR = iI / iBatches;
+        unsigned long iFirst = (unsigned long)(iI % iBatches) * iBatch;
+        uPaths.simulate (uSobol, iSeed * iReplications + iR, iFirst);
+        std::valarray<double> uV = rPayoff (uPaths);
+
+        ASSERT (uV.size () == iBatch);
+
+        unsigned iSize = std::min<unsigned long> (iBatch, iPaths - iFirst);
+        uSum[iI] = std::valarray<double> (uV[std::slice (0, iSize, 1)]).sum ();
+      }
+  });
+
+  // the estimates of the replications are independent
+  std::valarray<double> uMean (iReplications);
+  for (unsigned iR = 0; iR < iReplications; iR++)
+    {
+      uMean[iR]
+          = std::valarray<double> (uSum[std::slice (iR * iBatches, iBatches, 1)])
+                .sum ()
+            / iPaths;
+    }
+  double dMean = uMean.sum () / iReplications;
+  double dVar = ((uMean - dMean) * (uMean - dMean)).sum () / (iReplications - 1.);
+  double dN0
+      = rModel.model ().numeraire (0, std::valarray<double> (0., 1))[0];
+  std::valarray<double> uPrice
+      = { dN0 * dMean, dN0 * std::sqrt (dVar / iReplications) };
+
+  return uPrice;
+}
+
+// class Boundary
+
+cfl::MonteCarlo::Boundary::Boundary (const std::vector<double> &rEventTimes,
+                                     const TPathFunction &rState,
+                                     const std::vector<Function> &rBasis,
+                                     unsigned iRights)
+    : m_uEventTimes (rEventTimes), m_uState (rState), m_uBasis (rBasis),
+      m_iRights (iRights),
+      m_uCoeff (rEventTimes.size () * (iRights + 1),
+                std::valarray<double> (0., rBasis.size ()))
+{
+  PRECONDITION ((rBasis.size () > 0) && (iRights > 0));
+}
+
+void
+cfl::MonteCarlo::Boundary::assign (unsigned iTime, unsigned iRights,
+                                   const std::valarray<double> &rCoeff)
+{
+  PRECONDITION ((iTime < m_uEventTimes.size ()) && (iRights <= m_iRights));
+  PRECONDITION ((iRights > 0) && (rCoeff.size () == size ()));
+
+  m_uCoeff[iTime * (m_iRights + 1) + iRights] = rCoeff;
+}
+
+void
+cfl::MonteCarlo::Boundary::basis (const Paths &rPaths, unsigned iTime,
+                                  std::valarray<double> &rBasis) const
+{
+  std::valarray<double> uX = m_uState (rPaths, iTime);
+  unsigned iM = size ();
+  if (rBasis.size () != uX.size () * iM)
+    {
+      rBasis.resize (uX.size () * iM);
+    }
+  for (unsigned iN = 0; iN < uX.size (); iN++)
+    {
+      for (unsigned iJ = 0; iJ < iM; iJ++)
+        {
+          rBasis[iN * iM + iJ] = m_uBasis[iJ](uX[iN]);
+        }
+    }
+}
+
+std::valarray<double>
+cfl::MonteCarlo::Boundary::continuation (const Paths &rPaths, unsigned iTime,
+                                         unsigned iRights) const
+{
+  PRECONDITION (rPaths.eventTimes ().size () == m_uEventTimes.size ());
+  PRECONDITION (iRights <= m_iRights);
+
+  std::valarray<double> uC (0., rPaths.size ());
+  if ((iRights == 0) || (iTime + 1 == m_uEventTimes.size ()))
+    {
+      return uC;
+    }
+
+  std::valarray<double> uBasis;
+  basis (rPaths, iTime, uBasis);
+  const std::valarray<double> &rCoeff = coefficients (iTime, iRights);
+  unsigned iM = size ();
+  for (unsigned iN = 0; iN < uC.size (); iN++)
+    {
+      uC[iN] = cflMonteCarlo::dot (uBasis, iN * iM, rCoeff, 0, iM);
+    }
+  return uC;
+}
+
+Boundary
+cfl::MonteCarlo::boundary (const PathModel &rModel,
+                           const TPathFunction &rExercise,
+                           const TPathFunction &rState,
+                           const std::vector<Function> &rBasis,
+                           unsigned long iPaths, unsigned iRights,
+                           unsigned long iSeed, unsigned iBatch)
+{
+  PRECONDITION ((iPaths > 0) && (iBatch > 0));
+
+  const std::vector<double> &rTimes = rModel.model ().eventTimes ();
+  Boundary uBoundary (rTimes, rState, rBasis, iRights);
+  unsigned iLast = rTimes.size () - 1;
+  unsigned iM = rBasis.size ();
+  unsigned iBatches = (iPaths + iBatch - 1) / iBatch;
+
+  // the regression paths and the realized values of the policy for
+  // 0, ..., iRights rights, stored by paths
+  std::vector<Paths> uPaths (iBatches, Paths (rModel, iBatch));
+  std::vector<std::valarray<double> > uY (
+      iBatches, std::valarray<double> (0., iBatch * (iRights + 1)));
+  cfl::parallel (iBatches, [&] (unsigned iBegin, unsigned iEnd) {
+    for (unsigned iB = iBegin; iB < iEnd; iB++)
+      {
+        uPaths[iB].simulate (iSeed, (unsigned long)iB * iBatch);
+        if (iLast == 0)
+          {
+            continue;
+          }
+        std::valarray<double> uEx = rExercise (uPaths[iB], iLast);
+        for (unsigned iN = 0; iN < iBatch; iN++)
+          {
+            for (unsigned iR = 1; iR <= iRights; iR++)
+              {
+                uY[iB][iN * (iRights + 1) + iR] = std::max (uEx[iN], 0.);
+              }
+          }
+      }
+  });
+
+  // the regressions of all numbers of rights at an event time are
+  // the data sets of one batch of linear fits; the fitting scheme is
+  // constructed once for all event times
+  Fit uFit = NFit::linear (rBasis);
+  std::vector<std::valarray<double> > uEx (iBatches), uX (iBatches);
+  std::vector<double> uRight, uArg, uVal, uWt;
+  std::valarray<double> uCoeff (iM);
+  for (unsigned iTime = iLast; iTime-- > 1;)
+    {
+      cfl::parallel (iBatches, [&] (unsigned iBegin, unsigned iEnd) {
+        for (unsigned iB = iBegin; iB < iEnd; iB++)
+          {
+            uEx[iB] = rExercise (uPaths[iB], iTime);
+            uX[iB] = rState (uPaths[iB], iTime);
+          }
+      });
+
+      // the paths where the exercise value is positive
+      uRight.clear ();
+      uArg.clear ();
+      uVal.clear ();
+      for (unsigned iR = 1; iR <= iRights; iR++)
+        {
+          for (unsigned iB = 0; iB < iBatches; iB++)
+            {
+              unsigned iSize = std::min<unsigned long> (
+                  iBatch, iPaths - (unsigned long)iB * iBatch);
+              for (unsigned iN = 0; iN < iSize; iN++)
+                {
+                  if (uEx[iB][iN] > 0.)
+                    {
+                      uRight.push_back (iR);
+                      uArg.push_back (uX[iB][iN]);
+                      uVal.push_back (uY[iB][iN * (iRights + 1) + iR]);
+                    }
+                }
+            }
+        }
+      uWt.assign (uArg.size (), 1.);
+
+      // a failed regression, for example, with too few paths, gives
+      // the zero continuation value
+      FitBatch uFits;
+      uFits.size = 0;
+      if (uArg.size () > iRights * iM)
+        {
+          uFits = uFit.batch (uRight, uArg, uVal, uWt, false);
+        }
+      for (unsigned iR = 1; iR <= iRights; iR++)
+        {
+          uCoeff = 0.;
+          if (uFits.size == iM)
+            {
+              uCoeff = uFits.fit[std::slice ((iR - 1) * iM, iM, 1)];
+              if (!std::isfinite (uCoeff.sum ()))
+                {
+                  uCoeff = 0.;
+                }
+            }
+          uBoundary.assign (iTime, iR, uCoeff);
+        }
+
+      // the realized values of the policy; the rights are updated in
+      // the decreasing order
+      cfl::parallel (iBatches, [&] (unsigned iBegin, unsigned iEnd) {
+        std::valarray<double> uBasis;
+        for (unsigned iB = iBegin; iB < iEnd; iB++)
+          {
+            uBoundary.basis (uPaths[iB], iTime, uBasis);
+            for (unsigned iN = 0; iN < iBatch; iN++)
+              {
+                double dEx = uEx[iB][iN];
+                if (!(dEx > 0.))
+                  {
+                    continue;
+                  }
+                double *pY = &uY[iB][iN * (iRights + 1)];
+                for (unsigned iR = iRights; iR > 0; iR--)
+                  {
+                    double dHold = cflMonteCarlo::dot (
+                        uBasis, iN * iM, uBoundary.coefficients (iTime, iR),
+                        0, iM);
+                    double dRest = cflMonteCarlo::dot (
+                        uBasis, iN * iM,
+                        uBoundary.coefficients (iTime, iR - 1), 0, iM);
+                    if (dEx + dRest >= dHold)
+                      {
+                        pY[iR] = dEx + pY[iR - 1];
+                      }
+                  }
+              }
+          }
+      });
+    }
+
+  return uBoundary;
+}
+
+TPayoff
+cfl::MonteCarlo::american (const TPathFunction &rExercise,
+                           const Boundary &rBoundary)
+{
+  return [rExercise, rBoundary] (const Paths &rPaths) {
+    PRECONDITION (rPaths.eventTimes () == rBoundary.eventTimes ());
+
+    unsigned iLast = rPaths.eventTimes ().size () - 1;
+    unsigned iRights = rBoundary.rights ();
+    std::valarray<double> uV (0., rPaths.size ());
+    std::vector<unsigned> uRights (rPaths.size (), iRights);
+    unsigned iM = rBoundary.size ();
+    std::valarray<double> uBasis;
+    for (unsigned iTime = 1; iTime <= iLast; iTime++)
+      {
+        std::valarray<double> uEx = rExercise (rPaths, iTime);
+        bool bLast = (iTime == iLast);
+        if (!bLast)
+          {
+            rBoundary.basis (rPaths, iTime, uBasis);
+          }
+        for (unsigned iN = 0; iN < uV.size (); iN++)
+          {
+            unsigned iR = uRights[iN];
+            if ((iR == 0) || !(uEx[iN] > 0.))
+              {
+                continue;
+              }
+            double dHold = 0., dRest = 0.;
+            if (!bLast)
+              {
+                dHold = cflMonteCarlo::dot (
+                    uBasis, iN * iM, rBoundary.coefficients (iTime, iR), 0,
+                    iM);
+                dRest = cflMonteCarlo::dot (
+                    uBasis, iN * iM, rBoundary.coefficients (iTime, iR - 1),
+                    0, iM);
+              }
+            if (uEx[iN] + dRest >= dHold)
+              {
+                uV[iN] += uEx[iN];
+                uRights[iN]--;
+              }
+          }
+      }
+    return uV;
+  };
+}
+
+TPayoff
+cfl::MonteCarlo::american (const TPathFunction &rExercise,
+                           const Exercise &rRegion)
+{
+  return [rExercise, rRegion] (const Paths &rPaths) {
+    PRECONDITION (rPaths.eventTimes () == rRegion.eventTimes ());
+
+    std::valarray<double> uV (0., rPaths.size ());
+    std::valarray<bool> uAlive (true, rPaths.size ());
+    for (unsigned iTime = 1; iTime < rPaths.eventTimes ().size (); iTime++)
+      {
+        std::valarray<bool> uIn
+            = rRegion.exercise (iTime, rPaths.state (iTime)) && uAlive;
+        if (!uIn.max ())
+          {
+            continue;
+          }
+        std::valarray<double> uEx = rExercise (rPaths, iTime);
+        for (unsigned iN = 0; iN < uV.size (); iN++)
+          {
+            if (uIn[iN])
+              {
+                uV[iN] = uEx[iN];
+                uAlive[iN] = false;
+              }
+          }
+      }
+    return uV;
+  };
+}
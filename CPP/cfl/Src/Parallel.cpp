@@ -0,0 +1,195 @@
+#include "cfl/Parallel.hpp"
+#include "cfl/Error.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cflParallel
+{
+// true in the threads of the pool and in the calling thread while it
+// processes its block
+thread_local bool t_bWorker = false;
+
+// the blocks of one call of cfl::parallel that are given to the pool
+struct Batch
+{
+  unsigned iPending;
+  std::exception_ptr pError;
+  std::condition_variable uDone;
+};
+
+// the worker threads are started on the first parallel call and wait
+// for the blocks until the end of the program
+class Pool
+{
+public:
+  explicit Pool (unsigned iThreads)
+  {
+    m_uThreads.reserve (iThreads);
+    for (unsigned iI = 0; iI < iThreads; iI++)
+      {
+        m_uThreads.emplace_back ([this] () { work (); });
+      }
+  }
+
+  ~Pool ()
+  {
+    {
+      std::lock_guard<std::mutex> uLock (m_uMutex);
+      m_bStop = true;
+    }
+    m_uWake.notify_all ();
+    for (std::thread &rThread : m_uThreads)
+      {
+        rThread.join ();
+      }
+  }
+
+  // the number of worker threads together with the calling thread
+  unsigned
+  size () const
+  {
+    return m_uThreads.size () + 1;
+  }
+
+  // processes the blocks [1, iThreads) in the pool and the block 0 in
+  // the calling thread
+  void
+  run (unsigned iSize, unsigned iThreads,
+       const std::function<void (unsigned, unsigned)> &rF)
+  {
+    Batch uBatch;
+    uBatch.iPending = iThreads - 1;
+    {
+      std::lock_guard<std::mutex> uLock (m_uMutex);
+      for (unsigned iI = 1; iI < iThreads; iI++)
+        {
+          unsigned iBegin = bound (iSize, iI, iThreads);
+          unsigned iEnd = bound (iSize, iI + 1, iThreads);
+          m_uTasks.emplace_back ([this, &uBatch, &rF, iBegin, iEnd] () {
+            std::exception_ptr pError = call (rF, iBegin, iEnd);
+            std::lock_guard<std::mutex> uLock (m_uMutex);
+            if (pError && !uBatch.pError)
+              {
+                uBatch.pError = pError;
+              }
+            if (--uBatch.iPending == 0)
+              {
+                uBatch.uDone.notify_one ();
+              }
+          });
+        }
+    }
+    m_uWake.notify_all ();
+
+    t_bWorker = true;
+    std::exception_ptr pError = call (rF, 0, bound (iSize, 1, iThreads));
+    t_bWorker = false;
+
+    std::unique_lock<std::mutex> uLock (m_uMutex);
+    uBatch.uDone.wait (uLock, [&uBatch] () { return uBatch.iPending == 0; });
+    if (!pError)
+      {
+        pError = uBatch.pError;
+      }
+    uLock.unlock ();
+    if (pError)
+      {
+        std::rethrow_exception (pError);
+      }
+  }
+
+private:
+  // the beginning of the block iI; the product does not overflow
+  static unsigned
+  bound (unsigned iSize, unsigned iI, unsigned iThreads)
+  {
+    return unsigned ((std::uint64_t (iSize) * iI) / iThreads);
+  }
+
+  static std::exception_ptr
+  call (const std::function<void (unsigned, unsigned)> &rF, unsigned iBegin,
+        unsigned iEnd)
+  {
+    try
+      {
+        rF (iBegin, iEnd);
+      }
+    catch (...)
+      {
+        return std::current_exception ();
+      }
+    return std::exception_ptr ();
+  }
+
+  void
+  work ()
+  {
+    t_bWorker = true;
+    while (true)
+      {
+        std::function<void ()> uTask;
+        {
+          std::unique_lock<std::mutex> uLock (m_uMutex);
+          m_uWake.wait (uLock,
+                        [this] () { return m_bStop || !m_uTasks.empty (); });
+          if (m_uTasks.empty ())
+            {
+              return;
+            }
+          uTask = std::move (m_uTasks.front ());
+          m_uTasks.pop_front ();
+        }
+        uTask ();
+      }
+  }
+
+  std::mutex m_uMutex;
+  std::condition_variable m_uWake;
+  std::deque<std::function<void ()> > m_uTasks;
+  bool m_bStop = false;
+  std::vector<std::thread> m_uThreads;
+};
+
+Pool &
+pool ()
+{
+  static Pool uPool (std::max (std::thread::hardware_concurrency (), 1u) - 1);
+  return uPool;
+}
+} // namespace cflParallel
+
+void
+cfl::parallel (unsigned iSize,
+               const std::function<void (unsigned iBegin, unsigned iEnd)> &rF,
+               unsigned iMinBlock)
+{
+  PRECONDITION (iMinBlock > 0);
+
+  // nested calls run in the calling thread
+  if (cflParallel::t_bWorker)
+    {
+      if (iSize > 0)
+        {
+          rF (0, iSize);
+        }
+      return;
+    }
+
+  cflParallel::Pool &rPool = cflParallel::pool ();
+  unsigned iThreads = std::min (rPool.size (), iSize / iMinBlock);
+  if (iThreads <= 1)
+    {
+      if (iSize > 0)
+        {
+          rF (0, iSize);
+        }
+      return;
+    }
+  rPool.run (iSize, iThreads, rF);
+}
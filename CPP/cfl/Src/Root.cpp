@@ -2,6 +2,8 @@
 #include "cfl/Error.hpp"
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_roots.h>
+#include <memory>
+#include <mutex>
 
 using namespace cfl;
 using namespace std;
@@ -24,6 +26,9 @@ value (double dX, void *pF)
   return rF (dX);
 }
 
+typedef std::unique_ptr<gsl_root_fsolver, decltype (&gsl_root_fsolver_free)>
+    TSolver;
+
 class GSL_FSolver : public IRoot
 {
 public:
@@ -35,6 +40,7 @@ public:
     m_iMaxSteps = iMaxSteps;
     m_bFErr = false;
     m_pT = pT;
+    m_uSolver.reset (gsl_root_fsolver_alloc (m_pT));
   }
 
   GSL_FSolver (double dFErr, unsigned iMaxSteps,
@@ -44,21 +50,29 @@ public:
     m_iMaxSteps = iMaxSteps;
     m_bFErr = true;
     m_pT = pT;
+    m_uSolver.reset (gsl_root_fsolver_alloc (m_pT));
   }
 
   double
   find (const cfl::Function &rF, double dL, double dR) const
   {
+    // the solver only reads the function; we do not copy it
     gsl_function uF;
-    cfl::Function uG (rF);
-
     uF.function = &value;
-    uF.params = &uG;
+    uF.params = const_cast<cfl::Function *> (&rF);
 
-    std::unique_ptr<gsl_root_fsolver, decltype (&gsl_root_fsolver_free)>
-        uSolver (gsl_root_fsolver_alloc (m_pT), &gsl_root_fsolver_free);
+    // the workspace of the object is reused unless another thread
+    // holds it
+    std::unique_lock<std::mutex> uLock (m_uMutex, std::try_to_lock);
+    TSolver uLocal (nullptr, &gsl_root_fsolver_free);
+    if (!uLock.owns_lock ())
+      {
+        uLocal.reset (gsl_root_fsolver_alloc (m_pT));
+      }
+    gsl_root_fsolver *pSolver
+        = uLock.owns_lock () ? m_uSolver.get () : uLocal.get ();
 
-    gsl_root_fsolver_set (uSolver.get (), &uF, dL, dR);
+    gsl_root_fsolver_set (pSolver, &uF, dL, dR);
     int iStatus = GSL_CONTINUE;
     double dX = 0.5 * (dL + dR);
     unsigned iSteps = 0;
@@ -69,8 +83,8 @@ public:
         while ((iStatus == GSL_CONTINUE) && (iSteps < m_iMaxSteps))
           {
             iSteps++;
-            gsl_root_fsolver_iterate (uSolver.get ());
-            dX = gsl_root_fsolver_root (uSolver.get ());
+            gsl_root_fsolver_iterate (pSolver);
+            dX = gsl_root_fsolver_root (pSolver);
             dY = GSL_FN_EVAL (&uF, dX);
             iStatus = gsl_root_test_residual (dY, m_dFErr);
           }
@@ -82,12 +96,12 @@ public:
         while ((iStatus == GSL_CONTINUE) && (iSteps < m_iMaxSteps))
           {
             iSteps++;
-            gsl_root_fsolver_iterate (uSolver.get ());
-            dL = gsl_root_fsolver_x_lower (uSolver.get ());
-            dR = gsl_root_fsolver_x_upper (uSolver.get ());
+            gsl_root_fsolver_iterate (pSolver);
+            dL = gsl_root_fsolver_x_lower (pSolver);
+            dR = gsl_root_fsolver_x_upper (pSolver);
             iStatus = gsl_root_test_interval (dL, dR, m_dAbsErr, m_dRelErr);
           }
-        dX = gsl_root_fsolver_root (uSolver.get ());
+        dX = gsl_root_fsolver_root (pSolver);
       }
 
     ASSERT ((iStatus == GSL_SUCCESS) || (iSteps == m_iMaxSteps));
@@ -100,6 +114,8 @@ private:
   unsigned m_iMaxSteps;
   bool m_bFErr;
   const gsl_root_fsolver_type *m_pT;
+  TSolver m_uSolver{ nullptr, &gsl_root_fsolver_free };
+  mutable std::mutex m_uMutex;
 };
 }
 
@@ -2,6 +2,8 @@
 #include "cfl/Error.hpp"
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_roots.h>
+#include <memory>
+#include <mutex>
 
 using namespace cfl;
 using namespace std;
@@ -14,37 +16,44 @@ cfl::RootD::RootD (IRootD *pNewP) : m_uP (pNewP) {}
 
 namespace cflRootD
 {
+// the function and its derivative
+typedef std::pair<const Function *, const Function *> TFDF;
+
 double
 value (double dX, void *pF)
 {
-  const std::vector<Function> &rF = *(const std::vector<Function> *)pF;
+  const TFDF &rF = *(const TFDF *)pF;
 
-  ASSERT (rF.front ().belongs (dX));
+  ASSERT (rF.first->belongs (dX));
 
-  return rF.front () (dX);
+  return (*rF.first) (dX);
 }
 
 double
 deriv (double dX, void *pF)
 {
-  const std::vector<Function> &rF = *(const std::vector<Function> *)pF;
+  const TFDF &rF = *(const TFDF *)pF;
 
-  ASSERT (rF.back ().belongs (dX));
+  ASSERT (rF.second->belongs (dX));
 
-  return rF.back () (dX);
+  return (*rF.second) (dX);
 }
 
 void
 valueDeriv (double dX, void *pF, double *pV, double *pD)
 {
-  const std::vector<Function> &rF = *(const std::vector<Function> *)pF;
+  const TFDF &rF = *(const TFDF *)pF;
 
-  ASSERT (rF.front ().belongs (dX) && rF.back ().belongs (dX));
+  ASSERT (rF.first->belongs (dX) && rF.second->belongs (dX));
 
-  *pV = rF.front () (dX);
-  *pD = rF.back () (dX);
+  *pV = (*rF.first) (dX);
+  *pD = (*rF.second) (dX);
 }
 
+typedef std::unique_ptr<gsl_root_fdfsolver,
+                        decltype (&gsl_root_fdfsolver_free)>
+    TSolver;
+
 class GSL_FDFSolver : public IRootD
 {
 public:
@@ -56,6 +65,7 @@ public:
     m_iMaxSteps = iMaxSteps;
     m_bFErr = false;
     m_pT = pT;
+    m_uSolver.reset (gsl_root_fdfsolver_alloc (m_pT));
   }
 
   GSL_FDFSolver (double dFErr, unsigned iMaxSteps,
@@ -65,23 +75,33 @@ public:
     m_iMaxSteps = iMaxSteps;
     m_bFErr = true;
     m_pT = pT;
+    m_uSolver.reset (gsl_root_fdfsolver_alloc (m_pT));
   }
 
   double
   find (const cfl::Function &rF, const cfl::Function &rDF, double dX0) const
   {
+    // the solver only reads the functions; we do not copy them
     gsl_function_fdf uF;
-    std::vector<Function> uG = { rF, rDF };
+    TFDF uG (&rF, &rDF);
 
     uF.f = &value;
     uF.df = &deriv;
     uF.fdf = &valueDeriv;
     uF.params = &uG;
 
-    std::unique_ptr<gsl_root_fdfsolver, decltype (&gsl_root_fdfsolver_free)>
-        uSolver (gsl_root_fdfsolver_alloc (m_pT), &gsl_root_fdfsolver_free);
+    // the workspace of the object is reused unless another thread
+    // holds it
+    std::unique_lock<std::mutex> uLock (m_uMutex, std::try_to_lock);
+    TSolver uLocal (nullptr, &gsl_root_fdfsolver_free);
+    if (!uLock.owns_lock ())
+      {
+        uLocal.reset (gsl_root_fdfsolver_alloc (m_pT));
+      }
+    gsl_root_fdfsolver *pSolver
+        = uLock.owns_lock () ? m_uSolver.get () : uLocal.get ();
 
-    gsl_root_fdfsolver_set (uSolver.get (), &uF, dX0);
+    gsl_root_fdfsolver_set (pSolver, &uF, dX0);
     int iStatus = GSL_CONTINUE;
     double dX = dX0;
     unsigned iSteps = 0;
@@ -92,8 +112,8 @@ public:
         while ((iStatus == GSL_CONTINUE) && (iSteps < m_iMaxSteps))
           {
             iSteps++;
-            gsl_root_fdfsolver_iterate (uSolver.get ());
-            dX = gsl_root_fdfsolver_root (uSolver.get ());
+            gsl_root_fdfsolver_iterate (pSolver);
+            dX = gsl_root_fdfsolver_root (pSolver);
             dY = GSL_FN_FDF_EVAL_F (&uF, dX);
             iStatus = gsl_root_test_residual (dY, m_dFErr);
           }
@@ -105,8 +125,8 @@ public:
         while ((iStatus == GSL_CONTINUE) && (iSteps < m_iMaxSteps))
           {
             iSteps++;
-            gsl_root_fdfsolver_iterate (uSolver.get ());
-            dX = gsl_root_fdfsolver_root (uSolver.get ());
+            gsl_root_fdfsolver_iterate (pSolver);
+            dX = gsl_root_fdfsolver_root (pSolver);
             iStatus = gsl_root_test_delta (dX, dX0, m_dAbsErr, m_dRelErr);
             dX0 = dX;
           }
@@ -122,6 +142,8 @@ private:
   unsigned m_iMaxSteps;
   bool m_bFErr;
   const gsl_root_fdfsolver_type *m_pT;
+  TSolver m_uSolver{ nullptr, &gsl_root_fdfsolver_free };
+  mutable std::mutex m_uMutex;
 };
 }
 
@@ -7,8 +7,10 @@ using namespace std;
 class TargetModel : public IModel
 {
 public:
-  TargetModel (const TRollback &rRollback, const Model &rModel)
-      : m_uRollback (rRollback), m_uModel (rModel)
+  TargetModel (const TRollback &rRollback, const TRollback &rAdjointRollback,
+               const Model &rModel)
+      : m_uRollback (rRollback), m_uAdjointRollback (rAdjointRollback),
+        m_uModel (rModel)
   {
   }
 
@@ -62,6 +64,19 @@ public:
     rSlice.assign (*this);
   }
 
+  void
+  adjointRollback (Slice &rSlice, unsigned iTime) const
+  {
+    if (!m_uAdjointRollback)
+      {
+        IModel::adjointRollback (rSlice, iTime);
+        return;
+      }
+    rSlice.assign (model ());
+    m_uAdjointRollback (rSlice, iTime);
+    rSlice.assign (*this);
+  }
+
   void
   indicator (Slice &rSlice, double dBarrier) const
   {
@@ -86,12 +101,20 @@ private:
     return m_uModel.model ();
   }
 
-  TRollback m_uRollback;
+  TRollback m_uRollback, m_uAdjointRollback;
   Model m_uModel;
 };
 
 Model
 cfl::similar (const TRollback &rTargetRollback, const Model &rBase)
 {
-  return Model (new TargetModel (rTargetRollback, rBase));
+  return Model (new TargetModel (rTargetRollback, TRollback (), rBase));
+}
+
+Model
+cfl::similar (const TRollback &rTargetRollback,
+              const TRollback &rTargetAdjointRollback, const Model &rBase)
+{
+  return Model (
+      new TargetModel (rTargetRollback, rTargetAdjointRollback, rBase));
 }
@@ -260,3 +260,31 @@ cfl::atOrigin (const Slice &rSlice)
 
   return interpolate (rSlice) (uPoint);
 }
+
+valarray<double>
+cfl::atOrigin (const Slice &rSlice, const valarray<size_t> &rIndices)
+{
+  const vector<unsigned> &rIx = rSlice.dependence ();
+
+  if (rIx.size () == 0)
+    {
+      // the sensitivities of a constant are zero
+      valarray<double> uValues (0., rIndices.size ());
+      for (unsigned iI = 0; iI < rIndices.size (); iI++)
+        {
+          if (rIndices[iI] == 0)
+            {
+              uValues[iI] = rSlice.values ()[0];
+            }
+        }
+      return uValues;
+    }
+
+  const IModel &rModel = rSlice.model ();
+
+  valarray<size_t> uIx (rIx.size ());
+  copy (rIx.begin (), rIx.end (), begin (uIx));
+  valarray<double> uPoint (rModel.origin ()[uIx]);
+
+  return greeks (rSlice) (uPoint, rIndices);
+}
@@ -122,6 +122,19 @@ void compare (const std::valarray<double> &rExact,
               unsigned iColumn = 10, unsigned iSpace = 10,
               unsigned iMaxRows = 9);
 
+/**
+ * Compares two approximations of the same option on the uniform
+ * partition of the interval of initial values of the state process.
+ *
+ * @param rExact The reference values as the function of the state.
+ * @param rApprox The tested values as the function of the state.
+ * @param dInterval The interval of initial values for the state.
+ * @param iPoints The number of points.
+ * @param rTitle The title of the table.
+ */
+void compare (const cfl::Function &rExact, const cfl::Function &rApprox,
+              double dInterval, unsigned iPoints, const std::string &rTitle);
+
 /**
  * Prints displayed message.
  *
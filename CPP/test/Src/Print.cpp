@@ -74,6 +74,17 @@ test::compare (const std::valarray<double> &rExact,
   printTable (uResults, uHeads, rTitle, iColumn, iSpace, iMaxRows);
 }
 
+void
+test::compare (const Function &rExact, const Function &rApprox,
+               double dInterval, unsigned iPoints, const std::string &rTitle)
+{
+  PRECONDITION (dInterval > 0.);
+
+  std::valarray<double> uArg
+      = getArg (-0.45 * dInterval, 0.45 * dInterval, iPoints);
+  compare (getValues (rExact, uArg), getValues (rApprox, uArg), rTitle);
+}
+
 void
 test::print (double dValue, const std::string &sMessage, bool bExtraLine)
 {